@@ -0,0 +1,219 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmAtom.h"
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "cmSystemTools.h"
+
+/** Append-only open-addressing table of atom entries.
+
+    Readers probe the current slot array without locking.  Writers are
+    serialized by a mutex, publish each new entry with a release store, and
+    replace the slot array when it fills up.  Retired slot arrays are kept
+    alive because concurrent readers may still be probing them.
+
+    The table is shared by all live scopes and freed when the last of them
+    ends.  */
+class cmAtom::Table
+{
+public:
+  static Table& Instance()
+  {
+    if (Table* table = Active().load(std::memory_order_acquire)) {
+      return *table;
+    }
+    // Atoms created outside of any scope must stay valid until exit.
+    return *Acquire();
+  }
+
+  static Table* Acquire()
+  {
+    std::lock_guard<std::mutex> lock(ScopeMutex());
+    Table* table = Active().load(std::memory_order_relaxed);
+    if (!table) {
+      table = new Table;
+      Active().store(table, std::memory_order_release);
+    }
+    ++References();
+    return table;
+  }
+
+  static void Release()
+  {
+    std::lock_guard<std::mutex> lock(ScopeMutex());
+    if (--References() == 0) {
+      delete Active().exchange(nullptr, std::memory_order_acq_rel);
+    }
+  }
+
+  Entry const* GetEmpty() const { return this->Empty; }
+
+  Entry const* Intern(cm::string_view value)
+  {
+    std::size_t const hash = std::hash<cm::string_view>{}(value);
+    if (Entry const* entry = this->Find(value, hash)) {
+      return entry;
+    }
+
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    SlotArray* slots = this->Current.load(std::memory_order_relaxed);
+    std::size_t i = hash & slots->Mask;
+    for (;; i = (i + 1) & slots->Mask) {
+      Entry const* entry = slots->Slots[i].load(std::memory_order_relaxed);
+      if (!entry) {
+        break;
+      }
+      if (entry->Hash == hash && entry->Value == value) {
+        // Another thread interned it after our unlocked probe.
+        return entry;
+      }
+    }
+
+    this->Entries.emplace_back();
+    Entry* entry = &this->Entries.back();
+    entry->Value = std::string(value);
+    entry->Hash = hash;
+
+    // Keep the load factor at or below 1/2 so probe sequences stay short.
+    if (this->Entries.size() * 2 > slots->Mask + 1) {
+      slots = this->Grow(slots);
+      i = hash & slots->Mask;
+      while (slots->Slots[i].load(std::memory_order_relaxed)) {
+        i = (i + 1) & slots->Mask;
+      }
+    }
+    slots->Slots[i].store(entry, std::memory_order_release);
+    return entry;
+  }
+
+  Entry const* Find(cm::string_view value, std::size_t hash) const
+  {
+    SlotArray const* slots = this->Current.load(std::memory_order_acquire);
+    for (std::size_t i = hash & slots->Mask;; i = (i + 1) & slots->Mask) {
+      Entry const* entry = slots->Slots[i].load(std::memory_order_acquire);
+      if (!entry) {
+        return nullptr;
+      }
+      if (entry->Hash == hash && entry->Value == value) {
+        return entry;
+      }
+    }
+  }
+
+private:
+  struct SlotArray
+  {
+    explicit SlotArray(std::size_t size)
+      : Mask(size - 1)
+      , Slots(new std::atomic<Entry const*>[size])
+    {
+      for (std::size_t i = 0; i < size; ++i) {
+        this->Slots[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+    std::size_t Mask;
+    std::unique_ptr<std::atomic<Entry const*>[]> Slots;
+  };
+
+  Table()
+  {
+    this->SlotArrays.emplace_back(new SlotArray(1024));
+    this->Current.store(this->SlotArrays.back().get(),
+                        std::memory_order_release);
+    this->Empty = this->Intern({});
+  }
+
+  static std::atomic<Table*>& Active()
+  {
+    static std::atomic<Table*> active{ nullptr };
+    return active;
+  }
+  static std::mutex& ScopeMutex()
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
+  static std::size_t& References()
+  {
+    static std::size_t references = 0;
+    return references;
+  }
+
+  SlotArray* Grow(SlotArray const* old)
+  {
+    std::unique_ptr<SlotArray> slots(new SlotArray((old->Mask + 1) * 2));
+    for (std::size_t i = 0; i <= old->Mask; ++i) {
+      Entry const* entry = old->Slots[i].load(std::memory_order_relaxed);
+      if (!entry) {
+        continue;
+      }
+      std::size_t j = entry->Hash & slots->Mask;
+      while (slots->Slots[j].load(std::memory_order_relaxed)) {
+        j = (j + 1) & slots->Mask;
+      }
+      slots->Slots[j].store(entry, std::memory_order_relaxed);
+    }
+    SlotArray* result = slots.get();
+    this->SlotArrays.push_back(std::move(slots));
+    this->Current.store(result, std::memory_order_release);
+    return result;
+  }
+
+  std::mutex Mutex;
+  std::atomic<SlotArray*> Current;
+  std::vector<std::unique_ptr<SlotArray>> SlotArrays;
+  std::deque<Entry> Entries;
+  Entry const* Empty = nullptr;
+};
+
+cmAtom::Scope::Scope()
+{
+  Table::Acquire();
+}
+
+cmAtom::Scope::~Scope()
+{
+  Table::Release();
+}
+
+cmAtom::cmAtom()
+  : Data(Table::Instance().GetEmpty())
+{
+}
+
+cmAtom::cmAtom(cm::string_view value)
+  : Data(Table::Instance().Intern(value))
+{
+}
+
+cm::optional<cmAtom> cmAtom::Find(cm::string_view value)
+{
+  if (Entry const* entry = Table::Instance().Find(
+        value, std::hash<cm::string_view>{}(value))) {
+    return cmAtom(entry);
+  }
+  return cm::nullopt;
+}
+
+cmAtom cmAtom::GetLowerCase() const
+{
+  Entry const* lower = this->Data->Lower.load(std::memory_order_acquire);
+  if (!lower) {
+    lower = Table::Instance().Intern(
+      cmSystemTools::LowerCase(this->Data->Value));
+    // Racing threads intern the same entry, so either store wins.
+    this->Data->Lower.store(lower, std::memory_order_release);
+  }
+  return cmAtom(lower);
+}
+
+std::ostream& operator<<(std::ostream& os, cmAtom a)
+{
+  return os << a.GetString();
+}
@@ -0,0 +1,101 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+#include <cm/optional>
+#include <cm/string_view>
+
+/** \class cmAtom
+ * \brief An interned string with O(1) equality and a precomputed hash.
+ *
+ * Each distinct string value is stored once in a table.  Two atoms are
+ * equal exactly when they refer to the same table entry, so comparing and
+ * hashing them never touches the characters.  Use atoms for names drawn
+ * from a bounded vocabulary, such as command, variable and property names,
+ * but not for arbitrary values.
+ *
+ * The table is kept alive by cmAtom::Scope objects, one of which each
+ * cmake instance holds, and is freed with the last of them.  Atoms must
+ * not be used after that.  Atoms created while no scope exists go to a
+ * table that is never freed.
+ *
+ * Interning is thread-safe.  A default-constructed atom is the empty string.
+ */
+class cmAtom
+{
+public:
+  cmAtom();
+
+  /** Intern a string value.  */
+  explicit cmAtom(cm::string_view value);
+  explicit cmAtom(std::string const& value)
+    : cmAtom(cm::string_view(value))
+  {
+  }
+  explicit cmAtom(const char* value)
+    : cmAtom(cm::string_view(value))
+  {
+  }
+
+  /** Return the atom for a value only if it has already been interned.
+      A value that was never interned cannot be a key in any atom map.  */
+  static cm::optional<cmAtom> Find(cm::string_view value);
+
+  std::string const& GetString() const { return this->Data->Value; }
+  cm::string_view GetView() const { return this->Data->Value; }
+  std::size_t GetHash() const { return this->Data->Hash; }
+
+  /** Return the atom of the lower-case spelling.  It is computed once per
+      distinct value and then cached in the table.  */
+  cmAtom GetLowerCase() const;
+
+  friend bool operator==(cmAtom l, cmAtom r) { return l.Data == r.Data; }
+  friend bool operator!=(cmAtom l, cmAtom r) { return l.Data != r.Data; }
+
+  /** Order by string value so that sorted containers stay deterministic.  */
+  friend bool operator<(cmAtom l, cmAtom r)
+  {
+    return l.Data != r.Data && l.Data->Value < r.Data->Value;
+  }
+
+  struct Hash
+  {
+    std::size_t operator()(cmAtom a) const { return a.GetHash(); }
+  };
+
+  /** Keep the table of atoms alive while this object exists.  */
+  class Scope
+  {
+  public:
+    Scope();
+    ~Scope();
+
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+  };
+
+private:
+  struct Entry
+  {
+    std::string Value;
+    std::size_t Hash;
+    mutable std::atomic<Entry const*> Lower{ nullptr };
+  };
+  class Table;
+
+  explicit cmAtom(Entry const* data)
+    : Data(data)
+  {
+  }
+
+  Entry const* Data;
+};
+
+std::ostream& operator<<(std::ostream& os, cmAtom a);
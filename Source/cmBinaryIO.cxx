@@ -0,0 +1,182 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmBinaryIO.h"
+
+#include <chrono>
+#include <ios>
+#include <sstream>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmFileTime.h"
+#include "cmSystemTools.h"
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#  include <windows.h>
+#endif
+
+namespace cmBinaryIO {
+
+void WriteNumber(std::string& out, unsigned long long n, int bytes)
+{
+  for (int i = 0; i < bytes; ++i) {
+    out += static_cast<char>((n >> (8 * i)) & 0xff);
+  }
+}
+
+void WriteString(std::string& out, cm::string_view s)
+{
+  WriteNumber(out, s.size());
+  out.append(s.data(), s.size());
+}
+
+void WriteVarNumber(std::string& out, unsigned long long n)
+{
+  while (n >= 0x80) {
+    out += static_cast<char>((n & 0x7f) | 0x80);
+    n >>= 7;
+  }
+  out += static_cast<char>(n);
+}
+
+void WriteVarSignedNumber(std::string& out, long long n)
+{
+  WriteVarNumber(out,
+                 (static_cast<unsigned long long>(n) << 1) ^
+                   static_cast<unsigned long long>(n < 0 ? -1 : 0));
+}
+
+void WriteVarString(std::string& out, cm::string_view s)
+{
+  WriteVarNumber(out, s.size());
+  out.append(s.data(), s.size());
+}
+
+unsigned long long DecodeNumber(char const* data, int bytes)
+{
+  unsigned long long n = 0;
+  for (int i = 0; i < bytes; ++i) {
+    n |= static_cast<unsigned long long>(static_cast<unsigned char>(data[i]))
+      << (8 * i);
+  }
+  return n;
+}
+
+bool Reader::ReadMagic(cm::string_view magic)
+{
+  if (this->Data.compare(this->Pos, magic.size(), magic.data(),
+                         magic.size()) != 0) {
+    return false;
+  }
+  this->Pos += magic.size();
+  return true;
+}
+
+bool Reader::ReadByte(char& c)
+{
+  if (this->AtEnd()) {
+    return false;
+  }
+  c = this->Data[this->Pos++];
+  return true;
+}
+
+bool Reader::ReadNumber(unsigned long long& n)
+{
+  if (this->Data.size() - this->Pos < 8) {
+    return false;
+  }
+  n = DecodeNumber(this->Data.data() + this->Pos);
+  this->Pos += 8;
+  return true;
+}
+
+bool Reader::ReadString(std::string& s)
+{
+  unsigned long long len;
+  return this->ReadNumber(len) && this->ReadBytes(len, s);
+}
+
+bool Reader::ReadVarNumber(unsigned long long& n)
+{
+  n = 0;
+  for (int shift = 0; shift < 64 && !this->AtEnd(); shift += 7) {
+    auto const byte = static_cast<unsigned char>(this->Data[this->Pos++]);
+    n |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Reader::ReadVarSignedNumber(long long& n)
+{
+  unsigned long long u;
+  if (!this->ReadVarNumber(u)) {
+    return false;
+  }
+  n = static_cast<long long>(u >> 1) ^ -static_cast<long long>(u & 1);
+  return true;
+}
+
+bool Reader::ReadVarString(std::string& s)
+{
+  unsigned long long len;
+  return this->ReadVarNumber(len) && this->ReadBytes(len, s);
+}
+
+bool Reader::ReadBytes(unsigned long long len, std::string& s)
+{
+  if (this->Data.size() - this->Pos < len) {
+    return false;
+  }
+  s.assign(this->Data, this->Pos, static_cast<std::size_t>(len));
+  this->Pos += static_cast<std::size_t>(len);
+  return true;
+}
+
+bool ReadFile(std::string const& path, std::string& content)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  std::ostringstream ss;
+  ss << fin.rdbuf();
+  if (fin.bad()) {
+    return false;
+  }
+  content = ss.str();
+  return true;
+}
+
+bool StatFile(std::string const& path, long long& mtime,
+              unsigned long long& size)
+{
+  cmFileTime ft;
+  if (!ft.Load(path)) {
+    return false;
+  }
+  mtime = ft.GetTime();
+  size = cmSystemTools::FileLength(path);
+  return true;
+}
+
+bool IsRacy(long long mtime)
+{
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  cmFileTime::TimeType const now =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch())
+      .count();
+#else
+  FILETIME ft;
+  GetSystemTimeAsFileTime(&ft);
+  cmFileTime::TimeType const now = static_cast<cmFileTime::TimeType>(
+    (static_cast<unsigned long long>(ft.dwHighDateTime) << 32) +
+    ft.dwLowDateTime);
+#endif
+  return now - mtime < 2 * cmFileTime::UtPerS;
+}
+}
@@ -0,0 +1,85 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <string>
+
+#include <cm/string_view>
+
+/** \namespace cmBinaryIO
+ * \brief Encode and decode the binary files CMake keeps for its own use.
+ *
+ * Caches, logs and databases written to the build tree store numbers in
+ * little-endian order, either in a fixed number of bytes or in 7-bit
+ * groups that keep small numbers short.  Strings are stored as their
+ * length followed by their bytes.
+ */
+namespace cmBinaryIO {
+
+/** Append a number in the given number of bytes.  */
+void WriteNumber(std::string& out, unsigned long long n, int bytes = 8);
+
+/** Append a string with its length in 8 bytes.  */
+void WriteString(std::string& out, cm::string_view s);
+
+/** Append a number in as many 7-bit groups as it needs.  */
+void WriteVarNumber(std::string& out, unsigned long long n);
+
+/** Append a signed number such that small magnitudes stay short.  */
+void WriteVarSignedNumber(std::string& out, long long n);
+
+/** Append a string with its length in 7-bit groups.  */
+void WriteVarString(std::string& out, cm::string_view s);
+
+/** Decode a number written by WriteNumber from the given bytes.  */
+unsigned long long DecodeNumber(char const* data, int bytes = 8);
+
+/** Read the values written by the functions above from a buffer.  Each
+    method returns false, and the reader must not be used any more, if
+    the data ends before the value does.  */
+class Reader
+{
+public:
+  Reader(std::string const& data, std::size_t pos = 0)
+    : Data(data)
+    , Pos(pos)
+  {
+  }
+
+  /** Consume the given bytes, if the data continues with them.  */
+  bool ReadMagic(cm::string_view magic);
+
+  bool ReadByte(char& c);
+  bool ReadNumber(unsigned long long& n);
+  bool ReadString(std::string& s);
+  bool ReadVarNumber(unsigned long long& n);
+  bool ReadVarSignedNumber(long long& n);
+  bool ReadVarString(std::string& s);
+
+  bool AtEnd() const { return this->Pos == this->Data.size(); }
+  std::size_t GetPosition() const { return this->Pos; }
+
+private:
+  bool ReadBytes(unsigned long long len, std::string& s);
+
+  std::string const& Data;
+  std::size_t Pos;
+};
+
+/** Read the whole content of a file.  */
+bool ReadFile(std::string const& path, std::string& content);
+
+/** Get the modification time and size of a file, which the caches store
+    to tell whether the file changed since.  */
+bool StatFile(std::string const& path, long long& mtime,
+              unsigned long long& size);
+
+/** Whether a file with the given modification time, as returned by
+    StatFile, was modified so recently that another modification may not
+    change its time.  Some file systems store times in units of up to two
+    seconds.  A cache must not trust the time of such a file.  */
+bool IsRacy(long long mtime);
+}
@@ -0,0 +1,213 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmBinaryTrace.h"
+
+#include <ios>
+#include <memory>
+#include <ostream>
+#include <utility>
+
+#include <cm/string_view>
+#include <cmext/string_view>
+
+#include <cm3p/json/value.h>
+#include <cm3p/json/writer.h>
+
+#include "cmBinaryIO.h"
+
+namespace {
+// Bump this whenever the layout of the trace changes.
+unsigned long long const FormatVersion = 1;
+cm::string_view const Magic = "CMTRACE\n"_s;
+
+// The version of the json-v1 format a trace is decoded to.
+int const JsonMajorVersion = 1;
+int const JsonMinorVersion = 2;
+
+// Each record starts with a tag telling its kind.
+char const StringTag = 's';
+char const CommandTag = 'c';
+
+// Buffered records are written once they reach this size.
+std::size_t const BufferSize = 64 * 1024;
+}
+
+cmBinaryTrace::~cmBinaryTrace()
+{
+  this->Flush();
+}
+
+bool cmBinaryTrace::Open(std::string const& path)
+{
+  this->Stream.open(path.c_str(),
+                    std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!this->Stream) {
+    return false;
+  }
+  this->Buffer.assign(Magic.data(), Magic.size());
+  cmBinaryIO::WriteVarNumber(this->Buffer, FormatVersion);
+  return true;
+}
+
+std::size_t cmBinaryTrace::Intern(std::string const& str)
+{
+  auto const inserted = this->StringIds.emplace(str, this->StringIds.size());
+  if (inserted.second) {
+    this->Buffer += StringTag;
+    cmBinaryIO::WriteVarString(this->Buffer, str);
+  }
+  return inserted.first->second;
+}
+
+void cmBinaryTrace::WriteCommand(std::string const& file, long line,
+                                 long lineEnd,
+                                 cm::optional<std::string> const& deferId,
+                                 std::string const& command,
+                                 std::vector<std::string> const& args,
+                                 double time, unsigned long long frame,
+                                 unsigned long long globalFrame)
+{
+  if (!this->Stream.is_open()) {
+    return;
+  }
+
+  // Define the strings first, they are not part of the command record.
+  std::size_t const fileId = this->Intern(file);
+  std::size_t const commandId = this->Intern(command);
+  std::size_t const deferIdPlusOne = deferId ? this->Intern(*deferId) + 1 : 0;
+
+  auto const microseconds = static_cast<long long>(time * 1e6);
+
+  this->Buffer += CommandTag;
+  cmBinaryIO::WriteVarNumber(this->Buffer, fileId);
+  cmBinaryIO::WriteVarSignedNumber(this->Buffer, line);
+  cmBinaryIO::WriteVarSignedNumber(this->Buffer, lineEnd - line);
+  cmBinaryIO::WriteVarNumber(this->Buffer, deferIdPlusOne);
+  cmBinaryIO::WriteVarNumber(this->Buffer, commandId);
+  cmBinaryIO::WriteVarSignedNumber(this->Buffer,
+                                   microseconds - this->LastTime);
+  cmBinaryIO::WriteVarNumber(this->Buffer, frame);
+  cmBinaryIO::WriteVarNumber(this->Buffer, globalFrame);
+  cmBinaryIO::WriteVarNumber(this->Buffer, args.size());
+  for (std::string const& arg : args) {
+    cmBinaryIO::WriteVarString(this->Buffer, arg);
+  }
+  this->LastTime = microseconds;
+
+  if (this->Buffer.size() >= BufferSize) {
+    this->Flush();
+  }
+}
+
+void cmBinaryTrace::Flush()
+{
+  if (this->Stream.is_open() && !this->Buffer.empty()) {
+    this->Stream.write(this->Buffer.data(),
+                       static_cast<std::streamsize>(this->Buffer.size()));
+    this->Stream.flush();
+  }
+  this->Buffer.clear();
+}
+
+bool cmBinaryTrace::Decode(std::string const& path, std::ostream& os,
+                           std::string& error)
+{
+  std::string data;
+  if (!cmBinaryIO::ReadFile(path, data)) {
+    error = "cannot read file";
+    return false;
+  }
+
+  cmBinaryIO::Reader reader(data);
+  if (!reader.ReadMagic(Magic)) {
+    error = "not a binary trace";
+    return false;
+  }
+  unsigned long long version;
+  if (!reader.ReadVarNumber(version) || version != FormatVersion) {
+    error = "unsupported binary trace version";
+    return false;
+  }
+
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+
+  Json::Value versionValue;
+  versionValue["version"]["major"] = JsonMajorVersion;
+  versionValue["version"]["minor"] = JsonMinorVersion;
+  writer->write(versionValue, &os);
+  os << '\n';
+
+  std::vector<std::string> strings;
+  long long microseconds = 0;
+  char tag;
+  while (reader.ReadByte(tag)) {
+    if (tag == StringTag) {
+      std::string str;
+      if (!reader.ReadVarString(str)) {
+        error = "truncated binary trace";
+        return false;
+      }
+      strings.push_back(std::move(str));
+      continue;
+    }
+    if (tag != CommandTag) {
+      error = "corrupt binary trace";
+      return false;
+    }
+
+    unsigned long long fileId;
+    long long line;
+    long long lineDelta;
+    unsigned long long deferIdPlusOne;
+    unsigned long long commandId;
+    long long timeDelta;
+    unsigned long long frame;
+    unsigned long long globalFrame;
+    unsigned long long argc;
+    if (!reader.ReadVarNumber(fileId) || !reader.ReadVarSignedNumber(line) ||
+        !reader.ReadVarSignedNumber(lineDelta) ||
+        !reader.ReadVarNumber(deferIdPlusOne) ||
+        !reader.ReadVarNumber(commandId) ||
+        !reader.ReadVarSignedNumber(timeDelta) ||
+        !reader.ReadVarNumber(frame) || !reader.ReadVarNumber(globalFrame) ||
+        !reader.ReadVarNumber(argc)) {
+      error = "truncated binary trace";
+      return false;
+    }
+    if (fileId >= strings.size() || commandId >= strings.size() ||
+        deferIdPlusOne > strings.size()) {
+      error = "corrupt binary trace";
+      return false;
+    }
+    microseconds += timeDelta;
+
+    // Fill the fields as the json-v1 trace does.
+    Json::Value val;
+    val["file"] = strings[fileId];
+    val["line"] = static_cast<Json::Value::Int64>(line);
+    if (lineDelta != 0) {
+      val["line_end"] = static_cast<Json::Value::Int64>(line + lineDelta);
+    }
+    if (deferIdPlusOne != 0) {
+      val["defer"] = strings[deferIdPlusOne - 1];
+    }
+    val["cmd"] = strings[commandId];
+    val["args"] = Json::Value(Json::arrayValue);
+    std::string arg;
+    for (unsigned long long i = 0; i < argc; ++i) {
+      if (!reader.ReadVarString(arg)) {
+        error = "truncated binary trace";
+        return false;
+      }
+      val["args"].append(arg);
+    }
+    val["time"] = static_cast<double>(microseconds) / 1e6;
+    val["frame"] = static_cast<Json::Value::UInt64>(frame);
+    val["global_frame"] = static_cast<Json::Value::UInt64>(globalFrame);
+    writer->write(val, &os);
+    os << '\n';
+  }
+  return true;
+}
@@ -0,0 +1,62 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cm/optional>
+
+#include "cmsys/FStream.hxx"
+
+/** \class cmBinaryTrace
+ * \brief Write and decode the binary-v1 format of --trace.
+ *
+ * The trace holds the same data as the json-v1 format but is much cheaper
+ * to write.  File paths, command names and deferred call ids are written
+ * once and then referred to by their index, numbers are written as
+ * variable-length integers, and the time of each command is the number of
+ * microseconds since the previous one.  Records are buffered and written
+ * in large blocks.  A trace is converted to json-v1 by Decode.
+ */
+class cmBinaryTrace
+{
+public:
+  cmBinaryTrace() = default;
+  ~cmBinaryTrace();
+  cmBinaryTrace(cmBinaryTrace const&) = delete;
+  cmBinaryTrace& operator=(cmBinaryTrace const&) = delete;
+
+  /** Start a trace in the given file.  Returns false if it cannot be
+      written.  */
+  bool Open(std::string const& path);
+
+  /** Record a command executed, with the fields of a json-v1 record.  */
+  void WriteCommand(std::string const& file, long line, long lineEnd,
+                    cm::optional<std::string> const& deferId,
+                    std::string const& command,
+                    std::vector<std::string> const& args, double time,
+                    unsigned long long frame, unsigned long long globalFrame);
+
+  /**
+   * Convert a binary trace to the json-v1 format.  Returns false and sets
+   * the error if the trace cannot be read.  The records decoded before
+   * the error are written.
+   */
+  static bool Decode(std::string const& path, std::ostream& os,
+                     std::string& error);
+
+private:
+  std::size_t Intern(std::string const& str);
+  void Flush();
+
+  cmsys::ofstream Stream;
+  std::string Buffer;
+  std::unordered_map<std::string, std::size_t> StringIds;
+  long long LastTime = 0;
+};
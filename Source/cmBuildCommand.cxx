@@ -8,7 +8,6 @@
 #include "cmMessageType.h"
 #include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
-#include "cmSystemTools.h"
 #include "cmValue.h"
 
 namespace {
@@ -70,14 +69,14 @@ bool MainSignature(std::vector<std::string> const& args,
   // so we put this code here to end up with the same default configuration
   // as the original 2-arg build_command signature:
   //
+  cmMakefile& mf = status.GetMakefile();
   if (configuration.empty()) {
-    cmSystemTools::GetEnv("CMAKE_CONFIG_TYPE", configuration);
+    mf.GetEnvironmentValue("CMAKE_CONFIG_TYPE", configuration);
   }
   if (configuration.empty()) {
     configuration = "Release";
   }
 
-  cmMakefile& mf = status.GetMakefile();
   if (!project_name.empty()) {
     mf.IssueMessage(MessageType::AUTHOR_WARNING,
                     "Ignoring PROJECT_NAME option because it has no effect.");
@@ -105,7 +104,7 @@ bool TwoArgsSignature(std::vector<std::string> const& args,
   cmValue cacheValue = mf.GetDefinition(define);
 
   std::string configType;
-  if (!cmSystemTools::GetEnv("CMAKE_CONFIG_TYPE", configType) ||
+  if (!mf.GetEnvironmentValue("CMAKE_CONFIG_TYPE", configType) ||
       configType.empty()) {
     configType = "Release";
   }
@@ -563,6 +563,8 @@ bool cmCMakeHostSystemInformationCommand(std::vector<std::string> const& args,
     status.SetError("missing RESULT specification.");
     return false;
   }
+  status.GetMakefile().MarkConfigureVolatile(
+    "cmake_host_system_information()");
 
   auto const& variable = args[current_index + 1];
   current_index += 2;
@@ -64,7 +64,7 @@ const char* cmCommandArgumentParserHelper::ExpandSpecialVariable(
   }
   if (strcmp(key, "ENV") == 0) {
     std::string str;
-    if (cmSystemTools::GetEnv(var, str)) {
+    if (this->Makefile->GetEnvironmentValue(var, str)) {
       if (this->EscapeQuotes) {
         return this->AddString(cmEscapeQuotes(str));
       }
@@ -7,6 +7,8 @@
 #include <utility>
 
 #include "cmComputeLinkInformation.h"
+#include "cmFileSet.h"
+#include "cmGeneratorExpression.h"
 #include "cmGeneratorTarget.h"
 #include "cmGlobalCommonGenerator.h"
 #include "cmGlobalGenerator.h"
@@ -106,6 +108,73 @@ void cmCommonTargetGenerator::AppendFortranPreprocessFlags(
   }
 }
 
+cmCommonTargetGenerator::CompileSignature const&
+cmCommonTargetGenerator::GetCompileSignature(std::string const& l,
+                                             std::string const& config)
+{
+  auto& signatures = this->Configs[config].SignatureByLanguage;
+  auto i = signatures.find(l);
+  if (i == signatures.end()) {
+    CompileSignature signature;
+    this->GeneratorTarget->GetAppleArchs(config, signature.Architectures);
+    if (signature.Architectures.empty()) {
+      signature.Architectures.emplace_back();
+    }
+    for (std::string const& arch : signature.Architectures) {
+      std::string const pchSource =
+        this->GeneratorTarget->GetPchSource(config, l, arch);
+      if (!pchSource.empty()) {
+        signature.PchSources.emplace(pchSource, arch);
+      }
+    }
+    i = signatures.emplace(l, std::move(signature)).first;
+  }
+  return i->second;
+}
+
+std::map<std::string, std::string> const&
+cmCommonTargetGenerator::GetFileSetTypes(std::string const& config)
+{
+  ByConfig& byConfig = this->Configs[config];
+  if (byConfig.FileSetTypesComputed) {
+    return byConfig.FileSetTypes;
+  }
+  byConfig.FileSetTypesComputed = true;
+
+  auto const* tgt = this->GeneratorTarget->Target;
+  for (auto const& name : tgt->GetAllFileSetNames()) {
+    auto const* file_set = tgt->GetFileSet(name);
+    if (!file_set) {
+      this->Makefile->IssueMessage(
+        MessageType::INTERNAL_ERROR,
+        cmStrCat("Target \"", tgt->GetName(),
+                 "\" is tracked to have file set \"", name,
+                 "\", but it was not found."));
+      continue;
+    }
+
+    auto fileEntries = file_set->CompileFileEntries();
+    auto directoryEntries = file_set->CompileDirectoryEntries();
+    auto directories = file_set->EvaluateDirectoryEntries(
+      directoryEntries, this->GeneratorTarget->LocalGenerator, config,
+      this->GeneratorTarget);
+
+    std::map<std::string, std::vector<std::string>> files;
+    for (auto const& entry : fileEntries) {
+      file_set->EvaluateFileEntry(directories, files, entry,
+                                  this->GeneratorTarget->LocalGenerator,
+                                  config, this->GeneratorTarget);
+    }
+
+    for (auto const& it : files) {
+      for (auto const& filename : it.second) {
+        byConfig.FileSetTypes[filename] = file_set->GetType();
+      }
+    }
+  }
+  return byConfig.FileSetTypes;
+}
+
 std::string cmCommonTargetGenerator::GetFlags(const std::string& l,
                                               const std::string& config,
                                               const std::string& arch)
@@ -7,6 +7,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cmValue.h"
@@ -57,6 +58,21 @@ protected:
   void AppendOSXVerFlag(std::string& flags, const std::string& lang,
                         const char* name, bool so);
 
+  /** Compile settings shared by all sources of a language in a config.  */
+  struct CompileSignature
+  {
+    // The Apple architectures, or a single empty one.
+    std::vector<std::string> Architectures;
+    // Map from each source creating a precompiled header to its arch.
+    std::unordered_map<std::string, std::string> PchSources;
+  };
+  CompileSignature const& GetCompileSignature(std::string const& l,
+                                              std::string const& config);
+
+  /** Map from each source of a file set to the type of the file set.  */
+  std::map<std::string, std::string> const& GetFileSetTypes(
+    std::string const& config);
+
   std::string GetFlags(const std::string& l, const std::string& config,
                        const std::string& arch = std::string());
   std::string GetDefines(const std::string& l, const std::string& config);
@@ -80,6 +96,9 @@ private:
     ByLanguageMap FlagsByLanguage;
     ByLanguageMap DefinesByLanguage;
     ByLanguageMap IncludesByLanguage;
+    std::map<std::string, CompileSignature> SignatureByLanguage;
+    std::map<std::string, std::string> FileSetTypes;
+    bool FileSetTypesComputed = false;
   };
   std::map<std::string, ByConfig> Configs;
 };
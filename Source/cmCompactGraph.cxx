@@ -0,0 +1,48 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmCompactGraph.h"
+
+#include <algorithm>
+
+cmCompactGraph::cmCompactGraph(cmGraphAdjacencyList const& graph)
+{
+  std::size_t edges = 0;
+  for (cmGraphEdgeList const& el : graph) {
+    edges += el.size();
+  }
+  this->Offsets.reserve(graph.size() + 1);
+  this->Destinations.reserve(edges);
+  for (cmGraphEdgeList const& el : graph) {
+    this->AddNode();
+    for (cmGraphEdge const& edge : el) {
+      this->AddEdge(edge);
+    }
+  }
+}
+
+int cmCompactGraph::AddNode()
+{
+  this->Offsets.push_back(this->Destinations.size());
+  return this->GetNumberOfNodes() - 1;
+}
+
+void cmCompactGraph::AddEdge(int dest)
+{
+  this->Destinations.push_back(dest);
+  ++this->Offsets.back();
+}
+
+cmCompactGraphWalk::cmCompactGraphWalk(cmCompactGraph const& graph)
+  : Graph(graph)
+  , Marks(static_cast<std::size_t>(graph.GetNumberOfNodes()), 0)
+{
+}
+
+void cmCompactGraphWalk::Reset()
+{
+  // Start over with cleared marks once the walk numbers run out.
+  if (++this->WalkId == 0) {
+    std::fill(this->Marks.begin(), this->Marks.end(), 0);
+    this->WalkId = 1;
+  }
+}
@@ -0,0 +1,149 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "cmGraphAdjacencyList.h"
+
+/** \class cmCompactGraph
+ * \brief Directed graph of int nodes stored in compressed sparse rows.
+ *
+ * The edges of all nodes are stored in a single array, ordered by their
+ * source node, so walking the graph touches contiguous memory.  Edges are
+ * numbered by their position in that array, which lets callers keep data
+ * about each edge in a parallel array.  The graph is built once, adding
+ * the nodes in index order, and not modified afterwards.
+ */
+class cmCompactGraph
+{
+public:
+  cmCompactGraph() = default;
+
+  /** Build a compact copy of an adjacency list.  */
+  explicit cmCompactGraph(cmGraphAdjacencyList const& graph);
+
+  /** Add a node whose edges are added next.  Returns its index.  */
+  int AddNode();
+
+  /** Add an edge from the last node added to the given node.  */
+  void AddEdge(int dest);
+
+  int GetNumberOfNodes() const
+  {
+    return static_cast<int>(this->Offsets.size()) - 1;
+  }
+
+  std::size_t GetNumberOfEdges() const { return this->Destinations.size(); }
+
+  /** Get the range of numbers of the edges leaving a node.  */
+  std::size_t GetFirstEdge(int n) const { return this->Offsets[n]; }
+  std::size_t GetEndEdge(int n) const { return this->Offsets[n + 1]; }
+
+  /** Get the node an edge leads to.  */
+  int GetDestination(std::size_t e) const { return this->Destinations[e]; }
+
+private:
+  std::vector<std::size_t> Offsets = { 0 };
+  std::vector<int> Destinations;
+};
+
+/** \class cmCompactGraphWalk
+ * \brief Depth-first walks over a cmCompactGraph.
+ *
+ * Nodes are visited at most once until the walk is reset.  Visited nodes
+ * are marked with the number of the current walk, so resetting takes
+ * constant time however large the graph.  Walks use an explicit stack and
+ * do not recurse, so long chains of dependencies cannot exhaust the
+ * program stack.
+ */
+class cmCompactGraphWalk
+{
+public:
+  cmCompactGraphWalk(cmCompactGraph const& graph);
+
+  /** Forget the nodes visited so far.  */
+  void Reset();
+
+  /** Mark a node visited.  Returns false if it was visited already.  */
+  bool Visit(int n)
+  {
+    if (this->Marks[n] == this->WalkId) {
+      return false;
+    }
+    this->Marks[n] = this->WalkId;
+    return true;
+  }
+
+  /**
+   * Visit the nodes reachable from the root, the root included, that
+   * were not visited yet.  The function is called with each of them in
+   * depth-first preorder.
+   */
+  template <typename F>
+  void VisitNodes(int root, F f)
+  {
+    if (!this->Visit(root)) {
+      return;
+    }
+    f(root);
+    this->Walk(root, [this, &f](std::size_t e) {
+      int const dest = this->Graph.GetDestination(e);
+      if (!this->Visit(dest)) {
+        return false;
+      }
+      f(dest);
+      return true;
+    });
+  }
+
+  /**
+   * Visit the nodes reachable from the root that were not visited yet,
+   * marking the root visited.  The function is called with each edge
+   * leaving a newly visited node, depth first: the edges of a node
+   * reached through an edge come right after that edge.
+   */
+  template <typename F>
+  void VisitEdges(int root, F f)
+  {
+    if (!this->Visit(root)) {
+      return;
+    }
+    this->Walk(root, [this, &f](std::size_t e) {
+      f(e);
+      return this->Visit(this->Graph.GetDestination(e));
+    });
+  }
+
+private:
+  // Follow edges depth first from a visited node.  The function tells
+  // whether to descend into the destination of each edge.
+  template <typename F>
+  void Walk(int root, F descend)
+  {
+    this->Stack.emplace_back(this->Graph.GetFirstEdge(root),
+                             this->Graph.GetEndEdge(root));
+    while (!this->Stack.empty()) {
+      auto& top = this->Stack.back();
+      if (top.first == top.second) {
+        this->Stack.pop_back();
+        continue;
+      }
+      std::size_t const e = top.first++;
+      if (descend(e)) {
+        int const dest = this->Graph.GetDestination(e);
+        this->Stack.emplace_back(this->Graph.GetFirstEdge(dest),
+                                 this->Graph.GetEndEdge(dest));
+      }
+    }
+  }
+
+  cmCompactGraph const& Graph;
+  std::vector<unsigned int> Marks;
+  unsigned int WalkId = 1;
+  std::vector<std::pair<std::size_t, std::size_t>> Stack;
+};
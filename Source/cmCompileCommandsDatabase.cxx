@@ -0,0 +1,328 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmCompileCommandsDatabase.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <ios>
+#include <utility>
+
+#include <cm/string_view>
+#include <cmext/string_view>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmBinaryIO.h"
+#include "cmGeneratedFileStream.h"
+#include "cmStringAlgorithms.h"
+
+namespace {
+// Bump this whenever the layout of the database changes.
+std::uint64_t const FormatVersion = 1;
+cm::string_view const Magic = "CMCCDB\0\n"_s;
+
+// The header holds the magic, the version and the sizes of the tables.
+std::size_t const HeaderSize = 8 + 5 * 8;
+std::size_t const RecordSize = 5 * 4;
+
+// Reader of the tables of a database file.  Only the parts needed to
+// answer a query are read: the header, the index entries visited by the
+// binary search, and the records and strings they refer to.
+class DatabaseView
+{
+public:
+  bool Load(std::string const& path, std::string& error)
+  {
+    this->File.open(path.c_str(), std::ios::in | std::ios::binary);
+    if (!this->File) {
+      error = cmStrCat("cannot read ", path);
+      return false;
+    }
+    this->File.seekg(0, std::ios::end);
+    std::streamoff const fileSize = this->File.tellg();
+    char header[HeaderSize];
+    if (fileSize < static_cast<std::streamoff>(HeaderSize) ||
+        !this->Read(0, HeaderSize, header) ||
+        cm::string_view(header, Magic.size()) != Magic) {
+      error = "not a compile commands database";
+      return false;
+    }
+    char const* numbers = header + Magic.size();
+    if (cmBinaryIO::DecodeNumber(numbers, 8) != FormatVersion) {
+      error = "unsupported compile commands database version";
+      return false;
+    }
+    std::uint64_t const stringCount = cmBinaryIO::DecodeNumber(numbers + 8, 8);
+    std::uint64_t const entryCount = cmBinaryIO::DecodeNumber(numbers + 16, 8);
+    std::uint64_t const wordCount = cmBinaryIO::DecodeNumber(numbers + 24, 8);
+    std::uint64_t const stringDataSize =
+      cmBinaryIO::DecodeNumber(numbers + 32, 8);
+
+    // Check the sizes before computing offsets that could overflow.
+    std::uint64_t const limit = static_cast<std::uint64_t>(fileSize);
+    if (stringCount >= limit || entryCount >= limit || wordCount >= limit ||
+        stringDataSize > limit) {
+      error = "truncated compile commands database";
+      return false;
+    }
+    std::uint64_t const size = HeaderSize + (stringCount + 1) * 8 +
+      entryCount * RecordSize + wordCount * 4 + entryCount * 4 +
+      stringDataSize;
+    if (size != limit) {
+      error = "truncated compile commands database";
+      return false;
+    }
+
+    this->StringCount = stringCount;
+    this->EntryCount = entryCount;
+    this->WordCount = wordCount;
+    this->StringDataSize = stringDataSize;
+    this->StringOffsets = HeaderSize;
+    this->Records = this->StringOffsets + (stringCount + 1) * 8;
+    this->Words = this->Records + entryCount * RecordSize;
+    this->Index = this->Words + wordCount * 4;
+    this->StringData = this->Index + entryCount * 4;
+    return true;
+  }
+
+  std::uint64_t GetEntryCount() const { return this->EntryCount; }
+
+  bool GetString(std::uint64_t id, std::string& str)
+  {
+    char offsets[16];
+    if (id >= this->StringCount ||
+        !this->Read(this->StringOffsets + id * 8, sizeof(offsets), offsets)) {
+      return false;
+    }
+    std::uint64_t const begin = cmBinaryIO::DecodeNumber(offsets, 8);
+    std::uint64_t const end = cmBinaryIO::DecodeNumber(offsets + 8, 8);
+    if (begin > end || end > this->StringDataSize) {
+      return false;
+    }
+    str.resize(static_cast<std::size_t>(end - begin));
+    return str.empty() ||
+      this->Read(this->StringData + begin, str.size(), &str[0]);
+  }
+
+  bool GetIndexedEntry(std::uint64_t i, std::uint64_t& entry)
+  {
+    return this->ReadNumber(this->Index + i * 4, entry);
+  }
+
+  bool GetFile(std::uint64_t entry, std::string& file)
+  {
+    std::uint64_t id;
+    return entry < this->EntryCount && this->RecordField(entry, 1, id) &&
+      this->GetString(id, file);
+  }
+
+  bool GetEntry(std::uint64_t entry, cmCompileCommandsDatabase::Entry& out,
+                std::string& error)
+  {
+    error = "corrupt compile commands database";
+    char record[RecordSize];
+    if (!this->Read(this->Records + entry * RecordSize, RecordSize, record)) {
+      return false;
+    }
+    std::uint64_t const firstWord = cmBinaryIO::DecodeNumber(record + 12, 4);
+    std::uint64_t const wordCount = cmBinaryIO::DecodeNumber(record + 16, 4);
+    if (!this->GetString(cmBinaryIO::DecodeNumber(record, 4),
+                         out.Directory) ||
+        !this->GetString(cmBinaryIO::DecodeNumber(record + 4, 4), out.File) ||
+        !this->GetString(cmBinaryIO::DecodeNumber(record + 8, 4),
+                         out.Output) ||
+        firstWord > this->WordCount ||
+        wordCount > this->WordCount - firstWord) {
+      return false;
+    }
+    std::string words(static_cast<std::size_t>(wordCount * 4), '\0');
+    if (!words.empty() &&
+        !this->Read(this->Words + firstWord * 4, words.size(), &words[0])) {
+      return false;
+    }
+    out.Command.clear();
+    std::string word;
+    for (std::size_t w = 0; w < words.size(); w += 4) {
+      if (!this->GetString(cmBinaryIO::DecodeNumber(&words[w], 4), word)) {
+        return false;
+      }
+      if (w != 0) {
+        out.Command += ' ';
+      }
+      out.Command += word;
+    }
+    error.clear();
+    return true;
+  }
+
+private:
+  bool Read(std::uint64_t pos, std::size_t size, char* data)
+  {
+    this->File.clear();
+    this->File.seekg(static_cast<std::streamoff>(pos));
+    this->File.read(data, static_cast<std::streamsize>(size));
+    return this->File.gcount() == static_cast<std::streamsize>(size);
+  }
+
+  bool ReadNumber(std::uint64_t pos, std::uint64_t& n)
+  {
+    char data[4];
+    if (!this->Read(pos, sizeof(data), data)) {
+      return false;
+    }
+    n = cmBinaryIO::DecodeNumber(data, 4);
+    return true;
+  }
+
+  bool RecordField(std::uint64_t entry, int field, std::uint64_t& value)
+  {
+    return this->ReadNumber(this->Records + entry * RecordSize + field * 4,
+                            value);
+  }
+
+  cmsys::ifstream File;
+  std::uint64_t StringCount = 0;
+  std::uint64_t EntryCount = 0;
+  std::uint64_t WordCount = 0;
+  std::uint64_t StringDataSize = 0;
+  std::uint64_t StringOffsets = 0;
+  std::uint64_t Records = 0;
+  std::uint64_t Words = 0;
+  std::uint64_t Index = 0;
+  std::uint64_t StringData = 0;
+};
+}
+
+std::uint32_t cmCompileCommandsDatabase::Intern(std::string const& str)
+{
+  auto ins = this->StringIds.emplace(
+    str, static_cast<std::uint32_t>(this->Strings.size()));
+  if (ins.second) {
+    this->Strings.push_back(&ins.first->first);
+  }
+  return ins.first->second;
+}
+
+void cmCompileCommandsDatabase::Add(std::string const& directory,
+                                    std::string const& command,
+                                    std::string const& file,
+                                    std::string const& output)
+{
+  Record record;
+  record.Directory = this->Intern(directory);
+  record.File = this->Intern(file);
+  record.Output = this->Intern(output);
+  record.FirstWord = static_cast<std::uint32_t>(this->Words.size());
+
+  // Splitting at every single space keeps the command exactly as it was.
+  std::string::size_type begin = 0;
+  for (;;) {
+    std::string::size_type const end = command.find(' ', begin);
+    this->Words.push_back(this->Intern(command.substr(begin, end - begin)));
+    if (end == std::string::npos) {
+      break;
+    }
+    begin = end + 1;
+  }
+  record.WordCount =
+    static_cast<std::uint32_t>(this->Words.size() - record.FirstWord);
+  this->Records.push_back(record);
+}
+
+bool cmCompileCommandsDatabase::Write(std::string const& path) const
+{
+  std::vector<std::uint32_t> index(this->Records.size());
+  for (std::size_t i = 0; i < index.size(); ++i) {
+    index[i] = static_cast<std::uint32_t>(i);
+  }
+  std::stable_sort(index.begin(), index.end(),
+                   [this](std::uint32_t l, std::uint32_t r) {
+                     return *this->Strings[this->Records[l].File] <
+                       *this->Strings[this->Records[r].File];
+                   });
+
+  std::uint64_t stringDataSize = 0;
+  for (std::string const* str : this->Strings) {
+    stringDataSize += str->size();
+  }
+
+  std::string out(Magic.data(), Magic.size());
+  cmBinaryIO::WriteNumber(out, FormatVersion, 8);
+  cmBinaryIO::WriteNumber(out, this->Strings.size(), 8);
+  cmBinaryIO::WriteNumber(out, this->Records.size(), 8);
+  cmBinaryIO::WriteNumber(out, this->Words.size(), 8);
+  cmBinaryIO::WriteNumber(out, stringDataSize, 8);
+  std::uint64_t offset = 0;
+  cmBinaryIO::WriteNumber(out, offset, 8);
+  for (std::string const* str : this->Strings) {
+    offset += str->size();
+    cmBinaryIO::WriteNumber(out, offset, 8);
+  }
+  for (Record const& record : this->Records) {
+    cmBinaryIO::WriteNumber(out, record.Directory, 4);
+    cmBinaryIO::WriteNumber(out, record.File, 4);
+    cmBinaryIO::WriteNumber(out, record.Output, 4);
+    cmBinaryIO::WriteNumber(out, record.FirstWord, 4);
+    cmBinaryIO::WriteNumber(out, record.WordCount, 4);
+  }
+  for (std::uint32_t word : this->Words) {
+    cmBinaryIO::WriteNumber(out, word, 4);
+  }
+  for (std::uint32_t entry : index) {
+    cmBinaryIO::WriteNumber(out, entry, 4);
+  }
+  for (std::string const* str : this->Strings) {
+    out += *str;
+  }
+
+  cmGeneratedFileStream fout;
+  fout.Open(path, false, true);
+  fout.SetCopyIfDifferent(true);
+  fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+  return fout.Close();
+}
+
+bool cmCompileCommandsDatabase::Query(std::string const& path,
+                                      std::string const& file,
+                                      std::vector<Entry>& entries,
+                                      std::string& error)
+{
+  DatabaseView view;
+  if (!view.Load(path, error)) {
+    return false;
+  }
+
+  // Find the first indexed entry whose source is not before the file.
+  std::uint64_t lo = 0;
+  std::uint64_t hi = view.GetEntryCount();
+  std::uint64_t entry;
+  std::string entryFile;
+  while (lo < hi) {
+    std::uint64_t const mid = lo + (hi - lo) / 2;
+    if (!view.GetIndexedEntry(mid, entry) || !view.GetFile(entry, entryFile)) {
+      error = "corrupt compile commands database";
+      return false;
+    }
+    if (entryFile < file) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  for (; lo < view.GetEntryCount(); ++lo) {
+    if (!view.GetIndexedEntry(lo, entry) || !view.GetFile(entry, entryFile)) {
+      error = "corrupt compile commands database";
+      return false;
+    }
+    if (entryFile != file) {
+      break;
+    }
+    Entry result;
+    if (!view.GetEntry(entry, result, error)) {
+      return false;
+    }
+    entries.push_back(std::move(result));
+  }
+  return true;
+}
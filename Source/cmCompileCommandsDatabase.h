@@ -0,0 +1,72 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** \class cmCompileCommandsDatabase
+ * \brief Write and query the compact form of compile_commands.json.
+ *
+ * The compile commands of a project mostly differ by the source and object
+ * file names.  The compact database splits each command at its spaces and
+ * stores every distinct word and path once, in a string table.  An entry
+ * refers to its directory, source, output and command words by their
+ * index in the table.  The fixed-size little-endian tables are laid out
+ * so that the file can be memory-mapped, and are followed by an index of
+ * the entries sorted by source path, so that the commands of a single
+ * source are found without reading the whole database.
+ */
+class cmCompileCommandsDatabase
+{
+public:
+  struct Entry
+  {
+    std::string Directory;
+    std::string Command;
+    std::string File;
+    std::string Output;
+  };
+
+  cmCompileCommandsDatabase() = default;
+  cmCompileCommandsDatabase(cmCompileCommandsDatabase const&) = delete;
+  cmCompileCommandsDatabase& operator=(cmCompileCommandsDatabase const&) =
+    delete;
+
+  /** Add the entry of a compile command.  */
+  void Add(std::string const& directory, std::string const& command,
+           std::string const& file, std::string const& output);
+
+  /** Write the database to the given file, if its content changed.  */
+  bool Write(std::string const& path) const;
+
+  /**
+   * Find the entries of the given source file in a database file.  Only
+   * the header, the index entries visited to find them, and the entries
+   * found are read from the file.
+   * Returns false and sets the error if the database cannot be read.
+   */
+  static bool Query(std::string const& path, std::string const& file,
+                    std::vector<Entry>& entries, std::string& error);
+
+private:
+  struct Record
+  {
+    std::uint32_t Directory;
+    std::uint32_t File;
+    std::uint32_t Output;
+    std::uint32_t FirstWord;
+    std::uint32_t WordCount;
+  };
+
+  std::uint32_t Intern(std::string const& str);
+
+  std::unordered_map<std::string, std::uint32_t> StringIds;
+  std::vector<std::string const*> Strings;
+  std::vector<Record> Records;
+  std::vector<std::uint32_t> Words;
+};
@@ -15,6 +15,7 @@
 #include "cmComputeLinkDepends.h"
 #include "cmGeneratorTarget.h"
 #include "cmGlobalGenerator.h"
+#include "cmLinkInterfaceMemo.h"
 #include "cmListFileCache.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
@@ -254,6 +255,7 @@ cmComputeLinkInformation::cmComputeLinkInformation(
   , CMakeInstance(this->GlobalGenerator->GetCMakeInstance())
   // The configuration being linked.
   , Config(config)
+  , LinkInterfaceMemo(&this->GlobalGenerator->GetLinkInterfaceMemo(config))
 {
   // Check whether to recognize OpenBSD-style library versioned names.
   this->OpenBSD = this->Makefile->GetState()->GetGlobalPropertyAsBool(
@@ -635,11 +637,12 @@ bool cmComputeLinkInformation::Compute()
     std::set<cmGeneratorTarget const*> const& wrongItems =
       cld.GetOldWrongConfigItems();
     for (cmGeneratorTarget const* tgt : wrongItems) {
-      cmStateEnums::ArtifactType artifact = tgt->HasImportLibrary(this->Config)
+      cmStateEnums::ArtifactType artifact =
+        this->LinkInterfaceMemo->HasImportLibrary(tgt)
         ? cmStateEnums::ImportLibraryArtifact
         : cmStateEnums::RuntimeBinaryArtifact;
       this->OldLinkDirItems.push_back(
-        tgt->GetFullPath(this->Config, artifact, true));
+        this->LinkInterfaceMemo->GetFullPath(tgt, artifact));
     }
   }
 
@@ -1112,7 +1115,8 @@ void cmComputeLinkInformation::AddItem(LinkEntry const& entry)
   // Compute the proper name to use to link this library.
   const std::string& config = this->Config;
   bool impexe = (tgt && tgt->IsExecutableWithExports());
-  if (impexe && !tgt->HasImportLibrary(config) && !this->LoaderFlag) {
+  if (impexe && !this->LinkInterfaceMemo->HasImportLibrary(tgt) &&
+      !this->LoaderFlag) {
     // Skip linking to executables on platforms with no import
     // libraries or loader flags.
     return;
@@ -1124,10 +1128,11 @@ void cmComputeLinkInformation::AddItem(LinkEntry const& entry)
       // This link item is an executable that may provide symbols
       // used by this target.  A special flag is needed on this
       // platform.  Add it now using a special feature.
-      cmStateEnums::ArtifactType artifact = tgt->HasImportLibrary(config)
+      cmStateEnums::ArtifactType artifact =
+        this->LinkInterfaceMemo->HasImportLibrary(tgt)
         ? cmStateEnums::ImportLibraryArtifact
         : cmStateEnums::RuntimeBinaryArtifact;
-      std::string exe = tgt->GetFullPath(config, artifact, true);
+      std::string exe = this->LinkInterfaceMemo->GetFullPath(tgt, artifact);
       this->Items.emplace_back(
         BT<std::string>(exe, item.Backtrace), ItemIsPath::Yes, tgt,
         this->FindLibraryFeature(entry.Feature == DEFAULT
@@ -1150,13 +1155,14 @@ void cmComputeLinkInformation::AddItem(LinkEntry const& entry)
       // Its object-files should already have been extracted for linking.
     } else {
       // Decide whether to use an import library.
-      cmStateEnums::ArtifactType artifact = tgt->HasImportLibrary(config)
+      cmStateEnums::ArtifactType artifact =
+        this->LinkInterfaceMemo->HasImportLibrary(tgt)
         ? cmStateEnums::ImportLibraryArtifact
         : cmStateEnums::RuntimeBinaryArtifact;
 
       // Pass the full path to the target file.
       BT<std::string> lib = BT<std::string>(
-        tgt->GetFullPath(config, artifact, true), item.Backtrace);
+        this->LinkInterfaceMemo->GetFullPath(tgt, artifact), item.Backtrace);
       if (tgt->Target->IsAIX() && cmHasLiteralSuffix(lib.Value, "-NOTFOUND") &&
           artifact == cmStateEnums::ImportLibraryArtifact) {
         // This is an imported executable on AIX that has ENABLE_EXPORTS
@@ -1256,7 +1262,8 @@ void cmComputeLinkInformation::AddSharedDepItem(LinkEntry const& entry)
   // linked will be able to find it.
   std::string lib;
   if (tgt) {
-    cmStateEnums::ArtifactType artifact = tgt->HasImportLibrary(this->Config)
+    cmStateEnums::ArtifactType artifact =
+      this->LinkInterfaceMemo->HasImportLibrary(tgt)
       ? cmStateEnums::ImportLibraryArtifact
       : cmStateEnums::RuntimeBinaryArtifact;
     lib = tgt->GetFullPath(this->Config, artifact);
@@ -1279,7 +1286,7 @@ void cmComputeLinkInformation::AddSharedDepItem(LinkEntry const& entry)
   }
   if (order) {
     if (tgt) {
-      std::string soName = tgt->GetSOName(this->Config);
+      std::string const& soName = this->LinkInterfaceMemo->GetSOName(tgt);
       const char* soname = soName.empty() ? nullptr : soName.c_str();
       order->AddRuntimeLibrary(lib, soname);
     } else {
@@ -2208,7 +2215,7 @@ void cmComputeLinkInformation::AddLibraryRuntimeInfo(
 
   // Try to get the soname of the library.  Only files with this name
   // could possibly conflict.
-  std::string soName = target->GetSOName(this->Config);
+  std::string const& soName = this->LinkInterfaceMemo->GetSOName(target);
   const char* soname = soName.empty() ? nullptr : soName.c_str();
 
   // Include this library in the runtime path ordering.
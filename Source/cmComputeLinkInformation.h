@@ -20,6 +20,7 @@
 
 class cmGeneratorTarget;
 class cmGlobalGenerator;
+class cmLinkInterfaceMemo;
 class cmMakefile;
 class cmOrderDirectories;
 class cmake;
@@ -144,6 +145,9 @@ private:
   std::string const Config;
   std::string LinkLanguage;
 
+  // Link information about dependees shared with other targets.
+  cmLinkInterfaceMemo* const LinkInterfaceMemo;
+
   // Modes for dealing with dependent shared libraries.
   enum SharedDepMode
   {
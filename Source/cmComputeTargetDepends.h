@@ -41,6 +41,12 @@ public:
   void GetTargetDirectDepends(cmGeneratorTarget const* t,
                               cmTargetDependSet& deps);
 
+  /** Get the final dependencies of the targets, by index in GetTargets.  */
+  cmGraphAdjacencyList const& GetFinalGraph() const
+  {
+    return this->FinalGraph;
+  }
+
 private:
   struct TargetSideEffects
   {
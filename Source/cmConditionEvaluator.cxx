@@ -564,18 +564,24 @@ bool cmConditionEvaluator::HandleLevel1(cmArgumentList& newArgs, std::string&,
 
     // does a file exist
     if (this->IsKeyword(keyEXISTS, *args.current)) {
-      newArgs.ReduceOneArg(cmSystemTools::FileExists(args.next->GetValue()),
-                           args);
+      const auto& path = args.next->GetValue();
+      const auto result = cmSystemTools::FileExists(path);
+      this->Makefile.RecordPathQuery(keyEXISTS, path, result);
+      newArgs.ReduceOneArg(result, args);
     }
     // does a directory with this name exist
     else if (this->IsKeyword(keyIS_DIRECTORY, *args.current)) {
-      newArgs.ReduceOneArg(
-        cmSystemTools::FileIsDirectory(args.next->GetValue()), args);
+      const auto& path = args.next->GetValue();
+      const auto result = cmSystemTools::FileIsDirectory(path);
+      this->Makefile.RecordPathQuery(keyIS_DIRECTORY, path, result);
+      newArgs.ReduceOneArg(result, args);
     }
     // does a symlink with this name exist
     else if (this->IsKeyword(keyIS_SYMLINK, *args.current)) {
-      newArgs.ReduceOneArg(cmSystemTools::FileIsSymlink(args.next->GetValue()),
-                           args);
+      const auto& path = args.next->GetValue();
+      const auto result = cmSystemTools::FileIsSymlink(path);
+      this->Makefile.RecordPathQuery(keyIS_SYMLINK, path, result);
+      newArgs.ReduceOneArg(result, args);
     }
     // is the given path an absolute path ?
     else if (this->IsKeyword(keyIS_ABSOLUTE, *args.current)) {
@@ -609,7 +615,8 @@ bool cmConditionEvaluator::HandleLevel1(cmArgumentList& newArgs, std::string&,
       auto result = false;
       if (looksLikeSpecialVariable(var, "ENV"_s, varNameLen)) {
         const auto env = args.next->GetValue().substr(4, varNameLen - 5);
-        result = cmSystemTools::HasEnv(env);
+        std::string value;
+        result = this->Makefile.GetEnvironmentValue(env, value);
       }
 
       else if (looksLikeSpecialVariable(var, "CACHE"_s, varNameLen)) {
@@ -748,6 +755,7 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList& newArgs,
 
     // is file A newer than file B
     else if (this->IsKeyword(keyIS_NEWER_THAN, *args.next)) {
+      this->Makefile.MarkConfigureVolatile("if(IS_NEWER_THAN)");
       auto fileIsNewer = 0;
       cmsys::Status ftcStatus = cmSystemTools::FileTimeCompare(
         args.current->GetValue(), args.nextnext->GetValue(), &fileIsNewer);
@@ -0,0 +1,394 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmConfigureInputs.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include <cmext/string_view>
+
+#include <cm3p/json/reader.h>
+#include <cm3p/json/value.h>
+#include <cm3p/json/writer.h>
+
+#include "cmsys/FStream.hxx"
+#include "cmsys/Glob.hxx"
+
+#include "cmCryptoHash.h"
+#include "cmFileTime.h"
+#include "cmGeneratedFileStream.h"
+#include "cmGlobalGenerator.h"
+#include "cmMakefile.h"
+#include "cmState.h"
+#include "cmStateTypes.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmValue.h"
+#include "cmVersion.h"
+#include "cmake.h"
+
+namespace {
+// Bump this whenever the layout of the record changes.
+int const FormatVersion = 2;
+
+Json::Value StatFile(std::string const& path)
+{
+  Json::Value file = Json::objectValue;
+  file["path"] = path;
+  cmFileTime mtime;
+  if (mtime.Load(path)) {
+    file["mtime"] = static_cast<Json::Int64>(mtime.GetTime());
+    // Store both as signed numbers, which is what the reader produces.
+    file["size"] = static_cast<Json::Int64>(cmSystemTools::FileLength(path));
+  }
+  return file;
+}
+
+// Stat a list file and also record a hash of its content.
+Json::Value StatListFile(std::string const& path)
+{
+  Json::Value file = StatFile(path);
+  if (file.isMember("mtime")) {
+    file["sha256"] = cmCryptoHash(cmCryptoHash::AlgoSHA256).HashFile(path);
+  }
+  return file;
+}
+
+class FileStatCache
+{
+public:
+  // Return whether a file recorded by StatFile or StatListFile is
+  // unchanged.
+  bool Matches(Json::Value const& file)
+  {
+    std::string const path = file["path"].asString();
+    auto i = this->Files.find(path);
+    if (i == this->Files.end()) {
+      i = this->Files.emplace(path, StatFile(path)).first;
+    }
+    Json::Value const& current = i->second;
+    if (current["mtime"] == file["mtime"] &&
+        current["size"] == file["size"]) {
+      return true;
+    }
+    // A list file that was touched, or rewritten with the same content as
+    // by a version control checkout, is unchanged.  This is what makes the
+    // build tool run CMake again after such a file is saved.
+    if (!file.isMember("sha256") || !current.isMember("size") ||
+        current["size"] != file["size"]) {
+      return false;
+    }
+    auto h = this->Hashes.find(path);
+    if (h == this->Hashes.end()) {
+      h = this->Hashes
+            .emplace(path,
+                     cmCryptoHash(cmCryptoHash::AlgoSHA256).HashFile(path))
+            .first;
+    }
+    return h->second == file["sha256"].asString();
+  }
+
+private:
+  std::unordered_map<std::string, Json::Value> Files;
+  std::unordered_map<std::string, std::string> Hashes;
+};
+
+// List the files of the file-based API, whose replies are written by the
+// generate step for the queries present.
+Json::Value StatFileAPI(std::string const& binaryDir)
+{
+  Json::Value files = Json::arrayValue;
+  std::string const api = cmStrCat(binaryDir, "/.cmake/api/v1");
+  if (!cmSystemTools::FileIsDirectory(api)) {
+    return files;
+  }
+  cmsys::Glob glob;
+  glob.RecurseOn();
+  glob.SetListDirs(true);
+  glob.FindFiles(cmStrCat(api, "/*"));
+  std::vector<std::string> paths = glob.GetFiles();
+  std::sort(paths.begin(), paths.end());
+  for (std::string const& path : paths) {
+    files.append(StatFile(path));
+  }
+  return files;
+}
+}
+
+cmConfigureInputs::cmConfigureInputs(std::string const& binaryDir)
+  : BinaryDir(binaryDir)
+  , RecordFile(ComputeRecordFile(binaryDir))
+{
+}
+
+cmConfigureInputs::~cmConfigureInputs()
+{
+  if (this->Recording) {
+    cmGeneratedFileStreamBase::SetCloseCallback(nullptr);
+  }
+}
+
+std::string cmConfigureInputs::ComputeRecordFile(std::string const& binaryDir)
+{
+  return cmStrCat(binaryDir, "/CMakeFiles/ConfigureInputs.json");
+}
+
+std::string cmConfigureInputs::ComputeCacheDigest(cmState* state)
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  auto append = [&hasher](cm::string_view s) {
+    // Separate the fields with a character that cannot appear in them.
+    hasher.Append(s);
+    hasher.Append(cm::string_view("\0", 1));
+  };
+  for (std::string const& key : state->GetCacheEntryKeys()) {
+    append(key);
+    append(cmState::CacheEntryTypeToString(state->GetCacheEntryType(key)));
+    append(*state->GetCacheEntryValue(key));
+    for (std::string const& prop : state->GetCacheEntryPropertyList(key)) {
+      append(prop);
+      append(*state->GetCacheEntryProperty(key, prop));
+    }
+  }
+  return hasher.FinalizeHex();
+}
+
+bool cmConfigureInputs::Load(Json::Value& record) const
+{
+  cmsys::ifstream fin(this->RecordFile.c_str(), std::ios::in);
+  Json::CharReaderBuilder builder;
+  std::string errors;
+  return fin && Json::parseFromStream(builder, fin, &record, &errors) &&
+    record.isObject();
+}
+
+bool cmConfigureInputs::IsUpToDate(std::string const& cacheDigest,
+                                   std::vector<std::string>& changes) const
+{
+  Json::Value record;
+  if (!this->Load(record)) {
+    changes.emplace_back("no inputs were recorded by a previous run");
+    return false;
+  }
+  if (record["version"] != FormatVersion ||
+      record["cmake"]["version"] != cmVersion::GetCMakeVersion() ||
+      record["cmake"]["command"] != cmSystemTools::GetCMakeCommand()) {
+    changes.emplace_back("the inputs were recorded by another CMake");
+    return false;
+  }
+  if (record["cache"] != cacheDigest) {
+    changes.emplace_back("the cache changed");
+    return false;
+  }
+
+  FileStatCache stats;
+  for (Json::Value const& dir : record["directories"]) {
+    std::string const source = dir["source"].asString();
+    if (dir.isMember("volatile")) {
+      changes.emplace_back(cmStrCat(source, ": ran ",
+                                    dir["volatile"].asString()));
+      continue;
+    }
+    cm::optional<std::string> change;
+    for (Json::Value const& file : dir["files"]) {
+      if (!stats.Matches(file)) {
+        change = cmStrCat(file["path"].asString(), " changed");
+        break;
+      }
+    }
+    if (!change) {
+      Json::Value const& env = dir["environment"];
+      for (auto i = env.begin(); i != env.end(); ++i) {
+        std::string value;
+        bool const defined = cmSystemTools::GetEnv(i.name(), value);
+        if (defined != i->isString() || (defined && value != i->asString())) {
+          change = cmStrCat("environment variable ", i.name(), " changed");
+          break;
+        }
+      }
+    }
+    if (!change) {
+      for (Json::Value const& query : dir["paths"]) {
+        std::string const path = query["path"].asString();
+        if (QueryPath(query["query"].asString(), path) !=
+            query["result"].asBool()) {
+          change = cmStrCat(query["query"].asString(), ' ', path, " changed");
+          break;
+        }
+      }
+    }
+    if (change) {
+      changes.emplace_back(cmStrCat(source, ": ", *change));
+    }
+  }
+
+  for (Json::Value const& output : record["outputs"]) {
+    std::string const path = output.asString();
+    if (!cmSystemTools::FileExists(path)) {
+      changes.emplace_back(cmStrCat(path, " is missing"));
+      break;
+    }
+  }
+
+  if (StatFileAPI(this->BinaryDir) != record["fileApi"]) {
+    changes.emplace_back("the file-based API queries or replies changed");
+  }
+
+  return changes.empty();
+}
+
+void cmConfigureInputs::TouchRegenerationOutputs() const
+{
+  Json::Value record;
+  if (!this->Load(record)) {
+    return;
+  }
+  for (Json::Value const& output : record["regenerationOutputs"]) {
+    cmSystemTools::Touch(output.asString(), false);
+  }
+}
+
+void cmConfigureInputs::StartRecording()
+{
+  cmSystemTools::RemoveFile(this->RecordFile);
+  this->Directories.clear();
+  this->Outputs.clear();
+  this->Recording = true;
+  cmGeneratedFileStreamBase::SetCloseCallback(
+    [this](std::string const& path) { this->RecordOutput(path); });
+}
+
+void cmConfigureInputs::RecordEnvironment(cmMakefile const* mf,
+                                          std::string const& name,
+                                          cm::optional<std::string> value)
+{
+  if (this->Recording) {
+    this->Directories[mf].Environment.emplace(name, std::move(value));
+  }
+}
+
+void cmConfigureInputs::RecordPathQuery(cmMakefile const* mf,
+                                        cm::string_view query,
+                                        std::string const& path, bool result)
+{
+  if (this->Recording) {
+    this->Directories[mf].PathQueries.emplace(
+      std::make_pair(std::string(query), path), result);
+  }
+}
+
+void cmConfigureInputs::MarkVolatile(cmMakefile const* mf,
+                                     cm::string_view reason)
+{
+  if (this->Recording) {
+    DirectoryInputs& dir = this->Directories[mf];
+    if (dir.Volatile.empty()) {
+      dir.Volatile = std::string(reason);
+    }
+  }
+}
+
+void cmConfigureInputs::RecordOutput(std::string const& path)
+{
+  std::lock_guard<std::mutex> lock(this->OutputsMutex);
+  if (this->Recording) {
+    this->Outputs.insert(path);
+  }
+}
+
+bool cmConfigureInputs::Save(cmGlobalGenerator const* gg)
+{
+  Json::Value record = Json::objectValue;
+  record["version"] = FormatVersion;
+  record["cmake"]["version"] = cmVersion::GetCMakeVersion();
+  record["cmake"]["command"] = cmSystemTools::GetCMakeCommand();
+  record["cache"] =
+    ComputeCacheDigest(gg->GetCMakeInstance()->GetState());
+
+  Json::Value& dirs = record["directories"] = Json::arrayValue;
+  for (auto const& mf : gg->GetMakefiles()) {
+    Json::Value dir = Json::objectValue;
+    dir["source"] = mf->GetCurrentSourceDirectory();
+    dir["binary"] = mf->GetCurrentBinaryDirectory();
+
+    auto i = this->Directories.find(mf.get());
+    if (i != this->Directories.end() && !i->second.Volatile.empty()) {
+      dir["volatile"] = i->second.Volatile;
+    }
+
+    std::set<std::string> paths(mf->GetListFiles().begin(),
+                                mf->GetListFiles().end());
+    if (cmValue depends = mf->GetProperty("CMAKE_CONFIGURE_DEPENDS")) {
+      for (std::string const& depend : cmExpandedList(*depends)) {
+        paths.insert(cmSystemTools::CollapseFullPath(
+          depend, mf->GetCurrentSourceDirectory()));
+      }
+    }
+    Json::Value& files = dir["files"] = Json::arrayValue;
+    for (std::string const& path : paths) {
+      files.append(StatListFile(path));
+    }
+
+    Json::Value& env = dir["environment"] = Json::objectValue;
+    Json::Value& queries = dir["paths"] = Json::arrayValue;
+    if (i != this->Directories.end()) {
+      for (auto const& var : i->second.Environment) {
+        env[var.first] = var.second ? Json::Value(*var.second) : Json::Value();
+      }
+      for (auto const& query : i->second.PathQueries) {
+        Json::Value& q = queries.append(Json::objectValue);
+        q["query"] = query.first.first;
+        q["path"] = query.first.second;
+        q["result"] = query.second;
+      }
+    }
+    dirs.append(std::move(dir));
+  }
+
+  // Files written by try_compile projects are gone by now.
+  Json::Value& outputs = record["outputs"] = Json::arrayValue;
+  {
+    cmGeneratedFileStreamBase::SetCloseCallback(nullptr);
+    std::lock_guard<std::mutex> lock(this->OutputsMutex);
+    this->Recording = false;
+    for (std::string const& output : this->Outputs) {
+      if (output != this->RecordFile && cmSystemTools::FileExists(output)) {
+        outputs.append(output);
+      }
+    }
+  }
+
+  record["fileApi"] = StatFileAPI(this->BinaryDir);
+
+  Json::Value& regeneration = record["regenerationOutputs"] =
+    Json::arrayValue;
+  for (std::string const& output : gg->GetRegenerationOutputs()) {
+    regeneration.append(output);
+  }
+
+  cmGeneratedFileStream fout(this->RecordFile);
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+  std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+  writer->write(record, &fout);
+  fout << '\n';
+  return fout.Close();
+}
+
+bool cmConfigureInputs::QueryPath(cm::string_view query,
+                                  std::string const& path)
+{
+  if (query == "EXISTS"_s) {
+    return cmSystemTools::FileExists(path);
+  }
+  if (query == "IS_DIRECTORY"_s) {
+    return cmSystemTools::FileIsDirectory(path);
+  }
+  if (query == "IS_SYMLINK"_s) {
+    return cmSystemTools::FileIsSymlink(path);
+  }
+  return false;
+}
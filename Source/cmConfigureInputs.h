@@ -0,0 +1,122 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cm/optional>
+#include <cm/string_view>
+
+class cmGlobalGenerator;
+namespace Json {
+class Value;
+}
+class cmMakefile;
+class cmState;
+
+/** \class cmConfigureInputs
+ * \brief Record what each directory read while configuring.
+ *
+ * For every directory configured by a run, the record lists the list files
+ * it read, the environment variables it looked up, and the results of the
+ * file system queries made by its if() conditions and when it searched for
+ * list files to include, including those not found.  It also holds a digest
+ * of the cache saved by the run and the files written by it.  A later run
+ * that starts from the same cache, and for which every directory's inputs
+ * are unchanged, would reproduce the build system that is already on disk,
+ * so it may skip the configure and generate steps.
+ *
+ * Some commands, such as execute_process() or file(GLOB), read inputs that
+ * are not recorded.  They mark their directory as volatile, and a volatile
+ * directory is never considered unchanged.
+ */
+class cmConfigureInputs
+{
+public:
+  /** Use the record in the given top-level build directory.  */
+  explicit cmConfigureInputs(std::string const& binaryDir);
+  ~cmConfigureInputs();
+
+  cmConfigureInputs(cmConfigureInputs const&) = delete;
+  cmConfigureInputs& operator=(cmConfigureInputs const&) = delete;
+
+  std::string const& GetRecordFile() const { return this->RecordFile; }
+
+  /** Return the path of the record in the given top-level build
+      directory.  */
+  static std::string ComputeRecordFile(std::string const& binaryDir);
+
+  /** Compute a digest of all cache entries, their types and properties.  */
+  static std::string ComputeCacheDigest(cmState* state);
+
+  /**
+   * Compare the record written by a previous run against the current state.
+   * Returns true if the build system would not change.  Otherwise the
+   * reasons, one for each changed directory or other input, are appended
+   * to the given vector.
+   */
+  bool IsUpToDate(std::string const& cacheDigest,
+                  std::vector<std::string>& changes) const;
+
+  /**
+   * Touch the files the build tool compares against the inputs of the run
+   * that wrote the record, so that it considers the build system it kept
+   * up to date and does not run CMake again.
+   */
+  void TouchRegenerationOutputs() const;
+
+  /**
+   * Remove the previous record and start recording the inputs of a run.
+   * Files written through cmGeneratedFileStream are recorded as outputs
+   * until the record is saved.
+   */
+  void StartRecording();
+
+  /** Record an environment variable looked up by a directory.  */
+  void RecordEnvironment(cmMakefile const* mf, std::string const& name,
+                         cm::optional<std::string> value);
+
+  /** Record the result of a file system query made by a directory.  */
+  void RecordPathQuery(cmMakefile const* mf, cm::string_view query,
+                       std::string const& path, bool result);
+
+  /** Mark a directory as depending on inputs that are not recorded.  */
+  void MarkVolatile(cmMakefile const* mf, cm::string_view reason);
+
+  /** Record a file written by the run.  Thread-safe.  */
+  void RecordOutput(std::string const& path);
+
+  /**
+   * Write the record for the directories of the given global generator and
+   * the cache it saved, after a successful generate step.
+   */
+  bool Save(cmGlobalGenerator const* gg);
+
+  /** Evaluate a file system query, named like the if() operator.  */
+  static bool QueryPath(cm::string_view query, std::string const& path);
+
+private:
+  bool Load(Json::Value& record) const;
+
+  struct DirectoryInputs
+  {
+    std::string Volatile;
+    std::map<std::string, cm::optional<std::string>> Environment;
+    std::map<std::pair<std::string, std::string>, bool> PathQueries;
+  };
+
+  std::string BinaryDir;
+  std::string RecordFile;
+  bool Recording = false;
+  std::unordered_map<cmMakefile const*, DirectoryInputs> Directories;
+  std::mutex OutputsMutex;
+  std::set<std::string> Outputs;
+};
@@ -3,78 +3,236 @@
 #include "cmDefinitions.h"
 
 #include <cassert>
-#include <functional>
 #include <unordered_set>
 #include <utility>
 
-#include <cm/string_view>
+#include <cm/optional>
 
 cmDefinitions::Def cmDefinitions::NoDef;
 
-cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
-                                                     StackIter begin,
-                                                     StackIter end, bool raise)
+std::size_t cmDefinitions::HashKey(cmAtom key)
 {
-  assert(begin != end);
-  {
-    auto it = begin->Map.find(cm::String::borrow(key));
-    if (it != begin->Map.end()) {
-      return it->second;
+  std::size_t const hash = key.GetHash();
+  // Reserve zero for empty table slots.
+  return hash != 0 ? hash : 1;
+}
+
+cmDefinitions::Def const* cmDefinitions::DefTable::Find(cmAtom key) const
+{
+  if (this->Slots.empty()) {
+    return nullptr;
+  }
+  std::size_t const hash = HashKey(key);
+  std::size_t const mask = this->Slots.size() - 1;
+  for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+    Slot const& slot = this->Slots[i];
+    if (slot.Hash == 0) {
+      return nullptr;
     }
+    if (slot.Key == key) {
+      return &slot.Value;
+    }
+  }
+}
+
+cmDefinitions::Def& cmDefinitions::DefTable::Emplace(cmAtom key)
+{
+  // Keep the load factor at or below 3/4 so probe sequences stay short.
+  if ((this->Count + 1) * 4 > this->Slots.size() * 3) {
+    this->Grow();
   }
-  StackIter it = begin;
-  ++it;
-  if (it == end) {
-    return cmDefinitions::NoDef;
+  std::size_t const hash = HashKey(key);
+  std::size_t const mask = this->Slots.size() - 1;
+  for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+    Slot& slot = this->Slots[i];
+    if (slot.Hash == 0) {
+      slot.Hash = hash;
+      slot.Key = key;
+      ++this->Count;
+      return slot.Value;
+    }
+    if (slot.Key == key) {
+      return slot.Value;
+    }
   }
-  Def const& def = cmDefinitions::GetInternal(key, it, end, raise);
-  if (!raise) {
+}
+
+template <typename Callback>
+void cmDefinitions::DefTable::ForEach(Callback const& callback) const
+{
+  for (Slot const& slot : this->Slots) {
+    if (slot.Hash != 0) {
+      callback(slot.Key, slot.Value);
+    }
+  }
+}
+
+void cmDefinitions::DefTable::Grow()
+{
+  std::vector<Slot> old;
+  old.swap(this->Slots);
+  this->Slots.resize(old.empty() ? 8 : old.size() * 2);
+  std::size_t const mask = this->Slots.size() - 1;
+  for (Slot& slot : old) {
+    if (slot.Hash == 0) {
+      continue;
+    }
+    std::size_t i = slot.Hash & mask;
+    while (this->Slots[i].Hash != 0) {
+      i = (i + 1) & mask;
+    }
+    this->Slots[i] = std::move(slot);
+  }
+}
+
+cmDefinitions::Def const* cmDefinitions::Find(cmAtom key) const
+{
+  if (Def const* def = this->Map.Find(key)) {
     return def;
   }
-  return begin->Map.emplace(key, def).first->second;
+  for (Layer const* layer = this->Base.get(); layer;
+       layer = layer->Next.get()) {
+    if (Def const* def = layer->Map.Find(key)) {
+      return def;
+    }
+  }
+  return nullptr;
+}
+
+cmDefinitions::Def const& cmDefinitions::GetInternal(cmAtom key,
+                                                     StackIter begin,
+                                                     StackIter end)
+{
+  for (StackIter it = begin; it != end; ++it) {
+    if (Def const* def = it->Find(key)) {
+      return *def;
+    }
+  }
+  return cmDefinitions::NoDef;
 }
 
 cmValue cmDefinitions::Get(const std::string& key, StackIter begin,
                            StackIter end)
 {
-  Def const& def = cmDefinitions::GetInternal(key, begin, end, false);
+  cm::optional<cmAtom> atom = cmAtom::Find(key);
+  if (!atom) {
+    return nullptr;
+  }
+  Def const& def = cmDefinitions::GetInternal(*atom, begin, end);
   return def.Value ? cmValue(def.Value.str_if_stable()) : nullptr;
 }
 
 void cmDefinitions::Raise(const std::string& key, StackIter begin,
                           StackIter end)
 {
-  cmDefinitions::GetInternal(key, begin, end, true);
+  assert(begin != end);
+  cmAtom const atom(key);
+  if (begin->Map.Find(atom)) {
+    return;
+  }
+  // Only this scope needs its own copy before the parent changes.  The
+  // scopes between it and the definition keep looking it up.
+  Def const def = cmDefinitions::GetInternal(atom, begin, end);
+  begin->Map.Emplace(atom) = def;
+  begin->Frozen = false;
 }
 
 bool cmDefinitions::HasKey(const std::string& key, StackIter begin,
                            StackIter end)
 {
+  cm::optional<cmAtom> atom = cmAtom::Find(key);
+  if (!atom) {
+    return false;
+  }
   for (StackIter it = begin; it != end; ++it) {
-    if (it->Map.find(cm::String::borrow(key)) != it->Map.end()) {
+    if (it->Map.Find(*atom)) {
       return true;
     }
+    // A closure knows only the keys that were defined when it was taken.
+    for (Layer const* layer = it->Base.get(); layer;
+         layer = layer->Next.get()) {
+      if (Def const* def = layer->Map.Find(*atom)) {
+        if (def->Value) {
+          return true;
+        }
+        break;
+      }
+    }
   }
   return false;
 }
 
+std::shared_ptr<cmDefinitions::Layer const> cmDefinitions::PushLayer(
+  DefTable map, std::shared_ptr<Layer const> next)
+{
+  auto layer = std::make_shared<Layer>();
+  layer->Map = std::move(map);
+  if (next && next->Depth < MaxLayerDepth) {
+    layer->Depth = next->Depth + 1;
+    layer->Next = std::move(next);
+  } else {
+    // Flatten the chain below the new table into it.
+    for (Layer const* l = next.get(); l; l = l->Next.get()) {
+      l->Map.ForEach([&layer](cmAtom key, Def const& def) {
+        if (!layer->Map.Find(key)) {
+          layer->Map.Emplace(key) = def;
+        }
+      });
+    }
+  }
+  return layer;
+}
+
+std::shared_ptr<cmDefinitions::Layer const> const& cmDefinitions::Freeze()
+{
+  if (this->Frozen || this->Map.Size() == 0) {
+    return this->Base;
+  }
+  // Keep unset keys in the local table too.  They still count as known
+  // keys of this scope, but not of the closures sharing the layer.
+  DefTable unset;
+  this->Map.ForEach([&unset](cmAtom key, Def const& def) {
+    if (!def.Value) {
+      unset.Emplace(key);
+    }
+  });
+  this->Base = PushLayer(std::move(this->Map), std::move(this->Base));
+  this->Map = std::move(unset);
+  this->Frozen = true;
+  return this->Base;
+}
+
 cmDefinitions cmDefinitions::MakeClosure(StackIter begin, StackIter end)
 {
-  cmDefinitions closure;
-  std::unordered_set<cm::string_view> undefined;
+  assert(begin != end);
+  std::vector<StackIter> scopes;
   for (StackIter it = begin; it != end; ++it) {
-    // Consider local definitions.
-    for (auto const& mi : it->Map) {
-      // Use this key if it is not already set or unset.
-      if (closure.Map.find(mi.first) == closure.Map.end() &&
-          undefined.find(mi.first.view()) == undefined.end()) {
-        if (mi.second.Value) {
-          closure.Map.insert(mi);
-        } else {
-          undefined.emplace(mi.first.view());
+    scopes.push_back(it);
+  }
+
+  // Share the definitions of the outermost scope, which is the top scope
+  // of the directory.  Any function scopes in between are usually small
+  // and are copied into one more layer on top of it.
+  cmDefinitions closure;
+  closure.Base = scopes.back()->Freeze();
+  scopes.pop_back();
+  if (!scopes.empty()) {
+    DefTable map;
+    for (StackIter const& it : scopes) {
+      auto add = [&map](cmAtom key, Def const& def) {
+        if (!map.Find(key)) {
+          map.Emplace(key) = def;
         }
+      };
+      it->Map.ForEach(add);
+      for (Layer const* layer = it->Base.get(); layer;
+           layer = layer->Next.get()) {
+        layer->Map.ForEach(add);
       }
     }
+    if (map.Size() != 0) {
+      closure.Base = PushLayer(std::move(map), std::move(closure.Base));
+    }
   }
   return closure;
 }
@@ -83,15 +241,20 @@ std::vector<std::string> cmDefinitions::ClosureKeys(StackIter begin,
                                                     StackIter end)
 {
   std::vector<std::string> defined;
-  std::unordered_set<cm::string_view> bound;
+  std::unordered_set<cmAtom, cmAtom::Hash> bound;
+  auto add = [&defined, &bound](cmAtom key, Def const& def) {
+    // Use this key if it is not already set or unset.
+    if (bound.emplace(key).second && def.Value) {
+      defined.push_back(key.GetString());
+    }
+  };
 
   for (StackIter it = begin; it != end; ++it) {
-    defined.reserve(defined.size() + it->Map.size());
-    for (auto const& mi : it->Map) {
-      // Use this key if it is not already set or unset.
-      if (bound.emplace(mi.first.view()).second && mi.second.Value) {
-        defined.push_back(*mi.first.str_if_stable());
-      }
+    defined.reserve(defined.size() + it->Map.Size());
+    it->Map.ForEach(add);
+    for (Layer const* layer = it->Base.get(); layer;
+         layer = layer->Next.get()) {
+      layer->Map.ForEach(add);
     }
   }
 
@@ -100,10 +263,12 @@ std::vector<std::string> cmDefinitions::ClosureKeys(StackIter begin,
 
 void cmDefinitions::Set(const std::string& key, cm::string_view value)
 {
-  this->Map[key] = Def(value);
+  this->Map.Emplace(cmAtom(key)) = Def(value);
+  this->Frozen = false;
 }
 
 void cmDefinitions::Unset(const std::string& key)
 {
-  this->Map[key] = Def();
+  this->Map.Emplace(cmAtom(key)) = Def();
+  this->Frozen = false;
 }
@@ -4,13 +4,14 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
-#include <functional>
+#include <cstddef>
+#include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include <cm/string_view>
 
+#include "cmAtom.h"
 #include "cmLinkedTree.h"
 #include "cmString.hxx"
 #include "cmValue.h"
@@ -21,6 +22,17 @@
  * This stores the state of variable definitions (set or unset) for
  * one scope.  Sets are always local.  Gets search parent scopes
  * transitively and save results locally.
+ *
+ * Each scope keeps its definitions in a flat open-addressing table
+ * keyed by interned variable names, so probing compares pointers and
+ * the name is hashed at most once per lookup.  A name that was never
+ * interned cannot be defined in any scope.
+ *
+ * A new directory does not copy the definitions visible in its parent.
+ * The parent's local table is frozen into an immutable layer that both
+ * scopes share and look up through, and the parent continues with an
+ * empty local table.  Chains of layers are flattened once they grow
+ * deeper than a few levels to keep lookups short.
  */
 class cmDefinitions
 {
@@ -61,8 +73,63 @@ private:
   };
   static Def NoDef;
 
-  std::unordered_map<cm::String, Def> Map;
+  /** Open-addressing table of definitions with linear probing.
+      Keys are never removed; unsetting stores a null definition.  */
+  class DefTable
+  {
+  public:
+    Def const* Find(cmAtom key) const;
+
+    /** Find or insert the definition for a key.  */
+    Def& Emplace(cmAtom key);
+
+    template <typename Callback>
+    void ForEach(Callback const& callback) const;
+
+    std::size_t Size() const { return this->Count; }
+
+  private:
+    struct Slot
+    {
+      // A zero hash marks an empty slot.
+      std::size_t Hash = 0;
+      cmAtom Key;
+      Def Value;
+    };
+    std::vector<Slot> Slots;
+    std::size_t Count = 0;
+
+    void Grow();
+  };
+
+  /** Definitions of a directory scope frozen when a subdirectory took
+      its closure.  Layers are immutable and shared by the scope that
+      froze them and by every closure taken from it.  */
+  struct Layer
+  {
+    DefTable Map;
+    std::shared_ptr<Layer const> Next;
+    std::size_t Depth = 1;
+  };
+
+  DefTable Map;
+  std::shared_ptr<Layer const> Base;
+  // The local table holds nothing that is not already in Base.
+  bool Frozen = false;
+
+  static std::size_t HashKey(cmAtom key);
+
+  /** Find a definition in this scope, including its frozen layers.  */
+  Def const* Find(cmAtom key) const;
+
+  /** Layers are flattened beyond this depth.  */
+  static std::size_t const MaxLayerDepth = 8;
+
+  static Def const& GetInternal(cmAtom key, StackIter begin, StackIter end);
+
+  static std::shared_ptr<Layer const> PushLayer(
+    DefTable map, std::shared_ptr<Layer const> next);
 
-  static Def const& GetInternal(const std::string& key, StackIter begin,
-                                StackIter end, bool raise);
+  /** Move the local definitions into a new shared layer.  */
+  std::shared_ptr<Layer const> const& Freeze();
 };
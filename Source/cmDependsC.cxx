@@ -4,8 +4,13 @@
 
 #include <utility>
 
+#include <cm/memory>
+
 #include "cmsys/FStream.hxx"
 
+#ifndef CMAKE_BOOTSTRAP
+#  include "cmDependsCScanDatabase.h"
+#endif
 #include "cmFileTime.h"
 #include "cmGlobalUnixMakefileGenerator3.h"
 #include "cmLocalUnixMakefileGenerator3.h"
@@ -65,11 +70,27 @@ cmDependsC::cmDependsC(cmLocalUnixMakefileGenerator3* lg,
     cmStrCat(this->TargetDirectory, '/', lang, ".includecache");
 
   this->ReadCacheFile();
+
+#ifndef CMAKE_BOOTSTRAP
+  cmValue scanDatabase = mf->GetDefinition("CMAKE_DEPENDS_SCAN_DATABASE");
+  if (cmNonempty(scanDatabase)) {
+    this->ScanDatabase = cm::make_unique<cmDependsCScanDatabase>(
+      *scanDatabase,
+      cmStrCat(this->IncludeRegexLineString, '\n',
+               this->IncludeRegexScanString, '\n',
+               this->IncludeRegexTransformString));
+  }
+#endif
 }
 
 cmDependsC::~cmDependsC()
 {
   this->WriteCacheFile();
+#ifndef CMAKE_BOOTSTRAP
+  if (this->ScanDatabase) {
+    this->ScanDatabase->Save();
+  }
+#endif
 }
 
 bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
@@ -170,6 +191,11 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
 
         // Check whether this file is already in the cache
         auto fileIt = this->FileCache.find(fullName);
+#ifndef CMAKE_BOOTSTRAP
+        if (fileIt == this->FileCache.end()) {
+          fileIt = this->LookupScanDatabase(fullName);
+        }
+#endif
         if (fileIt != this->FileCache.end()) {
           fileIt->second.Used = true;
           dependencies.insert(fullName);
@@ -388,7 +414,43 @@ void cmDependsC::Scan(std::istream& is, const std::string& directory,
       }
     }
   }
+
+#ifndef CMAKE_BOOTSTRAP
+  if (this->ScanDatabase) {
+    std::vector<cmDependsCScanDatabase::Include> includes;
+    includes.reserve(newCacheEntry.UnscannedEntries.size());
+    for (UnscannedEntry const& inc : newCacheEntry.UnscannedEntries) {
+      includes.push_back({ inc.FileName, inc.QuotedLocation });
+    }
+    this->ScanDatabase->Store(fullName, std::move(includes));
+  }
+#endif
+}
+
+#ifndef CMAKE_BOOTSTRAP
+std::map<std::string, cmDependsC::cmIncludeLines>::iterator
+cmDependsC::LookupScanDatabase(std::string const& fullName)
+{
+  std::vector<cmDependsCScanDatabase::Include> includes;
+  if (!this->ScanDatabase ||
+      !this->ScanDatabase->Lookup(fullName, includes)) {
+    return this->FileCache.end();
+  }
+  if (this->Verbose) {
+    cmSystemTools::Stdout(cmStrCat("Reusing include directives of \"",
+                                   fullName, "\" from the scan database.\n"));
+  }
+  // Keep the entry in the cache of this target too.
+  cmIncludeLines& cacheEntry = this->FileCache[fullName];
+  for (cmDependsCScanDatabase::Include& inc : includes) {
+    UnscannedEntry entry;
+    entry.FileName = std::move(inc.FileName);
+    entry.QuotedLocation = std::move(inc.QuotedLocation);
+    cacheEntry.UnscannedEntries.push_back(std::move(entry));
+  }
+  return this->FileCache.find(fullName);
 }
+#endif
 
 void cmDependsC::SetupTransforms()
 {
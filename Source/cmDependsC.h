@@ -6,6 +6,7 @@
 
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
 #include <string>
@@ -15,6 +16,7 @@
 
 #include "cmDepends.h"
 
+class cmDependsCScanDatabase;
 class cmLocalUnixMakefileGenerator3;
 
 /** \class cmDependsC
@@ -91,4 +93,12 @@ protected:
 
   void WriteCacheFile() const;
   void ReadCacheFile();
+
+#ifndef CMAKE_BOOTSTRAP
+  // Include directives shared with the scanners of other targets.
+  std::unique_ptr<cmDependsCScanDatabase> ScanDatabase;
+
+  std::map<std::string, cmIncludeLines>::iterator LookupScanDatabase(
+    std::string const& fullName);
+#endif
 };
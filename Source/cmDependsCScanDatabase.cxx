@@ -0,0 +1,251 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmDependsCScanDatabase.h"
+
+#include <ios>
+#include <utility>
+
+#include <cmext/string_view>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmBinaryIO.h"
+#include "cmCryptoHash.h"
+#include "cmFileLock.h"
+#include "cmFileLockResult.h"
+#include "cmGeneratedFileStream.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmVersion.h"
+
+namespace {
+// Bump this whenever the layout of the database changes.
+unsigned long long const FormatVersion = 2;
+cm::string_view const Magic = "CMSCAN\n"_s;
+
+// Rewrite a shard once it holds this many times more records than entries.
+std::size_t const CompactionRatio = 4;
+
+// The number of leading hex digits of the path hash that name a shard.
+std::size_t const ShardDigits = 2;
+
+// How long to wait for another scanner to save its entries.
+unsigned long const LockTimeoutSec = 30;
+
+void WriteHeader(std::string& out)
+{
+  out.append(Magic.data(), Magic.size());
+  cmBinaryIO::WriteNumber(out, FormatVersion);
+  cmBinaryIO::WriteString(out, cmVersion::GetCMakeVersion());
+}
+
+void WriteRecord(std::string& out, std::string const& path, long long mtime,
+                 unsigned long long size,
+                 std::vector<cmDependsCScanDatabase::Include> const& includes)
+{
+  cmBinaryIO::WriteString(out, path);
+  cmBinaryIO::WriteNumber(out, static_cast<unsigned long long>(mtime));
+  cmBinaryIO::WriteNumber(out, size);
+  cmBinaryIO::WriteNumber(out, includes.size());
+  for (cmDependsCScanDatabase::Include const& inc : includes) {
+    cmBinaryIO::WriteString(out, inc.FileName);
+    cmBinaryIO::WriteString(out, inc.QuotedLocation);
+  }
+}
+}
+
+cmDependsCScanDatabase::cmDependsCScanDatabase(std::string const& directory,
+                                               std::string const& settings)
+{
+  // Scanners using different settings find different include directives.
+  cmCryptoHash hasher(cmCryptoHash::AlgoMD5);
+  this->DatabaseDirectory =
+    cmStrCat(directory, '/', hasher.HashString(settings));
+}
+
+cmDependsCScanDatabase::Shard& cmDependsCScanDatabase::GetShard(
+  std::string const& path)
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoMD5);
+  std::string const shardFile =
+    cmStrCat(this->DatabaseDirectory, '/',
+             hasher.HashString(path).substr(0, ShardDigits), ".db");
+  auto i = this->Shards.find(shardFile);
+  if (i == this->Shards.end()) {
+    i = this->Shards.emplace(shardFile, Shard()).first;
+    Shard& shard = i->second;
+    shard.LogValid = this->Read(shardFile, shard.Entries, shard.LogRecords);
+  }
+  return i->second;
+}
+
+bool cmDependsCScanDatabase::Read(std::string const& shardFile,
+                                  std::map<std::string, Entry>& entries,
+                                  std::size_t& records) const
+{
+  records = 0;
+  std::string data;
+  if (!cmBinaryIO::ReadFile(shardFile, data)) {
+    return false;
+  }
+  cmBinaryIO::Reader reader(data);
+  unsigned long long version;
+  std::string cmakeVersion;
+  if (!reader.ReadMagic(Magic) || !reader.ReadNumber(version) ||
+      version != FormatVersion || !reader.ReadString(cmakeVersion) ||
+      cmakeVersion != cmVersion::GetCMakeVersion()) {
+    return false;
+  }
+
+  // Later records replace earlier ones for the same file.  A truncated
+  // record is the end of an interrupted save, so keep what precedes it.
+  while (!reader.AtEnd()) {
+    std::string path;
+    unsigned long long mtime;
+    unsigned long long count;
+    Entry entry;
+    if (!reader.ReadString(path) || !reader.ReadNumber(mtime) ||
+        !reader.ReadNumber(entry.Size) || !reader.ReadNumber(count)) {
+      return false;
+    }
+    entry.MTime = static_cast<long long>(mtime);
+    for (unsigned long long i = 0; i < count; ++i) {
+      Include inc;
+      if (!reader.ReadString(inc.FileName) ||
+          !reader.ReadString(inc.QuotedLocation)) {
+        return false;
+      }
+      entry.Includes.push_back(std::move(inc));
+    }
+    entries[path] = std::move(entry);
+    ++records;
+  }
+  return true;
+}
+
+bool cmDependsCScanDatabase::Save()
+{
+  bool stored = false;
+  for (auto const& s : this->Shards) {
+    for (auto const& e : s.second.Entries) {
+      stored = stored || e.second.Stored;
+    }
+  }
+  if (!stored) {
+    return true;
+  }
+
+  // Serialize with the scanners of other targets.
+  std::string const lockFile = cmStrCat(this->DatabaseDirectory, "/lock");
+  if (!cmSystemTools::MakeDirectory(this->DatabaseDirectory) ||
+      !cmSystemTools::Touch(lockFile, true)) {
+    return false;
+  }
+  cmFileLock lock;
+  if (!lock.Lock(lockFile, LockTimeoutSec).IsOk()) {
+    return false;
+  }
+
+  bool okay = true;
+  for (auto& s : this->Shards) {
+    if (!this->SaveShard(s.first, s.second)) {
+      okay = false;
+    }
+  }
+  return okay;
+}
+
+bool cmDependsCScanDatabase::SaveShard(std::string const& shardFile,
+                                       Shard const& shard) const
+{
+  std::size_t stored = 0;
+  for (auto const& e : shard.Entries) {
+    if (e.second.Stored) {
+      ++stored;
+    }
+  }
+  if (stored == 0) {
+    return true;
+  }
+
+  // Rewrite the whole shard when it was unusable, has been removed since,
+  // or holds too many records replaced since.
+  if (!shard.LogValid || cmSystemTools::FileLength(shardFile) == 0 ||
+      shard.LogRecords + stored >
+        CompactionRatio * (shard.Entries.size() + 1)) {
+    return this->Compact(shardFile, shard);
+  }
+
+  std::string out;
+  for (auto const& e : shard.Entries) {
+    if (e.second.Stored) {
+      WriteRecord(out, e.first, e.second.MTime, e.second.Size,
+                  e.second.Includes);
+    }
+  }
+  cmsys::ofstream fout(shardFile.c_str(),
+                       std::ios::out | std::ios::app | std::ios::binary);
+  fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+  return static_cast<bool>(fout);
+}
+
+bool cmDependsCScanDatabase::Compact(std::string const& shardFile,
+                                     Shard const& shard) const
+{
+  // Keep the entries saved by other scanners since this one was loaded.
+  std::map<std::string, Entry> merged;
+  std::size_t records;
+  this->Read(shardFile, merged, records);
+  for (auto const& e : shard.Entries) {
+    if (e.second.Stored) {
+      merged[e.first] = e.second;
+    }
+  }
+
+  // Drop the entries of files that were removed or changed since.
+  std::string out;
+  WriteHeader(out);
+  for (auto const& e : merged) {
+    long long mtime;
+    unsigned long long size;
+    if (cmBinaryIO::StatFile(e.first, mtime, size) &&
+        mtime == e.second.MTime && size == e.second.Size) {
+      WriteRecord(out, e.first, mtime, size, e.second.Includes);
+    }
+  }
+  cmGeneratedFileStream fout;
+  fout.Open(shardFile, false, true);
+  fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+  return fout.Close();
+}
+
+bool cmDependsCScanDatabase::Lookup(std::string const& path,
+                                    std::vector<Include>& includes)
+{
+  Shard& shard = this->GetShard(path);
+  auto i = shard.Entries.find(path);
+  if (i == shard.Entries.end()) {
+    return false;
+  }
+  long long mtime;
+  unsigned long long size;
+  if (!cmBinaryIO::StatFile(path, mtime, size) ||
+      mtime != i->second.MTime || size != i->second.Size) {
+    shard.Entries.erase(i);
+    return false;
+  }
+  includes = i->second.Includes;
+  return true;
+}
+
+void cmDependsCScanDatabase::Store(std::string const& path,
+                                   std::vector<Include> includes)
+{
+  Entry entry;
+  if (!cmBinaryIO::StatFile(path, entry.MTime, entry.Size)) {
+    return;
+  }
+  entry.Includes = std::move(includes);
+  entry.Stored = true;
+  this->GetShard(path).Entries[path] = std::move(entry);
+}
@@ -0,0 +1,94 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+/** \class cmDependsCScanDatabase
+ * \brief Remember the include directives of headers across targets.
+ *
+ * The include directives found in a file by cmDependsC do not depend on
+ * the target being scanned, only on the regular expressions and include
+ * transforms used to find them.  The database records them for every
+ * scanned file, along with its size and modification time, so that the
+ * dependency scanning of any target of the build tree can reuse them
+ * instead of reading the file again.
+ *
+ * The database is split into shards by a hash of the file path.  A
+ * scanner reads a shard only when it first looks up a file in it, so the
+ * cost of a scan does not grow with the number of files scanned by all
+ * other targets.  Each shard is a log to which each scanner appends the
+ * entries it stored, while holding a lock so that concurrent scanners of
+ * other targets do not interleave their records.  Later records replace
+ * earlier ones for the same file.  Once a shard holds many more records
+ * than entries, it is rewritten with only the latest entry of each file
+ * that still exists unchanged.
+ */
+class cmDependsCScanDatabase
+{
+public:
+  struct Include
+  {
+    std::string FileName;
+    std::string QuotedLocation;
+  };
+
+  /** Use the database for the given scanner settings in a directory.  */
+  cmDependsCScanDatabase(std::string const& directory,
+                         std::string const& settings);
+
+  cmDependsCScanDatabase(cmDependsCScanDatabase const&) = delete;
+  cmDependsCScanDatabase& operator=(cmDependsCScanDatabase const&) = delete;
+
+  std::string const& GetDatabaseDirectory() const
+  {
+    return this->DatabaseDirectory;
+  }
+
+  /** Append the entries stored by this scanner to the database.  */
+  bool Save();
+
+  /**
+   * Get the include directives of the given file, if it did not change
+   * since they were recorded.  A missing or incompatible shard is silently
+   * treated as empty, and a truncated one as ending with the last complete
+   * record.
+   */
+  bool Lookup(std::string const& path, std::vector<Include>& includes);
+
+  /** Record the include directives just found in the given file.  */
+  void Store(std::string const& path, std::vector<Include> includes);
+
+private:
+  struct Entry
+  {
+    long long MTime = 0;
+    unsigned long long Size = 0;
+    std::vector<Include> Includes;
+    // Whether the entry was stored by this scanner.
+    bool Stored = false;
+  };
+
+  struct Shard
+  {
+    std::map<std::string, Entry> Entries;
+    bool LogValid = false;
+    std::size_t LogRecords = 0;
+  };
+
+  std::string DatabaseDirectory;
+  // The shards read so far, by file name.
+  std::map<std::string, Shard> Shards;
+
+  Shard& GetShard(std::string const& path);
+  bool Read(std::string const& shardFile,
+            std::map<std::string, Entry>& entries,
+            std::size_t& records) const;
+  bool SaveShard(std::string const& shardFile, Shard const& shard) const;
+  bool Compact(std::string const& shardFile, Shard const& shard) const;
+};
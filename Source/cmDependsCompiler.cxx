@@ -4,6 +4,8 @@
 #include "cmDependsCompiler.h"
 
 #include <algorithm>
+#include <cstddef>
+#include <ios>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -18,14 +20,35 @@
 
 #include "cmsys/FStream.hxx"
 
+#include "cmBinaryIO.h"
 #include "cmFileTime.h"
 #include "cmGccDepfileReader.h"
+#include "cmGeneratedFileStream.h"
 #include "cmGccDepfileReaderTypes.h"
 #include "cmGlobalUnixMakefileGenerator3.h"
 #include "cmLocalUnixMakefileGenerator3.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
+namespace {
+// Bump this whenever the layout of the dependency log changes.
+unsigned long long const FormatVersion = 1;
+cm::string_view const Magic = "CMDLOG\n"_s;
+
+// Rewrite the log once it holds this many times more records than entries.
+std::size_t const CompactionRatio = 4;
+
+void WriteRecord(std::string& out, std::string const& depender,
+                 std::vector<std::string> const& dependees)
+{
+  cmBinaryIO::WriteString(out, depender);
+  cmBinaryIO::WriteNumber(out, dependees.size());
+  for (std::string const& dependee : dependees) {
+    cmBinaryIO::WriteString(out, dependee);
+  }
+}
+}
+
 bool cmDependsCompiler::CheckDependencies(
   const std::string& internalDepFile, const std::vector<std::string>& depFiles,
   cmDepends::DependencyMap& dependencies,
@@ -35,42 +58,28 @@ bool cmDependsCompiler::CheckDependencies(
   bool forceReadDeps = true;
 
   cmFileTime internalDepFileTime;
-  // read cached dependencies stored in internal file
-  if (cmSystemTools::FileExists(internalDepFile)) {
-    internalDepFileTime.Load(internalDepFile);
-    forceReadDeps = false;
-
-    // read current dependencies
-    cmsys::ifstream fin(internalDepFile.c_str());
-    if (fin) {
-      std::string line;
-      std::string depender;
-      std::vector<std::string>* currentDependencies = nullptr;
-      while (std::getline(fin, line)) {
-        if (line.empty() || line.front() == '#') {
-          continue;
-        }
-        // Drop carriage return character at the end
-        if (line.back() == '\r') {
-          line.pop_back();
-          if (line.empty()) {
-            continue;
-          }
-        }
-        // Check if this a depender line
-        if (line.front() != ' ') {
-          depender = std::move(line);
-          currentDependencies = &dependencies[depender];
-          continue;
-        }
-        // This is a dependee line
-        if (currentDependencies != nullptr) {
-          currentDependencies->emplace_back(line.substr(1));
-        }
+  if (internalDepFileTime.Load(internalDepFile)) {
+    // Most of the time no dependencies file changed since the log was last
+    // updated.  Avoid reading the log at all in that case.
+    bool upToDate = true;
+    cmFileTime depFileTime;
+    for (std::size_t i = 3; i < depFiles.size(); i += 4) {
+      if (depFileTime.Load(depFiles[i]) &&
+          depFileTime.Compare(internalDepFileTime) >= 0) {
+        upToDate = false;
+        break;
       }
-      fin.close();
     }
+    if (upToDate) {
+      return true;
+    }
+
+    // read cached dependencies stored in the log
+    forceReadDeps = !this->ReadDependencyLog(internalDepFile, dependencies);
   }
+  this->LogValid = !forceReadDeps;
+  cmDepends::DependencyMap const previous =
+    forceReadDeps ? cmDepends::DependencyMap() : dependencies;
 
   // Now, update dependencies map with all new compiler generated
   // dependencies files
@@ -183,12 +192,94 @@ bool cmDependsCompiler::CheckDependencies(
     }
   }
 
+  // Remember which dependencies differ from those in the log.
+  this->ChangedDependers.clear();
+  for (auto const& node : dependencies) {
+    auto const i = previous.find(node.first);
+    if (!this->LogValid || i == previous.end() || i->second != node.second) {
+      this->ChangedDependers.push_back(node.first);
+    }
+  }
+
   return status;
 }
 
+bool cmDependsCompiler::ReadDependencyLog(
+  const std::string& internalDepFile, cmDepends::DependencyMap& dependencies)
+{
+  std::string data;
+  if (!cmBinaryIO::ReadFile(internalDepFile, data)) {
+    return false;
+  }
+  cmBinaryIO::Reader reader(data);
+  unsigned long long version;
+  if (!reader.ReadMagic(Magic) || !reader.ReadNumber(version) ||
+      version != FormatVersion) {
+    return false;
+  }
+
+  // Later records replace earlier ones for the same depender.  A truncated
+  // record means the log cannot be trusted at all.
+  this->LogRecords = 0;
+  while (!reader.AtEnd()) {
+    std::string depender;
+    unsigned long long count;
+    if (!reader.ReadString(depender) || !reader.ReadNumber(count)) {
+      dependencies.clear();
+      return false;
+    }
+    std::vector<std::string>& dependees = dependencies[depender];
+    dependees.clear();
+    for (unsigned long long i = 0; i < count; ++i) {
+      std::string dependee;
+      if (!reader.ReadString(dependee)) {
+        dependencies.clear();
+        return false;
+      }
+      dependees.push_back(std::move(dependee));
+    }
+    ++this->LogRecords;
+  }
+  return true;
+}
+
+bool cmDependsCompiler::WriteDependencyLog(
+  const std::string& internalDepFile,
+  const cmDepends::DependencyMap& dependencies)
+{
+  // Rewrite the whole log when it is missing or holds too many records
+  // replaced since.
+  if (!this->LogValid ||
+      this->LogRecords + this->ChangedDependers.size() >
+        CompactionRatio * (dependencies.size() + 1)) {
+    std::string out(Magic.data(), Magic.size());
+    cmBinaryIO::WriteNumber(out, FormatVersion);
+    for (auto const& node : dependencies) {
+      WriteRecord(out, node.first, node.second);
+    }
+    cmGeneratedFileStream fout;
+    fout.Open(internalDepFile, false, true);
+    fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return fout.Close();
+  }
+
+  // The log must be newer than the dependencies files just read.
+  if (this->ChangedDependers.empty()) {
+    return cmSystemTools::Touch(internalDepFile, false).IsSuccess();
+  }
+
+  std::string out;
+  for (std::string const& depender : this->ChangedDependers) {
+    WriteRecord(out, depender, dependencies.at(depender));
+  }
+  cmsys::ofstream fout(internalDepFile.c_str(),
+                       std::ios::out | std::ios::app | std::ios::binary);
+  fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+  return static_cast<bool>(fout);
+}
+
 void cmDependsCompiler::WriteDependencies(
-  const cmDepends::DependencyMap& dependencies, std::ostream& makeDepends,
-  std::ostream& internalDepends)
+  const cmDepends::DependencyMap& dependencies, std::ostream& makeDepends)
 {
   // dependencies file consumed by make tool
   const auto& lineContinue = static_cast<cmGlobalUnixMakefileGenerator3*>(
@@ -236,15 +327,6 @@ void cmDependsCompiler::WriteDependencies(
   for (const auto& target : phonyTargets) {
     makeDepends << std::endl << target << ':' << std::endl;
   }
-
-  // internal dependencies file
-  for (const auto& node : dependencies) {
-    internalDepends << node.first << std::endl;
-    for (const auto& dep : node.second) {
-      internalDepends << ' ' << dep << std::endl;
-    }
-    internalDepends << std::endl;
-  }
 }
 
 void cmDependsCompiler::ClearDependencies(
@@ -4,6 +4,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <functional>
 #include <iosfwd>
 #include <string>
@@ -39,22 +40,43 @@ public:
 
   /** Read dependencies for the target file. Return true if
       dependencies didn't changed and false if not.
-      Up-to-date Dependencies will be stored in deps. */
+      Up-to-date Dependencies will be stored in deps.
+      The dependencies are recorded in a binary log which is read only
+      when a dependencies file is newer than it. */
   bool CheckDependencies(
     const std::string& internalDepFile,
     const std::vector<std::string>& depFiles,
     cmDepends::DependencyMap& dependencies,
     const std::function<bool(const std::string&)>& isValidPath);
 
+  /** Return whether the dependencies checked last differ from those
+      recorded in the log, so that the make depends file is outdated.  */
+  bool HasChangedDependencies() const
+  {
+    return !this->LogValid || !this->ChangedDependers.empty();
+  }
+
   /** Write dependencies for the target file.  */
   void WriteDependencies(const cmDepends::DependencyMap& dependencies,
-                         std::ostream& makeDepends,
-                         std::ostream& internalDepends);
+                         std::ostream& makeDepends);
+
+  /** Record the dependencies checked last in the log.  Only those that
+      changed are appended, unless the log needs to be rewritten.  */
+  bool WriteDependencyLog(const std::string& internalDepFile,
+                          const cmDepends::DependencyMap& dependencies);
 
   /** Clear dependencies for the target so they will be regenerated.  */
   void ClearDependencies(const std::vector<std::string>& depFiles);
 
 private:
+  bool ReadDependencyLog(const std::string& internalDepFile,
+                         cmDepends::DependencyMap& dependencies);
+
   bool Verbose = false;
   cmLocalUnixMakefileGenerator3* LocalGenerator = nullptr;
+
+  // State of the log read by CheckDependencies.
+  bool LogValid = false;
+  std::size_t LogRecords = 0;
+  std::vector<std::string> ChangedDependers;
 };
@@ -7,6 +7,7 @@
 #include "cmsys/Process.h"
 
 #include "cmExecutionStatus.h"
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmProcessOutput.h"
 #include "cmStringAlgorithms.h"
@@ -28,6 +29,8 @@ bool cmExecProgramCommand(std::vector<std::string> const& args,
     status.SetError("called with incorrect number of arguments");
     return false;
   }
+  status.GetMakefile().MarkConfigureVolatile("exec_program()");
+  status.GetMakefile().GetGlobalGenerator()->InvalidateDirectoryContent();
   std::string arguments;
   bool doingargs = false;
   int count = 0;
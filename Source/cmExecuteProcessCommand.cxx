@@ -20,6 +20,7 @@
 
 #include "cmArgumentParser.h"
 #include "cmExecutionStatus.h"
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
 #include "cmProcessOutput.h"
@@ -46,6 +47,9 @@ bool cmExecuteProcessCommand(std::vector<std::string> const& args,
     status.SetError("called with incorrect number of arguments");
     return false;
   }
+  status.GetMakefile().MarkConfigureVolatile("execute_process()");
+  // The processes may write anywhere.
+  status.GetMakefile().GetGlobalGenerator()->InvalidateDirectoryContent();
 
   struct Arguments : public ArgumentParser::ParseResult
   {
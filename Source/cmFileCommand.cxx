@@ -3757,5 +3757,59 @@ bool cmFileCommand(std::vector<std::string> const& args,
     { "CHMOD_RECURSE"_s, HandleChmodRecurseCommand },
   };
 
+  // These read files, directories or the network without recording them
+  // as inputs of the configure step.
+  static std::set<std::string> const volatileSubcommands{
+    "ARCHIVE_EXTRACT", "COPY",         "COPY_FILE",
+    "DIFFERENT",       "DOWNLOAD",     "GET_RUNTIME_DEPENDENCIES",
+    "GLOB",            "GLOB_RECURSE", "MD5",
+    "READ",            "READ_ELF",     "READ_SYMLINK",
+    "REAL_PATH",       "SHA1",         "SHA224",
+    "SHA256",          "SHA384",       "SHA512",
+    "SHA3_224",        "SHA3_256",     "SHA3_384",
+    "SHA3_512",        "SIZE",         "STRINGS",
+    "TIMESTAMP",       "UPLOAD",
+  };
+  if (volatileSubcommands.count(args[0])) {
+    status.GetMakefile().MarkConfigureVolatile(
+      cmStrCat("file(", args[0], ')'));
+  }
+
+  // Keep the directory listings cached for find commands up to date.
+  // These do not change the content of any directory.
+  static std::set<std::string> const readOnlySubcommands{
+    "CHMOD",          "CHMOD_RECURSE",
+    "CHRPATH",        "DIFFERENT",
+    "GENERATE",       "GET_RUNTIME_DEPENDENCIES",
+    "GLOB",           "GLOB_RECURSE",
+    "MD5",            "READ",
+    "READ_ELF",       "READ_SYMLINK",
+    "REAL_PATH",      "RELATIVE_PATH",
+    "RPATH_CHANGE",   "RPATH_CHECK",
+    "RPATH_REMOVE",   "RPATH_SET",
+    "SHA1",           "SHA224",
+    "SHA256",         "SHA384",
+    "SHA512",         "SHA3_224",
+    "SHA3_256",       "SHA3_384",
+    "SHA3_512",       "SIZE",
+    "STRINGS",        "TIMESTAMP",
+    "TO_CMAKE_PATH",  "TO_NATIVE_PATH",
+    "UPLOAD",
+  };
+  cmMakefile& mf = status.GetMakefile();
+  cmGlobalGenerator* gg = mf.GetGlobalGenerator();
+  if (args[0] == "WRITE" || args[0] == "APPEND") {
+    gg->InvalidateDirectoryContent(cmSystemTools::CollapseFullPath(
+      args[1], mf.GetCurrentSourceDirectory()));
+  } else if (args[0] == "MAKE_DIRECTORY" || args[0] == "TOUCH" ||
+             args[0] == "TOUCH_NOCREATE") {
+    for (std::string const& arg : cmMakeRange(args).advance(1)) {
+      gg->InvalidateDirectoryContent(
+        cmSystemTools::CollapseFullPath(arg, mf.GetCurrentSourceDirectory()));
+    }
+  } else if (!readOnlySubcommands.count(args[0])) {
+    gg->InvalidateDirectoryContent();
+  }
+
   return subcommand(args[0], args, status);
 }
@@ -15,6 +15,7 @@
 
 #include "cmCMakePath.h"
 #include "cmExecutionStatus.h"
+#include "cmGlobalGenerator.h"
 #include "cmListFileCache.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
@@ -560,6 +561,13 @@ void cmFindBase::StoreFindResult(const std::string& value)
   bool updateNormalVariable =
     this->Makefile->GetPolicyStatus(cmPolicies::CMP0126) == cmPolicies::NEW;
 
+  // A result that is not cached is searched for again by the next run, so
+  // it depends on the files present.
+  if (value.empty() || !this->StoreResultInCache) {
+    this->Makefile->MarkConfigureVolatile(
+      cmStrCat(this->FindCommandName, "()"));
+  }
+
   if (!value.empty()) {
     if (this->StoreResultInCache) {
       this->Makefile->AddCacheDefinition(this->VariableName, value,
@@ -607,6 +615,13 @@ cmFindBaseDebugState::cmFindBaseDebugState(std::string commandName,
   : FindCommand(findBase)
   , CommandName(std::move(commandName))
 {
+  if (this->FindCommand->DebugMode) {
+    cmGlobalGenerator::DirectoryContentStatistics const& stats =
+      this->FindCommand->Makefile->GetGlobalGenerator()
+        ->GetDirectoryContentStatistics();
+    this->DirectoryContentHits = stats.Hits;
+    this->DirectoryContentMisses = stats.Misses;
+  }
 }
 
 cmFindBaseDebugState::~cmFindBaseDebugState()
@@ -668,6 +683,14 @@ cmFindBaseDebugState::~cmFindBaseDebugState()
       buffer += "The item was not found.\n";
     }
 
+    cmGlobalGenerator::DirectoryContentStatistics const& stats =
+      this->FindCommand->Makefile->GetGlobalGenerator()
+        ->GetDirectoryContentStatistics();
+    buffer += cmStrCat("The directory listing cache had ",
+                       stats.Hits - this->DirectoryContentHits, " hits and ",
+                       stats.Misses - this->DirectoryContentMisses,
+                       " misses.\n");
+
     this->FindCommand->DebugMessage(buffer);
   }
 }
@@ -4,6 +4,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <string>
 #include <utility>
 #include <vector>
@@ -108,4 +109,6 @@ private:
   std::string CommandName;
   std::vector<DebugLibState> FailedSearchLocations;
   DebugLibState FoundSearchLocation;
+  std::size_t DirectoryContentHits = 0;
+  std::size_t DirectoryContentMisses = 0;
 };
@@ -419,7 +419,8 @@ bool cmFindLibraryHelper::CheckDirectoryForName(std::string const& path,
   if (name.TryRaw) {
     this->TestPath = cmStrCat(path, name.Raw);
 
-    const bool exists = cmSystemTools::FileExists(this->TestPath, true);
+    const bool exists = this->GG->MayBeInDirectoryContent(this->TestPath) &&
+      cmSystemTools::FileExists(this->TestPath, true);
     if (!exists) {
       this->DebugLibraryFailed(name.Raw, path);
     } else {
@@ -442,7 +443,8 @@ bool cmFindLibraryHelper::CheckDirectoryForName(std::string const& path,
   // Search for a file matching the library name regex.
   std::string dir = path;
   cmSystemTools::ConvertToUnixSlashes(dir);
-  std::set<std::string> const& files = this->GG->GetDirectoryContent(dir);
+  std::set<std::string> const& files =
+    this->GG->GetFindDirectoryContent(dir);
   for (std::string const& origName : files) {
 #if defined(_WIN32) || defined(__APPLE__)
     std::string testName = cmSystemTools::LowerCase(origName);
@@ -553,7 +555,9 @@ std::string cmFindLibraryCommand::FindFrameworkLibraryNamesPerDir()
   for (std::string const& d : this->SearchPaths) {
     for (std::string const& n : this->Names) {
       fwPath = cmStrCat(d, n, ".framework");
-      if (cmSystemTools::FileIsDirectory(fwPath)) {
+      if (this->Makefile->GetGlobalGenerator()->MayBeInDirectoryContent(
+            fwPath) &&
+          cmSystemTools::FileIsDirectory(fwPath)) {
         auto finalPath = cmSystemTools::CollapseFullPath(fwPath);
         if (this->Validate(finalPath)) {
           return finalPath;
@@ -573,7 +577,9 @@ std::string cmFindLibraryCommand::FindFrameworkLibraryDirsPerName()
   for (std::string const& n : this->Names) {
     for (std::string const& d : this->SearchPaths) {
       fwPath = cmStrCat(d, n, ".framework");
-      if (cmSystemTools::FileIsDirectory(fwPath)) {
+      if (this->Makefile->GetGlobalGenerator()->MayBeInDirectoryContent(
+            fwPath) &&
+          cmSystemTools::FileIsDirectory(fwPath)) {
         auto finalPath = cmSystemTools::CollapseFullPath(fwPath);
         if (this->Validate(finalPath)) {
           return finalPath;
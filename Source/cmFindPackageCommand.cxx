@@ -23,6 +23,7 @@
 
 #include "cmAlgorithms.h"
 #include "cmDependencyProvider.h"
+#include "cmGlobalGenerator.h"
 #include "cmListFileCache.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
@@ -36,6 +37,12 @@
 #include "cmValue.h"
 #include "cmVersion.h"
 #include "cmWindowsRegistry.h"
+#include "cmake.h"
+
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmCryptoHash.h"
+#  include "cmFindPackageSearchCache.h"
+#endif
 
 #if defined(__HAIKU__)
 #  include <FindDirectory.h>
@@ -104,14 +111,6 @@ public:
 };
 #endif
 
-bool isDirentryToIgnore(const char* const fname)
-{
-  assert(fname != nullptr);
-  assert(fname[0] != 0);
-  return fname[0] == '.' &&
-    (fname[1] == 0 || (fname[1] == '.' && fname[2] == 0));
-}
-
 class cmAppendPathSegmentGenerator
 {
 public:
@@ -163,29 +162,25 @@ private:
 class cmCaseInsensitiveDirectoryListGenerator
 {
 public:
-  cmCaseInsensitiveDirectoryListGenerator(cm::string_view name)
-    : DirectoryLister{}
+  cmCaseInsensitiveDirectoryListGenerator(cmGlobalGenerator* gg,
+                                          cm::string_view name)
+    : GlobalGenerator{ gg }
     , DirName{ name }
   {
   }
 
   std::string GetNextCandidate(const std::string& parent)
   {
-    if (!this->Loaded) {
-      this->CurrentIdx = 0ul;
-      this->Loaded = true;
-      if (!this->DirectoryLister.Load(parent)) {
-        return {};
-      }
+    if (!this->Content) {
+      // The listing is shared by all find_package calls of this run.
+      this->Content =
+        &this->GlobalGenerator->GetFindDirectoryContent(parent);
+      this->Current = this->Content->cbegin();
     }
 
-    while (this->CurrentIdx < this->DirectoryLister.GetNumberOfFiles()) {
-      const char* const fname =
-        this->DirectoryLister.GetFile(this->CurrentIdx++);
-      if (isDirentryToIgnore(fname)) {
-        continue;
-      }
-      if (cmsysString_strcasecmp(fname, this->DirName.data()) == 0) {
+    while (this->Current != this->Content->cend()) {
+      std::string const& fname = *this->Current++;
+      if (cmsysString_strcasecmp(fname.c_str(), this->DirName.data()) == 0) {
         auto candidate = cmStrCat(parent, '/', fname);
         if (cmSystemTools::FileIsDirectory(candidate)) {
           return candidate;
@@ -195,20 +190,22 @@ public:
     return {};
   }
 
-  void Reset() { this->Loaded = false; }
+  void Reset() { this->Content = nullptr; }
 
 private:
-  cmsys::Directory DirectoryLister;
+  cmGlobalGenerator* GlobalGenerator;
+  std::set<std::string> const* Content = nullptr;
+  std::set<std::string>::const_iterator Current;
   const cm::string_view DirName;
-  unsigned long CurrentIdx = 0ul;
-  bool Loaded = false;
 };
 
 class cmDirectoryListGenerator
 {
 public:
-  cmDirectoryListGenerator(std::vector<std::string> const& names)
-    : Names{ names }
+  cmDirectoryListGenerator(cmGlobalGenerator* gg,
+                           std::vector<std::string> const& names)
+    : GlobalGenerator{ gg }
+    , Names{ names }
     , Matches{}
     , Current{ this->Matches.cbegin() }
   {
@@ -219,33 +216,24 @@ public:
   {
     // Construct a list of matches if not yet
     if (this->Matches.empty()) {
-      cmsys::Directory directoryLister;
-      // ALERT `Directory::Load()` keeps only names
-      // internally and LOST entry type from `dirent`.
-      // So, `Directory::FileIsDirectory` gonna use
-      // `SystemTools::FileIsDirectory()` and waste a syscall.
-      // TODO Need to enhance the `Directory` class.
-      directoryLister.Load(parent);
-
-      // ATTENTION Is it guaranteed that first two entries are
-      // `.` and `..`?
-      // TODO If so, just start with index 2 and drop the
-      // `isDirentryToIgnore(i)` condition to check.
-      for (auto i = 0ul; i < directoryLister.GetNumberOfFiles(); ++i) {
-        const char* const fname = directoryLister.GetFile(i);
-        if (isDirentryToIgnore(fname)) {
-          continue;
-        }
+      // The listing is shared by all find_package calls of this run.  It
+      // keeps only names, so matching entries are checked for being
+      // directories.
+      std::set<std::string> const& content =
+        this->GlobalGenerator->GetFindDirectoryContent(parent);
 
+      for (std::string const& fname : content) {
         for (const auto& n : this->Names.get()) {
           // NOTE Customization point for `cmMacProjectDirectoryListGenerator`
           const auto name = this->TransformNameBeforeCmp(n);
           // Skip entries that don't match and non-directories.
           // ATTENTION BTW, original code also didn't check if it's a symlink
           // to a directory!
-          const auto equal =
-            (cmsysString_strncasecmp(fname, name.c_str(), name.length()) == 0);
-          if (equal && directoryLister.FileIsDirectory(i)) {
+          const auto equal = (cmsysString_strncasecmp(fname.c_str(),
+                                                      name.c_str(),
+                                                      name.length()) == 0);
+          if (equal &&
+              cmSystemTools::FileIsDirectory(cmStrCat(parent, '/', fname))) {
             this->Matches.emplace_back(fname);
           }
         }
@@ -274,6 +262,7 @@ protected:
   virtual void OnMatchesLoaded() {}
   virtual std::string TransformNameBeforeCmp(std::string same) { return same; }
 
+  cmGlobalGenerator* GlobalGenerator;
   std::reference_wrapper<const std::vector<std::string>> Names;
   std::vector<std::string> Matches;
   std::vector<std::string>::const_iterator Current;
@@ -282,10 +271,11 @@ protected:
 class cmProjectDirectoryListGenerator : public cmDirectoryListGenerator
 {
 public:
-  cmProjectDirectoryListGenerator(std::vector<std::string> const& names,
+  cmProjectDirectoryListGenerator(cmGlobalGenerator* gg,
+                                  std::vector<std::string> const& names,
                                   cmFindPackageCommand::SortOrderType so,
                                   cmFindPackageCommand::SortDirectionType sd)
-    : cmDirectoryListGenerator{ names }
+    : cmDirectoryListGenerator{ gg, names }
     , SortOrder{ so }
     , SortDirection{ sd }
   {
@@ -310,9 +300,10 @@ private:
 class cmMacProjectDirectoryListGenerator : public cmDirectoryListGenerator
 {
 public:
-  cmMacProjectDirectoryListGenerator(const std::vector<std::string>& names,
+  cmMacProjectDirectoryListGenerator(cmGlobalGenerator* gg,
+                                     const std::vector<std::string>& names,
                                      cm::string_view ext)
-    : cmDirectoryListGenerator{ names }
+    : cmDirectoryListGenerator{ gg, names }
     , Extension{ ext }
   {
   }
@@ -330,8 +321,9 @@ private:
 class cmFileListGeneratorGlob
 {
 public:
-  cmFileListGeneratorGlob(cm::string_view pattern)
-    : Pattern(pattern)
+  cmFileListGeneratorGlob(cmGlobalGenerator* gg, cm::string_view pattern)
+    : GG(gg)
+    , Pattern(pattern)
     , Files{}
     , Current{}
   {
@@ -340,7 +332,9 @@ public:
   std::string GetNextCandidate(const std::string& parent)
   {
     if (this->Files.empty()) {
-      // Glob the set of matching files.
+      // Glob the set of matching files.  This bypasses the directory
+      // listings, so a search cannot tell whether the result changed.
+      this->GG->MarkDirectoryContentWatchIncomplete();
       std::string expr = cmStrCat(parent, this->Pattern);
       cmsys::Glob g;
       if (!g.FindFiles(expr)) {
@@ -367,6 +361,7 @@ public:
   }
 
 private:
+  cmGlobalGenerator* GG;
   cm::string_view Pattern;
   std::vector<std::string> Files;
   std::vector<std::string>::const_iterator Current;
@@ -1405,6 +1400,10 @@ bool cmFindPackageCommand::HandlePackageMode(
     // Search for the config file if it is not already found.
     if (cmIsOff(def) || !fileFound) {
       fileFound = this->FindConfig();
+      // The next run searches again for a package that was not found.
+      if (!fileFound) {
+        this->Makefile->MarkConfigureVolatile("find_package()");
+      }
     }
 
     // Sanity check.
@@ -1632,6 +1631,42 @@ bool cmFindPackageCommand::FindConfig()
 
   // Look for the project's configuration file.
   bool found = false;
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
+  cmGlobalGenerator::DirectoryContentStatistics const& stats =
+    gg->GetDirectoryContentStatistics();
+  cmGlobalGenerator::DirectoryContentStatistics const initialStats = stats;
+
+#if !defined(CMAKE_BOOTSTRAP)
+  // Reuse the result of a previous run if the search would not change.
+  cmFindPackageSearchCache* searchCache = nullptr;
+  std::string searchCacheKey;
+  if (this->Makefile->IsOn("CMAKE_FIND_PACKAGE_SEARCH_CACHE")) {
+    searchCache =
+      this->Makefile->GetCMakeInstance()->GetFindPackageSearchCache();
+  }
+  // The redirects directory is recreated by every run, so its content is
+  // checked here instead of being watched.
+  std::string redirectsDir;
+  if (searchCache) {
+    redirectsDir =
+      this->Makefile->GetSafeDefinition("CMAKE_FIND_PACKAGE_REDIRECTS_DIR");
+    searchCacheKey = this->ComputeSearchCacheKey();
+    if (redirectsDir.empty() ||
+        gg->GetFindDirectoryContent(redirectsDir).empty()) {
+      if (cm::optional<std::vector<std::string>> candidates =
+            searchCache->Lookup(searchCacheKey)) {
+        return this->FindCachedConfig(*candidates);
+      }
+    }
+  }
+  std::size_t const firstConsidered = this->ConsideredConfigs.size();
+  cmGlobalGenerator::DirectoryContentWatch watch;
+  cmGlobalGenerator::DirectoryContentWatch* outerWatch = nullptr;
+  if (searchCache) {
+    outerWatch = gg->SetDirectoryContentWatch(&watch);
+  }
+#endif
+
   if (this->DebugMode) {
     this->DebugBuffer = cmStrCat(this->DebugBuffer,
                                  "find_package considered the following "
@@ -1664,6 +1699,31 @@ bool cmFindPackageCommand::FindConfig()
     found = this->FindAppBundleConfig();
   }
 
+#if !defined(CMAKE_BOOTSTRAP)
+  if (searchCache) {
+    gg->SetDirectoryContentWatch(outerWatch);
+    if (!redirectsDir.empty()) {
+      auto& dirs = watch.Directories;
+      dirs.erase(cmSystemTools::GetFilenamePath(redirectsDir));
+      dirs.erase(redirectsDir);
+      std::string const prefix = cmStrCat(redirectsDir, '/');
+      for (auto i = dirs.lower_bound(prefix);
+           i != dirs.end() && cmHasPrefix(i->first, prefix);) {
+        i = dirs.erase(i);
+      }
+    }
+    if (watch.Complete) {
+      std::vector<std::string> candidates;
+      for (std::size_t i = firstConsidered; i < this->ConsideredConfigs.size();
+           ++i) {
+        candidates.push_back(this->ConsideredConfigs[i].filename);
+      }
+      searchCache->Store(searchCacheKey, this->Name, std::move(candidates),
+                         std::move(watch.Directories));
+    }
+  }
+#endif
+
   if (this->DebugMode) {
     if (found) {
       this->DebugBuffer = cmStrCat(
@@ -1672,8 +1732,18 @@ bool cmFindPackageCommand::FindConfig()
       this->DebugBuffer =
         cmStrCat(this->DebugBuffer, "The file was not found.\n");
     }
+    this->DebugBuffer =
+      cmStrCat(this->DebugBuffer, "The directory listing cache had ",
+               stats.Hits - initialStats.Hits, " hits and ",
+               stats.Misses - initialStats.Misses, " misses.\n");
   }
 
+  this->StoreConfigDir(found);
+  return found;
+}
+
+void cmFindPackageCommand::StoreConfigDir(bool found)
+{
   // Store the entry in the cache so it can be set by the user.
   std::string init;
   if (found) {
@@ -1683,9 +1753,93 @@ bool cmFindPackageCommand::FindConfig()
   }
   // We force the value since we do not get here if it was already set.
   this->SetConfigDirCacheVariable(init);
+}
+
+#if !defined(CMAKE_BOOTSTRAP)
+std::string cmFindPackageCommand::ComputeSearchCacheKey() const
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  auto append = [&hasher](cm::string_view s) {
+    // Separate the fields with a character that cannot appear in them.
+    hasher.Append(s);
+    hasher.Append(cm::string_view("\0", 1));
+  };
+  auto appendList = [&append](std::string const& name,
+                              std::vector<std::string> const& list) {
+    append(name);
+    append(std::to_string(list.size()));
+    for (std::string const& item : list) {
+      append(item);
+    }
+  };
+
+  append(this->Name);
+  append(this->VersionComplete);
+  append(this->VersionExact ? "EXACT" : "");
+  appendList("NAMES", this->Names);
+  appendList("CONFIGS", this->Configs);
+  appendList("PATHS", this->SearchPaths);
+  appendList("PATH_SUFFIXES", this->SearchPathSuffixes);
+  appendList("IGNORE",
+             std::vector<std::string>(this->IgnoredPaths.begin(),
+                                      this->IgnoredPaths.end()));
+  appendList("IGNORE_PREFIX",
+             std::vector<std::string>(this->IgnoredPrefixPaths.begin(),
+                                      this->IgnoredPrefixPaths.end()));
+  append(this->LibraryArchitecture);
+  std::string flags;
+  for (bool flag :
+       { this->UseLib32Paths, this->UseLib64Paths, this->UseLibx32Paths,
+         this->SearchFrameworkFirst, this->SearchFrameworkOnly,
+         this->SearchFrameworkLast, this->SearchAppBundleFirst,
+         this->SearchAppBundleOnly, this->SearchAppBundleLast }) {
+    flags += flag ? '1' : '0';
+  }
+  append(flags);
+  append(cmStrCat(static_cast<int>(this->SortOrder), ' ',
+                  static_cast<int>(this->SortDirection)));
+  return hasher.FinalizeHex();
+}
 
+bool cmFindPackageCommand::FindCachedConfig(
+  std::vector<std::string> const& candidates)
+{
+  // The directories searched did not change, so the same config files are
+  // candidates in the same order.  Check their versions again because the
+  // version files may have changed, or may depend on the project.
+  if (this->DebugMode) {
+    this->DebugBuffer =
+      cmStrCat(this->DebugBuffer, "find_package reused a previous search for ",
+               this->Name, "'s Config module, which considered:\n");
+  }
+  bool found = false;
+  for (std::string const& candidate : candidates) {
+    if (this->DebugMode) {
+      this->DebugBuffer = cmStrCat(this->DebugBuffer, "  ", candidate, "\n");
+    }
+    if (cmSystemTools::FileExists(candidate, true) &&
+        this->CheckVersion(candidate)) {
+      this->FileFound =
+        this->UseRealPath ? cmSystemTools::GetRealPath(candidate) : candidate;
+      cmSystemTools::ConvertToUnixSlashes(this->FileFound);
+      found = true;
+      break;
+    }
+  }
+  if (this->DebugMode) {
+    if (found) {
+      this->DebugBuffer = cmStrCat(
+        this->DebugBuffer, "The file was found at\n  ", this->FileFound, "\n");
+    } else {
+      this->DebugBuffer =
+        cmStrCat(this->DebugBuffer, "The file was not found.\n");
+    }
+  }
+  this->StoreConfigDir(found);
   return found;
 }
+#endif
 
 void cmFindPackageCommand::SetConfigDirCacheVariable(const std::string& value)
 {
@@ -2312,7 +2466,8 @@ bool cmFindPackageCommand::FindConfigFile(std::string const& dir,
     if (this->DebugMode) {
       this->DebugBuffer = cmStrCat(this->DebugBuffer, "  ", file, "\n");
     }
-    if (cmSystemTools::FileExists(file, true) && this->CheckVersion(file)) {
+    if (this->Makefile->GetGlobalGenerator()->MayBeInDirectoryContent(file) &&
+        cmSystemTools::FileExists(file, true) && this->CheckVersion(file)) {
       // Allow resolving symlinks when the config file is found through a link
       if (this->UseRealPath) {
         file = cmSystemTools::GetRealPath(file);
@@ -2485,16 +2640,20 @@ bool cmFindPackageCommand::SearchPrefix(std::string const& prefix_in)
 {
   assert(!prefix_in.empty() && prefix_in.back() == '/');
 
+  std::string prefixWithoutSlash = prefix_in;
+  if (prefixWithoutSlash != "/" && prefixWithoutSlash.back() == '/') {
+    prefixWithoutSlash.erase(prefixWithoutSlash.length() - 1);
+  }
+
   // Skip this if the prefix does not exist.
-  if (!cmSystemTools::FileIsDirectory(prefix_in)) {
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
+  if ((prefixWithoutSlash != "/" &&
+       !gg->MayBeInDirectoryContent(prefixWithoutSlash)) ||
+      !cmSystemTools::FileIsDirectory(prefix_in)) {
     return false;
   }
 
   // Skip this if it's in ignored paths.
-  std::string prefixWithoutSlash = prefix_in;
-  if (prefixWithoutSlash != "/" && prefixWithoutSlash.back() == '/') {
-    prefixWithoutSlash.erase(prefixWithoutSlash.length() - 1);
-  }
   if (this->IgnoredPaths.count(prefixWithoutSlash) ||
       this->IgnoredPrefixPaths.count(prefixWithoutSlash)) {
     return false;
@@ -2513,9 +2672,9 @@ bool cmFindPackageCommand::SearchPrefix(std::string const& prefix_in)
     return this->SearchDirectory(fullPath);
   };
 
-  auto iCMakeGen = cmCaseInsensitiveDirectoryListGenerator{ "cmake"_s };
+  auto iCMakeGen = cmCaseInsensitiveDirectoryListGenerator{ gg, "cmake"_s };
   auto firstPkgDirGen =
-    cmProjectDirectoryListGenerator{ this->Names, this->SortOrder,
+    cmProjectDirectoryListGenerator{ gg, this->Names, this->SortOrder,
                                      this->SortDirection };
 
   // PREFIX/(cmake|CMake)/ (useful on windows or in build trees)
@@ -2534,7 +2693,7 @@ bool cmFindPackageCommand::SearchPrefix(std::string const& prefix_in)
   }
 
   auto secondPkgDirGen =
-    cmProjectDirectoryListGenerator{ this->Names, this->SortOrder,
+    cmProjectDirectoryListGenerator{ gg, this->Names, this->SortOrder,
                                      this->SortDirection };
 
   // PREFIX/(Foo|foo|FOO).*/(cmake|CMake)/(Foo|foo|FOO).*/
@@ -2609,12 +2768,13 @@ bool cmFindPackageCommand::SearchFrameworkPrefix(std::string const& prefix_in)
     return this->SearchDirectory(fullPath);
   };
 
-  auto iCMakeGen = cmCaseInsensitiveDirectoryListGenerator{ "cmake"_s };
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
+  auto iCMakeGen = cmCaseInsensitiveDirectoryListGenerator{ gg, "cmake"_s };
   auto fwGen =
-    cmMacProjectDirectoryListGenerator{ this->Names, ".framework"_s };
+    cmMacProjectDirectoryListGenerator{ gg, this->Names, ".framework"_s };
   auto rGen = cmAppendPathSegmentGenerator{ "Resources"_s };
   auto vGen = cmAppendPathSegmentGenerator{ "Versions"_s };
-  auto grGen = cmFileListGeneratorGlob{ "/*/Resources"_s };
+  auto grGen = cmFileListGeneratorGlob{ gg, "/*/Resources"_s };
 
   // <prefix>/Foo.framework/Resources/
   if (TryGeneratedPaths(searchFn, prefix, fwGen, rGen)) {
@@ -2647,7 +2807,9 @@ bool cmFindPackageCommand::SearchAppBundlePrefix(std::string const& prefix_in)
     return this->SearchDirectory(fullPath);
   };
 
-  auto appGen = cmMacProjectDirectoryListGenerator{ this->Names, ".app"_s };
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
+  auto appGen =
+    cmMacProjectDirectoryListGenerator{ gg, this->Names, ".app"_s };
   auto crGen = cmAppendPathSegmentGenerator{ "Contents/Resources"_s };
 
   // <prefix>/Foo.app/Contents/Resources
@@ -2658,7 +2820,7 @@ bool cmFindPackageCommand::SearchAppBundlePrefix(std::string const& prefix_in)
   // <prefix>/Foo.app/Contents/Resources/CMake
   return TryGeneratedPaths(
     searchFn, prefix, appGen, crGen,
-    cmCaseInsensitiveDirectoryListGenerator{ "cmake"_s });
+    cmCaseInsensitiveDirectoryListGenerator{ gg, "cmake"_s });
 }
 
 // TODO: Debug cmsys::Glob double slash problem.
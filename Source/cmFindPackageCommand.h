@@ -113,6 +113,11 @@ private:
   bool HandlePackageMode(HandlePackageModeType type);
 
   bool FindConfig();
+  void StoreConfigDir(bool found);
+#if !defined(CMAKE_BOOTSTRAP)
+  std::string ComputeSearchCacheKey() const;
+  bool FindCachedConfig(std::vector<std::string> const& candidates);
+#endif
   bool FindPrefixedConfig();
   bool FindFrameworkConfig();
   bool FindAppBundleConfig();
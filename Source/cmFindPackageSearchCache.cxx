@@ -0,0 +1,142 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmFindPackageSearchCache.h"
+
+#include <memory>
+#include <utility>
+
+#include <cm3p/json/reader.h>
+#include <cm3p/json/value.h>
+#include <cm3p/json/writer.h>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmFileTime.h"
+#include "cmGeneratedFileStream.h"
+#include "cmStringAlgorithms.h"
+#include "cmVersion.h"
+
+namespace {
+// Bump this whenever the layout of the cache file changes.
+int const FormatVersion = 1;
+
+cm::optional<long long> StatDirectory(std::string const& dir)
+{
+  cmFileTime mtime;
+  if (!mtime.Load(dir)) {
+    return cm::nullopt;
+  }
+  return mtime.GetTime();
+}
+}
+
+cmFindPackageSearchCache::cmFindPackageSearchCache(
+  std::string const& binaryDir)
+  : CacheFile(cmStrCat(binaryDir, "/CMakeFindPackageCache.json"))
+{
+}
+
+void cmFindPackageSearchCache::Load()
+{
+  Json::Value root;
+  {
+    cmsys::ifstream fin(this->CacheFile.c_str(), std::ios::in);
+    Json::CharReaderBuilder builder;
+    std::string errors;
+    if (!fin || !Json::parseFromStream(builder, fin, &root, &errors) ||
+        !root.isObject()) {
+      return;
+    }
+  }
+  // The search order may differ between versions of CMake.
+  if (root["version"] != FormatVersion ||
+      root["cmake"] != cmVersion::GetCMakeVersion()) {
+    return;
+  }
+
+  Json::Value const& entries = root["entries"];
+  for (auto i = entries.begin(); i != entries.end(); ++i) {
+    Entry entry;
+    entry.Package = (*i)["package"].asString();
+    for (Json::Value const& candidate : (*i)["candidates"]) {
+      entry.Candidates.push_back(candidate.asString());
+    }
+    Json::Value const& dirs = (*i)["directories"];
+    for (auto d = dirs.begin(); d != dirs.end(); ++d) {
+      cm::optional<long long>& mtime = entry.Directories[d.name()];
+      if (d->isInt64()) {
+        mtime = d->asInt64();
+      }
+    }
+    this->Entries.emplace(i.name(), std::move(entry));
+  }
+}
+
+bool cmFindPackageSearchCache::Save()
+{
+  Json::Value root = Json::objectValue;
+  root["version"] = FormatVersion;
+  root["cmake"] = cmVersion::GetCMakeVersion();
+  Json::Value& entries = root["entries"] = Json::objectValue;
+  for (auto const& e : this->Entries) {
+    // Forget the searches that this run did not make.
+    if (!e.second.Used) {
+      continue;
+    }
+    Json::Value& entry = entries[e.first] = Json::objectValue;
+    entry["package"] = e.second.Package;
+    Json::Value& candidates = entry["candidates"] = Json::arrayValue;
+    for (std::string const& candidate : e.second.Candidates) {
+      candidates.append(candidate);
+    }
+    Json::Value& dirs = entry["directories"] = Json::objectValue;
+    for (auto const& dir : e.second.Directories) {
+      dirs[dir.first] = dir.second
+        ? Json::Value(static_cast<Json::Int64>(*dir.second))
+        : Json::Value();
+    }
+  }
+
+  cmGeneratedFileStream fout(this->CacheFile);
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+  std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+  writer->write(root, &fout);
+  fout << '\n';
+  return fout.Close();
+}
+
+cm::optional<std::vector<std::string>> cmFindPackageSearchCache::Lookup(
+  std::string const& key)
+{
+  auto i = this->Entries.find(key);
+  if (i == this->Entries.end()) {
+    ++this->Stats.Misses;
+    return cm::nullopt;
+  }
+  for (auto const& dir : i->second.Directories) {
+    if (StatDirectory(dir.first) != dir.second) {
+      ++this->Stats.Stale;
+      this->Entries.erase(i);
+      return cm::nullopt;
+    }
+  }
+  ++this->Stats.Hits;
+  i->second.Used = true;
+  return i->second.Candidates;
+}
+
+void cmFindPackageSearchCache::Store(
+  std::string const& key, std::string const& package,
+  std::vector<std::string> candidates,
+  std::map<std::string, cm::optional<long long>> directories)
+{
+  // A directory changed after it was listed looks changed to the next run,
+  // which then searches again.
+  Entry& entry = this->Entries[key];
+  entry.Package = package;
+  entry.Candidates = std::move(candidates);
+  entry.Directories = std::move(directories);
+  entry.Used = true;
+  ++this->Stats.Stored;
+}
@@ -0,0 +1,83 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <cm/optional>
+
+/** \class cmFindPackageSearchCache
+ * \brief Remember the config files find_package considered in earlier runs.
+ *
+ * An entry records, for one set of search parameters, the config files a
+ * search considered, in order, and the modification times of the
+ * directories whose content the search looked at.  While none of those
+ * directories changed, a new search would consider the same files in the
+ * same order, so only their version files need to be checked again.
+ *
+ * The entries are stored next to CMakeCache.txt so that they survive a
+ * fresh configure of the build tree.
+ */
+class cmFindPackageSearchCache
+{
+public:
+  struct Statistics
+  {
+    unsigned long Hits = 0;
+    unsigned long Misses = 0;
+    unsigned long Stale = 0;
+    unsigned long Stored = 0;
+  };
+
+  /** Use the cache file in the given top-level build directory.  */
+  explicit cmFindPackageSearchCache(std::string const& binaryDir);
+
+  cmFindPackageSearchCache(cmFindPackageSearchCache const&) = delete;
+  cmFindPackageSearchCache& operator=(cmFindPackageSearchCache const&) =
+    delete;
+
+  std::string const& GetCacheFile() const { return this->CacheFile; }
+  Statistics const& GetStatistics() const { return this->Stats; }
+
+  /**
+   * Read the entries stored by a previous run.  A missing, truncated or
+   * incompatible cache file is silently treated as empty.
+   */
+  void Load();
+
+  /** Write the entries used or stored during this run.  */
+  bool Save();
+
+  /**
+   * Return the config files considered by the search with the given key,
+   * if none of the directories it looked at changed since.
+   */
+  cm::optional<std::vector<std::string>> Lookup(std::string const& key);
+
+  /**
+   * Store the config files considered by a search, in order, and the
+   * directories whose content it looked at with their modification times,
+   * if they existed, taken before their content was listed.
+   */
+  void Store(std::string const& key, std::string const& package,
+             std::vector<std::string> candidates,
+             std::map<std::string, cm::optional<long long>> directories);
+
+private:
+  struct Entry
+  {
+    std::string Package;
+    std::vector<std::string> Candidates;
+    // The modification time of each directory, if it existed.
+    std::map<std::string, cm::optional<long long>> Directories;
+    bool Used = false;
+  };
+
+  std::string CacheFile;
+  std::map<std::string, Entry> Entries;
+  Statistics Stats;
+};
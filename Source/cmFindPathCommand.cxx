@@ -6,6 +6,8 @@
 
 #include "cmsys/Glob.hxx"
 
+#include "cmGlobalGenerator.h"
+#include "cmMakefile.h"
 #include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
@@ -88,7 +90,9 @@ std::string cmFindPathCommand::FindHeaderInFramework(
     if (!frameWorkName.empty()) {
       std::string fpath = cmStrCat(dir, frameWorkName, ".framework");
       std::string intPath = cmStrCat(fpath, "/Headers/", fileName);
-      if (cmSystemTools::FileExists(intPath) &&
+      if (this->Makefile->GetGlobalGenerator()->MayBeInDirectoryContent(
+            intPath) &&
+          cmSystemTools::FileExists(intPath) &&
           this->Validate(this->IncludeFileInPath ? intPath : fpath)) {
         debug.FoundAt(intPath);
         if (this->IncludeFileInPath) {
@@ -121,11 +125,13 @@ std::string cmFindPathCommand::FindHeaderInFramework(
 
 std::string cmFindPathCommand::FindNormalHeader(cmFindBaseDebugState& debug)
 {
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
   std::string tryPath;
   for (std::string const& n : this->Names) {
     for (std::string const& sp : this->SearchPaths) {
       tryPath = cmStrCat(sp, n);
-      if (cmSystemTools::FileExists(tryPath) &&
+      if (gg->MayBeInDirectoryContent(tryPath) &&
+          cmSystemTools::FileExists(tryPath) &&
           this->Validate(this->IncludeFileInPath ? tryPath : sp)) {
         debug.FoundAt(tryPath);
         if (this->IncludeFileInPath) {
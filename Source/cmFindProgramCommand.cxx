@@ -6,6 +6,7 @@
 #include <string>
 #include <utility>
 
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
 #include "cmPolicies.h"
@@ -96,7 +97,10 @@ struct cmFindProgramHelper
                          this->TestNameExt = cmStrCat(name, ext);
                          this->TestPath = cmSystemTools::CollapseFullPath(
                            this->TestNameExt, path);
-                         bool exists = this->FileIsValid(this->TestPath);
+                         bool exists =
+                           this->Makefile->GetGlobalGenerator()
+                             ->MayBeInDirectoryContent(this->TestPath) &&
+                           this->FileIsValid(this->TestPath);
                          exists ? this->DebugSearches.FoundAt(this->TestPath)
                                 : this->DebugSearches.FailedAt(this->TestPath);
                          if (exists) {
@@ -2,6 +2,7 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmGccDepfileLexerHelper.h"
 
+#include <cstddef>
 #include <cstdio>
 #include <memory>
 #include <string>
@@ -41,6 +42,125 @@ bool cmGccDepfileLexerHelper::readFile(const char* filePath)
   return this->HelperState != State::Failed;
 }
 
+cmGccDepfileLexerHelper::ParseResult cmGccDepfileLexerHelper::parseContent(
+  cm::string_view content)
+{
+  // Follow the rules of the lexer, calling the same functions for the same
+  // input, but bail out on anything other than plain text, separators and
+  // line continuations.
+  auto isSpace = [](char c) { return c == ' ' || c == '\t'; };
+  auto isSpecial = [](char c) {
+    switch (c) {
+      case ':':
+      case '\\':
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+      case '$':
+      case '\0':
+        return true;
+      default:
+        return false;
+    }
+  };
+  auto newlineLength = [&content](std::size_t pos) -> std::size_t {
+    if (pos < content.size() && content[pos] == '\n') {
+      return 1;
+    }
+    if (pos + 1 < content.size() && content[pos] == '\r' &&
+        content[pos + 1] == '\n') {
+      return 2;
+    }
+    return 0;
+  };
+
+  this->newEntry();
+  std::size_t pos = 0;
+  while (pos < content.size()) {
+    char const c = content[pos];
+    switch (c) {
+      case '\\': {
+        std::size_t const nl = newlineLength(pos + 1);
+        if (nl != 0) {
+          // A line continuation ends the current file name.
+          this->newRuleOrDependency();
+          pos += 1 + nl;
+          continue;
+        }
+        if (pos + 1 == content.size()) {
+          return ParseResult::NeedLexer;
+        }
+        char const next = content[pos + 1];
+        if (isSpace(next) || next == '\\' || next == '#' || next == '\r') {
+          return ParseResult::NeedLexer;
+        }
+        // A backslash not starting an escape is part of the file name.
+        this->addToCurrentPath(content.substr(pos, 1));
+        ++pos;
+      } break;
+      case ':': {
+        std::size_t const nl = newlineLength(pos + 1);
+        if (nl != 0) {
+          // A newline after colon terminates the current rule.
+          this->newDependency();
+          this->newEntry();
+          pos += 1 + nl;
+        } else if (pos + 1 < content.size() && isSpace(content[pos + 1])) {
+          // A colon followed by space ends the rules.
+          this->newDependency();
+          ++pos;
+          while (pos < content.size() && isSpace(content[pos])) {
+            ++pos;
+          }
+        } else if (pos + 1 < content.size() && content[pos + 1] == '\\' &&
+                   newlineLength(pos + 2) != 0) {
+          // A colon followed by a line continuation ends the rules.
+          this->newDependency();
+          pos += 2 + newlineLength(pos + 2);
+        } else {
+          // Any other colon is part of the file name.
+          this->addToCurrentPath(content.substr(pos, 1));
+          ++pos;
+        }
+      } break;
+      case ' ':
+      case '\t':
+        // Rules and dependencies are separated by blocks of whitespace.
+        while (pos < content.size() && isSpace(content[pos])) {
+          ++pos;
+        }
+        this->newRuleOrDependency();
+        break;
+      case '\n':
+      case '\r': {
+        std::size_t const nl = newlineLength(pos);
+        if (nl == 0) {
+          return ParseResult::NeedLexer;
+        }
+        // A newline ends the current file name and the current rule.
+        this->newEntry();
+        pos += nl;
+      } break;
+      case '$':
+      case '\0':
+        return ParseResult::NeedLexer;
+      default: {
+        // Got a span of plain text.
+        std::size_t end = pos + 1;
+        while (end < content.size() && !isSpecial(content[end])) {
+          ++end;
+        }
+        this->addToCurrentPath(content.substr(pos, end - pos));
+        pos = end;
+      } break;
+    }
+  }
+  this->sanitizeContent();
+  return this->HelperState == State::Failed ? ParseResult::Failure
+                                            : ParseResult::Success;
+}
+
 void cmGccDepfileLexerHelper::newEntry()
 {
   if (this->HelperState == State::Rule && !this->Content.empty()) {
@@ -84,7 +204,7 @@ void cmGccDepfileLexerHelper::newRuleOrDependency()
   }
 }
 
-void cmGccDepfileLexerHelper::addToCurrentPath(const char* s)
+void cmGccDepfileLexerHelper::addToCurrentPath(cm::string_view s)
 {
   if (this->Content.empty()) {
     return;
@@ -107,7 +227,7 @@ void cmGccDepfileLexerHelper::addToCurrentPath(const char* s)
     case State::Failed:
       return;
   }
-  dst->append(s);
+  dst->append(s.data(), s.size());
 }
 
 void cmGccDepfileLexerHelper::sanitizeContent()
@@ -4,6 +4,8 @@
 
 #include <utility>
 
+#include <cm/string_view>
+
 #include <cmGccDepfileReaderTypes.h>
 
 class cmGccDepfileLexerHelper
@@ -12,6 +14,19 @@ public:
   cmGccDepfileLexerHelper() = default;
 
   bool readFile(const char* filePath);
+
+  enum class ParseResult
+  {
+    Success,
+    Failure,
+    // The content uses escapes that only the lexer handles.
+    NeedLexer,
+  };
+
+  // Parse the content of a depfile without the lexer.  This handles the
+  // depfiles written by common compilers without copying their content
+  // more than once.  After NeedLexer, the helper must not be used again.
+  ParseResult parseContent(cm::string_view content);
   cmGccDepfileContent extractContent() && { return std::move(this->Content); }
 
   // Functions called by the lexer
@@ -19,7 +34,7 @@ public:
   void newRule();
   void newDependency();
   void newRuleOrDependency();
-  void addToCurrentPath(const char* s);
+  void addToCurrentPath(cm::string_view s);
 
 private:
   void sanitizeContent();
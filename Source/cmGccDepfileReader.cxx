@@ -2,45 +2,114 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmGccDepfileReader.h"
 
+#include <cstddef>
+#include <ios>
+#include <mutex>
+#include <sstream>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <cm/optional>
 
+#include "cmsys/FStream.hxx"
+
 #include "cmGccDepfileLexerHelper.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
+namespace {
+// Depfiles read by the same process name the same headers over and over.
+class NormalizedPathCache
+{
+public:
+  void Normalize(std::string& path)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      auto i = this->Paths.find(path);
+      if (i != this->Paths.end()) {
+        path = i->second;
+        return;
+      }
+    }
+    std::string normalized = path;
+    if (cmSystemTools::FileIsFullPath(normalized)) {
+      normalized = cmSystemTools::CollapseFullPath(normalized);
+    }
+    cmSystemTools::ConvertToLongPath(normalized);
+
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (this->Paths.size() >= MaxSize) {
+      this->Paths.clear();
+    }
+    path = this->Paths.emplace(std::move(path), std::move(normalized))
+             .first->second;
+  }
+
+private:
+  static std::size_t const MaxSize = 1 << 16;
+
+  std::mutex Mutex;
+  std::unordered_map<std::string, std::string> Paths;
+};
+
+NormalizedPathCache& GetNormalizedPathCache()
+{
+  static NormalizedPathCache cache;
+  return cache;
+}
+
+bool ReadDepfile(const char* filePath, cmGccDepfileLexerHelper& helper)
+{
+  std::string content;
+  {
+    cmsys::ifstream fin(filePath, std::ios::in | std::ios::binary);
+    if (!fin) {
+      return false;
+    }
+    std::ostringstream ss;
+    ss << fin.rdbuf();
+    content = ss.str();
+  }
+  switch (helper.parseContent(content)) {
+    case cmGccDepfileLexerHelper::ParseResult::Success:
+      return true;
+    case cmGccDepfileLexerHelper::ParseResult::Failure:
+      return false;
+    case cmGccDepfileLexerHelper::ParseResult::NeedLexer:
+      break;
+  }
+  helper = cmGccDepfileLexerHelper();
+  return helper.readFile(filePath);
+}
+}
+
 cm::optional<cmGccDepfileContent> cmReadGccDepfile(
   const char* filePath, const std::string& prefix,
   GccDepfilePrependPaths prependPaths)
 {
   cmGccDepfileLexerHelper helper;
-  if (!helper.readFile(filePath)) {
+  if (!ReadDepfile(filePath, helper)) {
     return cm::nullopt;
   }
   auto deps = cm::make_optional(std::move(helper).extractContent());
 
+  NormalizedPathCache& cache = GetNormalizedPathCache();
   for (auto& dep : *deps) {
     for (auto& rule : dep.rules) {
       if (prependPaths == GccDepfilePrependPaths::All && !prefix.empty() &&
           !cmSystemTools::FileIsFullPath(rule)) {
         rule = cmStrCat(prefix, '/', rule);
       }
-      if (cmSystemTools::FileIsFullPath(rule)) {
-        rule = cmSystemTools::CollapseFullPath(rule);
-      }
-      cmSystemTools::ConvertToLongPath(rule);
+      cache.Normalize(rule);
     }
     for (auto& path : dep.paths) {
       if (!prefix.empty() && !cmSystemTools::FileIsFullPath(path)) {
         path = cmStrCat(prefix, '/', path);
       }
-      if (cmSystemTools::FileIsFullPath(path)) {
-        path = cmSystemTools::CollapseFullPath(path);
-      }
-      cmSystemTools::ConvertToLongPath(path);
+      cache.Normalize(path);
     }
   }
 
@@ -0,0 +1,136 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmGeneratedFileHashes.h"
+
+#include <ios>
+#include <utility>
+#include <vector>
+
+#include <cm/string_view>
+#include <cmext/string_view>
+
+#include "cmBinaryIO.h"
+#include "cmCryptoHash.h"
+#include "cmGeneratedFileStream.h"
+#include "cmStringAlgorithms.h"
+#include "cmVersion.h"
+
+namespace {
+// Bump this whenever the layout of the record changes.
+unsigned long long const FormatVersion = 1;
+cm::string_view const Magic = "CMGFH\n"_s;
+}
+
+cmGeneratedFileHashes::cmGeneratedFileHashes(std::string const& binaryDir)
+  : RecordFile(cmStrCat(binaryDir, "/CMakeFiles/GeneratedFileHashes.bin"))
+{
+}
+
+void cmGeneratedFileHashes::Load()
+{
+  this->Entries.clear();
+
+  std::string data;
+  if (!cmBinaryIO::ReadFile(this->RecordFile, data)) {
+    return;
+  }
+  cmBinaryIO::Reader reader(data);
+  if (!reader.ReadMagic(Magic)) {
+    return;
+  }
+
+  // A different CMake may hash the content differently.
+  unsigned long long version;
+  std::string cmakeVersion;
+  unsigned long long numEntries;
+  if (!reader.ReadNumber(version) || version != FormatVersion ||
+      !reader.ReadString(cmakeVersion) ||
+      cmakeVersion != cmVersion::GetCMakeVersion() ||
+      !reader.ReadNumber(numEntries)) {
+    return;
+  }
+  for (unsigned long long e = 0; e < numEntries; ++e) {
+    std::string path;
+    Entry entry;
+    unsigned long long mtime;
+    if (!reader.ReadString(path) || !reader.ReadString(entry.Hash) ||
+        !reader.ReadNumber(mtime) || !reader.ReadNumber(entry.Size)) {
+      this->Entries.clear();
+      return;
+    }
+    entry.MTime = static_cast<long long>(mtime);
+    this->Entries.emplace(std::move(path), std::move(entry));
+  }
+  if (!reader.AtEnd()) {
+    this->Entries.clear();
+  }
+}
+
+bool cmGeneratedFileHashes::Save()
+{
+  // Forget the files not generated during this run.  The files written
+  // during this run have been replaced by now, so their times are final.
+  std::vector<std::pair<std::string const*, Entry*>> entries;
+  for (auto& e : this->Entries) {
+    Entry& entry = e.second;
+    if (entry.Written
+          ? cmBinaryIO::StatFile(e.first, entry.MTime, entry.Size)
+          : entry.Verified) {
+      entries.emplace_back(&e.first, &entry);
+    }
+  }
+
+  std::string out(Magic.data(), Magic.size());
+  cmBinaryIO::WriteNumber(out, FormatVersion);
+  cmBinaryIO::WriteString(out, cmVersion::GetCMakeVersion());
+  cmBinaryIO::WriteNumber(out, entries.size());
+  for (auto const& e : entries) {
+    cmBinaryIO::WriteString(out, *e.first);
+    cmBinaryIO::WriteString(out, e.second->Hash);
+    cmBinaryIO::WriteNumber(out,
+                            static_cast<unsigned long long>(e.second->MTime));
+    cmBinaryIO::WriteNumber(out, e.second->Size);
+  }
+
+  cmGeneratedFileStream fout;
+  fout.Open(this->RecordFile, true, true);
+  fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+  return fout.Close();
+}
+
+std::string cmGeneratedFileHashes::HashContent(std::string const& content)
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoMD5);
+  std::vector<unsigned char> hash = hasher.ByteHashString(content);
+  return std::string(hash.begin(), hash.end());
+}
+
+bool cmGeneratedFileHashes::IsUnchanged(std::string const& path,
+                                        std::string const& hash)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  auto i = this->Entries.find(path);
+  // Until a file written during this run is replaced, its time is unknown.
+  if (i == this->Entries.end() || i->second.Written ||
+      i->second.Hash != hash) {
+    return false;
+  }
+  long long mtime;
+  unsigned long long size;
+  if (!cmBinaryIO::StatFile(path, mtime, size) ||
+      mtime != i->second.MTime || size != i->second.Size) {
+    return false;
+  }
+  i->second.Verified = true;
+  return true;
+}
+
+void cmGeneratedFileHashes::Record(std::string const& path,
+                                   std::string const& hash)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  Entry& entry = this->Entries[path];
+  entry.Hash = hash;
+  entry.Verified = false;
+  entry.Written = true;
+}
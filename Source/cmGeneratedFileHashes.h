@@ -0,0 +1,78 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/** \class cmGeneratedFileHashes
+ * \brief Remember the content of the files generated by earlier runs.
+ *
+ * While a record is active, a cmGeneratedFileStream keeps its content in
+ * memory.  When it is closed, the hash of the content is compared with
+ * the hash recorded for the destination by a previous run.  If they
+ * match, and the destination still has the size and modification time
+ * it had when the record was saved, a copy-if-different stream does not
+ * touch the disk at all.
+ */
+class cmGeneratedFileHashes
+{
+public:
+  struct Statistics
+  {
+    std::atomic<unsigned long> Written{ 0 };
+    std::atomic<unsigned long> Unchanged{ 0 };
+    std::atomic<unsigned long> Skipped{ 0 };
+  };
+
+  /** Use the record in the given top-level build directory.  */
+  explicit cmGeneratedFileHashes(std::string const& binaryDir);
+
+  cmGeneratedFileHashes(cmGeneratedFileHashes const&) = delete;
+  cmGeneratedFileHashes& operator=(cmGeneratedFileHashes const&) = delete;
+
+  std::string const& GetRecordFile() const { return this->RecordFile; }
+  Statistics& GetStatistics() { return this->Stats; }
+
+  /**
+   * Read the record saved by a previous run.  A missing, truncated or
+   * incompatible record is silently treated as empty.
+   */
+  void Load();
+
+  /** Write the entries of the files generated during this run.  */
+  bool Save();
+
+  /** Compute the hash of the content of a generated file.  */
+  static std::string HashContent(std::string const& content);
+
+  /**
+   * Return whether the destination still holds the content with the given
+   * hash, as recorded by a previous run.  Thread-safe.
+   */
+  bool IsUnchanged(std::string const& path, std::string const& hash);
+
+  /** Record the hash of the content written to a destination.  */
+  void Record(std::string const& path, std::string const& hash);
+
+private:
+  struct Entry
+  {
+    std::string Hash;
+    long long MTime = 0;
+    unsigned long long Size = 0;
+    // Whether the destination was found unchanged during this run.
+    bool Verified = false;
+    // Whether the destination was written during this run.
+    bool Written = false;
+  };
+
+  std::string RecordFile;
+  std::mutex Mutex;
+  std::unordered_map<std::string, Entry> Entries;
+  Statistics Stats;
+};
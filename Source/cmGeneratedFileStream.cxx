@@ -3,6 +3,9 @@
 #include "cmGeneratedFileStream.h"
 
 #include <cstdio>
+#include <cwchar>
+#include <locale>
+#include <utility>
 
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
@@ -11,10 +14,12 @@
 #  include <cm3p/zlib.h>
 
 #  include "cm_codecvt.hxx"
+#  include "cmGeneratedFileHashes.h"
 #endif
 
 cmGeneratedFileStream::cmGeneratedFileStream(Encoding encoding)
 {
+  this->Encoded = encoding != codecvt::None;
 #ifndef CMAKE_BOOTSTRAP
   if (encoding != codecvt::None) {
     this->imbue(std::locale(this->getloc(), new codecvt(encoding)));
@@ -27,8 +32,11 @@ cmGeneratedFileStream::cmGeneratedFileStream(Encoding encoding)
 cmGeneratedFileStream::cmGeneratedFileStream(std::string const& name,
                                              bool quiet, Encoding encoding)
   : cmGeneratedFileStreamBase(name)
-  , Stream(this->TempName.c_str()) // NOLINT(cmake-use-cmsys-fstream)
 {
+  this->Quiet = quiet;
+  this->Encoded = encoding != codecvt::None;
+  this->OpenTempFile();
+
   // Check if the file opened.
   if (!*this && !quiet) {
     cmSystemTools::Error("Cannot open file for write: " + this->TempName);
@@ -66,13 +74,9 @@ cmGeneratedFileStream& cmGeneratedFileStream::Open(std::string const& name,
   this->cmGeneratedFileStreamBase::Open(name);
 
   // Open the temporary output file.
-  if (binaryFlag) {
-    this->Stream::open( // NOLINT(cmake-use-cmsys-fstream)
-      this->TempName.c_str(), std::ios::out | std::ios::binary);
-  } else {
-    this->Stream::open( // NOLINT(cmake-use-cmsys-fstream)
-      this->TempName.c_str());
-  }
+  this->Quiet = quiet;
+  this->BinaryMode = binaryFlag;
+  this->OpenTempFile();
 
   // Check if the file opened.
   if (!*this && !quiet) {
@@ -82,13 +86,38 @@ cmGeneratedFileStream& cmGeneratedFileStream::Open(std::string const& name,
   return *this;
 }
 
+void cmGeneratedFileStream::OpenTempFile()
+{
+#ifndef CMAKE_BOOTSTRAP
+  // The content of an encoded stream depends on the locale at the time
+  // it was written, so only streams without an encoding are kept.
+  if (!this->Encoded && GetContentHashes()) {
+    this->InMemory = true;
+    this->MemoryContent.str(std::string());
+    this->std::ios::rdbuf(&this->MemoryContent);
+    return;
+  }
+#endif
+  this->InMemory = false;
+  this->std::ios::rdbuf(this->Stream::rdbuf());
+  if (this->BinaryMode) {
+    this->Stream::open( // NOLINT(cmake-use-cmsys-fstream)
+      this->TempName.c_str(), std::ios::out | std::ios::binary);
+  } else {
+    this->Stream::open( // NOLINT(cmake-use-cmsys-fstream)
+      this->TempName.c_str());
+  }
+}
+
 bool cmGeneratedFileStream::Close()
 {
   // Save whether the temporary output file is valid before closing.
   this->Okay = !this->fail();
 
   // Close the temporary output file.
-  this->Stream::close(); // NOLINT(cmake-use-cmsys-fstream)
+  if (!this->InMemory) {
+    this->Stream::close(); // NOLINT(cmake-use-cmsys-fstream)
+  }
 
   // Remove the temporary file (possibly by renaming to the real file).
   return this->cmGeneratedFileStreamBase::Close();
@@ -109,6 +138,38 @@ void cmGeneratedFileStream::SetCompressionExtraExtension(bool ext)
   this->CompressExtraExtension = ext;
 }
 
+namespace {
+cmGeneratedFileStreamBase::CloseCallback& GetCloseCallback()
+{
+  static cmGeneratedFileStreamBase::CloseCallback callback;
+  return callback;
+}
+}
+
+void cmGeneratedFileStreamBase::SetCloseCallback(CloseCallback callback)
+{
+  GetCloseCallback() = std::move(callback);
+}
+
+namespace {
+cmGeneratedFileHashes*& ContentHashes()
+{
+  static cmGeneratedFileHashes* hashes = nullptr;
+  return hashes;
+}
+}
+
+void cmGeneratedFileStreamBase::SetContentHashes(
+  cmGeneratedFileHashes* hashes)
+{
+  ContentHashes() = hashes;
+}
+
+cmGeneratedFileHashes* cmGeneratedFileStreamBase::GetContentHashes()
+{
+  return ContentHashes();
+}
+
 cmGeneratedFileStreamBase::cmGeneratedFileStreamBase() = default;
 
 cmGeneratedFileStreamBase::cmGeneratedFileStreamBase(std::string const& name)
@@ -151,38 +212,116 @@ void cmGeneratedFileStreamBase::Open(std::string const& name)
 
 bool cmGeneratedFileStreamBase::Close()
 {
-  bool replaced = false;
-
   std::string resname = this->Name;
   if (this->Compress && this->CompressExtraExtension) {
     resname += ".gz";
   }
 
+  if (!this->Name.empty() && this->Okay && GetCloseCallback()) {
+    GetCloseCallback()(resname);
+  }
+
+#ifndef CMAKE_BOOTSTRAP
+  if (this->InMemory) {
+    this->InMemory = false;
+    if (this->Name.empty() || !this->Okay ||
+        !this->WriteMemoryContent(resname)) {
+      // There is no temporary file to commit.
+      this->MemoryContent.str(std::string());
+      this->Name.clear();
+      this->TempName.clear();
+      return false;
+    }
+  }
+#endif
+
   // Only consider replacing the destination file if no error
   // occurred.
-  if (!this->Name.empty() && this->Okay &&
-      (!this->CopyIfDifferent ||
-       cmSystemTools::FilesDiffer(this->TempName, resname))) {
+  if (!this->Name.empty() && this->Okay) {
+    return CommitTempFile(this->TempName, resname, this->CopyIfDifferent,
+                          this->Compress);
+  }
+
+  // Else, the destination was not replaced.
+  //
+  // Always delete the temporary file. We never want it to stay around.
+  if (!this->TempName.empty()) {
+    cmSystemTools::RemoveFile(this->TempName);
+  }
+
+  return false;
+}
+
+#ifndef CMAKE_BOOTSTRAP
+bool cmGeneratedFileStreamBase::WriteMemoryContent(std::string const& destName)
+{
+  std::string const content = this->MemoryContent.str();
+  this->MemoryContent.str(std::string());
+
+  cmGeneratedFileHashes* hashes = GetContentHashes();
+  std::string hash;
+  if (hashes) {
+    hash = cmGeneratedFileHashes::HashContent(content);
+    if (this->CopyIfDifferent && hashes->IsUnchanged(destName, hash)) {
+      ++hashes->GetStatistics().Skipped;
+      return false;
+    }
+  }
+
+  cmsys::ofstream fout(this->TempName.c_str(),
+                       this->BinaryMode ? std::ios::out | std::ios::binary
+                                        : std::ios::out);
+  fout.write(content.data(), static_cast<std::streamsize>(content.size()));
+  fout.close();
+  if (!fout) {
+    if (!this->Quiet) {
+      cmSystemTools::Error("Cannot write file: " + this->TempName);
+      cmSystemTools::ReportLastSystemError("");
+    }
+    cmSystemTools::RemoveFile(this->TempName);
+    return false;
+  }
+
+  if (hashes) {
+    hashes->Record(destName, hash);
+  }
+  return true;
+}
+#endif
+
+bool cmGeneratedFileStreamBase::CommitTempFile(std::string const& tempName,
+                                               std::string const& destName,
+                                               bool copyIfDifferent,
+                                               bool compress)
+{
+  bool replaced = false;
+
+  if (!copyIfDifferent || cmSystemTools::FilesDiffer(tempName, destName)) {
     // The destination is to be replaced.  Rename the temporary to the
     // destination atomically.
-    if (this->Compress) {
-      std::string gzname = cmStrCat(this->TempName, ".temp.gz");
-      if (this->CompressFile(this->TempName, gzname)) {
-        this->RenameFile(gzname, resname);
+    if (compress) {
+      std::string gzname = cmStrCat(tempName, ".temp.gz");
+      if (CompressFile(tempName, gzname)) {
+        RenameFile(gzname, destName);
       }
       cmSystemTools::RemoveFile(gzname);
     } else {
-      this->RenameFile(this->TempName, resname);
+      RenameFile(tempName, destName);
     }
 
     replaced = true;
   }
 
-  // Else, the destination was not replaced.
-  //
+#ifndef CMAKE_BOOTSTRAP
+  if (cmGeneratedFileHashes* hashes = GetContentHashes()) {
+    ++(replaced ? hashes->GetStatistics().Written
+                : hashes->GetStatistics().Unchanged);
+  }
+#endif
+
   // Always delete the temporary file. We never want it to stay around.
-  if (!this->TempName.empty()) {
-    cmSystemTools::RemoveFile(this->TempName);
+  if (!tempName.empty()) {
+    cmSystemTools::RemoveFile(tempName);
   }
 
   return replaced;
@@ -239,10 +378,57 @@ void cmGeneratedFileStream::SetTempExt(std::string const& ext)
   this->TempExt = ext;
 }
 
+#ifndef CMAKE_BOOTSTRAP
+namespace {
+// Convert data with the facet a file stream would use for the encoding.
+bool ConvertToEncoding(std::string const& data,
+                       cmGeneratedFileStream::Encoding encoding,
+                       std::string& converted)
+{
+  using Facet = std::codecvt<char, char, std::mbstate_t>;
+  std::locale const loc(std::locale::classic(), new codecvt(encoding));
+  Facet const& facet = std::use_facet<Facet>(loc);
+  if (facet.always_noconv()) {
+    converted = data;
+    return true;
+  }
+
+  std::size_t const maxLength = static_cast<std::size_t>(facet.max_length());
+  converted.assign((data.size() + 1) * maxLength, '\0');
+  std::mbstate_t state = std::mbstate_t();
+  char const* const from = data.data();
+  char const* fromNext = from;
+  char* const to = &converted[0];
+  char* const toEnd = to + converted.size();
+  char* toNext = to;
+  std::codecvt_base::result result = facet.out(
+    state, from, from + data.size(), fromNext, to, toEnd, toNext);
+  if (result == std::codecvt_base::ok) {
+    result = facet.unshift(state, toNext, toEnd, toNext);
+  }
+  converted.resize(static_cast<std::size_t>(toNext - to));
+  return result == std::codecvt_base::ok ||
+    result == std::codecvt_base::noconv;
+}
+}
+#endif
+
 void cmGeneratedFileStream::WriteAltEncoding(std::string const& data,
                                              Encoding encoding)
 {
 #ifndef CMAKE_BOOTSTRAP
+  if (this->InMemory) {
+    // A string buffer does not convert what is written to it, and its
+    // content is written to the file unchanged, so convert it here.
+    std::string converted;
+    if (!ConvertToEncoding(data, encoding, converted)) {
+      this->setstate(std::ios::failbit);
+      return;
+    }
+    this->write(converted.data(),
+                static_cast<std::streamsize>(converted.size()));
+    return;
+  }
   std::locale prevLocale =
     this->imbue(std::locale(this->getloc(), new codecvt(encoding)));
   this->write(data.data(), data.size());
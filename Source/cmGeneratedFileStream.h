@@ -4,17 +4,36 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <functional>
+#include <sstream>
 #include <string>
 
 #include "cmsys/FStream.hxx"
 
 #include "cm_codecvt.hxx"
 
+class cmGeneratedFileHashes;
+
 // This is the first base class of cmGeneratedFileStream.  It will be
 // created before and destroyed after the ofstream portion and can
 // therefore be used to manage the temporary file.
 class cmGeneratedFileStreamBase
 {
+public:
+  // Set a function to be told the name of every destination file that is
+  // closed without error, or clear it with an empty function.  Used to
+  // record the files written by a run.  Must not be changed while files
+  // are being written.
+  using CloseCallback = std::function<void(std::string const&)>;
+  static void SetCloseCallback(CloseCallback callback);
+
+  // Set the record of generated file contents, or clear it with null.
+  // While it is set, streams without an encoding keep their content in
+  // memory and skip unchanged copy-if-different files without touching
+  // the disk.  Must not be changed while files are being written.
+  static void SetContentHashes(cmGeneratedFileHashes* hashes);
+  static cmGeneratedFileHashes* GetContentHashes();
+
 protected:
   // This constructor does not prepare the temporary file.  The open
   // method must be used.
@@ -33,11 +52,25 @@ protected:
   void Open(std::string const& name);
   bool Close();
 
+  // Write the content kept in memory to the temporary file, unless the
+  // destination is known to hold it already.  Returns whether the
+  // temporary file was written.
+  bool WriteMemoryContent(std::string const& destName);
+
+  // Replace the destination with a closed temporary file, unless only
+  // a changed file should be copied and it did not change.  Always
+  // removes the temporary file.  Returns whether it replaced the file.
+  static bool CommitTempFile(std::string const& tempName,
+                             std::string const& destName,
+                             bool copyIfDifferent, bool compress);
+
   // Internal file replacement implementation.
-  int RenameFile(std::string const& oldname, std::string const& newname);
+  static int RenameFile(std::string const& oldname,
+                        std::string const& newname);
 
   // Internal file compression implementation.
-  int CompressFile(std::string const& oldname, std::string const& newname);
+  static int CompressFile(std::string const& oldname,
+                          std::string const& newname);
 
   // The name of the final destination file for the output.
   std::string Name;
@@ -59,6 +92,21 @@ protected:
 
   // Whether the destination file is compressed
   bool CompressExtraExtension = true;
+
+  // Whether the content is kept in memory until the stream is closed.
+  bool InMemory = false;
+
+  // Whether the temporary file is written in binary mode.
+  bool BinaryMode = false;
+
+  // Whether errors writing the temporary file are not reported.
+  bool Quiet = false;
+
+  // Whether the stream converts its content to an encoding.
+  bool Encoded = false;
+
+  // The content of an in-memory stream.
+  std::stringbuf MemoryContent;
 };
 
 /** \class cmGeneratedFileStream
@@ -149,7 +197,13 @@ public:
 
   /**
    * Write a specific string using an alternate encoding.
-   * Afterward, the original encoding is restored.
+   * Afterward, the original encoding is restored.  A stream that writes to
+   * memory stores the converted bytes.
    */
   void WriteAltEncoding(std::string const& data, Encoding encoding);
+
+private:
+  // Open the temporary file, or write to memory while content hashes
+  // are recorded.
+  void OpenTempFile();
 };
@@ -3,8 +3,18 @@
 #include "cmGeneratorExpression.h"
 
 #include <cassert>
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+#include <cm/memory>
+#include <cm/optional>
+#include <cm/string_view>
 
 #include "cmsys/RegularExpression.hxx"
 
@@ -13,8 +23,180 @@
 #include "cmGeneratorExpressionEvaluator.h"
 #include "cmGeneratorExpressionLexer.h"
 #include "cmGeneratorExpressionParser.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
+#include "cmMessenger.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
+
+/** The lowered form of one input string.  It does not depend on where the
+    string appeared, so compiled expressions with equal input may share it.
+    Its evaluators refer to its own copy of the input.  */
+struct cmCompiledGeneratorExpression::Program
+{
+  Program(std::string input, bool fold);
+
+  std::string const Input;
+  cmGeneratorExpressionEvaluatorVector Evaluators;
+  bool NeedsEvaluation = false;
+
+  // The value of the whole expression if it is the same in every context.
+  cm::optional<std::string> Constant;
+};
+
+cmCompiledGeneratorExpression::Program::Program(std::string input, bool fold)
+  : Input(std::move(input))
+{
+  cmGeneratorExpressionLexer l;
+  std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(this->Input);
+  this->NeedsEvaluation = l.GetSawGeneratorExpression();
+
+  if (this->NeedsEvaluation) {
+    cmGeneratorExpressionParser p(tokens);
+    p.Parse(this->Evaluators);
+    if (!fold) {
+      return;
+    }
+    cmLowerGeneratorExpression(this->Evaluators);
+    if (this->Evaluators.empty()) {
+      this->Constant = std::string();
+    } else if (this->Evaluators.size() == 1) {
+      if (cm::optional<cm::string_view> value =
+            this->Evaluators.front()->GetConstantValue()) {
+        this->Constant = std::string(*value);
+      }
+    }
+  }
+}
+
+struct cmGeneratorExpressionCache::Data
+{
+  using Program = cmCompiledGeneratorExpression::Program;
+
+  // Everything that determines the result of an evaluation.  The DAG
+  // checker chain is empty when evaluating without a DAG checker.
+  struct ResultKey
+  {
+    Program const* Code;
+    cmLocalGenerator* LG;
+    std::string Config;
+    cmGeneratorTarget const* HeadTarget;
+    cmGeneratorTarget const* CurrentTarget;
+    std::string Language;
+    bool Quiet;
+    bool EvaluateForBuildsystem;
+    cmGeneratorExpressionDAGChecker::Chain DAGChain;
+    std::size_t Hash;
+
+    bool operator==(ResultKey const& r) const
+    {
+      return std::tie(this->Hash, this->Code, this->LG, this->Config,
+                      this->HeadTarget, this->CurrentTarget, this->Language,
+                      this->Quiet, this->EvaluateForBuildsystem,
+                      this->DAGChain) ==
+        std::tie(r.Hash, r.Code, r.LG, r.Config, r.HeadTarget,
+                 r.CurrentTarget, r.Language, r.Quiet,
+                 r.EvaluateForBuildsystem, r.DAGChain);
+    }
+  };
+  struct ResultKeyHash
+  {
+    std::size_t operator()(ResultKey const& key) const { return key.Hash; }
+  };
+
+  // An evaluation result and what the evaluation recorded.
+  struct Result
+  {
+    std::string Output;
+    std::set<cmGeneratorTarget*> DependTargets;
+    std::set<cmGeneratorTarget const*> AllTargetsSeen;
+    std::set<std::string> SeenTargetProperties;
+    std::map<cmGeneratorTarget const*, std::map<std::string, std::string>>
+      MaxLanguageStandard;
+    std::set<cmGeneratorTarget const*> SourceSensitiveTargets;
+    bool HadContextSensitiveCondition;
+    bool HadHeadSensitiveCondition;
+    bool HadLinkLanguageSensitiveCondition;
+    std::vector<cmGeneratorExpressionDAGChecker::SeenProperty> DAGSeen;
+  };
+
+  // Programs stay here until cleared, so the address of a program is not
+  // reused while results for it are stored.  Stored results are never
+  // replaced before then either, so references to them may be returned
+  // after releasing the mutex.
+  std::mutex Mutex;
+  std::unordered_map<cm::string_view, std::shared_ptr<Program>> Programs;
+  bool Folding = true;
+  bool ResultsEnabled = false;
+  std::unordered_map<ResultKey, Result, ResultKeyHash> Results;
+};
+
+cmGeneratorExpressionCache::cmGeneratorExpressionCache()
+  : Cache(cm::make_unique<Data>())
+{
+}
+
+cmGeneratorExpressionCache::~cmGeneratorExpressionCache() = default;
+
+void cmGeneratorExpressionCache::EnableResults()
+{
+  std::lock_guard<std::mutex> lock(this->Cache->Mutex);
+  this->Cache->ResultsEnabled = true;
+}
+
+bool cmGeneratorExpressionCache::GetResultsEnabled() const
+{
+  std::lock_guard<std::mutex> lock(this->Cache->Mutex);
+  return this->Cache->ResultsEnabled;
+}
+
+void cmGeneratorExpressionCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->Cache->Mutex);
+  this->Cache->ResultsEnabled = false;
+  this->Cache->Results.clear();
+  this->Cache->Programs.clear();
+}
+
+void cmGeneratorExpressionCache::SetFolding(bool folding)
+{
+  std::lock_guard<std::mutex> lock(this->Cache->Mutex);
+  this->Cache->Folding = folding;
+  this->Cache->Results.clear();
+  this->Cache->Programs.clear();
+}
+
+std::size_t cmGeneratorExpressionCache::GetProgramCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Cache->Mutex);
+  return this->Cache->Programs.size();
+}
+
+std::size_t cmGeneratorExpressionCache::GetResultCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Cache->Mutex);
+  return this->Cache->Results.size();
+}
+
+std::shared_ptr<cmCompiledGeneratorExpression::Program>
+cmGeneratorExpressionCache::GetProgram(std::string const& input)
+{
+  bool fold;
+  {
+    std::lock_guard<std::mutex> lock(this->Cache->Mutex);
+    auto it = this->Cache->Programs.find(input);
+    if (it != this->Cache->Programs.end()) {
+      return it->second;
+    }
+    fold = this->Cache->Folding;
+  }
+
+  auto program = std::make_shared<Data::Program>(input, fold);
+  std::lock_guard<std::mutex> lock(this->Cache->Mutex);
+  return this->Cache->Programs.emplace(program->Input, program)
+    .first->second;
+}
 
 cmGeneratorExpression::cmGeneratorExpression(cmListFileBacktrace backtrace)
   : Backtrace(std::move(backtrace))
@@ -52,25 +234,133 @@ const std::string& cmCompiledGeneratorExpression::Evaluate(
   cmGeneratorExpressionDAGChecker* dagChecker,
   const cmGeneratorTarget* currentTarget, std::string const& language) const
 {
+  // Share the program of equal inputs compiled for the same global
+  // generator.
+  cmGeneratorExpressionCache* cache =
+    lg ? &lg->GetGlobalGenerator()->GetGeneratorExpressionCache() : nullptr;
+  if (cache) {
+    this->Code = cache->GetProgram(this->Input);
+  } else if (!this->Code) {
+    this->Code = std::make_shared<Program>(this->Input, true);
+  }
+  Program const& code = *this->Code;
+  if (!code.NeedsEvaluation) {
+    return code.Input;
+  }
+  if (code.Constant) {
+    this->DependTargets.clear();
+    this->AllTargetsSeen.clear();
+    this->MaxLanguageStandard.clear();
+    this->HadContextSensitiveCondition = false;
+    this->HadHeadSensitiveCondition = false;
+    this->HadLinkLanguageSensitiveCondition = false;
+    this->SourceSensitiveTargets.clear();
+    return *code.Constant;
+  }
+
+  if (!currentTarget) {
+    currentTarget = headTarget;
+  }
   cmGeneratorExpressionContext context(
-    lg, config, this->Quiet, headTarget,
-    currentTarget ? currentTarget : headTarget, this->EvaluateForBuildsystem,
-    this->Backtrace, language);
+    lg, config, this->Quiet, headTarget, currentTarget,
+    this->EvaluateForBuildsystem, this->Backtrace, language);
 
-  return this->EvaluateWithContext(context, dagChecker);
+  // Results may be reused only while targets cannot change.
+  if (!cache || !cache->GetResultsEnabled()) {
+    return this->EvaluateWithContext(context, dagChecker);
+  }
+  using Data = cmGeneratorExpressionCache::Data;
+  Data& data = *cache->Cache;
+  Data::ResultKey key{ &code,
+                       lg,
+                       config,
+                       headTarget,
+                       currentTarget,
+                       language,
+                       this->Quiet,
+                       this->EvaluateForBuildsystem,
+                       {},
+                       0 };
+  std::size_t& hash = key.Hash;
+  hash = std::hash<std::string>{}(config) ^ std::hash<std::string>{}(language);
+  hash = hash * 1000003 ^ std::hash<void const*>{}(&code);
+  hash = hash * 1000003 ^ std::hash<void const*>{}(headTarget);
+  hash = hash * 1000003 ^ std::hash<void const*>{}(currentTarget);
+  if (dagChecker) {
+    key.DAGChain = dagChecker->GetChain();
+    hash = hash * 1000003 ^ dagChecker->GetChainHash();
+  }
+  Data::Result const* found = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(data.Mutex);
+    auto it = data.Results.find(key);
+    if (it != data.Results.end()) {
+      found = &it->second;
+    }
+  }
+  if (found && (!dagChecker || dagChecker->MarkSeen(found->DAGSeen))) {
+    Data::Result const& result = *found;
+    this->SeenTargetProperties.insert(result.SeenTargetProperties.cbegin(),
+                                      result.SeenTargetProperties.cend());
+    this->MaxLanguageStandard = result.MaxLanguageStandard;
+    this->HadContextSensitiveCondition = result.HadContextSensitiveCondition;
+    this->HadHeadSensitiveCondition = result.HadHeadSensitiveCondition;
+    this->HadLinkLanguageSensitiveCondition =
+      result.HadLinkLanguageSensitiveCondition;
+    this->SourceSensitiveTargets = result.SourceSensitiveTargets;
+    this->DependTargets = result.DependTargets;
+    this->AllTargetsSeen = result.AllTargetsSeen;
+    return result.Output;
+  }
+
+  // Do not memoize evaluations that reported anything, or whose result
+  // depends on what else has been evaluated under the same DAG checker.
+  cmMessenger const* messenger = lg->GetCMakeInstance()->GetMessenger();
+  std::size_t const messages = messenger->GetIssuedMessageCount();
+  std::size_t const alreadySeen =
+    dagChecker ? dagChecker->GetAlreadySeenCount() : 0;
+  std::size_t const seen = dagChecker ? dagChecker->GetSeenCount() : 0;
+
+  std::string const& output = this->EvaluateWithContext(context, dagChecker);
+
+  if (!context.HadError &&
+      messages == messenger->GetIssuedMessageCount() &&
+      alreadySeen == (dagChecker ? dagChecker->GetAlreadySeenCount() : 0)) {
+    Data::Result result{ output,
+                         context.DependTargets,
+                         context.AllTargets,
+                         context.SeenTargetProperties,
+                         context.MaxLanguageStandard,
+                         context.SourceSensitiveTargets,
+                         context.HadContextSensitiveCondition,
+                         context.HadHeadSensitiveCondition,
+                         context.HadLinkLanguageSensitiveCondition,
+                         {} };
+    if (dagChecker) {
+      result.DAGSeen = dagChecker->GetSeenSince(seen);
+    }
+    std::lock_guard<std::mutex> lock(data.Mutex);
+    // The cache may have been cleared while evaluating.
+    auto it = data.Programs.find(code.Input);
+    if (data.ResultsEnabled && it != data.Programs.end() &&
+        it->second.get() == &code) {
+      data.Results.emplace(std::move(key), std::move(result));
+    }
+  }
+  return output;
 }
 
 const std::string& cmCompiledGeneratorExpression::EvaluateWithContext(
   cmGeneratorExpressionContext& context,
   cmGeneratorExpressionDAGChecker* dagChecker) const
 {
-  if (!this->NeedsEvaluation) {
-    return this->Input;
+  if (!this->Code->NeedsEvaluation) {
+    return this->Code->Input;
   }
 
   this->Output.clear();
 
-  for (const auto& it : this->Evaluators) {
+  for (const auto& it : this->Code->Evaluators) {
     this->Output += it->Evaluate(&context, dagChecker);
 
     this->SeenTargetProperties.insert(context.SeenTargetProperties.cbegin(),
@@ -101,13 +391,10 @@ cmCompiledGeneratorExpression::cmCompiledGeneratorExpression(
   : Backtrace(std::move(backtrace))
   , Input(std::move(input))
 {
-  cmGeneratorExpressionLexer l;
-  std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(this->Input);
-  this->NeedsEvaluation = l.GetSawGeneratorExpression();
-
-  if (this->NeedsEvaluation) {
-    cmGeneratorExpressionParser p(tokens);
-    p.Parse(this->Evaluators);
+  // Strings without generator expressions are cheap to compile and too
+  // numerous to share.  Others are compiled when first evaluated.
+  if (cmGeneratorExpression::Find(this->Input) == std::string::npos) {
+    this->Code = std::make_shared<Program>(this->Input, true);
   }
 }
 
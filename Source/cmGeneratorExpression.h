@@ -4,6 +4,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <set>
@@ -18,7 +19,6 @@ class cmGeneratorTarget;
 class cmLocalGenerator;
 struct cmGeneratorExpressionContext;
 struct cmGeneratorExpressionDAGChecker;
-struct cmGeneratorExpressionEvaluator;
 
 /** \class cmGeneratorExpression
  * \brief Evaluate generate-time query expression syntax.
@@ -148,6 +148,8 @@ public:
                               std::map<std::string, std::string>& mapping);
 
 private:
+  struct Program;
+
   const std::string& EvaluateWithContext(
     cmGeneratorExpressionContext& context,
     cmGeneratorExpressionDAGChecker* dagChecker) const;
@@ -156,11 +158,11 @@ private:
                                 std::string input);
 
   friend class cmGeneratorExpression;
+  friend class cmGeneratorExpressionCache;
 
   cmListFileBacktrace Backtrace;
-  std::vector<std::unique_ptr<cmGeneratorExpressionEvaluator>> Evaluators;
   const std::string Input;
-  bool NeedsEvaluation;
+  mutable std::shared_ptr<Program> Code;
   bool EvaluateForBuildsystem = false;
   bool Quiet = false;
 
@@ -177,6 +179,50 @@ private:
   mutable std::set<cmGeneratorTarget const*> SourceSensitiveTargets;
 };
 
+/** \class cmGeneratorExpressionCache
+ * \brief Compiled generator expressions shared within a global generator.
+ *
+ * Compiled expressions with equal input evaluated for the same global
+ * generator share one program.  Once results are enabled, when targets no
+ * longer change, the result of each evaluation is remembered per program
+ * and evaluation context.  The global generator clears everything
+ * together with the targets and local generators the results refer to.
+ */
+class cmGeneratorExpressionCache
+{
+public:
+  cmGeneratorExpressionCache();
+  ~cmGeneratorExpressionCache();
+
+  cmGeneratorExpressionCache(cmGeneratorExpressionCache const&) = delete;
+  cmGeneratorExpressionCache& operator=(cmGeneratorExpressionCache const&) =
+    delete;
+
+  /** Remember evaluation results from now on until cleared.  */
+  void EnableResults();
+  bool GetResultsEnabled() const;
+
+  /** Forget all programs and results, and stop remembering results.  */
+  void Clear();
+
+  /** Whether new programs fold context independent parts into constants.
+      Folding is on by default.  Changing it forgets all programs and
+      results.  */
+  void SetFolding(bool folding);
+
+  std::size_t GetProgramCount() const;
+  std::size_t GetResultCount() const;
+
+private:
+  friend class cmCompiledGeneratorExpression;
+
+  std::shared_ptr<cmCompiledGeneratorExpression::Program> GetProgram(
+    std::string const& input);
+
+  struct Data;
+  std::unique_ptr<Data> Cache;
+};
+
 class cmGeneratorExpressionInterpreter
 {
 public:
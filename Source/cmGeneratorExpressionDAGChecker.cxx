@@ -3,6 +3,7 @@
 #include "cmGeneratorExpressionDAGChecker.h"
 
 #include <cstring>
+#include <functional>
 #include <sstream>
 #include <utility>
 
@@ -62,10 +63,12 @@ void cmGeneratorExpressionDAGChecker::Initialize()
       const std::set<std::string>& propSet = it->second;
       if (propSet.find(this->Property) != propSet.end()) {
         this->CheckResult = ALREADY_SEEN;
+        ++top->AlreadySeen;
         return;
       }
     }
     top->Seen[this->Target].insert(this->Property);
+    top->SeenLog.emplace_back(this->Target, this->Property);
   }
 }
 
@@ -218,6 +221,61 @@ cmGeneratorTarget const* cmGeneratorExpressionDAGChecker::TopTarget() const
   return this->Top()->Target;
 }
 
+cmGeneratorExpressionDAGChecker::Chain
+cmGeneratorExpressionDAGChecker::GetChain() const
+{
+  Chain chain;
+  for (cmGeneratorExpressionDAGChecker const* checker = this; checker;
+       checker = checker->Parent) {
+    chain.emplace_back(checker->Target, checker->GetPropertyAtom(),
+                       checker->TransitivePropertiesOnly);
+  }
+  return chain;
+}
+
+std::size_t cmGeneratorExpressionDAGChecker::GetChainHash() const
+{
+  if (this->ChainHash == 0) {
+    std::size_t hash = this->Parent ? this->Parent->GetChainHash() : 0;
+    hash = hash * 1000003 ^ std::hash<void const*>{}(this->Target);
+    hash = hash * 1000003 ^ this->GetPropertyAtom().GetHash();
+    this->ChainHash = hash;
+  }
+  return this->ChainHash;
+}
+
+cmAtom cmGeneratorExpressionDAGChecker::GetPropertyAtom() const
+{
+  if (!this->PropertyAtom) {
+    this->PropertyAtom = cmAtom(this->Property);
+  }
+  return *this->PropertyAtom;
+}
+
+std::vector<cmGeneratorExpressionDAGChecker::SeenProperty>
+cmGeneratorExpressionDAGChecker::GetSeenSince(std::size_t count) const
+{
+  std::vector<SeenProperty> const& log = this->Top()->SeenLog;
+  return std::vector<SeenProperty>(log.begin() + count, log.end());
+}
+
+bool cmGeneratorExpressionDAGChecker::MarkSeen(
+  std::vector<SeenProperty> const& properties) const
+{
+  const auto* top = this->Top();
+  for (SeenProperty const& p : properties) {
+    auto it = top->Seen.find(p.first);
+    if (it != top->Seen.end() && it->second.count(p.second)) {
+      return false;
+    }
+  }
+  for (SeenProperty const& p : properties) {
+    top->Seen[p.first].insert(p.second);
+    top->SeenLog.push_back(p);
+  }
+  return true;
+}
+
 enum TransitiveProperty
 {
 #define DEFINE_ENUM_ENTRY(NAME) NAME,
@@ -4,10 +4,17 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <map>
 #include <set>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
+#include <cm/optional>
+
+#include "cmAtom.h"
 #include "cmListFileCache.h"
 
 struct GeneratorExpressionContent;
@@ -92,6 +99,29 @@ struct cmGeneratorExpressionDAGChecker
   cmGeneratorExpressionDAGChecker const* Top() const;
   cmGeneratorTarget const* TopTarget() const;
 
+  // The target, property and transitive-only flag of each checker from
+  // this one up to the top.  Checkers with equal chains answer every query
+  // alike, except for ALREADY_SEEN results that depend on what else has
+  // been evaluated below the top.
+  using Chain =
+    std::vector<std::tuple<cmGeneratorTarget const*, cmAtom, bool>>;
+  Chain GetChain() const;
+
+  // A hash of the targets and properties in the chain.
+  std::size_t GetChainHash() const;
+
+  // The transitive properties recorded as seen below the top, in order.
+  using SeenProperty = std::pair<cmGeneratorTarget const*, std::string>;
+  std::size_t GetSeenCount() const { return this->Top()->SeenLog.size(); }
+  std::vector<SeenProperty> GetSeenSince(std::size_t count) const;
+
+  // The number of ALREADY_SEEN results below the top.
+  std::size_t GetAlreadySeenCount() const { return this->Top()->AlreadySeen; }
+
+  // Record properties as seen below the top, as a repeated evaluation
+  // would have, unless one of them has been seen already.
+  bool MarkSeen(std::vector<SeenProperty> const& properties) const;
+
 private:
   Result CheckGraph() const;
   void Initialize();
@@ -100,6 +130,12 @@ private:
   cmGeneratorTarget const* Target;
   const std::string Property;
   mutable std::map<cmGeneratorTarget const*, std::set<std::string>> Seen;
+  cmAtom GetPropertyAtom() const;
+
+  mutable cm::optional<cmAtom> PropertyAtom;
+  mutable std::size_t ChainHash = 0;
+  mutable std::vector<SeenProperty> SeenLog;
+  mutable std::size_t AlreadySeen = 0;
   const GeneratorExpressionContent* const Content;
   const cmListFileBacktrace Backtrace;
   Result CheckResult;
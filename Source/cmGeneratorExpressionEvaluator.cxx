@@ -4,8 +4,45 @@
 
 #include <sstream>
 
+#include <cm/memory>
+
 #include "cmGeneratorExpressionContext.h"
 #include "cmGeneratorExpressionNode.h"
+#include "cmListFileCache.h"
+#include "cmStringAlgorithms.h"
+
+void cmLowerGeneratorExpression(
+  cmGeneratorExpressionEvaluatorVector& evaluators)
+{
+  cmGeneratorExpressionEvaluatorVector lowered;
+  lowered.reserve(evaluators.size());
+  for (auto& evaluator : evaluators) {
+    if (evaluator->GetType() == cmGeneratorExpressionEvaluator::Generator &&
+        !evaluator->GetConstantValue()) {
+      cm::optional<std::string> value =
+        static_cast<GeneratorExpressionContent&>(*evaluator).Lower();
+      if (value) {
+        evaluator = cm::make_unique<ConstantContent>(std::move(*value));
+      }
+    }
+    // Adjacent literal text stays as it is, for nodes requiring literal
+    // input.
+    if (!lowered.empty() &&
+        (lowered.back()->GetType() != cmGeneratorExpressionEvaluator::Text ||
+         evaluator->GetType() != cmGeneratorExpressionEvaluator::Text)) {
+      cm::optional<cm::string_view> const last =
+        lowered.back()->GetConstantValue();
+      cm::optional<cm::string_view> const next = evaluator->GetConstantValue();
+      if (last && next) {
+        lowered.back() =
+          cm::make_unique<ConstantContent>(cmStrCat(*last, *next));
+        continue;
+      }
+    }
+    lowered.push_back(std::move(evaluator));
+  }
+  evaluators = std::move(lowered);
+}
 
 GeneratorExpressionContent::GeneratorExpressionContent(
   const char* startContent, size_t length)
@@ -21,6 +58,53 @@ std::string GeneratorExpressionContent::GetOriginalExpression() const
   return std::string(this->StartContent, this->ContentLength);
 }
 
+cm::optional<std::string> GeneratorExpressionContent::Lower()
+{
+  cmLowerGeneratorExpression(this->IdentifierChildren);
+  for (cmGeneratorExpressionEvaluatorVector& param : this->ParamChildren) {
+    cmLowerGeneratorExpression(param);
+  }
+
+  if (this->IdentifierChildren.size() != 1) {
+    return cm::nullopt;
+  }
+  cm::optional<cm::string_view> const identifier =
+    this->IdentifierChildren.front()->GetConstantValue();
+  if (!identifier) {
+    return cm::nullopt;
+  }
+  this->Identifier = std::string(*identifier);
+  this->Node = cmGeneratorExpressionNode::GetNode(this->Identifier);
+  if (!this->Node || !this->Node->IsContextIndependent()) {
+    return cm::nullopt;
+  }
+
+  // Parameters of nodes like $<0:...> are never evaluated, so they need
+  // not be constant.
+  if (this->Node->GeneratesContent() ||
+      this->Node->NumExpectedParameters() != 1 ||
+      !this->Node->AcceptsArbitraryContentParameter()) {
+    for (cmGeneratorExpressionEvaluatorVector const& param :
+         this->ParamChildren) {
+      for (auto const& pExprEval : param) {
+        if (!pExprEval->GetConstantValue()) {
+          return cm::nullopt;
+        }
+      }
+    }
+  }
+
+  // Evaluate quietly, leaving any error to be reported in context.
+  cmGeneratorExpressionContext context(nullptr, std::string(), true, nullptr,
+                                       nullptr, false, cmListFileBacktrace(),
+                                       std::string());
+  std::string value = this->Evaluate(&context, nullptr);
+  if (context.HadError) {
+    return cm::nullopt;
+  }
+  return cm::optional<std::string>(std::move(value));
+}
+
 std::string GeneratorExpressionContent::ProcessArbitraryContent(
   const cmGeneratorExpressionNode* node, const std::string& identifier,
   cmGeneratorExpressionContext* context,
@@ -61,24 +145,27 @@ std::string GeneratorExpressionContent::Evaluate(
   cmGeneratorExpressionContext* context,
   cmGeneratorExpressionDAGChecker* dagChecker) const
 {
-  std::string identifier;
-  {
+  std::string evaluatedIdentifier;
+  const cmGeneratorExpressionNode* node = this->Node;
+  if (!node) {
     for (const auto& pExprEval : this->IdentifierChildren) {
-      identifier += pExprEval->Evaluate(context, dagChecker);
+      evaluatedIdentifier += pExprEval->Evaluate(context, dagChecker);
       if (context->HadError) {
         return std::string();
       }
     }
-  }
 
-  const cmGeneratorExpressionNode* node =
-    cmGeneratorExpressionNode::GetNode(identifier);
+    node = cmGeneratorExpressionNode::GetNode(evaluatedIdentifier);
 
-  if (!node) {
-    reportError(context, this->GetOriginalExpression(),
-                "Expression did not evaluate to a known generator expression");
-    return std::string();
+    if (!node) {
+      reportError(
+        context, this->GetOriginalExpression(),
+        "Expression did not evaluate to a known generator expression");
+      return std::string();
+    }
   }
+  std::string const& identifier =
+    this->Node ? this->Identifier : evaluatedIdentifier;
 
   if (!node->GeneratesContent()) {
     if (node->NumExpectedParameters() == 1 &&
@@ -10,6 +10,9 @@
 #include <utility>
 #include <vector>
 
+#include <cm/optional>
+#include <cm/string_view>
+
 struct cmGeneratorExpressionContext;
 struct cmGeneratorExpressionDAGChecker;
 struct cmGeneratorExpressionNode;
@@ -34,11 +37,24 @@ struct cmGeneratorExpressionEvaluator
 
   virtual std::string Evaluate(cmGeneratorExpressionContext* context,
                                cmGeneratorExpressionDAGChecker*) const = 0;
+
+  // The value this evaluates to in every context, if known.
+  virtual cm::optional<cm::string_view> GetConstantValue() const
+  {
+    return cm::nullopt;
+  }
 };
 
 using cmGeneratorExpressionEvaluatorVector =
   std::vector<std::unique_ptr<cmGeneratorExpressionEvaluator>>;
 
+/** Prepare parsed evaluators for repeated evaluation.  Node identifiers
+    are looked up once, sub-expressions whose value cannot depend on the
+    evaluation context are replaced by their value, and adjacent constant
+    evaluators are merged.  */
+void cmLowerGeneratorExpression(
+  cmGeneratorExpressionEvaluatorVector& evaluators);
+
 struct TextContent : public cmGeneratorExpressionEvaluator
 {
   TextContent(const char* start, size_t length)
@@ -58,6 +74,11 @@ struct TextContent : public cmGeneratorExpressionEvaluator
     return cmGeneratorExpressionEvaluator::Text;
   }
 
+  cm::optional<cm::string_view> GetConstantValue() const override
+  {
+    return cm::string_view(this->Content, this->Length);
+  }
+
   void Extend(size_t length) { this->Length += length; }
 
   size_t GetLength() const { return this->Length; }
@@ -67,6 +88,36 @@ private:
   size_t Length;
 };
 
+// The folded value of generator expressions independent of their context.
+// It still reports the Generator type so that nodes requiring literal input
+// diagnose it as before.
+struct ConstantContent : public cmGeneratorExpressionEvaluator
+{
+  explicit ConstantContent(std::string value)
+    : Value(std::move(value))
+  {
+  }
+
+  std::string Evaluate(cmGeneratorExpressionContext*,
+                       cmGeneratorExpressionDAGChecker*) const override
+  {
+    return this->Value;
+  }
+
+  Type GetType() const override
+  {
+    return cmGeneratorExpressionEvaluator::Generator;
+  }
+
+  cm::optional<cm::string_view> GetConstantValue() const override
+  {
+    return cm::string_view(this->Value);
+  }
+
+private:
+  std::string Value;
+};
+
 struct GeneratorExpressionContent : public cmGeneratorExpressionEvaluator
 {
   GeneratorExpressionContent(const char* startContent, size_t length);
@@ -92,6 +143,10 @@ struct GeneratorExpressionContent : public cmGeneratorExpressionEvaluator
 
   std::string GetOriginalExpression() const;
 
+  // Lower the children and return the value of this expression if it is
+  // the same in every context.
+  cm::optional<std::string> Lower();
+
   ~GeneratorExpressionContent() override;
 
 private:
@@ -110,6 +165,9 @@ private:
 
   cmGeneratorExpressionEvaluatorVector IdentifierChildren;
   std::vector<cmGeneratorExpressionEvaluatorVector> ParamChildren;
+  // The node named by a constant identifier, found when lowering.
+  std::string Identifier;
+  const cmGeneratorExpressionNode* Node = nullptr;
   const char* StartContent;
   size_t ContentLength;
 };
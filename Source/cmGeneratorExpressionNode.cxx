@@ -80,6 +80,8 @@ static const struct ZeroNode : public cmGeneratorExpressionNode
 {
   ZeroNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   bool GeneratesContent() const override { return false; }
 
   bool AcceptsArbitraryContentParameter() const override { return true; }
@@ -98,6 +100,8 @@ static const struct OneNode : public cmGeneratorExpressionNode
 {
   OneNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -126,6 +130,8 @@ struct BooleanOpNode : public cmGeneratorExpressionNode
 
   int NumExpectedParameters() const override { return OneOrMoreParameters; }
 
+  bool IsContextIndependent() const override { return true; }
+
   std::string Evaluate(const std::vector<std::string>& parameters,
                        cmGeneratorExpressionContext* context,
                        const GeneratorExpressionContent* content,
@@ -155,6 +161,8 @@ static const struct NotNode : public cmGeneratorExpressionNode
 {
   NotNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   std::string Evaluate(
     const std::vector<std::string>& parameters,
     cmGeneratorExpressionContext* context,
@@ -175,6 +183,8 @@ static const struct BoolNode : public cmGeneratorExpressionNode
 {
   BoolNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 1; }
 
   std::string Evaluate(
@@ -191,6 +201,8 @@ static const struct IfNode : public cmGeneratorExpressionNode
 {
   IfNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 3; }
 
   std::string Evaluate(const std::vector<std::string>& parameters,
@@ -212,6 +224,8 @@ static const struct StrEqualNode : public cmGeneratorExpressionNode
 {
   StrEqualNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -228,6 +242,8 @@ static const struct EqualNode : public cmGeneratorExpressionNode
 {
   EqualNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -329,6 +345,8 @@ static const struct FilterNode : public cmGeneratorExpressionNode
 {
   FilterNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 3; }
 
   std::string Evaluate(
@@ -375,6 +393,8 @@ static const struct RemoveDuplicatesNode : public cmGeneratorExpressionNode
 {
   RemoveDuplicatesNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 1; }
 
   std::string Evaluate(
@@ -574,6 +594,8 @@ static const struct LowerCaseNode : public cmGeneratorExpressionNode
 {
   LowerCaseNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -590,6 +612,8 @@ static const struct UpperCaseNode : public cmGeneratorExpressionNode
 {
   UpperCaseNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -676,6 +700,8 @@ static const struct PathNode : public cmGeneratorExpressionNode
 {
   PathNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return TwoOrMoreParameters; }
 
   bool AcceptsArbitraryContentParameter() const override { return true; }
@@ -1038,6 +1064,8 @@ static const struct PathEqualNode : public cmGeneratorExpressionNode
 {
   PathEqualNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -1055,6 +1083,8 @@ static const struct MakeCIdentifierNode : public cmGeneratorExpressionNode
 {
   MakeCIdentifierNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -1072,6 +1102,8 @@ struct CharacterNode : public cmGeneratorExpressionNode
 {
   CharacterNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 0; }
 
   std::string Evaluate(
@@ -1274,6 +1306,8 @@ struct VersionNode : public cmGeneratorExpressionNode
 {
   VersionNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -1397,6 +1431,8 @@ static const struct JoinNode : public cmGeneratorExpressionNode
 {
   JoinNode() {} // NOLINT(modernize-use-equals-default)
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   bool AcceptsArbitraryContentParameter() const override { return true; }
@@ -33,6 +33,10 @@ struct cmGeneratorExpressionNode
 
   virtual int NumExpectedParameters() const { return 1; }
 
+  // Whether the result depends only on the parameters.  Such expressions
+  // are folded to constants when compiled if their parameters are constant.
+  virtual bool IsContextIndependent() const { return false; }
+
   virtual std::string Evaluate(
     const std::vector<std::string>& parameters,
     cmGeneratorExpressionContext* context,
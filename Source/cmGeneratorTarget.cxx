@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <iterator>
+#include <mutex>
 #include <queue>
 #include <sstream>
 #include <unordered_set>
@@ -391,6 +392,11 @@ cmValue cmGeneratorTarget::GetSourcesProperty() const
   return cmValue(value);
 }
 
+std::recursive_mutex& cmGeneratorTarget::GetTargetEvaluationMutex() const
+{
+  return this->GlobalGenerator->GetTargetEvaluationMutex();
+}
+
 cmGlobalGenerator* cmGeneratorTarget::GetGlobalGenerator() const
 {
   return this->GetLocalGenerator()->GetGlobalGenerator();
@@ -746,6 +752,7 @@ void cmGeneratorTarget::ClearLinkInterfaceCache()
 {
   this->LinkInterfaceMap.clear();
   this->LinkInterfaceUsageRequirementsOnlyMap.clear();
+  this->LocalGenerator->GetGlobalGenerator()->ClearLinkInterfaceMemos();
 }
 
 void cmGeneratorTarget::AddSourceCommon(const std::string& src, bool before)
@@ -1282,53 +1289,59 @@ bool cmGeneratorTarget::IsSystemIncludeDirectory(
   }
 
   std::string key = cmStrCat(config_upper, "/", language);
-  auto iter = this->SystemIncludesCache.find(key);
+  std::vector<std::string> const& systemIncludes =
+    this->SystemIncludesCache.Get(
+      key, this->GetTargetEvaluationMutex(), [&]() {
+        return this->ComputeSystemIncludeDirectories(config, language);
+      });
 
-  if (iter == this->SystemIncludesCache.end()) {
-    cmGeneratorExpressionDAGChecker dagChecker(
-      this, "SYSTEM_INCLUDE_DIRECTORIES", nullptr, nullptr);
+  return std::binary_search(systemIncludes.begin(), systemIncludes.end(),
+                            dir);
+}
 
-    bool excludeImported = this->GetPropertyAsBool("NO_SYSTEM_FROM_IMPORTED");
+std::vector<std::string> cmGeneratorTarget::ComputeSystemIncludeDirectories(
+  std::string const& config, std::string const& language) const
+{
+  cmGeneratorExpressionDAGChecker dagChecker(
+    this, "SYSTEM_INCLUDE_DIRECTORIES", nullptr, nullptr);
 
-    std::vector<std::string> result;
-    for (std::string const& it : this->Target->GetSystemIncludeDirectories()) {
-      cmExpandList(cmGeneratorExpression::Evaluate(it, this->LocalGenerator,
-                                                   config, this, &dagChecker,
-                                                   nullptr, language),
-                   result);
-    }
+  bool excludeImported = this->GetPropertyAsBool("NO_SYSTEM_FROM_IMPORTED");
 
-    std::vector<cmGeneratorTarget const*> const& deps =
-      this->GetLinkImplementationClosure(config);
-    for (cmGeneratorTarget const* dep : deps) {
-      handleSystemIncludesDep(this->LocalGenerator, dep, config, this,
-                              &dagChecker, result, excludeImported, language);
-    }
-
-    cmLinkImplementation const* impl =
-      this->GetLinkImplementation(config, LinkInterfaceFor::Usage);
-    if (impl != nullptr) {
-      auto runtimeEntries = impl->LanguageRuntimeLibraries.find(language);
-      if (runtimeEntries != impl->LanguageRuntimeLibraries.end()) {
-        for (auto const& lib : runtimeEntries->second) {
-          if (lib.Target) {
-            handleSystemIncludesDep(this->LocalGenerator, lib.Target, config,
-                                    this, &dagChecker, result, excludeImported,
-                                    language);
-          }
+  std::vector<std::string> result;
+  for (std::string const& it : this->Target->GetSystemIncludeDirectories()) {
+    cmExpandList(cmGeneratorExpression::Evaluate(it, this->LocalGenerator,
+                                                 config, this, &dagChecker,
+                                                 nullptr, language),
+                 result);
+  }
+
+  std::vector<cmGeneratorTarget const*> const& deps =
+    this->GetLinkImplementationClosure(config);
+  for (cmGeneratorTarget const* dep : deps) {
+    handleSystemIncludesDep(this->LocalGenerator, dep, config, this,
+                            &dagChecker, result, excludeImported, language);
+  }
+
+  cmLinkImplementation const* impl =
+    this->GetLinkImplementation(config, LinkInterfaceFor::Usage);
+  if (impl != nullptr) {
+    auto runtimeEntries = impl->LanguageRuntimeLibraries.find(language);
+    if (runtimeEntries != impl->LanguageRuntimeLibraries.end()) {
+      for (auto const& lib : runtimeEntries->second) {
+        if (lib.Target) {
+          handleSystemIncludesDep(this->LocalGenerator, lib.Target, config,
+                                  this, &dagChecker, result, excludeImported,
+                                  language);
         }
       }
     }
-
-    std::for_each(result.begin(), result.end(),
-                  cmSystemTools::ConvertToUnixSlashes);
-    std::sort(result.begin(), result.end());
-    result.erase(std::unique(result.begin(), result.end()), result.end());
-
-    iter = this->SystemIncludesCache.emplace(key, result).first;
   }
 
-  return std::binary_search(iter->second.begin(), iter->second.end(), dir);
+  std::for_each(result.begin(), result.end(),
+                cmSystemTools::ConvertToUnixSlashes);
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
 }
 
 bool cmGeneratorTarget::GetPropertyAsBool(const std::string& prop) const
@@ -2356,16 +2369,9 @@ bool cmGeneratorTarget::IsImportedSharedLibWithoutSOName(
 bool cmGeneratorTarget::HasMacOSXRpathInstallNameDir(
   const std::string& config) const
 {
-  TargetPtrToBoolMap& cache = this->MacOSXRpathInstallNameDirCache[config];
-  const auto lookup = cache.find(this->Target);
-
-  if (lookup != cache.cend()) {
-    return lookup->second;
-  }
-
-  const bool result = this->DetermineHasMacOSXRpathInstallNameDir(config);
-  cache[this->Target] = result;
-  return result;
+  return this->MacOSXRpathInstallNameDirCache.Get(
+    config, this->GetTargetEvaluationMutex(),
+    [&]() { return this->DetermineHasMacOSXRpathInstallNameDir(config); });
 }
 
 bool cmGeneratorTarget::DetermineHasMacOSXRpathInstallNameDir(
@@ -3817,6 +3823,9 @@ void processIncludeDirectories(cmGeneratorTarget const* tgt,
 std::vector<BT<std::string>> cmGeneratorTarget::GetIncludeDirectories(
   const std::string& config, const std::string& lang) const
 {
+  // The evaluation fills in lazily computed state of other targets.
+  std::lock_guard<std::recursive_mutex> lock(this->GetTargetEvaluationMutex());
+
   std::vector<BT<std::string>> includes;
   std::unordered_set<std::string> uniqueIncludes;
 
@@ -4155,6 +4164,9 @@ void cmGeneratorTarget::GetCompileDefinitions(
 std::vector<BT<std::string>> cmGeneratorTarget::GetCompileDefinitions(
   std::string const& config, std::string const& language) const
 {
+  // The evaluation fills in lazily computed state of other targets.
+  std::lock_guard<std::recursive_mutex> lock(this->GetTargetEvaluationMutex());
+
   std::vector<BT<std::string>> list;
   std::unordered_set<std::string> uniqueOptions;
 
@@ -6307,22 +6319,25 @@ cmComputeLinkInformation* cmGeneratorTarget::GetLinkInformation(
 {
   // Lookup any existing information for this configuration.
   std::string key(cmSystemTools::UpperCase(config));
-  auto i = this->LinkInformation.find(key);
-  if (i == this->LinkInformation.end()) {
-    // Compute information for this configuration.
-    auto info = cm::make_unique<cmComputeLinkInformation>(this, config);
-    if (info && !info->Compute()) {
-      info.reset();
-    }
-
-    // Store the information for this configuration.
-    i = this->LinkInformation.emplace(key, std::move(info)).first;
+  std::recursive_mutex& mutex = this->GetTargetEvaluationMutex();
+  bool computed = false;
+  std::unique_ptr<cmComputeLinkInformation> const& info =
+    this->LinkInformation.Get(key, mutex, [&]() {
+      // Compute information for this configuration.
+      computed = true;
+      auto result = cm::make_unique<cmComputeLinkInformation>(this, config);
+      if (result && !result->Compute()) {
+        result.reset();
+      }
+      return result;
+    });
 
-    if (i->second) {
-      this->CheckPropertyCompatibility(*i->second, config);
-    }
+  // Check the information once it is stored for this configuration.
+  if (computed && info) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    this->CheckPropertyCompatibility(*info, config);
   }
-  return i->second.get();
+  return info.get();
 }
 
 void cmGeneratorTarget::CheckLinkLibraries() const
@@ -7535,25 +7550,24 @@ cmGeneratorTarget::ImportInfo const* cmGeneratorTarget::GetImportInfo(
     config_upper = "NOCONFIG";
   }
 
-  auto i = this->ImportInfoMap.find(config_upper);
-  if (i == this->ImportInfoMap.end()) {
-    ImportInfo info;
-    this->ComputeImportInfo(config_upper, info);
-    ImportInfoMapType::value_type entry(config_upper, info);
-    i = this->ImportInfoMap.insert(entry).first;
-  }
+  ImportInfo const& info = this->ImportInfoMap.Get(
+    config_upper, this->GetTargetEvaluationMutex(), [&]() {
+      ImportInfo result;
+      this->ComputeImportInfo(config_upper, result);
+      return result;
+    });
 
   if (this->GetType() == cmStateEnums::INTERFACE_LIBRARY) {
-    return &i->second;
+    return &info;
   }
   // If the location is empty then the target is not available for
   // this configuration.
-  if (i->second.Location.empty() && i->second.ImportLibrary.empty()) {
+  if (info.Location.empty() && info.ImportLibrary.empty()) {
     return nullptr;
   }
 
   // Return the import information.
-  return &i->second;
+  return &info;
 }
 
 void cmGeneratorTarget::ComputeImportInfo(std::string const& desired_config,
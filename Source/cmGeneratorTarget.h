@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -19,6 +20,7 @@
 #include "cmAlgorithms.h"
 #include "cmLinkItem.h"
 #include "cmListFileCache.h"
+#include "cmMemoMap.h"
 #include "cmPolicies.h"
 #include "cmStateTypes.h"
 #include "cmValue.h"
@@ -489,7 +491,8 @@ public:
   std::string GetCreateRuleVariable(std::string const& lang,
                                     std::string const& config) const;
 
-  /** Get the include directories for this target.  */
+  /** Get the include directories for this target.  Safe to call from
+      concurrent readers once the targets no longer change.  */
   std::vector<BT<std::string>> GetIncludeDirectories(
     const std::string& config, const std::string& lang) const;
 
@@ -504,6 +507,8 @@ public:
   std::vector<BT<std::string>> GetCompileFeatures(
     std::string const& config) const;
 
+  /** Get the compile definitions for this target.  Safe to call from
+      concurrent readers once the targets no longer change.  */
   void GetCompileDefinitions(std::vector<std::string>& result,
                              const std::string& config,
                              const std::string& language) const;
@@ -898,13 +903,18 @@ private:
   mutable std::map<cmSourceFile const*, std::string> Objects;
   std::set<cmSourceFile const*> ExplicitObjectName;
 
-  using TargetPtrToBoolMap = std::unordered_map<cmTarget*, bool>;
-  mutable std::unordered_map<std::string, TargetPtrToBoolMap>
-    MacOSXRpathInstallNameDirCache;
+  // The caches below are filled lazily, possibly by concurrent readers.
+  // Their values are computed while holding the global generator's
+  // target evaluation mutex.
+  cmMemoMap<std::string, bool> MacOSXRpathInstallNameDirCache;
   bool DetermineHasMacOSXRpathInstallNameDir(const std::string& config) const;
 
+  std::recursive_mutex& GetTargetEvaluationMutex() const;
+  std::vector<std::string> ComputeSystemIncludeDirectories(
+    std::string const& config, std::string const& language) const;
+
   // "config/language" is the key
-  mutable std::map<std::string, std::vector<std::string>> SystemIncludesCache;
+  cmMemoMap<std::string, std::vector<std::string>> SystemIncludesCache;
 
   mutable std::string ExportMacro;
 
@@ -958,9 +968,8 @@ private:
   };
   mutable std::map<std::string, CompatibleInterfaces> CompatibleInterfacesMap;
 
-  using cmTargetLinkInformationMap =
-    std::map<std::string, std::unique_ptr<cmComputeLinkInformation>>;
-  mutable cmTargetLinkInformationMap LinkInformation;
+  cmMemoMap<std::string, std::unique_ptr<cmComputeLinkInformation>>
+    LinkInformation;
 
   void CheckPropertyCompatibility(cmComputeLinkInformation& info,
                                   const std::string& config) const;
@@ -1025,8 +1034,7 @@ private:
     std::string SharedDeps;
   };
 
-  using ImportInfoMapType = std::map<std::string, ImportInfo>;
-  mutable ImportInfoMapType ImportInfoMap;
+  cmMemoMap<std::string, ImportInfo> ImportInfoMap;
   void ComputeImportInfo(std::string const& desired_config,
                          ImportInfo& info) const;
   ImportInfo const* GetImportInfo(const std::string& config) const;
@@ -63,6 +63,10 @@ bool cmGetFilenameComponentCommand(std::vector<std::string> const& args,
       }
     }
 
+    // The program is searched in the PATH, which is not recorded.
+    status.GetMakefile().MarkConfigureVolatile(
+      "get_filename_component(PROGRAM)");
+
     // First assume the path to the program was specified with no
     // arguments and with no quoting or escaping for spaces.
     // Only bother doing this if there is non-whitespace.
@@ -112,6 +116,8 @@ bool cmGetFilenameComponentCommand(std::vector<std::string> const& args,
     if (args[2] == "REALPATH") {
       // Resolve symlinks if possible
       result = cmSystemTools::GetRealPath(result);
+      status.GetMakefile().MarkConfigureVolatile(
+        "get_filename_component(REALPATH)");
     }
   } else {
     std::string err = "unknown component " + args[2];
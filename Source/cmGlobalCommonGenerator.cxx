@@ -5,8 +5,10 @@
 #include <memory>
 #include <utility>
 
+#include <cm/memory>
 #include <cmext/algorithm>
 
+#include "cmCompileCommandsDatabase.h"
 #include "cmGeneratorExpression.h"
 #include "cmGeneratorTarget.h"
 #include "cmLocalGenerator.h"
@@ -14,6 +16,7 @@
 #include "cmStateDirectory.h"
 #include "cmStateSnapshot.h"
 #include "cmStateTypes.h"
+#include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmValue.h"
 #include "cmake.h"
@@ -124,3 +127,31 @@ std::string cmGlobalCommonGenerator::GetEditCacheCommand() const
   cmValue edit_cmd = cm->GetCacheDefinition("CMAKE_EDIT_COMMAND");
   return edit_cmd ? *edit_cmd : std::string();
 }
+
+void cmGlobalCommonGenerator::AddCompactCompileCommand(
+  std::string const& directory, std::string const& command,
+  std::string const& file, std::string const& output)
+{
+  if (!this->CompactCompileCommandsChecked) {
+    this->CompactCompileCommandsChecked = true;
+    if (this->LocalGenerators[0]->GetMakefile()->IsOn(
+          "CMAKE_EXPORT_COMPILE_COMMANDS_BINARY")) {
+      this->CompactCompileCommands =
+        cm::make_unique<cmCompileCommandsDatabase>();
+    }
+  }
+  if (this->CompactCompileCommands) {
+    this->CompactCompileCommands->Add(directory, command, file, output);
+  }
+}
+
+void cmGlobalCommonGenerator::WriteCompactCompileCommands()
+{
+  if (this->CompactCompileCommands) {
+    this->CompactCompileCommands->Write(
+      cmStrCat(this->GetCMakeInstance()->GetHomeOutputDirectory(),
+               "/compile_commands.bin"));
+    this->CompactCompileCommands.reset();
+  }
+  this->CompactCompileCommandsChecked = false;
+}
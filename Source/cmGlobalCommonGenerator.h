@@ -5,12 +5,14 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "cmGlobalGenerator.h"
 
 class cmake;
+class cmCompileCommandsDatabase;
 class cmGeneratorTarget;
 class cmLocalGenerator;
 
@@ -47,4 +49,20 @@ protected:
   virtual bool SupportsDirectConsole() const { return true; }
   const char* GetEditCacheTargetName() const override { return "edit_cache"; }
   std::string GetEditCacheCommand() const override;
+
+  /**
+   * Record an entry of compile_commands.json for the compact database,
+   * if CMAKE_EXPORT_COMPILE_COMMANDS_BINARY is enabled.
+   */
+  void AddCompactCompileCommand(std::string const& directory,
+                                std::string const& command,
+                                std::string const& file,
+                                std::string const& output);
+
+  /** Write the compact database of the recorded compile commands.  */
+  void WriteCompactCompileCommands();
+
+private:
+  std::unique_ptr<cmCompileCommandsDatabase> CompactCompileCommands;
+  bool CompactCompileCommandsChecked = false;
 };
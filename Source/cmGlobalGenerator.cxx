@@ -34,11 +34,13 @@
 #include "cmDuration.h"
 #include "cmExportBuildFileGenerator.h"
 #include "cmExternalMakefileProjectGenerator.h"
+#include "cmFileTime.h"
 #include "cmGeneratedFileStream.h"
 #include "cmGeneratorExpression.h"
 #include "cmGeneratorTarget.h"
 #include "cmInstallGenerator.h"
 #include "cmInstallRuntimeDependencySet.h"
+#include "cmLinkInterfaceMemo.h"
 #include "cmLinkLineComputer.h"
 #include "cmLocalGenerator.h"
 #include "cmMSVC60LinkLineComputer.h"
@@ -52,6 +54,7 @@
 #include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmUnityBuildCostFile.h"
 #include "cmValue.h"
 #include "cmVersion.h"
 #include "cmWorkingDirectory.h"
@@ -83,6 +86,7 @@ bool cmTarget::StrictTargetComparison::operator()(cmTarget const* t1,
 
 cmGlobalGenerator::cmGlobalGenerator(cmake* cm)
   : CMakeInstance(cm)
+  , GeneratorExpressionCache(cm::make_unique<cmGeneratorExpressionCache>())
 {
   // By default the .SYMBOLIC dependency is not needed on symbolic rules.
   this->NeedSymbolicMark = false;
@@ -1593,6 +1597,10 @@ bool cmGlobalGenerator::Compute()
 
 void cmGlobalGenerator::Generate()
 {
+  // Targets are final once computed, so generator expressions evaluated
+  // from here on may reuse earlier results.
+  this->GeneratorExpressionCache->EnableResults();
+
   // Create a map from local generator to the complete set of targets
   // it builds by default.
   this->InitializeProgressMarks();
@@ -1682,9 +1690,12 @@ bool cmGlobalGenerator::ComputeTargetDepends()
   if (!ctd.Compute()) {
     return false;
   }
+  int index = 0;
   for (cmGeneratorTarget const* target : ctd.GetTargets()) {
     ctd.GetTargetDirectDepends(target, this->TargetDependencies[target]);
+    this->TargetDependIndex[target] = index++;
   }
+  this->TargetDependGraph = cmCompactGraph(ctd.GetFinalGraph());
   return true;
 }
 
@@ -1898,6 +1909,9 @@ void cmGlobalGenerator::CreateGeneratorTargets(TargetTypes targetTypes)
 
 void cmGlobalGenerator::ClearGeneratorMembers()
 {
+  // Targets are about to be recreated.
+  this->GeneratorExpressionCache->Clear();
+
   this->BuildExportSets.clear();
 
   this->Makefiles.clear();
@@ -1908,6 +1922,8 @@ void cmGlobalGenerator::ClearGeneratorMembers()
   this->ExportSets.clear();
   this->InstallComponents.clear();
   this->TargetDependencies.clear();
+  this->TargetDependGraph = cmCompactGraph();
+  this->TargetDependIndex.clear();
   this->TargetSearchIndex.clear();
   this->GeneratorTargetSearchIndex.clear();
   this->MakefileSearchIndex.clear();
@@ -1916,8 +1932,10 @@ void cmGlobalGenerator::ClearGeneratorMembers()
   this->ProjectMap.clear();
   this->RuleHashes.clear();
   this->DirectoryContentMap.clear();
+  this->DirectoryContentStats = DirectoryContentStatistics();
   this->BinaryDirectories.clear();
   this->GeneratedFiles.clear();
+  this->LinkInterfaceMemos.clear();
 }
 
 void cmGlobalGenerator::ComputeTargetObjectDirectory(
@@ -3036,6 +3054,13 @@ cmGlobalGenerator::GetTargetDirectDepends(cmGeneratorTarget const* target)
   return this->TargetDependencies[target];
 }
 
+int cmGlobalGenerator::GetTargetDependIndex(
+  cmGeneratorTarget const* target) const
+{
+  auto i = this->TargetDependIndex.find(target);
+  return i != this->TargetDependIndex.end() ? i->second : -1;
+}
+
 bool cmGlobalGenerator::IsReservedTarget(std::string const& name)
 {
   // The following is a list of targets reserved
@@ -3130,6 +3155,9 @@ void cmGlobalGenerator::AddToManifest(std::string const& f)
   DirectoryContent& dc = this->DirectoryContentMap[dir];
   dc.Generated.insert(file);
   dc.All.insert(file);
+#if defined(_WIN32) || defined(__APPLE__)
+  dc.AllLower.insert(cmSystemTools::LowerCase(file));
+#endif
 }
 
 std::set<std::string> const& cmGlobalGenerator::GetDirectoryContent(
@@ -3137,28 +3165,136 @@ std::set<std::string> const& cmGlobalGenerator::GetDirectoryContent(
 {
   DirectoryContent& dc = this->DirectoryContentMap[dir];
   if (needDisk) {
-    long mt = cmSystemTools::ModifiedTime(dir);
-    if (mt != dc.LastDiskTime) {
-      // Reset to non-loaded directory content.
-      dc.All = dc.Generated;
-
-      // Load the directory content from disk.
-      cmsys::Directory d;
-      if (d.Load(dir)) {
-        unsigned long n = d.GetNumberOfFiles();
-        for (unsigned long i = 0; i < n; ++i) {
-          const char* f = d.GetFile(i);
-          if (strcmp(f, ".") != 0 && strcmp(f, "..") != 0) {
-            dc.All.insert(f);
-          }
-        }
-      }
-      dc.LastDiskTime = mt;
+    LoadDirectoryContent(dir, dc);
+  }
+  return dc.All;
+}
+
+std::set<std::string> const& cmGlobalGenerator::GetFindDirectoryContent(
+  std::string const& dir)
+{
+  DirectoryContent& dc = this->DirectoryContentMap[dir];
+  if (dc.Trusted && this->CurrentConfigureMakefile &&
+      this->CurrentConfigureMakefile->IsOn(
+        "CMAKE_FIND_TRUST_DIRECTORY_LISTINGS")) {
+    ++this->DirectoryContentStats.Hits;
+  } else {
+    long const lastDiskTime = dc.LastDiskTime;
+    LoadDirectoryContent(dir, dc);
+    if (dc.LastDiskTime == lastDiskTime) {
+      ++this->DirectoryContentStats.Hits;
+    } else {
+      ++this->DirectoryContentStats.Misses;
     }
+    dc.Trusted = true;
+  }
+  // Record the time of the content returned, not a later one that could
+  // hide a change made after listing it.
+  if (this->DirectoryContentWatcher) {
+    this->DirectoryContentWatcher->Directories.emplace(dir, dc.ListedTime);
   }
   return dc.All;
 }
 
+void cmGlobalGenerator::LoadDirectoryContent(std::string const& dir,
+                                             DirectoryContent& dc)
+{
+  long mt = cmSystemTools::ModifiedTime(dir);
+  if (mt == dc.LastDiskTime) {
+    return;
+  }
+
+  // Reset to non-loaded directory content.
+  dc.All = dc.Generated;
+  cmFileTime listedTime;
+  if (listedTime.Load(dir)) {
+    dc.ListedTime = listedTime.GetTime();
+  } else {
+    dc.ListedTime = cm::nullopt;
+  }
+
+  // Load the directory content from disk.
+  cmsys::Directory d;
+  if (d.Load(dir)) {
+    unsigned long n = d.GetNumberOfFiles();
+    for (unsigned long i = 0; i < n; ++i) {
+      const char* f = d.GetFile(i);
+      if (strcmp(f, ".") != 0 && strcmp(f, "..") != 0) {
+        dc.All.insert(f);
+      }
+    }
+  }
+#if defined(_WIN32) || defined(__APPLE__)
+  dc.AllLower.clear();
+  for (std::string const& f : dc.All) {
+    dc.AllLower.insert(cmSystemTools::LowerCase(f));
+  }
+#endif
+  dc.LastDiskTime = mt;
+}
+
+bool cmGlobalGenerator::MayBeInDirectoryContent(std::string const& path)
+{
+  std::string::size_type const slash = path.rfind('/');
+  if (slash == std::string::npos || slash + 1 == path.size()) {
+    this->MarkDirectoryContentWatchIncomplete();
+    return true;
+  }
+  std::string const dir = slash == 0 ? "/" : path.substr(0, slash);
+  if (!IsDirectoryContentTracked(dir)) {
+    this->MarkDirectoryContentWatchIncomplete();
+    return true;
+  }
+  std::set<std::string> const& content = this->GetFindDirectoryContent(dir);
+#if defined(_WIN32) || defined(__APPLE__)
+  static_cast<void>(content);
+  return this->DirectoryContentMap[dir].AllLower.count(
+    cmSystemTools::LowerCase(path.substr(slash + 1)));
+#else
+  return content.count(path.substr(slash + 1));
+#endif
+}
+
+bool cmGlobalGenerator::IsDirectoryContentTracked(std::string const& dir)
+{
+  // Listings are cached only for normalized paths so that invalidation
+  // finds them.
+  std::string const dirSlash = cmStrCat(dir, '/');
+  return dirSlash.find("/./") == std::string::npos &&
+    dirSlash.find("/../") == std::string::npos &&
+    dir.find("//") == std::string::npos && cmSystemTools::FileIsFullPath(dir);
+}
+
+void cmGlobalGenerator::InvalidateDirectoryContent(std::string const& path)
+{
+  std::string const dir = cmSystemTools::CollapseFullPath(path);
+  // Creating a file or directory may also have created its parents.
+  for (std::string d = dir; !d.empty();) {
+    auto i = this->DirectoryContentMap.find(d);
+    if (i != this->DirectoryContentMap.end()) {
+      i->second.Invalidate();
+    }
+    std::string parent = cmSystemTools::GetFilenamePath(d);
+    if (parent == d) {
+      break;
+    }
+    d = std::move(parent);
+  }
+  std::string const prefix = cmStrCat(dir, '/');
+  for (auto i = this->DirectoryContentMap.lower_bound(prefix);
+       i != this->DirectoryContentMap.end() && cmHasPrefix(i->first, prefix);
+       ++i) {
+    i->second.Invalidate();
+  }
+}
+
+void cmGlobalGenerator::InvalidateDirectoryContent()
+{
+  for (auto& dc : this->DirectoryContentMap) {
+    dc.second.Invalidate();
+  }
+}
+
 void cmGlobalGenerator::AddRuleHash(const std::vector<std::string>& outputs,
                                     std::string const& content)
 {
@@ -3430,6 +3566,38 @@ const std::string& cmGlobalGenerator::GetRealPath(const std::string& dir)
   return i->second;
 }
 
+cmLinkInterfaceMemo& cmGlobalGenerator::GetLinkInterfaceMemo(
+  std::string const& config) const
+{
+  std::unique_ptr<cmLinkInterfaceMemo>& memo =
+    this->LinkInterfaceMemos[config];
+  if (!memo) {
+    memo = cm::make_unique<cmLinkInterfaceMemo>(config);
+  }
+  return *memo;
+}
+
+void cmGlobalGenerator::ClearLinkInterfaceMemos()
+{
+  this->LinkInterfaceMemos.clear();
+}
+
+cmUnityBuildCostFile const* cmGlobalGenerator::GetUnityBuildCostFile(
+  std::string const& path, std::string& error)
+{
+  auto i = this->UnityBuildCostFiles.find(path);
+  if (i == this->UnityBuildCostFiles.end()) {
+    UnityBuildCostFileEntry entry;
+    entry.File = cm::make_unique<cmUnityBuildCostFile>();
+    if (!entry.File->Load(path, entry.Error)) {
+      entry.File.reset();
+    }
+    i = this->UnityBuildCostFiles.emplace(path, std::move(entry)).first;
+  }
+  error = i->second.Error;
+  return i->second.File.get();
+}
+
 std::string cmGlobalGenerator::NewDeferId()
 {
   return cmStrCat("__"_s, std::to_string(this->NextDeferId++));
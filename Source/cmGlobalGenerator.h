@@ -8,6 +8,7 @@
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -22,6 +23,7 @@
 #include "cm_codecvt.hxx"
 
 #include "cmBuildOptions.h"
+#include "cmCompactGraph.h"
 #include "cmCustomCommandLines.h"
 #include "cmDuration.h"
 #include "cmExportSet.h"
@@ -44,8 +46,10 @@
 class cmDirectoryId;
 class cmExportBuildFileGenerator;
 class cmExternalMakefileProjectGenerator;
+class cmGeneratorExpressionCache;
 class cmGeneratorTarget;
 class cmInstallRuntimeDependencySet;
+class cmLinkInterfaceMemo;
 class cmLinkLineComputer;
 class cmLocalGenerator;
 class cmMakefile;
@@ -53,6 +57,7 @@ class cmOutputConverter;
 class cmSourceFile;
 class cmState;
 class cmStateDirectory;
+class cmUnityBuildCostFile;
 class cmake;
 
 namespace detail {
@@ -436,12 +441,78 @@ public:
                                         std::string& dir);
 
   /** Get the content of a directory.  Directory listings are cached
-      and re-loaded from disk only when modified.  During the generation
-      step the content will include the target files to be built even if
-      they do not yet exist.  */
+      and re-loaded from disk only when modified.  During the
+      generation step the content will include the target files to be
+      built even if they do not yet exist.  */
   std::set<std::string> const& GetDirectoryContent(std::string const& dir,
                                                    bool needDisk = true);
 
+  /** Get the content of a directory for the find_* commands.  Like
+      GetDirectoryContent, the listing is re-loaded from disk when the
+      directory was modified.  If CMAKE_FIND_TRUST_DIRECTORY_LISTINGS is
+      set in the directory being configured, a listing loaded by this is
+      instead trusted without checking the directory again until it is
+      invalidated.  The lookups are counted in the statistics and recorded
+      by the watch.  */
+  std::set<std::string> const& GetFindDirectoryContent(
+    std::string const& dir);
+
+  /** Return false if the file with the given full path does not exist
+      because its name is missing from the content of its directory, as
+      listed by GetFindDirectoryContent.  Otherwise the file may exist and
+      the caller must check it.  */
+  bool MayBeInDirectoryContent(std::string const& path);
+
+  /** Return whether the cached listing of the given directory is kept up
+      to date by InvalidateDirectoryContent, i.e. whether the directory is
+      a normalized full path.  */
+  static bool IsDirectoryContentTracked(std::string const& dir);
+
+  /** Check again the cached listings of the given directory, the
+      directories containing it and all directories below it the next time
+      they are used.  */
+  void InvalidateDirectoryContent(std::string const& path);
+
+  /** Check again all cached directory listings the next time they are
+      used, e.g. after running a process that may have written anywhere.  */
+  void InvalidateDirectoryContent();
+
+  struct DirectoryContentStatistics
+  {
+    // Lookups answered by a listing loaded before.
+    std::size_t Hits = 0;
+    // Lookups that loaded the listing from disk.
+    std::size_t Misses = 0;
+  };
+  DirectoryContentStatistics const& GetDirectoryContentStatistics() const
+  {
+    return this->DirectoryContentStats;
+  }
+
+  /** The directories whose content was looked up while a watch is set.  */
+  struct DirectoryContentWatch
+  {
+    // The modification time of each directory, if it existed, taken
+    // before the content that was looked up was listed.
+    std::map<std::string, cm::optional<long long>> Directories;
+    // False if a file was looked up without listing its directory.
+    bool Complete = true;
+  };
+  /** Set the watch to record lookups in and return the previous one.  */
+  DirectoryContentWatch* SetDirectoryContentWatch(
+    DirectoryContentWatch* watch)
+  {
+    std::swap(watch, this->DirectoryContentWatcher);
+    return watch;
+  }
+  /** Note in the current watch, if any, a lookup made without a listing.  */
+  void MarkDirectoryContentWatchIncomplete()
+  {
+    if (this->DirectoryContentWatcher) {
+      this->DirectoryContentWatcher->Complete = false;
+    }
+  }
+
   void IndexTarget(cmTarget* t);
   void IndexGeneratorTarget(cmGeneratorTarget* gt);
 
@@ -477,6 +548,18 @@ public:
   TargetDependSet const& GetTargetDirectDepends(
     const cmGeneratorTarget* target);
 
+  /** The direct dependencies of all targets as a compact graph whose
+      nodes are numbered by GetTargetDependIndex, for walks over the
+      dependencies of many targets.  */
+  cmCompactGraph const& GetTargetDependGraph() const
+  {
+    return this->TargetDependGraph;
+  }
+
+  /** The node of the target in the compact dependency graph, or -1 for
+      targets without computed dependencies.  */
+  int GetTargetDependIndex(cmGeneratorTarget const* target) const;
+
   const std::map<std::string, std::vector<cmLocalGenerator*>>& GetProjectMap()
     const
   {
@@ -508,6 +591,14 @@ public:
 
   virtual bool IsNinja() const { return false; }
 
+  /** Return the full paths of the generated files that the build tool
+      compares against the CMake inputs to decide whether to run CMake
+      again.  Meaningful only after Generate.  */
+  virtual std::vector<std::string> GetRegenerationOutputs() const
+  {
+    return {};
+  }
+
   /** Return true if we know the exact location of object files for the given
      cmTarget. If false, store the reason in the given string. This is
      meaningful only after EnableLanguage has been called.  */
@@ -577,6 +668,21 @@ public:
   cmFileLockPool& GetFileLockPool() { return this->FileLockPool; }
 #endif
 
+  /** Return the compiled generator expressions shared by the local
+      generators, which remember their results during the generate step
+      when targets no longer change.  */
+  cmGeneratorExpressionCache& GetGeneratorExpressionCache() const
+  {
+    return *this->GeneratorExpressionCache;
+  }
+
+  /** Return the mutex held while lazily evaluating generator target
+      state that concurrent readers may share.  */
+  std::recursive_mutex& GetTargetEvaluationMutex() const
+  {
+    return this->TargetEvaluationMutex;
+  }
+
   bool GetConfigureDoneCMP0026() const
   {
     return this->ConfigureDoneCMP0026AndCMP0024;
@@ -593,6 +699,16 @@ public:
 
   std::string const& GetRealPath(std::string const& dir);
 
+  /** Get the link information about targets shared by the links of all
+      targets in the given configuration.  */
+  cmLinkInterfaceMemo& GetLinkInterfaceMemo(std::string const& config) const;
+  void ClearLinkInterfaceMemos();
+
+  /** Get the unity build cost file at the given path, reading it once.
+      Returns nullptr and sets the error if it cannot be read.  */
+  cmUnityBuildCostFile const* GetUnityBuildCostFile(std::string const& path,
+                                                    std::string& error);
+
   std::string NewDeferId();
 
   cmInstallRuntimeDependencySet* CreateAnonymousRuntimeDependencySet();
@@ -767,6 +883,8 @@ private:
   // Store computed inter-target dependencies.
   using TargetDependMap = std::map<cmGeneratorTarget const*, TargetDependSet>;
   TargetDependMap TargetDependencies;
+  cmCompactGraph TargetDependGraph;
+  std::unordered_map<cmGeneratorTarget const*, int> TargetDependIndex;
 
   friend class cmake;
   void CreateGeneratorTargets(
@@ -791,10 +909,29 @@ private:
   struct DirectoryContent
   {
     long LastDiskTime = -1;
+    // The precise modification time taken before listing the content,
+    // if the directory existed.
+    cm::optional<long long> ListedTime;
+    bool Trusted = false;
     std::set<std::string> All;
     std::set<std::string> Generated;
+#if defined(_WIN32) || defined(__APPLE__)
+    // Names in All in lower case, for case-insensitive file systems.
+    std::set<std::string> AllLower;
+#endif
+    // Reload from disk on next use.  The modification time of a directory
+    // has a resolution too coarse to notice changes made in the meantime.
+    void Invalidate()
+    {
+      this->LastDiskTime = -1;
+      this->Trusted = false;
+    }
   };
   std::map<std::string, DirectoryContent> DirectoryContentMap;
+  static void LoadDirectoryContent(std::string const& dir,
+                                   DirectoryContent& dc);
+  DirectoryContentStatistics DirectoryContentStats;
+  DirectoryContentWatch* DirectoryContentWatcher = nullptr;
 
   // Set of binary directories on disk.
   std::set<std::string> BinaryDirectories;
@@ -809,6 +946,16 @@ private:
 
   std::map<std::string, std::string> RealPaths;
 
+  struct UnityBuildCostFileEntry
+  {
+    std::unique_ptr<cmUnityBuildCostFile> File;
+    std::string Error;
+  };
+  std::map<std::string, UnityBuildCostFileEntry> UnityBuildCostFiles;
+
+  mutable std::map<std::string, std::unique_ptr<cmLinkInterfaceMemo>>
+    LinkInterfaceMemos;
+
   std::unordered_set<std::string> GeneratedFiles;
 
   std::vector<std::unique_ptr<cmInstallRuntimeDependencySet>>
@@ -821,6 +968,10 @@ private:
   cmFileLockPool FileLockPool;
 #endif
 
+  mutable std::recursive_mutex TargetEvaluationMutex;
+
+  std::unique_ptr<cmGeneratorExpressionCache> GeneratorExpressionCache;
+
 protected:
   float FirstTimeProgress;
   bool NeedSymbolicMark;
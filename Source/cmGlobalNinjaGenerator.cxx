@@ -8,6 +8,7 @@
 #include <cstdio>
 #include <functional>
 #include <sstream>
+#include <thread>
 #include <utility>
 
 #include <cm/iterator>
@@ -42,6 +43,7 @@
 #include "cmOutputConverter.h"
 #include "cmRange.h"
 #include "cmScanDepFormat.h"
+#include "cmScanDepInfoCache.h"
 #include "cmState.h"
 #include "cmStateDirectory.h"
 #include "cmStateSnapshot.h"
@@ -52,6 +54,7 @@
 #include "cmTargetDepend.h"
 #include "cmValue.h"
 #include "cmVersion.h"
+#include "cmWorkerPool.h"
 #include "cmake.h"
 
 const char* cmGlobalNinjaGenerator::NINJA_BUILD_FILE = "build.ninja";
@@ -519,6 +522,14 @@ void cmGlobalNinjaGenerator::WriteInclude(std::ostream& os,
   os << "include " << filename << "\n";
 }
 
+void cmGlobalNinjaGenerator::WriteSubninja(std::ostream& os,
+                                           const std::string& filename,
+                                           const std::string& comment)
+{
+  cmGlobalNinjaGenerator::WriteComment(os, comment);
+  os << "subninja " << filename << "\n";
+}
+
 void cmGlobalNinjaGenerator::WriteDefault(std::ostream& os,
                                           const cmNinjaDeps& targets,
                                           const std::string& comment)
@@ -586,7 +597,14 @@ void cmGlobalNinjaGenerator::Generate()
 
   for (auto& it : this->Configs) {
     it.second.TargetDependsClosures.clear();
+    it.second.TargetDependsClosurePhonies.clear();
   }
+  this->PhonyDependsClosures =
+    this->LocalGenerators[0]->GetMakefile()->IsOn(
+      "CMAKE_NINJA_PHONY_DEPENDS_CLOSURES");
+  this->SubninjaDirectories = this->LocalGenerators[0]->GetMakefile()->IsOn(
+    "CMAKE_NINJA_SUBNINJA_DIRECTORIES");
+  this->DirectoryFiles.clear();
 
   this->InitOutputPathPrefix();
   this->TargetAll = this->NinjaOutputPath("all");
@@ -1044,8 +1062,8 @@ bool cmGlobalNinjaGenerator::OpenFileStream(
   // Get a stream where to generate things.
   if (!stream) {
     // Compute Ninja's build file path.
-    std::string path =
-      cmStrCat(this->GetCMakeInstance()->GetHomeOutputDirectory(), '/', name);
+    std::string path = cmSystemTools::CollapseFullPath(
+      name, this->GetCMakeInstance()->GetHomeOutputDirectory());
     stream = cm::make_unique<cmGeneratedFileStream>(
       path, false, this->GetMakefileEncoding());
     if (!(*stream)) {
@@ -1084,6 +1102,60 @@ cm::optional<std::set<std::string>> cmGlobalNinjaGenerator::ListSubsetWithAll(
   return cm::make_optional(result);
 }
 
+std::vector<cmGlobalNinjaGenerator::DirectoryFileStream>
+cmGlobalNinjaGenerator::GetDirectoryFileStreams()
+{
+  return { { &this->BuildFileStream, NINJA_BUILD_FILE } };
+}
+
+bool cmGlobalNinjaGenerator::OpenDirectoryFileStreams(
+  cmLocalGenerator const* lg)
+{
+  // The root directory declares the variables and rules the other
+  // directories use, so it stays in the build files themselves.
+  if (!this->SubninjaDirectories || lg->IsRootMakefile()) {
+    return true;
+  }
+
+  this->DirectoryFileStreams = this->GetDirectoryFileStreams();
+  for (DirectoryFileStream const& dfs : this->DirectoryFileStreams) {
+    std::string const path =
+      cmStrCat(lg->GetCurrentBinaryDirectory(), "/CMakeFiles/",
+               cmSystemTools::GetFilenameName(dfs.FileName));
+    std::unique_ptr<cmGeneratedFileStream> stream;
+    if (!this->OpenFileStream(stream, path)) {
+      return false;
+    }
+    stream->SetCopyIfDifferent(true);
+    *stream << "# This file contains the build statements of the directory\n"
+            << "# " << lg->GetCurrentBinaryDirectory() << "\n"
+            << "# It is included in '" << dfs.FileName << "'.\n\n";
+
+    std::string const& ninjaPath = this->ConvertToNinjaPath(path);
+    cmGlobalNinjaGenerator::WriteSubninja(**dfs.Stream,
+                                          this->EncodePath(ninjaPath));
+    this->DirectoryFiles.push_back(ninjaPath);
+
+    this->DirectoryParentStreams.emplace_back(std::move(*dfs.Stream));
+    *dfs.Stream = std::move(stream);
+  }
+  return true;
+}
+
+void cmGlobalNinjaGenerator::CloseDirectoryFileStreams()
+{
+  for (std::size_t i = 0; i < this->DirectoryParentStreams.size(); ++i) {
+    std::unique_ptr<cmGeneratedFileStream>& stream =
+      *this->DirectoryFileStreams[i].Stream;
+    if (cmSystemTools::GetErrorOccurredFlag()) {
+      stream->setstate(std::ios::failbit);
+    }
+    stream = std::move(this->DirectoryParentStreams[i]);
+  }
+  this->DirectoryFileStreams.clear();
+  this->DirectoryParentStreams.clear();
+}
+
 void cmGlobalNinjaGenerator::CloseBuildFileStreams()
 {
   if (this->BuildFileStream) {
@@ -1199,6 +1271,9 @@ void cmGlobalNinjaGenerator::AddCXXCompileCommand(
       sourceFileName, this->GetCMakeInstance()->GetHomeOutputDirectory());
   }
 
+  this->AddCompactCompileCommand(buildFileDir, commandLine, sourceFileName,
+                                 objPath);
+
   /* clang-format off */
   *this->CompileCommandsStream << "{\n"
      << R"(  "directory": ")"
@@ -1219,6 +1294,7 @@ void cmGlobalNinjaGenerator::CloseCompileCommandsStream()
     *this->CompileCommandsStream << "\n]";
     this->CompileCommandsStream.reset();
   }
+  this->WriteCompactCompileCommands();
 }
 
 void cmGlobalNinjaGenerator::WriteDisclaimer(std::ostream& os) const
@@ -1429,6 +1505,85 @@ void cmGlobalNinjaGenerator::AppendTargetDependsClosure(
   outputs.insert(outs.begin(), outs.end());
 }
 
+void cmGlobalNinjaGenerator::AppendTargetDependsClosurePhony(
+  cmGeneratorTarget const* target, cmNinjaDeps& outputs,
+  const std::string& config, const std::string& fileConfig, bool genexOutput)
+{
+  std::string const& phony = this->WriteTargetDependsClosurePhony(
+    target, config, fileConfig, genexOutput);
+  if (!phony.empty()) {
+    outputs.push_back(phony);
+  }
+}
+
+std::string const& cmGlobalNinjaGenerator::WriteTargetDependsClosurePhony(
+  cmGeneratorTarget const* target, const std::string& config,
+  const std::string& fileConfig, bool genexOutput)
+{
+  ByConfig& byConfig = this->Configs[fileConfig];
+  ByConfig::TargetDependsClosureKey key{
+    target,
+    config,
+    genexOutput,
+  };
+  auto find = byConfig.TargetDependsClosurePhonies.find(key);
+  if (find != byConfig.TargetDependsClosurePhonies.end()) {
+    return find->second;
+  }
+
+  // Select the same dependencies as AppendTargetDependsClosure.
+  cmNinjaBuild build("phony");
+  for (auto const& dep_target : this->GetTargetDirectDepends(target)) {
+    if (!dep_target->IsInBuildSystem()) {
+      continue;
+    }
+
+    if (!this->IsSingleConfigUtility(target) &&
+        !this->IsSingleConfigUtility(dep_target) &&
+        this->EnableCrossConfigBuild() && !dep_target.IsCross() &&
+        !genexOutput) {
+      continue;
+    }
+
+    std::string const& depConfig =
+      dep_target.IsCross() ? fileConfig : config;
+    std::string const& depPhony = this->WriteTargetDependsClosurePhony(
+      dep_target, depConfig, fileConfig, genexOutput);
+    if (!depPhony.empty()) {
+      build.ExplicitDeps.push_back(depPhony);
+    }
+    this->AppendTargetOutputs(dep_target, build.ExplicitDeps, depConfig,
+                              DependOnTargetArtifact);
+  }
+
+  std::string name;
+  if (!build.ExplicitDeps.empty()) {
+    std::sort(build.ExplicitDeps.begin(), build.ExplicitDeps.end());
+    build.ExplicitDeps.erase(
+      std::unique(build.ExplicitDeps.begin(), build.ExplicitDeps.end()),
+      build.ExplicitDeps.end());
+
+    // Target names cannot contain a slash, and configuration names name
+    // files, so they cannot either.
+    name = cmStrCat(genexOutput ? "cmake_target_depends_closure_genex/"
+                                : "cmake_target_depends_closure/",
+                    target->GetName());
+    if (this->IsMultiConfig()) {
+      name = cmStrCat(name, '/', config);
+      if (fileConfig != config) {
+        name = cmStrCat(name, '/', fileConfig);
+      }
+    }
+    name = this->NinjaOutputPath(name);
+    build.Comment = cmStrCat("Dependencies of custom commands in target ",
+                             target->GetName());
+    build.Outputs.push_back(name);
+    this->WriteBuild(*this->GetImplFileStream(fileConfig), build);
+  }
+  return byConfig.TargetDependsClosurePhonies.emplace(key, std::move(name))
+    .first->second;
+}
+
 void cmGlobalNinjaGenerator::AddTargetAlias(const std::string& alias,
                                             cmGeneratorTarget* target,
                                             const std::string& config)
@@ -1825,6 +1980,7 @@ void cmGlobalNinjaGenerator::WriteTargetRebuildManifest(std::ostream& os)
   cmNinjaBuild reBuild("RERUN_CMAKE");
   reBuild.Comment = "Re-run CMake if any of its inputs changed.";
   this->AddRebuildManifestOutputs(reBuild.Outputs);
+  cm::append(reBuild.Outputs, this->DirectoryFiles);
 
   for (const auto& localGen : this->LocalGenerators) {
     for (std::string const& fi : localGen->GetMakefile()->GetListFiles()) {
@@ -2191,6 +2347,30 @@ std::string cmGlobalNinjaGenerator::NinjaOutputPath(
   return cmStrCat(this->OutputPathPrefix, path);
 }
 
+std::vector<std::string> cmGlobalNinjaGenerator::GetRegenerationOutputs()
+  const
+{
+  // These are the outputs of the RERUN_CMAKE build statement.
+  cmNinjaDeps outputs;
+  this->AddRebuildManifestOutputs(outputs);
+  cm::append(outputs, this->DirectoryFiles);
+
+  std::string const& home =
+    this->GetCMakeInstance()->GetHomeOutputDirectory();
+  std::vector<std::string> paths;
+  paths.reserve(outputs.size());
+  for (std::string const& output : outputs) {
+    cm::string_view path = output;
+    if (this->HasOutputPathPrefix() &&
+        cmHasPrefix(path, this->OutputPathPrefix)) {
+      path.remove_prefix(this->OutputPathPrefix.size());
+    }
+    paths.push_back(
+      cmSystemTools::CollapseFullPath(std::string(path), home));
+  }
+  return paths;
+}
+
 void cmGlobalNinjaGenerator::StripNinjaOutputPathPrefixAsSuffix(
   std::string& path)
 {
@@ -2473,6 +2653,98 @@ cm::optional<cmSourceInfo> cmcmd_cmake_ninja_depends_fortran(
   }
   return info;
 }
+
+// Parse scan results in parallel only when there are enough of them to
+// outweigh the cost of starting the threads.
+std::size_t const ParallelDdiParseThreshold = 16;
+
+class JobParseDdiT : public cmWorkerPool::JobT
+{
+public:
+  JobParseDdiT(std::string const& ddi, cmScanDepInfo* info,
+               std::string* error, char* parsed)
+    : Ddi(ddi)
+    , Info(info)
+    , Error(error)
+    , Parsed(parsed)
+  {
+  }
+
+private:
+  void Process() override
+  {
+    *this->Parsed =
+      cmScanDepFormat_P1689_Parse(this->Ddi, this->Info, this->Error);
+  }
+
+  std::string const& Ddi;
+  cmScanDepInfo* Info;
+  std::string* Error;
+  char* Parsed;
+};
+
+class JobParseDdiFinishT : public cmWorkerPool::JobFenceT
+{
+private:
+  void Process() override { this->Pool()->Abort(); }
+};
+
+// Parse the scan results not found in the cache, in parallel if there are
+// many.  Errors are reported in the order of the files.
+bool ParseScanDepInfos(std::vector<std::string> const& arg_ddis,
+                       std::string const& cache_file,
+                       std::vector<cmScanDepInfo>& objects)
+{
+  cmScanDepInfoCache cache(cache_file);
+  cache.Load();
+
+  objects.resize(arg_ddis.size());
+  std::vector<std::size_t> missing;
+  for (std::size_t i = 0; i < arg_ddis.size(); ++i) {
+    if (!cache.Lookup(arg_ddis[i], objects[i])) {
+      missing.push_back(i);
+    }
+  }
+
+  std::vector<std::string> errors(missing.size());
+  std::vector<char> parsed(missing.size(), 0);
+  unsigned int const threads =
+    std::max(std::thread::hardware_concurrency(), 1u);
+  if (missing.size() < ParallelDdiParseThreshold || threads == 1) {
+    for (std::size_t m = 0; m < missing.size(); ++m) {
+      parsed[m] = cmScanDepFormat_P1689_Parse(
+        arg_ddis[missing[m]], &objects[missing[m]], &errors[m]);
+    }
+  } else {
+    cmWorkerPool pool;
+    pool.SetThreadCount(static_cast<unsigned int>(
+      std::min<std::size_t>(threads, missing.size())));
+    for (std::size_t m = 0; m < missing.size(); ++m) {
+      pool.EmplaceJob<JobParseDdiT>(arg_ddis[missing[m]],
+                                    &objects[missing[m]], &errors[m],
+                                    &parsed[m]);
+    }
+    pool.EmplaceJob<JobParseDdiFinishT>();
+    pool.Process();
+  }
+
+  for (std::size_t m = 0; m < missing.size(); ++m) {
+    std::string const& arg_ddi = arg_ddis[missing[m]];
+    if (!parsed[m]) {
+      if (!errors[m].empty()) {
+        cmSystemTools::Error(errors[m]);
+      }
+      cmSystemTools::Error(
+        cmStrCat("-E cmake_ninja_dyndep failed to parse ddi file ", arg_ddi));
+      return false;
+    }
+    cache.Store(arg_ddi, objects[missing[m]]);
+  }
+
+  // The cache only saves work, so failing to write it is not an error.
+  cache.Save();
+  return true;
+}
 }
 
 struct CxxModuleFileSet
@@ -2536,14 +2808,11 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
   }
 
   std::vector<cmScanDepInfo> objects;
-  for (std::string const& arg_ddi : arg_ddis) {
-    cmScanDepInfo info;
-    if (!cmScanDepFormat_P1689_Parse(arg_ddi, &info)) {
-      cmSystemTools::Error(
-        cmStrCat("-E cmake_ninja_dyndep failed to parse ddi file ", arg_ddi));
-      return false;
-    }
-    objects.push_back(std::move(info));
+  if (!ParseScanDepInfos(arg_ddis,
+                         cmStrCat(cmSystemTools::GetFilenamePath(arg_dd), '/',
+                                  arg_lang, "DdiCache.bin"),
+                         objects)) {
+    return false;
   }
 
   CxxModuleUsage usages;
@@ -2652,7 +2921,9 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
     }
   }
 
+  // Leave unchanged outputs alone so that ninja can restat them.
   cmGeneratedFileStream ddf(arg_dd);
+  ddf.SetCopyIfDifferent(true);
   ddf << "ninja_dyndep_version = 1.0\n";
 
   {
@@ -2710,6 +2981,7 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
         // `cmNinjaTargetGenerator::WriteObjectBuildStatements` to generate the
         // corresponding file path.
         cmGeneratedFileStream mmf(cmStrCat(object.PrimaryOutput, ".modmap"));
+        mmf.SetCopyIfDifferent(true);
         mmf << mm;
       }
 
@@ -2754,6 +3026,7 @@ bool cmGlobalNinjaGenerator::WriteDyndepFile(
   std::string const target_mods_file = cmStrCat(
     cmSystemTools::GetFilenamePath(arg_dd), '/', arg_lang, "Modules.json");
   cmGeneratedFileStream tmf(target_mods_file);
+  tmf.SetCopyIfDifferent(true);
   tmf << target_module_info;
 
   bool result = true;
@@ -3277,6 +3550,19 @@ bool cmGlobalNinjaMultiGenerator::OpenBuildFileStreams()
     });
 }
 
+std::vector<cmGlobalNinjaGenerator::DirectoryFileStream>
+cmGlobalNinjaMultiGenerator::GetDirectoryFileStreams()
+{
+  std::vector<DirectoryFileStream> streams;
+  streams.push_back({ &this->CommonFileStream, NINJA_COMMON_FILE });
+  for (auto const& config : this->Makefiles[0]->GetGeneratorConfigs(
+         cmMakefile::IncludeEmptyConfig)) {
+    streams.push_back(
+      { &this->ImplFileStreams[config], GetNinjaImplFilename(config) });
+  }
+  return streams;
+}
+
 void cmGlobalNinjaMultiGenerator::CloseBuildFileStreams()
 {
   if (this->CommonFileStream) {
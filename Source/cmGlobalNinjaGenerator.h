@@ -161,6 +161,13 @@ public:
   static void WriteInclude(std::ostream& os, const std::string& filename,
                            const std::string& comment = "");
 
+  /**
+   * Write a subninja statement including @a filename with an optional
+   * @a comment to the @a os stream.
+   */
+  static void WriteSubninja(std::ostream& os, const std::string& filename,
+                            const std::string& comment = "");
+
   /**
    * Write a default target statement specifying @a targets as
    * the default targets.
@@ -190,6 +197,8 @@ public:
 
   bool IsNinja() const override { return true; }
 
+  std::vector<std::string> GetRegenerationOutputs() const override;
+
   /** Get encoding used by generator for ninja files */
   codecvt::Encoding GetMakefileEncoding() const override;
 
@@ -360,6 +369,24 @@ public:
                                   const std::string& fileConfig,
                                   bool genexOutput, bool omit_self);
 
+  /// Whether AppendTargetDependsClosurePhony should be used instead of
+  /// AppendTargetDependsClosure, as selected by the
+  /// CMAKE_NINJA_PHONY_DEPENDS_CLOSURES variable.
+  bool UsePhonyDependsClosures() const
+  {
+    return this->PhonyDependsClosures;
+  }
+  /// Append a phony edge that depends on the same outputs as the closure
+  /// appended by AppendTargetDependsClosure, if it is not empty.  The edge
+  /// depends on the outputs of the direct dependencies and on their own
+  /// phony edges, so the manifest grows with the number of dependencies
+  /// rather than with the size of their closures.
+  void AppendTargetDependsClosurePhony(cmGeneratorTarget const* target,
+                                       cmNinjaDeps& outputs,
+                                       const std::string& config,
+                                       const std::string& fileConfig,
+                                       bool genexOutput);
+
   void AppendDirectoryForConfig(const std::string& prefix,
                                 const std::string& config,
                                 const std::string& suffix,
@@ -375,6 +402,12 @@ public:
     outputs.push_back(this->NinjaOutputPath(NINJA_BUILD_FILE));
   }
 
+  /// Redirect the build statements of a non-root directory to files of its
+  /// own, included with 'subninja', if the CMAKE_NINJA_SUBNINJA_DIRECTORIES
+  /// variable is enabled.  The files are only replaced if they changed.
+  bool OpenDirectoryFileStreams(cmLocalGenerator const* lg);
+  void CloseDirectoryFileStreams();
+
   int GetRuleCmdLength(const std::string& name)
   {
     return this->RuleCmdLength[name];
@@ -483,6 +516,14 @@ protected:
   bool OpenFileStream(std::unique_ptr<cmGeneratedFileStream>& stream,
                       const std::string& name);
 
+  /// A build file stream that OpenDirectoryFileStreams redirects.
+  struct DirectoryFileStream
+  {
+    std::unique_ptr<cmGeneratedFileStream>* Stream;
+    std::string FileName;
+  };
+  virtual std::vector<DirectoryFileStream> GetDirectoryFileStreams();
+
   static cm::optional<std::set<std::string>> ListSubsetWithAll(
     const std::set<std::string>& all, const std::set<std::string>& defaults,
     const std::vector<std::string>& items);
@@ -601,6 +642,18 @@ private:
   std::string TargetAll;
   std::string CMakeCacheFile;
   bool DisableCleandead = false;
+  bool PhonyDependsClosures = false;
+  bool SubninjaDirectories = false;
+
+  /// The redirected streams and the build file streams they replace.
+  std::vector<DirectoryFileStream> DirectoryFileStreams;
+  std::vector<std::unique_ptr<cmGeneratedFileStream>> DirectoryParentStreams;
+  /// The files written for each directory, as ninja paths.
+  cmNinjaDeps DirectoryFiles;
+
+  std::string const& WriteTargetDependsClosurePhony(
+    cmGeneratorTarget const* target, const std::string& config,
+    const std::string& fileConfig, bool genexOutput);
 
   struct ByConfig
   {
@@ -618,6 +671,10 @@ private:
 
     std::map<TargetDependsClosureKey, cmNinjaOuts> TargetDependsClosures;
 
+    /// The phony edges written for closures, or empty if a closure is empty.
+    std::map<TargetDependsClosureKey, std::string>
+      TargetDependsClosurePhonies;
+
     TargetAliasMap TargetAliases;
 
     cmNinjaDeps ByproductsForCleanTarget;
@@ -733,6 +790,7 @@ public:
 protected:
   bool OpenBuildFileStreams() override;
   void CloseBuildFileStreams() override;
+  std::vector<DirectoryFileStream> GetDirectoryFileStreams() override;
 
 private:
   std::map<std::string, std::unique_ptr<cmGeneratedFileStream>>
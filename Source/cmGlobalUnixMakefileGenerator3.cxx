@@ -11,6 +11,7 @@
 #include <cmext/algorithm>
 #include <cmext/memory>
 
+#include "cmCompactGraph.h"
 #include "cmDocumentationEntry.h"
 #include "cmGeneratedFileStream.h"
 #include "cmGeneratorTarget.h"
@@ -124,6 +125,19 @@ void cmGlobalUnixMakefileGenerator3::Generate()
   for (auto& pmi : this->ProgressMap) {
     pmi.second.WriteProgressVariables(total, current);
   }
+
+  // Look up the marks of each target once for the walks over their
+  // dependencies below.
+  cmCompactGraph const& dependGraph = this->GetTargetDependGraph();
+  this->ProgressMarkCounts.assign(
+    static_cast<size_t>(dependGraph.GetNumberOfNodes()), 0);
+  for (auto const& pmi : this->ProgressMap) {
+    int const index = this->GetTargetDependIndex(pmi.first);
+    if (index >= 0) {
+      this->ProgressMarkCounts[index] = pmi.second.Marks.size();
+    }
+  }
+  this->ProgressMarkWalk = cm::make_unique<cmCompactGraphWalk>(dependGraph);
   for (const auto& lg : this->LocalGenerators) {
     std::string markFileName =
       cmStrCat(lg->GetCurrentBinaryDirectory(), "/CMakeFiles/progress.marks");
@@ -139,6 +153,7 @@ void cmGlobalUnixMakefileGenerator3::Generate()
     *this->CommandDatabase << "\n]";
     this->CommandDatabase.reset();
   }
+  this->WriteCompactCompileCommands();
 }
 
 void cmGlobalUnixMakefileGenerator3::AddCXXCompileCommand(
@@ -155,6 +170,8 @@ void cmGlobalUnixMakefileGenerator3::AddCXXCompileCommand(
   } else {
     *this->CommandDatabase << ",\n";
   }
+  this->AddCompactCompileCommand(workingDirectory, compileCommand, sourceFile,
+                                 objPath);
   *this->CommandDatabase << "{\n"
                          << R"(  "directory": ")"
                          << cmGlobalGenerator::EscapeJSON(workingDirectory)
@@ -230,6 +247,16 @@ void cmGlobalUnixMakefileGenerator3::WriteMainMakefile2()
   rootLG.WriteSpecialTargetsBottom(makefileStream);
 }
 
+std::vector<std::string>
+cmGlobalUnixMakefileGenerator3::GetRegenerationOutputs() const
+{
+  // These are the CMAKE_MAKEFILE_OUTPUTS checked by --check-build-system.
+  std::string const& home =
+    this->GetCMakeInstance()->GetHomeOutputDirectory();
+  return { cmStrCat(home, "/Makefile"),
+           cmStrCat(home, "/CMakeFiles/cmake.check_cache") };
+}
+
 void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
 {
   if (this->GlobalSettingIsOn("CMAKE_SUPPRESS_REGENERATION")) {
@@ -718,9 +745,7 @@ void cmGlobalUnixMakefileGenerator3::WriteConvenienceRules2(
         progCmd << lg.ConvertToOutputFormat(progress.Dir,
                                             cmOutputConverter::SHELL);
         //
-        std::set<cmGeneratorTarget const*> emitted;
-        progCmd << " "
-                << this->CountProgressMarksInTarget(gtarget.get(), emitted);
+        progCmd << " " << this->CountProgressMarksInTarget(gtarget.get());
         commands.push_back(progCmd.str());
       }
       std::string tmp = "CMakeFiles/Makefile2";
@@ -815,33 +840,39 @@ void cmGlobalUnixMakefileGenerator3::InitializeProgressMarks()
 }
 
 size_t cmGlobalUnixMakefileGenerator3::CountProgressMarksInTarget(
-  cmGeneratorTarget const* target, std::set<cmGeneratorTarget const*>& emitted)
+  cmGeneratorTarget const* target)
 {
-  size_t count = 0;
-  if (emitted.insert(target).second) {
-    count = this->ProgressMap[target].Marks.size();
-    for (cmTargetDepend const& depend : this->GetTargetDirectDepends(target)) {
-      if (!depend->IsInBuildSystem()) {
-        continue;
-      }
-      count += this->CountProgressMarksInTarget(depend, emitted);
-    }
-  }
-  return count;
+  this->ProgressMarkWalk->Reset();
+  return this->CountProgressMarksInWalk(target);
 }
 
 size_t cmGlobalUnixMakefileGenerator3::CountProgressMarksInAll(
   const cmLocalGenerator& lg)
 {
   size_t count = 0;
-  std::set<cmGeneratorTarget const*> emitted;
+  this->ProgressMarkWalk->Reset();
   for (cmGeneratorTarget const* target :
        this->DirectoryTargetsMap[lg.GetStateSnapshot()]) {
-    count += this->CountProgressMarksInTarget(target, emitted);
+    count += this->CountProgressMarksInWalk(target);
   }
   return count;
 }
 
+size_t cmGlobalUnixMakefileGenerator3::CountProgressMarksInWalk(
+  cmGeneratorTarget const* target)
+{
+  // Count each target reached by the current walk once.  The computed
+  // dependencies are all in the build system.
+  int const index = this->GetTargetDependIndex(target);
+  if (index < 0) {
+    return this->ProgressMap[target].Marks.size();
+  }
+  size_t count = 0;
+  this->ProgressMarkWalk->VisitNodes(
+    index, [this, &count](int n) { count += this->ProgressMarkCounts[n]; });
+  return count;
+}
+
 void cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
   cmMakefileTargetGenerator* tg)
 {
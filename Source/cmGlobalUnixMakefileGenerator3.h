@@ -18,6 +18,7 @@
 #include "cmGlobalGeneratorFactory.h"
 #include "cmStateSnapshot.h"
 
+class cmCompactGraphWalk;
 class cmGeneratedFileStream;
 class cmLocalGenerator;
 class cmLocalUnixMakefileGenerator3;
@@ -188,6 +189,8 @@ public:
 
   bool IsIPOSupported() const override { return true; }
 
+  std::vector<std::string> GetRegenerationOutputs() const override;
+
   void ComputeTargetObjectDirectory(cmGeneratorTarget* gt) const override;
 
   std::string IncludeDirective;
@@ -274,10 +277,12 @@ protected:
                                    cmGeneratorTarget::StrictTargetComparison>;
   ProgressMapType ProgressMap;
 
-  size_t CountProgressMarksInTarget(
-    cmGeneratorTarget const* target,
-    std::set<cmGeneratorTarget const*>& emitted);
+  // Count the progress marks of targets and all their dependencies.
+  size_t CountProgressMarksInTarget(cmGeneratorTarget const* target);
   size_t CountProgressMarksInAll(const cmLocalGenerator& lg);
+  size_t CountProgressMarksInWalk(cmGeneratorTarget const* target);
+  std::vector<size_t> ProgressMarkCounts;
+  std::unique_ptr<cmCompactGraphWalk> ProgressMarkWalk;
 
   std::unique_ptr<cmGeneratedFileStream> CommandDatabase;
 
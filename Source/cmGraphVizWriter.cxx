@@ -11,6 +11,7 @@
 
 #include <cm/memory>
 
+#include "cmCompactGraph.h"
 #include "cmGeneratedFileStream.h"
 #include "cmGeneratorTarget.h"
 #include "cmGlobalGenerator.h"
@@ -272,6 +273,19 @@ void cmGraphVizWriter::Write()
 {
   const auto* gg = this->GlobalGenerator;
 
+  // Look up the aliases of all targets at once, nodes are labeled with them.
+  this->AliasNames.clear();
+  for (auto const& lg : gg->GetLocalGenerators()) {
+    for (auto const& aliasTargets : lg->GetMakefile()->GetAliasTargets()) {
+      this->AliasNames[aliasTargets.second].push_back(aliasTargets.first);
+    }
+  }
+  for (auto& aliasNames : this->AliasNames) {
+    std::vector<std::string>& names = aliasNames.second;
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+  }
+
   this->VisitGraph(gg->GetName());
 
   // We want to traverse in a determined order, such that the output is always
@@ -306,72 +320,67 @@ void cmGraphVizWriter::Write()
   }
 }
 
-void cmGraphVizWriter::FindAllConnections(const ConnectionsMap& connectionMap,
-                                          const cmLinkItem& rootItem,
-                                          Connections& extendedCons,
-                                          std::set<cmLinkItem>& visitedItems)
-{
-  // some "targets" are not in map, e.g. linker flags as -lm or
-  // targets without dependency.
-  // in both cases we are finished with traversing the graph
-  if (connectionMap.find(rootItem) == connectionMap.cend()) {
-    return;
-  }
-
-  const Connections& origCons = connectionMap.at(rootItem);
-
-  for (const Connection& con : origCons) {
-    extendedCons.emplace_back(con);
-    const cmLinkItem& dstItem = con.dst;
-    bool const visited = visitedItems.find(dstItem) != visitedItems.cend();
-    if (!visited) {
-      visitedItems.insert(dstItem);
-      this->FindAllConnections(connectionMap, dstItem, extendedCons,
-                               visitedItems);
-    }
-  }
-}
-
-void cmGraphVizWriter::FindAllConnections(const ConnectionsMap& connectionMap,
-                                          const cmLinkItem& rootItem,
-                                          Connections& extendedCons)
-{
-  std::set<cmLinkItem> visitedItems = { rootItem };
-  this->FindAllConnections(connectionMap, rootItem, extendedCons,
-                           visitedItems);
-}
-
 template <typename DirFunc>
 void cmGraphVizWriter::WritePerTargetConnections(
   const ConnectionsMap& connections, const std::string& fileNameSuffix)
 {
-  // the per target connections must be extended by indirect dependencies
-  ConnectionsMap extendedConnections;
+  // Number the items, those having connections first, in the order of the
+  // map, and store the connections in a compact graph.
+  std::map<cmLinkItem, int> itemIndex;
+  std::vector<cmLinkItem const*> items;
+  for (auto const& conPerTarget : connections) {
+    itemIndex.emplace(conPerTarget.first, static_cast<int>(items.size()));
+    items.push_back(&conPerTarget.first);
+  }
+  cmCompactGraph graph;
+  std::vector<Connection const*> edges;
   for (auto const& conPerTarget : connections) {
-    const cmLinkItem& rootItem = conPerTarget.first;
-    Connections& extendedCons = extendedConnections[conPerTarget.first];
-    this->FindAllConnections(connections, rootItem, extendedCons);
+    graph.AddNode();
+    for (const Connection& con : conPerTarget.second) {
+      auto const inserted =
+        itemIndex.emplace(con.dst, static_cast<int>(items.size()));
+      if (inserted.second) {
+        items.push_back(&con.dst);
+      }
+      graph.AddEdge(inserted.first->second);
+      edges.push_back(&con);
+    }
+  }
+  // some "targets" are not in map, e.g. linker flags as -lm or
+  // targets without dependency, they have no connections
+  while (graph.GetNumberOfNodes() < static_cast<int>(items.size())) {
+    graph.AddNode();
   }
 
-  for (auto const& conPerTarget : extendedConnections) {
-    const cmLinkItem& rootItem = conPerTarget.first;
+  // The per target connections must be extended by indirect dependencies.
+  // A connection is written to the files of all targets reaching it, so
+  // format it only once.
+  std::vector<std::string> edgeTexts(edges.size());
+  cmCompactGraphWalk walk(graph);
+  int const numberOfRoots = static_cast<int>(connections.size());
+  for (int root = 0; root < numberOfRoots; ++root) {
+    const cmLinkItem& rootItem = *items[root];
 
     // some of the nodes are excluded completely and are not written
     if (this->ItemExcluded(rootItem)) {
       continue;
     }
 
-    const Connections& cons = conPerTarget.second;
-
     std::unique_ptr<cmGeneratedFileStream> fileStream =
       this->CreateTargetFile(rootItem, fileNameSuffix);
 
-    for (const Connection& con : cons) {
-      const cmLinkItem& src = DirFunc::src(con);
-      const cmLinkItem& dst = DirFunc::dst(con);
-      this->WriteNode(*fileStream, con.dst);
-      this->WriteConnection(*fileStream, src, dst, con.scopeType);
-    }
+    walk.Reset();
+    walk.VisitEdges(root, [&](std::size_t e) {
+      std::string& edgeText = edgeTexts[e];
+      if (edgeText.empty()) {
+        const Connection& con = *edges[e];
+        edgeText = cmStrCat(this->GetNodeText(con.dst),
+                            this->GetConnectionText(DirFunc::src(con),
+                                                    DirFunc::dst(con),
+                                                    con.scopeType));
+      }
+      *fileStream << edgeText;
+    });
 
     this->WriteFooter(*fileStream);
   }
@@ -439,6 +448,11 @@ void cmGraphVizWriter::WriteLegend(cmGeneratedFileStream& fs)
 
 void cmGraphVizWriter::WriteNode(cmGeneratedFileStream& fs,
                                  cmLinkItem const& item)
+{
+  fs << this->GetNodeText(item);
+}
+
+std::string cmGraphVizWriter::GetNodeText(cmLinkItem const& item)
 {
   auto const& itemName = item.AsStr();
   auto const& nodeName = this->NodeNames[itemName];
@@ -446,22 +460,28 @@ void cmGraphVizWriter::WriteNode(cmGeneratedFileStream& fs,
   auto const itemNameWithAliases = this->ItemNameWithAliases(itemName);
   auto const escapedLabel = EscapeForDotFile(itemNameWithAliases);
 
-  fs << "    \"" << nodeName << "\" [ label = \"" << escapedLabel
-     << "\", shape = " << getShapeForTarget(item) << " ];\n";
+  return cmStrCat("    \"", nodeName, "\" [ label = \"", escapedLabel,
+                  "\", shape = ", getShapeForTarget(item), " ];\n");
 }
 
 void cmGraphVizWriter::WriteConnection(cmGeneratedFileStream& fs,
                                        cmLinkItem const& depender,
                                        cmLinkItem const& dependee,
                                        std::string const& edgeStyle)
+{
+  fs << this->GetConnectionText(depender, dependee, edgeStyle);
+}
+
+std::string cmGraphVizWriter::GetConnectionText(cmLinkItem const& depender,
+                                                cmLinkItem const& dependee,
+                                                std::string const& edgeStyle)
 {
   auto const& dependerName = depender.AsStr();
   auto const& dependeeName = dependee.AsStr();
 
-  fs << "    \"" << this->NodeNames[dependerName] << "\" -> \""
-     << this->NodeNames[dependeeName] << "\" "
-     << edgeStyle
-     << " // " << dependerName << " -> " << dependeeName << '\n';
+  return cmStrCat("    \"", this->NodeNames[dependerName], "\" -> \"",
+                  this->NodeNames[dependeeName], "\" ", edgeStyle, " // ",
+                  dependerName, " -> ", dependeeName, '\n');
 }
 
 bool cmGraphVizWriter::ItemExcluded(cmLinkItem const& item)
@@ -546,21 +566,12 @@ bool cmGraphVizWriter::TargetTypeEnabled(
 std::string cmGraphVizWriter::ItemNameWithAliases(
   std::string const& itemName) const
 {
-  std::vector<std::string> items;
-  for (auto const& lg : this->GlobalGenerator->GetLocalGenerators()) {
-    for (auto const& aliasTargets : lg->GetMakefile()->GetAliasTargets()) {
-      if (aliasTargets.second == itemName) {
-        items.push_back(aliasTargets.first);
-      }
-    }
-  }
-
-  std::sort(items.begin(), items.end());
-  items.erase(std::unique(items.begin(), items.end()), items.end());
-
   auto nameWithAliases = itemName;
-  for(auto const& item : items) {
-    nameWithAliases += "\\n(" + item + ")";
+  auto const aliasNames = this->AliasNames.find(itemName);
+  if (aliasNames != this->AliasNames.end()) {
+    for (auto const& item : aliasNames->second) {
+      nameWithAliases += "\\n(" + item + ")";
+    }
   }
 
   return nameWithAliases;
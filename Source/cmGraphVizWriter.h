@@ -6,7 +6,6 @@
 
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -72,6 +71,8 @@ private:
 
   void WriteNode(cmGeneratedFileStream& fs, cmLinkItem const& item);
 
+  std::string GetNodeText(cmLinkItem const& item);
+
   std::unique_ptr<cmGeneratedFileStream> CreateTargetFile(
     cmLinkItem const& target, std::string const& fileNameSuffix = "");
 
@@ -80,14 +81,9 @@ private:
                        cmLinkItem const& dependeeTargetName,
                        std::string const& edgeStyle);
 
-  void FindAllConnections(const ConnectionsMap& connectionMap,
-                          const cmLinkItem& rootItem,
-                          Connections& extendedCons,
-                          std::set<cmLinkItem>& visitedItems);
-
-  void FindAllConnections(const ConnectionsMap& connectionMap,
-                          const cmLinkItem& rootItem,
-                          Connections& extendedCons);
+  std::string GetConnectionText(cmLinkItem const& dependerTargetName,
+                                cmLinkItem const& dependeeTargetName,
+                                std::string const& edgeStyle);
 
   template <typename DirFunc>
   void WritePerTargetConnections(const ConnectionsMap& connections,
@@ -122,6 +118,8 @@ private:
   int NextNodeId = 0;
   // maps from the actual item names to node names in dot:
   std::map<std::string, std::string> NodeNames;
+  // maps from the actual item names to their sorted alias names:
+  std::map<std::string, std::vector<std::string>> AliasNames;
 
   bool GenerateForExecutables = true;
   bool GenerateForStaticLibs = true;
@@ -151,6 +151,9 @@ bool cmIncludeCommand(std::vector<std::string> const& args,
 
   const bool fileDoesnotExist = !cmSystemTools::FileExists(listFile);
   const bool fileIsDirectory = cmSystemTools::FileIsDirectory(listFile);
+  status.GetMakefile().RecordPathQuery("EXISTS", listFile, !fileDoesnotExist);
+  status.GetMakefile().RecordPathQuery("IS_DIRECTORY", listFile,
+                                       fileIsDirectory);
   if (fileDoesnotExist || fileIsDirectory) {
     if (!resultVarName.empty()) {
       status.GetMakefile().AddDefinition(resultVarName, "NOTFOUND");
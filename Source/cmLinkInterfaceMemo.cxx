@@ -0,0 +1,49 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmLinkInterfaceMemo.h"
+
+#include <utility>
+
+#include "cmGeneratorTarget.h"
+
+cmLinkInterfaceMemo::cmLinkInterfaceMemo(std::string config)
+  : Config(std::move(config))
+{
+}
+
+bool cmLinkInterfaceMemo::HasImportLibrary(cmGeneratorTarget const* target)
+{
+  Entry& entry = this->Entries[target];
+  if (!entry.HasImportLibrary) {
+    entry.HasImportLibrary = target->HasImportLibrary(this->Config);
+  }
+  return *entry.HasImportLibrary;
+}
+
+std::string const& cmLinkInterfaceMemo::GetFullPath(
+  cmGeneratorTarget const* target, cmStateEnums::ArtifactType artifact)
+{
+  Entry& entry = this->Entries[target];
+  cm::optional<std::string>& path =
+    artifact == cmStateEnums::ImportLibraryArtifact ? entry.ImportPath
+                                                    : entry.RuntimePath;
+  if (!path) {
+    path = target->GetFullPath(this->Config, artifact, true);
+  }
+  return *path;
+}
+
+std::string const& cmLinkInterfaceMemo::GetSOName(
+  cmGeneratorTarget const* target)
+{
+  Entry& entry = this->Entries[target];
+  if (!entry.SOName) {
+    entry.SOName = target->GetSOName(this->Config);
+  }
+  return *entry.SOName;
+}
+
+void cmLinkInterfaceMemo::Clear()
+{
+  this->Entries.clear();
+}
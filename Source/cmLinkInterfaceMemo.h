@@ -0,0 +1,56 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <unordered_map>
+
+#include <cm/optional>
+
+#include "cmStateTypes.h"
+
+class cmGeneratorTarget;
+
+/** \class cmLinkInterfaceMemo
+ * \brief Per-config link information about targets shared by all links.
+ *
+ * Every target linking to a library asks it for the file and soname to
+ * link.  The answers do not depend on the dependent target.  They are
+ * computed once per configuration and shared by the
+ * cmComputeLinkInformation instances of all targets.
+ */
+class cmLinkInterfaceMemo
+{
+public:
+  cmLinkInterfaceMemo(std::string config);
+
+  cmLinkInterfaceMemo(cmLinkInterfaceMemo const&) = delete;
+  cmLinkInterfaceMemo& operator=(cmLinkInterfaceMemo const&) = delete;
+
+  /** Whether the target has an import library.  */
+  bool HasImportLibrary(cmGeneratorTarget const* target);
+
+  /** Get the real full path of the given artifact of the target.  */
+  std::string const& GetFullPath(cmGeneratorTarget const* target,
+                                 cmStateEnums::ArtifactType artifact);
+
+  /** Get the soname of the target.  */
+  std::string const& GetSOName(cmGeneratorTarget const* target);
+
+  /** Forget everything, when link information has to be recomputed.  */
+  void Clear();
+
+private:
+  struct Entry
+  {
+    cm::optional<bool> HasImportLibrary;
+    cm::optional<std::string> RuntimePath;
+    cm::optional<std::string> ImportPath;
+    cm::optional<std::string> SOName;
+  };
+
+  std::string const Config;
+  std::unordered_map<cmGeneratorTarget const*, Entry> Entries;
+};
@@ -12,6 +12,7 @@
 
 #include <cm/optional>
 
+#include "cmAtom.h"
 #include "cmConstStack.h"
 #include "cmSystemTools.h"
 
@@ -61,10 +62,16 @@ public:
 
   std::string const& OriginalName() const noexcept
   {
-    return this->Impl->OriginalName;
+    return this->Impl->OriginalName.GetString();
   }
 
   std::string const& LowerCaseName() const noexcept
+  {
+    return this->Impl->LowerCaseName.GetString();
+  }
+
+  /** The interned lower-case name, used to look up the command.  */
+  cmAtom LowerCaseNameAtom() const noexcept
   {
     return this->Impl->LowerCaseName;
   }
@@ -82,16 +89,16 @@ private:
   {
     Implementation(std::string name, long line, long lineEnd,
                    std::vector<cmListFileArgument> args)
-      : OriginalName{ std::move(name) }
-      , LowerCaseName{ cmSystemTools::LowerCase(this->OriginalName) }
+      : OriginalName{ name }
+      , LowerCaseName{ this->OriginalName.GetLowerCase() }
       , Line{ line }
       , LineEnd{ lineEnd }
       , Arguments{ std::move(args) }
     {
     }
 
-    std::string OriginalName;
-    std::string LowerCaseName;
+    cmAtom OriginalName;
+    cmAtom LowerCaseName;
     long Line = 0;
     long LineEnd = 0;
     std::vector<cmListFileArgument> Arguments;
@@ -243,4 +250,8 @@ struct cmListFile
                    cmMessenger* messenger, cmListFileBacktrace const& lfbt);
 
   std::vector<cmListFileFunction> Functions;
+
+  // Whether parsing issued warnings that must be repeated each time
+  // the file is read, so the result may not be reused.
+  bool HasWarnings = false;
 };
@@ -0,0 +1,347 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmListFileParseCache.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <cmext/string_view>
+
+#include "cmBinaryIO.h"
+#include "cmCryptoHash.h"
+#include "cmFileTime.h"
+#include "cmGeneratedFileStream.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmVersion.h"
+
+namespace {
+// Bump this whenever the layout of the cache file changes.
+unsigned long long const FormatVersion = 2;
+cm::string_view const Magic = "CMLFPC\n"_s;
+
+bool ReadLong(cmBinaryIO::Reader& reader, long& n)
+{
+  unsigned long long u;
+  if (!reader.ReadNumber(u)) {
+    return false;
+  }
+  n = static_cast<long>(static_cast<long long>(u));
+  return true;
+}
+
+std::string HashContent(std::string const& content)
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoMD5);
+  std::vector<unsigned char> hash = hasher.ByteHashString(content);
+  return std::string(hash.begin(), hash.end());
+}
+
+// Parse the content of a list file as cmListFile::ParseFile would read
+// it from disk.
+std::shared_ptr<cmListFile> ParseContent(std::string const& path,
+                                         std::string content,
+                                         cmMessenger* messenger,
+                                         cmListFileBacktrace const& lfbt)
+{
+  auto listFile = std::make_shared<cmListFile>();
+
+  // The lexer checks the byte-order mark only when reading a file, and
+  // reads a string only up to the first null byte.
+  if (cmHasLiteralPrefix(content, "\xFE\xFF") ||
+      cmHasLiteralPrefix(content, "\xFF\xFE") ||
+      content.find('\0') != std::string::npos) {
+    if (!listFile->ParseFile(path.c_str(), messenger, lfbt)) {
+      return nullptr;
+    }
+    return listFile;
+  }
+
+  // Skip a UTF-8 byte-order mark and convert CRLF to LF like the lexer
+  // does when reading a file.
+  std::string::size_type const start =
+    cmHasLiteralPrefix(content, "\xEF\xBB\xBF") ? 3 : 0;
+  std::string::size_type out = 0;
+  for (std::string::size_type in = start; in < content.size(); ++in) {
+    if (content[in] == '\r' && in + 1 < content.size() &&
+        content[in + 1] == '\n') {
+      continue;
+    }
+    content[out++] = content[in];
+  }
+  content.resize(out);
+
+  if (!listFile->ParseString(content.c_str(), path.c_str(), messenger,
+                             lfbt)) {
+    return nullptr;
+  }
+  return listFile;
+}
+}
+
+cm::optional<cmListFileParseCache::Mode> cmListFileParseCache::ModeFromString(
+  cm::string_view value)
+{
+  if (value == "off"_s) {
+    return Mode::Off;
+  }
+  if (value == "read"_s) {
+    return Mode::Read;
+  }
+  if (value == "readwrite"_s) {
+    return Mode::ReadWrite;
+  }
+  return cm::nullopt;
+}
+
+cmListFileParseCache::cmListFileParseCache(Mode mode, std::string cacheFile)
+  : CacheMode(mode)
+  , CacheFile(std::move(cacheFile))
+{
+}
+
+void cmListFileParseCache::Load()
+{
+  this->Entries.clear();
+  this->Stats.Loaded = 0;
+  if (this->CacheMode == Mode::Off) {
+    return;
+  }
+
+  std::string data;
+  if (!cmBinaryIO::ReadFile(this->CacheFile, data) ||
+      !this->ReadEntries(data)) {
+    this->Entries.clear();
+  }
+  this->Stats.Loaded = static_cast<unsigned long>(this->Entries.size());
+}
+
+bool cmListFileParseCache::ReadEntries(std::string const& data)
+{
+  cmBinaryIO::Reader reader(data);
+  if (!reader.ReadMagic(Magic)) {
+    return false;
+  }
+
+  // Entries written by a different CMake may have been lexed differently.
+  unsigned long long version;
+  std::string cmakeVersion;
+  if (!reader.ReadNumber(version) || version != FormatVersion ||
+      !reader.ReadString(cmakeVersion) ||
+      cmakeVersion != cmVersion::GetCMakeVersion()) {
+    return false;
+  }
+
+  unsigned long long numEntries;
+  if (!reader.ReadNumber(numEntries)) {
+    return false;
+  }
+  for (unsigned long long e = 0; e < numEntries; ++e) {
+    std::string path;
+    Entry entry;
+    unsigned long long mtime;
+    unsigned long long numFunctions;
+    unsigned long long racy;
+    if (!reader.ReadString(path) || !reader.ReadNumber(mtime) ||
+        !reader.ReadNumber(entry.Size) || !reader.ReadString(entry.Hash) ||
+        !reader.ReadNumber(racy) || !reader.ReadNumber(numFunctions)) {
+      return false;
+    }
+    entry.MTime = static_cast<long long>(mtime);
+    entry.Racy = racy != 0;
+    auto listFile = std::make_shared<cmListFile>();
+    listFile->Functions.reserve(static_cast<std::size_t>(numFunctions));
+    for (unsigned long long f = 0; f < numFunctions; ++f) {
+      std::string name;
+      long line;
+      long lineEnd;
+      unsigned long long numArgs;
+      if (!reader.ReadString(name) || !ReadLong(reader, line) ||
+          !ReadLong(reader, lineEnd) || !reader.ReadNumber(numArgs)) {
+        return false;
+      }
+      std::vector<cmListFileArgument> args;
+      args.reserve(static_cast<std::size_t>(numArgs));
+      for (unsigned long long a = 0; a < numArgs; ++a) {
+        std::string value;
+        unsigned long long delim;
+        long argLine;
+        if (!reader.ReadString(value) || !reader.ReadNumber(delim) ||
+            delim > cmListFileArgument::Bracket ||
+            !ReadLong(reader, argLine)) {
+          return false;
+        }
+        args.emplace_back(std::move(value),
+                          static_cast<cmListFileArgument::Delimiter>(delim),
+                          argLine);
+      }
+      listFile->Functions.emplace_back(std::move(name), line, lineEnd,
+                                       std::move(args));
+    }
+    entry.ListFile = std::move(listFile);
+    this->Entries[std::move(path)] = std::move(entry);
+  }
+  return reader.AtEnd();
+}
+
+bool cmListFileParseCache::Save()
+{
+  if (this->CacheMode != Mode::ReadWrite) {
+    return true;
+  }
+
+  // Skip writing unless entries were stored or updated.  Then drop the
+  // entries for files not read during this run so that the cache does not
+  // grow without bound.
+  if (this->Stats.Stored == 0 && !this->Modified) {
+    return true;
+  }
+  unsigned long numUsed = 0;
+  for (auto const& e : this->Entries) {
+    if (e.second.Used) {
+      ++numUsed;
+    }
+  }
+
+  std::string out(Magic.data(), Magic.size());
+  cmBinaryIO::WriteNumber(out, FormatVersion);
+  cmBinaryIO::WriteString(out, cmVersion::GetCMakeVersion());
+  cmBinaryIO::WriteNumber(out, numUsed);
+  for (auto const& e : this->Entries) {
+    Entry const& entry = e.second;
+    if (!entry.Used) {
+      continue;
+    }
+    cmBinaryIO::WriteString(out, e.first);
+    cmBinaryIO::WriteNumber(out, static_cast<unsigned long long>(entry.MTime));
+    cmBinaryIO::WriteNumber(out, entry.Size);
+    cmBinaryIO::WriteString(out, entry.Hash);
+    cmBinaryIO::WriteNumber(out, entry.Racy ? 1 : 0);
+    cmBinaryIO::WriteNumber(out, entry.ListFile->Functions.size());
+    for (cmListFileFunction const& func : entry.ListFile->Functions) {
+      cmBinaryIO::WriteString(out, func.OriginalName());
+      cmBinaryIO::WriteNumber(out,
+                              static_cast<unsigned long long>(func.Line()));
+      cmBinaryIO::WriteNumber(out,
+                              static_cast<unsigned long long>(func.LineEnd()));
+      cmBinaryIO::WriteNumber(out, func.Arguments().size());
+      for (cmListFileArgument const& arg : func.Arguments()) {
+        cmBinaryIO::WriteString(out, arg.Value);
+        cmBinaryIO::WriteNumber(out,
+                                static_cast<unsigned long long>(arg.Delim));
+        cmBinaryIO::WriteNumber(out,
+                                static_cast<unsigned long long>(arg.Line));
+      }
+    }
+  }
+
+  cmGeneratedFileStream fout;
+  fout.Open(this->CacheFile, true, true);
+  fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+  return fout.Close();
+}
+
+std::shared_ptr<cmListFile const> cmListFileParseCache::ParseFile(
+  std::string const& path, cmMessenger* messenger,
+  cmListFileBacktrace const& lfbt)
+{
+  cmFileTime mtime;
+  if (!mtime.Load(path) || cmSystemTools::FileIsDirectory(path)) {
+    auto listFile = std::make_shared<cmListFile>();
+    if (!listFile->ParseFile(path.c_str(), messenger, lfbt)) {
+      return nullptr;
+    }
+    return listFile;
+  }
+
+  auto it = this->Entries.find(path);
+  if (it != this->Entries.end() && !it->second.Racy &&
+      it->second.MTime == mtime.GetTime() &&
+      it->second.Size == cmSystemTools::FileLength(path)) {
+    return this->UseEntry(it->second);
+  }
+
+  // The file may have changed.  Compare its content.
+  std::string content;
+  if (!cmBinaryIO::ReadFile(path, content)) {
+    auto listFile = std::make_shared<cmListFile>();
+    if (!listFile->ParseFile(path.c_str(), messenger, lfbt)) {
+      return nullptr;
+    }
+    return listFile;
+  }
+  std::string hash = HashContent(content);
+  bool const racy = cmBinaryIO::IsRacy(mtime.GetTime());
+
+  if (it != this->Entries.end()) {
+    Entry& entry = it->second;
+    if (entry.Size == content.size() && entry.Hash == hash) {
+      // Only the time changed, or it has become old enough to trust.
+      if (entry.MTime != mtime.GetTime() || entry.Racy != racy) {
+        entry.MTime = mtime.GetTime();
+        entry.Racy = racy;
+        this->Modified = true;
+      }
+      return this->UseEntry(entry);
+    }
+    ++this->Stats.Stale;
+    this->Entries.erase(it);
+  }
+
+  ++this->Stats.Misses;
+  unsigned long long const size = content.size();
+  std::shared_ptr<cmListFile> listFile =
+    ParseContent(path, std::move(content), messenger, lfbt);
+  if (!listFile) {
+    return nullptr;
+  }
+  if (listFile->HasWarnings || this->IsTransient(path)) {
+    ++this->Stats.Uncacheable;
+    return listFile;
+  }
+
+  Entry& entry = this->Entries[path];
+  entry.MTime = mtime.GetTime();
+  entry.Size = size;
+  entry.Hash = std::move(hash);
+  entry.ListFile = listFile;
+  entry.Racy = racy;
+  entry.Used = true;
+  ++this->Stats.Stored;
+  return listFile;
+}
+
+std::shared_ptr<cmListFile const> cmListFileParseCache::UseEntry(Entry& entry)
+{
+  if (entry.Used) {
+    ++this->Stats.Reused;
+  } else {
+    ++this->Stats.Hits;
+    entry.Used = true;
+  }
+  return entry.ListFile;
+}
+
+void cmListFileParseCache::PushTransientDirectory(std::string dir)
+{
+  this->TransientDirectories.push_back(std::move(dir));
+}
+
+void cmListFileParseCache::PopTransientDirectory()
+{
+  if (!this->TransientDirectories.empty()) {
+    this->TransientDirectories.pop_back();
+  }
+}
+
+bool cmListFileParseCache::IsTransient(std::string const& path) const
+{
+  for (std::string const& dir : this->TransientDirectories) {
+    if (cmSystemTools::IsSubDirectory(path, dir)) {
+      return true;
+    }
+  }
+  return false;
+}
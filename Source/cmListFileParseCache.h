@@ -0,0 +1,114 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cm/optional>
+#include <cm/string_view>
+
+#include "cmListFileCache.h"
+
+class cmMessenger;
+
+/** \class cmListFileParseCache
+ * \brief Share parsed list files within and across CMake runs.
+ *
+ * A list file whose path, modification time and size match an entry
+ * parsed earlier in this run, or stored in the build tree by a previous
+ * run, is not lexed again.  Instead the same immutable cmListFile is
+ * handed out to every directory that reads it.  The content is read and
+ * compared by hash only if the modification time or size differ, or if
+ * the file was modified too recently for its time to tell changes apart.
+ */
+class cmListFileParseCache
+{
+public:
+  enum class Mode
+  {
+    Off,
+    Read,
+    ReadWrite,
+  };
+
+  /** Convert the value of --parse-cache to a mode.  */
+  static cm::optional<Mode> ModeFromString(cm::string_view value);
+
+  struct Statistics
+  {
+    unsigned long Loaded = 0;
+    unsigned long Hits = 0;
+    unsigned long Reused = 0;
+    unsigned long Misses = 0;
+    unsigned long Stale = 0;
+    unsigned long Uncacheable = 0;
+    unsigned long Stored = 0;
+  };
+
+  cmListFileParseCache(Mode mode, std::string cacheFile);
+
+  cmListFileParseCache(cmListFileParseCache const&) = delete;
+  cmListFileParseCache& operator=(cmListFileParseCache const&) = delete;
+
+  Mode GetMode() const { return this->CacheMode; }
+  std::string const& GetCacheFile() const { return this->CacheFile; }
+  Statistics const& GetStatistics() const { return this->Stats; }
+
+  /**
+   * Read the entries stored by a previous run.  A missing, truncated or
+   * incompatible cache file is silently treated as empty.
+   */
+  void Load();
+
+  /**
+   * Write the entries used during this run back to the cache file if
+   * entries were stored or updated.  Does nothing unless the mode is
+   * ReadWrite.
+   */
+  bool Save();
+
+  /**
+   * Do not store the files below the given directory, such as those of a
+   * try_compile project, which are removed after use, until the matching
+   * PopTransientDirectory.
+   */
+  void PushTransientDirectory(std::string dir);
+  void PopTransientDirectory();
+
+  /**
+   * Parse the list file at the given full path, reusing an earlier
+   * result when the file has not changed.  Returns null on error.
+   */
+  std::shared_ptr<cmListFile const> ParseFile(std::string const& path,
+                                              cmMessenger* messenger,
+                                              cmListFileBacktrace const& lfbt);
+
+private:
+  struct Entry
+  {
+    long long MTime = 0;
+    unsigned long long Size = 0;
+    std::string Hash;
+    std::shared_ptr<cmListFile const> ListFile;
+    // Whether the file was modified too recently when the entry was
+    // stored for another modification to change its time.
+    bool Racy = false;
+    bool Used = false;
+  };
+
+  bool ReadEntries(std::string const& data);
+  std::shared_ptr<cmListFile const> UseEntry(Entry& entry);
+  bool IsTransient(std::string const& path) const;
+
+  Mode CacheMode;
+  std::string CacheFile;
+  std::unordered_map<std::string, Entry> Entries;
+  Statistics Stats;
+  bool Modified = false;
+  std::vector<std::string> TransientDirectories;
+};
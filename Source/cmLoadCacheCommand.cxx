@@ -26,6 +26,7 @@ bool cmLoadCacheCommand(std::vector<std::string> const& args,
     status.SetError("called with wrong number of arguments.");
     return false;
   }
+  status.GetMakefile().MarkConfigureVolatile("load_cache()");
 
   if (args.size() >= 2 && args[1] == "READ_WITH_PREFIX") {
     return ReadWithPrefix(args, status);
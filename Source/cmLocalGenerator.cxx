@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <initializer_list>
@@ -52,6 +53,7 @@
 #include "cmSystemTools.h"
 #include "cmTarget.h"
 #include "cmTestGenerator.h"
+#include "cmUnityBuildCostFile.h"
 #include "cmValue.h"
 #include "cmVersion.h"
 #include "cmake.h"
@@ -2898,6 +2900,16 @@ inline void RegisterUnitySources(cmGeneratorTarget* target, cmSourceFile* sf,
   target->AddSourceFileToUnityBatch(sf->ResolveFullPath());
   sf->SetProperty("UNITY_SOURCE_FILE", filename);
 }
+
+// Round a compile cost to a logarithmic scale with four steps per doubling
+// so that ordinary timing noise does not move sources between batches.
+double QuantizeUnityCost(double cost)
+{
+  if (cost <= 0) {
+    return 0;
+  }
+  return std::pow(2.0, std::round(std::log2(cost) * 4) / 4);
+}
 }
 
 cmLocalGenerator::UnitySource cmLocalGenerator::WriteUnitySource(
@@ -3048,6 +3060,128 @@ cmLocalGenerator::AddUnityFilesModeGroup(
   return unity_files;
 }
 
+std::vector<cmLocalGenerator::UnitySource>
+cmLocalGenerator::AddUnityFilesModeCost(
+  cmGeneratorTarget* target, std::string const& lang,
+  std::vector<std::string> const& configs,
+  std::vector<UnityBatchedSource> const& filtered_sources,
+  cmValue beforeInclude, cmValue afterInclude,
+  std::string const& filename_base, size_t batchSize)
+{
+  std::vector<UnitySource> unity_files;
+  if (filtered_sources.empty()) {
+    return unity_files;
+  }
+
+  cmValue costFile = target->GetProperty("UNITY_BUILD_COST_FILE");
+  if (!cmNonempty(costFile)) {
+    this->IssueMessage(
+      MessageType::FATAL_ERROR,
+      cmStrCat("UNITY_BUILD_MODE value of COST assigned to target ",
+               target->GetName(),
+               " requires the UNITY_BUILD_COST_FILE property to be set."));
+    return unity_files;
+  }
+  std::string const costPath = cmSystemTools::CollapseFullPath(
+    *costFile, this->GetCurrentSourceDirectory());
+  std::string error;
+  cmUnityBuildCostFile const* costs =
+    this->GlobalGenerator->GetUnityBuildCostFile(costPath, error);
+  if (!costs) {
+    this->IssueMessage(MessageType::FATAL_ERROR, error);
+    return unity_files;
+  }
+
+  size_t const count = filtered_sources.size();
+  if (batchSize == 0) {
+    batchSize = count;
+  }
+  size_t const batchCount = (count + batchSize - 1) / batchSize;
+
+  // Look up the measured cost of each source.  A ninja log knows the
+  // sources by the object files of a previous build without unity files.
+  std::string const targetDirName = cmStrCat(target->GetName(), ".dir");
+  std::string const objectDir = cmStrCat(this->GetCurrentBinaryDirectory(),
+                                         "/CMakeFiles/", targetDirName, '/');
+  std::vector<cm::optional<double>> sourceCosts;
+  std::vector<double> knownCosts;
+  sourceCosts.reserve(count);
+  for (UnityBatchedSource const& ubs : filtered_sources) {
+    std::string const& fullPath = ubs.Source->ResolveFullPath();
+    std::string objectName =
+      this->GetObjectFileNameWithoutTarget(*ubs.Source, objectDir);
+    std::string::size_type const dot = objectName.rfind('.');
+    if (dot != std::string::npos &&
+        objectName.find('/', dot) == std::string::npos) {
+      objectName.erase(dot);
+    }
+    cm::optional<double> cost =
+      costs->GetCost(fullPath, targetDirName, objectName);
+    if (cost) {
+      cost = QuantizeUnityCost(*cost);
+      knownCosts.push_back(*cost);
+    }
+    sourceCosts.emplace_back(cost);
+  }
+
+  // Sources missing from the cost file are assumed to have the median cost.
+  double defaultCost = 1;
+  if (!knownCosts.empty()) {
+    auto const median = knownCosts.begin() + knownCosts.size() / 2;
+    std::nth_element(knownCosts.begin(), median, knownCosts.end());
+    defaultCost = *median;
+  }
+  std::vector<double> sortCosts;
+  sortCosts.reserve(count);
+  for (cm::optional<double> const& cost : sourceCosts) {
+    sortCosts.push_back(cost ? *cost : defaultCost);
+  }
+
+  // Assign the most expensive sources first, each to the cheapest batch
+  // that is not yet full.  Ties are broken by path so that the same costs
+  // always produce the same batches.
+  std::vector<size_t> order(count);
+  for (size_t i = 0; i < count; ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+    if (sortCosts[l] != sortCosts[r]) {
+      return sortCosts[l] > sortCosts[r];
+    }
+    return filtered_sources[l].Source->GetFullPath() <
+      filtered_sources[r].Source->GetFullPath();
+  });
+  std::vector<double> batchCosts(batchCount, 0);
+  std::vector<size_t> batchSizes(batchCount, 0);
+  std::vector<size_t> sourceBatch(count);
+  for (size_t i : order) {
+    size_t best = batchCount;
+    for (size_t b = 0; b < batchCount; ++b) {
+      if (batchSizes[b] < batchSize &&
+          (best == batchCount || batchCosts[b] < batchCosts[best])) {
+        best = b;
+      }
+    }
+    batchCosts[best] += sortCosts[i];
+    ++batchSizes[best];
+    sourceBatch[i] = best;
+  }
+
+  // Keep the sources of each batch in the order of the target.
+  std::vector<std::vector<UnityBatchedSource>> batches(batchCount);
+  for (size_t i = 0; i < count; ++i) {
+    batches[sourceBatch[i]].emplace_back(filtered_sources[i]);
+  }
+  for (size_t batch = 0; batch < batchCount; ++batch) {
+    std::string filename = cmStrCat(filename_base, "unity_", batch,
+                                    (lang == "C") ? "_c.c" : "_cxx.cxx");
+    unity_files.emplace_back(this->WriteUnitySource(
+      target, configs, cmMakeRange(batches[batch]), beforeInclude,
+      afterInclude, std::move(filename)));
+  }
+  return unity_files;
+}
+
 void cmLocalGenerator::AddUnityBuild(cmGeneratorTarget* target)
 {
   if (!target->GetPropertyAsBool("UNITY_BUILD")) {
@@ -3115,11 +3249,15 @@ void cmLocalGenerator::AddUnityBuild(cmGeneratorTarget* target)
       unity_files =
         AddUnityFilesModeGroup(target, lang, configs, filtered_sources,
                                beforeInclude, afterInclude, filename_base);
+    } else if (unityMode && *unityMode == "COST") {
+      unity_files = AddUnityFilesModeCost(
+        target, lang, configs, filtered_sources, beforeInclude, afterInclude,
+        filename_base, unityBatchSize);
     } else {
       // unity mode is set to an unsupported value
       std::string e("Invalid UNITY_BUILD_MODE value of " + *unityMode +
                     " assigned to target " + target->GetName() +
-                    ". Acceptable values are BATCH and GROUP.");
+                    ". Acceptable values are BATCH, GROUP and COST.");
       this->IssueMessage(MessageType::FATAL_ERROR, e);
     }
 
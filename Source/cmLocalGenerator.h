@@ -691,6 +691,12 @@ private:
     std::vector<UnityBatchedSource> const& filtered_sources,
     cmValue beforeInclude, cmValue afterInclude,
     std::string const& filename_base);
+  std::vector<UnitySource> AddUnityFilesModeCost(
+    cmGeneratorTarget* target, std::string const& lang,
+    std::vector<std::string> const& configs,
+    std::vector<UnityBatchedSource> const& filtered_sources,
+    cmValue beforeInclude, cmValue afterInclude,
+    std::string const& filename_base, size_t batchSize);
 };
 
 #if !defined(CMAKE_BOOTSTRAP)
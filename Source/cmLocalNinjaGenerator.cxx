@@ -66,6 +66,11 @@ void cmLocalNinjaGenerator::Generate()
     this->HomeRelativeOutputPath.clear();
   }
 
+  if (!this->GetGlobalNinjaGenerator()->OpenDirectoryFileStreams(this)) {
+    this->GetGlobalNinjaGenerator()->CloseDirectoryFileStreams();
+    return;
+  }
+
   if (this->GetGlobalGenerator()->IsMultiConfig()) {
     for (auto const& config : this->GetConfigNames()) {
       this->WriteProcessedMakefile(this->GetImplFileStream(config));
@@ -157,6 +162,8 @@ void cmLocalNinjaGenerator::Generate()
     this->WriteCustomCommandBuildStatements(config);
     this->AdditionalCleanFiles(config);
   }
+
+  this->GetGlobalNinjaGenerator()->CloseDirectoryFileStreams();
 }
 
 // TODO: Picked up from cmLocalUnixMakefileGenerator3.  Refactor it.
@@ -597,10 +604,18 @@ void cmLocalNinjaGenerator::WriteCustomCommandBuildStatement(
     // dependencies.
     auto j = targets.begin();
     assert(j != targets.end());
-    this->GetGlobalNinjaGenerator()->AppendTargetDependsClosure(
-      *j, orderOnlyDeps, ccg.GetOutputConfig(), fileConfig, ccgs.size() > 1);
-    std::sort(orderOnlyDeps.begin(), orderOnlyDeps.end());
-    ++j;
+    if (gg->UsePhonyDependsClosures() && targets.size() == 1) {
+      // Refer to the closure through a phony edge written once per target.
+      gg->AppendTargetDependsClosurePhony(*j, orderOnlyDeps,
+                                          ccg.GetOutputConfig(), fileConfig,
+                                          ccgs.size() > 1);
+      j = targets.end();
+    } else {
+      gg->AppendTargetDependsClosure(*j, orderOnlyDeps, ccg.GetOutputConfig(),
+                                     fileConfig, ccgs.size() > 1);
+      std::sort(orderOnlyDeps.begin(), orderOnlyDeps.end());
+      ++j;
+    }
 
     for (; j != targets.end(); ++j) {
       std::vector<std::string> jDeps;
@@ -1424,7 +1424,8 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(
       }
 
       status = this->ScanDependencies(targetDir, dependFile,
-                                      internalDependFile, validDependencies);
+                                      internalDependFile, validDependencies,
+                                      verbose);
     }
   }
 
@@ -1464,29 +1465,25 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(
           message.c_str(), true, color);
       }
 
-      // Open the make depends file.  This should be copy-if-different
-      // because the make tool may try to reload it needlessly otherwise.
-      cmGeneratedFileStream ruleFileStream(
-        depFile, false, this->GlobalGenerator->GetMakefileEncoding());
-      ruleFileStream.SetCopyIfDifferent(true);
-      if (!ruleFileStream) {
-        return false;
+      // Rewrite the make depends file only if the dependencies changed.
+      // This should be copy-if-different because the make tool may try to
+      // reload it needlessly otherwise.
+      if (depsManager.HasChangedDependencies()) {
+        cmGeneratedFileStream ruleFileStream(
+          depFile, false, this->GlobalGenerator->GetMakefileEncoding());
+        ruleFileStream.SetCopyIfDifferent(true);
+        if (!ruleFileStream) {
+          return false;
+        }
+        this->WriteDisclaimer(ruleFileStream);
+        depsManager.WriteDependencies(dependencies, ruleFileStream);
       }
 
-      // Open the cmake dependency tracking file.  This should not be
-      // copy-if-different because dependencies are re-scanned when it is
-      // older than the DependInfo.cmake.
-      cmGeneratedFileStream internalRuleFileStream(
-        internalDepFile, false, this->GlobalGenerator->GetMakefileEncoding());
-      if (!internalRuleFileStream) {
+      // Update the cmake dependency tracking log.  Its timestamp tells
+      // which dependencies files have been consolidated already.
+      if (!depsManager.WriteDependencyLog(internalDepFile, dependencies)) {
         return false;
       }
-
-      this->WriteDisclaimer(ruleFileStream);
-      this->WriteDisclaimer(internalRuleFileStream);
-
-      depsManager.WriteDependencies(dependencies, ruleFileStream,
-                                    internalRuleFileStream);
     }
   }
 
@@ -1496,7 +1493,8 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(
 
 bool cmLocalUnixMakefileGenerator3::ScanDependencies(
   std::string const& targetDir, std::string const& dependFile,
-  std::string const& internalDependFile, cmDepends::DependencyMap& validDeps)
+  std::string const& internalDependFile, cmDepends::DependencyMap& validDeps,
+  bool verbose)
 {
   // Read the directory information file.
   cmMakefile* mf = this->Makefile;
@@ -1578,6 +1576,7 @@ bool cmLocalUnixMakefileGenerator3::ScanDependencies(
 
     if (scanner) {
       scanner->SetLocalGenerator(this);
+      scanner->SetVerbose(verbose);
       scanner->SetFileTimeCache(
         this->GlobalGenerator->GetCMakeInstance()->GetFileTimeCache());
       scanner->SetLanguage(lang);
@@ -1882,6 +1881,13 @@ void cmLocalUnixMakefileGenerator3::WriteDependLanguageInfo(
                         : "OFF")
                   << ")\n\n";
 
+  if (this->Makefile->IsOn("CMAKE_DEPENDS_SCAN_DATABASE")) {
+    cmakefileStream << "# Share scanned include directives among targets.\n"
+                    << "set(CMAKE_DEPENDS_SCAN_DATABASE \""
+                    << this->GetBinaryDirectory()
+                    << "/CMakeFiles/CMakeDependsScan\")\n\n";
+  }
+
   auto const& implicitLangs =
     this->GetImplicitDepends(target, cmDependencyScannerKind::CMake);
 
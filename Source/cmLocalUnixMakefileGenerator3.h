@@ -241,7 +241,7 @@ protected:
   bool ScanDependencies(std::string const& targetDir,
                         std::string const& dependFile,
                         std::string const& internalDependFile,
-                        cmDepends::DependencyMap& validDeps);
+                        cmDepends::DependencyMap& validDeps, bool verbose);
   void CheckMultipleOutputs(bool verbose);
 
 private:
@@ -3,6 +3,7 @@
 #include "cmMakeDirectoryCommand.h"
 
 #include "cmExecutionStatus.h"
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmSystemTools.h"
 
@@ -21,6 +22,9 @@ bool cmMakeDirectoryCommand(std::vector<std::string> const& args,
     cmSystemTools::SetFatalErrorOccurred();
     return false;
   }
+  // The find commands must list the directories again.
+  status.GetMakefile().GetGlobalGenerator()->InvalidateDirectoryContent(
+    cmSystemTools::CollapseFullPath(args[0]));
   cmSystemTools::MakeDirectory(args[0]);
   return true;
 }
@@ -63,6 +63,9 @@
 #include "cmake.h"
 
 #ifndef CMAKE_BOOTSTRAP
+#  include "cmBinaryTrace.h"
+#  include "cmConfigureInputs.h"
+#  include "cmListFileParseCache.h"
 #  include "cmMakefileProfilingData.h"
 #  include "cmVariableWatch.h"
 #endif
@@ -290,6 +293,10 @@ void cmMakefile::PrintCommandTrace(cmListFileFunction const& lff,
     }
   }
 
+  if (!this->GetCMakeInstance()->SampleTrace()) {
+    return;
+  }
+
   std::ostringstream msg;
   std::vector<std::string> args;
   std::string temp;
@@ -335,6 +342,21 @@ void cmMakefile::PrintCommandTrace(cmListFileFunction const& lff,
 #endif
       break;
     }
+    case cmake::TraceFormat::TRACE_BINARY_V1: {
+#ifndef CMAKE_BOOTSTRAP
+      if (cmBinaryTrace* binaryTrace =
+            this->GetCMakeInstance()->GetBinaryTrace()) {
+        binaryTrace->WriteCommand(
+          full_path, lff.Line(), lff.LineEnd(), deferId, lff.OriginalName(),
+          args, cmSystemTools::GetTime(),
+          (missing == CommandMissingFromStack::Yes ? 1 : 0) +
+            static_cast<unsigned long long>(this->ExecutionStatusStack.size()),
+          (missing == CommandMissingFromStack::Yes ? 1 : 0) +
+            static_cast<unsigned long long>(this->RecursionDepth));
+      }
+#endif
+      return;
+    }
     case cmake::TraceFormat::TRACE_HUMAN:
       msg << full_path << "(" << lff.Line() << "):";
       if (deferId) {
@@ -445,7 +467,7 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
 
   // Lookup the command prototype.
   if (cmState::Command command =
-        this->GetState()->GetCommandByExactName(lff.LowerCaseName())) {
+        this->GetState()->GetCommandByExactName(lff.LowerCaseNameAtom())) {
     // Decide whether to invoke the command.
     if (!cmSystemTools::GetFatalErrorOccurred()) {
       // if trace is enabled, print out invoke information
@@ -625,13 +647,13 @@ bool cmMakefile::ReadDependentFile(const std::string& filename,
 
   IncludeScope incScope(this, filenametoread, noPolicyScope);
 
-  cmListFile listFile;
-  if (!listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+  std::shared_ptr<cmListFile const> listFile =
+    this->ParseListFile(filenametoread);
+  if (!listFile) {
     return false;
   }
 
-  this->RunListFile(listFile, filenametoread);
+  this->RunListFile(*listFile, filenametoread);
   if (cmSystemTools::GetFatalErrorOccurred()) {
     incScope.Quiet();
   }
@@ -726,13 +748,13 @@ bool cmMakefile::ReadListFile(const std::string& filename)
 
   ListFileScope scope(this, filenametoread);
 
-  cmListFile listFile;
-  if (!listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+  std::shared_ptr<cmListFile const> listFile =
+    this->ParseListFile(filenametoread);
+  if (!listFile) {
     return false;
   }
 
-  this->RunListFile(listFile, filenametoread);
+  this->RunListFile(*listFile, filenametoread);
   if (cmSystemTools::GetFatalErrorOccurred()) {
     scope.Quiet();
   }
@@ -760,6 +782,23 @@ bool cmMakefile::ReadListFileAsString(const std::string& content,
   return true;
 }
 
+std::shared_ptr<cmListFile const> cmMakefile::ParseListFile(
+  std::string const& filename)
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  if (cmListFileParseCache* cache =
+        this->GetCMakeInstance()->GetListFileParseCache()) {
+    return cache->ParseFile(filename, this->GetMessenger(), this->Backtrace);
+  }
+#endif
+  auto listFile = std::make_shared<cmListFile>();
+  if (!listFile->ParseFile(filename.c_str(), this->GetMessenger(),
+                           this->Backtrace)) {
+    return nullptr;
+  }
+  return listFile;
+}
+
 void cmMakefile::RunListFile(cmListFile const& listFile,
                              std::string const& filenametoread,
                              DeferCommands* defer)
@@ -1621,15 +1660,15 @@ void cmMakefile::Configure()
   assert(cmSystemTools::FileExists(currentStart, true));
   this->AddDefinition("CMAKE_PARENT_LIST_FILE", currentStart);
 
-  cmListFile listFile;
-  if (!listFile.ParseFile(currentStart.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+  std::shared_ptr<cmListFile const> listFile =
+    this->ParseListFile(currentStart);
+  if (!listFile) {
     return;
   }
   if (this->IsRootMakefile()) {
     bool hasVersion = false;
     // search for the right policy command
-    for (cmListFileFunction const& func : listFile.Functions) {
+    for (cmListFileFunction const& func : listFile->Functions) {
       if (func.LowerCaseName() == "cmake_minimum_required") {
         hasVersion = true;
         break;
@@ -1639,7 +1678,7 @@ void cmMakefile::Configure()
     // non advanced functions or a lot of functions
     if (!hasVersion) {
       bool isProblem = true;
-      if (listFile.Functions.size() < 30) {
+      if (listFile->Functions.size() < 30) {
         // the list of simple commands DO NOT ADD TO THIS LIST!!!!!
         // these commands must have backwards compatibility forever and
         // and that is a lot longer than your tiny mind can comprehend mortal
@@ -1656,7 +1695,7 @@ void cmMakefile::Configure()
         allowedCommands.insert("option");
         allowedCommands.insert("message");
         isProblem = false;
-        for (cmListFileFunction const& func : listFile.Functions) {
+        for (cmListFileFunction const& func : listFile->Functions) {
           if (!cm::contains(allowedCommands, func.LowerCaseName())) {
             isProblem = true;
             break;
@@ -1676,7 +1715,7 @@ void cmMakefile::Configure()
     }
     bool hasProject = false;
     // search for a project command
-    for (cmListFileFunction const& func : listFile.Functions) {
+    for (cmListFileFunction const& func : listFile->Functions) {
       if (func.LowerCaseName() == "project") {
         hasProject = true;
         break;
@@ -1701,12 +1740,15 @@ void cmMakefile::Configure()
                                       0 },
                                     { "__CMAKE_INJECTED_PROJECT_COMMAND__",
                                       cmListFileArgument::Unquoted, 0 } } };
-      listFile.Functions.insert(listFile.Functions.begin(), project);
+      // The parsed list file may be shared, so modify a copy.
+      auto withProject = std::make_shared<cmListFile>(*listFile);
+      withProject->Functions.insert(withProject->Functions.begin(), project);
+      listFile = std::move(withProject);
     }
   }
 
   this->Defer = cm::make_unique<DeferCommands>();
-  this->RunListFile(listFile, currentStart, this->Defer.get());
+  this->RunListFile(*listFile, currentStart, this->Defer.get());
   this->Defer.reset();
   if (cmSystemTools::GetFatalErrorOccurred()) {
     scope.Quiet();
@@ -2942,7 +2984,7 @@ MessageType cmMakefile::ExpandVariablesInStringNew(
               }
               break;
             case ENVIRONMENT:
-              if (cmSystemTools::GetEnv(lookup, svalue)) {
+              if (this->GetEnvironmentValue(lookup, svalue)) {
                 value = cmValue(svalue);
               }
               break;
@@ -3586,6 +3628,11 @@ int cmMakefile::TryCompile(const std::string& srcdir,
   // copy trace state
   cm.SetTraceRedirect(this->GetCMakeInstance());
 
+#if !defined(CMAKE_BOOTSTRAP)
+  // reuse list files already parsed by this project
+  cm.ShareListFileParseCache(this->GetCMakeInstance());
+#endif
+
   // do a configure
   cm.SetHomeDirectory(srcdir);
   cm.SetHomeOutputDirectory(bindir);
@@ -3748,7 +3795,9 @@ std::string cmMakefile::GetModulesFile(const std::string& filename,
       cmSystemTools::ConvertToUnixSlashes(itempl);
       itempl += "/";
       itempl += filename;
-      if (cmSystemTools::FileExists(itempl)) {
+      bool const exists = cmSystemTools::FileExists(itempl);
+      this->RecordPathQuery("EXISTS", itempl, exists);
+      if (exists) {
         moduleInCMakeModulePath = itempl;
         break;
       }
@@ -3762,7 +3811,9 @@ std::string cmMakefile::GetModulesFile(const std::string& filename,
   moduleInCMakeRoot =
     cmStrCat(cmSystemTools::GetCMakeRoot(), "/Modules/", filename);
   cmSystemTools::ConvertToUnixSlashes(moduleInCMakeRoot);
-  if (!cmSystemTools::FileExists(moduleInCMakeRoot)) {
+  bool const existsInCMakeRoot = cmSystemTools::FileExists(moduleInCMakeRoot);
+  this->RecordPathQuery("EXISTS", moduleInCMakeRoot, existsInCMakeRoot);
+  if (!existsInCMakeRoot) {
     if (debug) {
       debugBuffer = cmStrCat(debugBuffer, "  ", moduleInCMakeRoot, "\n");
     }
@@ -3907,6 +3958,7 @@ int cmMakefile::ConfigureFile(const std::string& infile,
   // when we finalize the configuration we will remove all
   // output files that now don't exist.
   this->AddCMakeOutputFile(soutfile);
+  this->GetGlobalGenerator()->InvalidateDirectoryContent(soutfile);
 
   if (permissions == 0) {
     cmSystemTools::GetPermissions(sinfile, permissions);
@@ -4098,6 +4150,47 @@ void cmMakefile::AddCMakeDependFilesFromUser()
   }
 }
 
+bool cmMakefile::GetEnvironmentValue(std::string const& name,
+                                     std::string& value) const
+{
+  bool const defined = cmSystemTools::GetEnv(name, value);
+#if !defined(CMAKE_BOOTSTRAP)
+  if (cmConfigureInputs* inputs =
+        this->GetCMakeInstance()->GetConfigureInputs()) {
+    inputs->RecordEnvironment(
+      this, name, defined ? cm::make_optional(value) : cm::nullopt);
+  }
+#endif
+  return defined;
+}
+
+void cmMakefile::RecordPathQuery(cm::string_view query,
+                                 std::string const& path, bool result) const
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  if (cmConfigureInputs* inputs =
+        this->GetCMakeInstance()->GetConfigureInputs()) {
+    inputs->RecordPathQuery(this, query, path, result);
+  }
+#else
+  static_cast<void>(query);
+  static_cast<void>(path);
+  static_cast<void>(result);
+#endif
+}
+
+void cmMakefile::MarkConfigureVolatile(cm::string_view reason) const
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  if (cmConfigureInputs* inputs =
+        this->GetCMakeInstance()->GetConfigureInputs()) {
+    inputs->MarkVolatile(this, reason);
+  }
+#else
+  static_cast<void>(reason);
+#endif
+}
+
 std::string cmMakefile::FormatListFileStack() const
 {
   std::vector<std::string> listFiles;
@@ -631,6 +631,23 @@ public:
   }
   void AddCMakeDependFilesFromUser();
 
+  /**
+   * Look up an environment variable on behalf of the project code of this
+   * directory.  The lookup is recorded as an input of the directory when
+   * --skip-unchanged-reconfigure is given.
+   */
+  bool GetEnvironmentValue(std::string const& name, std::string& value) const;
+
+  //! Record the result of a file system query as an input.
+  void RecordPathQuery(cm::string_view query, std::string const& path,
+                       bool result) const;
+
+  /**
+   * Note that this directory read inputs that cannot be recorded, so
+   * --skip-unchanged-reconfigure must always configure it again.
+   */
+  void MarkConfigureVolatile(cm::string_view reason) const;
+
   std::string FormatListFileStack() const;
 
   /**
@@ -1102,6 +1119,9 @@ private:
                    const std::string& filenametoread,
                    DeferCommands* defer = nullptr);
 
+  std::shared_ptr<cmListFile const> ParseListFile(
+    std::string const& filename);
+
   bool ParseDefineFlag(std::string const& definition, bool remove);
 
   bool EnforceUniqueDir(const std::string& srcPath,
@@ -8,6 +8,7 @@
 #include <utility>
 #include <vector>
 
+#include <cm/memory>
 #include <cm/utility>
 
 #include <cm3p/json/value.h>
@@ -17,11 +18,12 @@
 #include "cmsys/SystemInformation.hxx"
 
 #include "cmListFileCache.h"
+#include "cmMakefileProfilingSummary.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 
 cmMakefileProfilingData::cmMakefileProfilingData(
-  const std::string& profileStream)
+  const std::string& profileStream, Format format)
 {
   std::ios::openmode omode = std::ios::out | std::ios::trunc;
   this->ProfileStream.open(profileStream.c_str(), omode);
@@ -32,6 +34,11 @@ cmMakefileProfilingData::cmMakefileProfilingData(
     throw std::runtime_error(std::string("Unable to open: ") + profileStream);
   }
 
+  if (format == Format::Summary) {
+    this->Summary = cm::make_unique<cmMakefileProfilingSummary>();
+    return;
+  }
+
   this->ProfileStream << "[";
 }
 
@@ -39,7 +46,11 @@ cmMakefileProfilingData::~cmMakefileProfilingData() noexcept
 {
   if (this->ProfileStream.good()) {
     try {
-      this->ProfileStream << "]";
+      if (this->Summary) {
+        this->Summary->Write(this->ProfileStream);
+      } else {
+        this->ProfileStream << "]";
+      }
       this->ProfileStream.close();
     } catch (...) {
       cmSystemTools::Error("Error writing profiling output!");
@@ -50,6 +61,11 @@ cmMakefileProfilingData::~cmMakefileProfilingData() noexcept
 void cmMakefileProfilingData::StartEntry(const cmListFileFunction& lff,
                                          cmListFileContext const& lfc)
 {
+  if (this->Summary) {
+    this->Summary->StartEntry(lff, lfc);
+    return;
+  }
+
   cm::optional<Json::Value> argsValue(cm::in_place, Json::objectValue);
   if (!lff.Arguments().empty()) {
     std::string args;
@@ -67,6 +83,11 @@ void cmMakefileProfilingData::StartEntry(const std::string& category,
                                          const std::string& name,
                                          cm::optional<Json::Value> args)
 {
+  if (this->Summary) {
+    this->Summary->StartEntry(category, name);
+    return;
+  }
+
   /* Do not try again if we previously failed to write to output. */
   if (!this->ProfileStream.good()) {
     return;
@@ -102,6 +123,11 @@ void cmMakefileProfilingData::StartEntry(const std::string& category,
 
 void cmMakefileProfilingData::StopEntry()
 {
+  if (this->Summary) {
+    this->Summary->StopEntry();
+    return;
+  }
+
   /* Do not try again if we previously failed to write to output. */
   if (!this->ProfileStream.good()) {
     return;
@@ -127,6 +153,43 @@ void cmMakefileProfilingData::StopEntry()
   }
 }
 
+void cmMakefileProfilingData::AddCounters(const std::string& name,
+                                          Json::Value counters)
+{
+  if (this->Summary) {
+    this->Summary->AddCounters(name, std::move(counters));
+    return;
+  }
+
+  /* Do not try again if we previously failed to write to output. */
+  if (!this->ProfileStream.good()) {
+    return;
+  }
+
+  try {
+    if (this->ProfileStream.tellp() > 1) {
+      this->ProfileStream << ",";
+    }
+    cmsys::SystemInformation info;
+    Json::Value v;
+    v["ph"] = "C";
+    v["name"] = name;
+    v["ts"] = static_cast<Json::Value::UInt64>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count());
+    v["pid"] = static_cast<int>(info.GetProcessId());
+    v["tid"] = 0;
+    v["args"] = std::move(counters);
+    this->JsonWriter->write(v, &this->ProfileStream);
+  } catch (std::ios_base::failure& fail) {
+    cmSystemTools::Error(
+      cmStrCat("Failed to write to profiling output: ", fail.what()));
+  } catch (...) {
+    cmSystemTools::Error("Error writing profiling output!");
+  }
+}
+
 cmMakefileProfilingData::RAII::RAII(RAII&& other) noexcept
   : Data(other.Data)
 {
@@ -17,16 +17,28 @@ class StreamWriter;
 
 class cmListFileContext;
 class cmListFileFunction;
+class cmMakefileProfilingSummary;
 
 class cmMakefileProfilingData
 {
 public:
-  cmMakefileProfilingData(const std::string&);
+  enum class Format
+  {
+    // One event per command, in Google Trace Format.
+    GoogleTrace,
+    // Times aggregated by location and command, see
+    // cmMakefileProfilingSummary.
+    Summary,
+  };
+
+  cmMakefileProfilingData(const std::string&,
+                          Format format = Format::GoogleTrace);
   ~cmMakefileProfilingData() noexcept;
   void StartEntry(const cmListFileFunction& lff, cmListFileContext const& lfc);
   void StartEntry(const std::string& category, const std::string& name,
                   cm::optional<Json::Value> args = cm::nullopt);
   void StopEntry();
+  void AddCounters(const std::string& name, Json::Value counters);
 
   class RAII
   {
@@ -54,4 +66,5 @@ public:
 private:
   cmsys::ofstream ProfileStream;
   std::unique_ptr<Json::StreamWriter> JsonWriter;
+  std::unique_ptr<cmMakefileProfilingSummary> Summary;
 };
@@ -0,0 +1,186 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmMakefileProfilingSummary.h"
+
+#include <algorithm>
+#include <memory>
+#include <ostream>
+
+#include <cm3p/json/writer.h>
+
+#include "cmListFileCache.h"
+
+namespace {
+Json::Value::Int64 Microseconds(std::chrono::steady_clock::duration d)
+{
+  return static_cast<Json::Value::Int64>(
+    std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+}
+
+// Order items by decreasing self time, keeping the first seen first.
+template <typename T, typename F>
+std::vector<std::size_t> SortBySelfTime(std::vector<T> const& items, F times)
+{
+  std::vector<std::size_t> order(items.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&items, &times](std::size_t l, std::size_t r) {
+                     return times(items[l]).Self > times(items[r]).Self;
+                   });
+  return order;
+}
+}
+
+void cmMakefileProfilingSummary::StartEntry(cmListFileFunction const& lff,
+                                            cmListFileContext const& lfc)
+{
+  // Consecutive commands are usually in the same file.
+  if (!this->LastFileLocations || lfc.FilePath != this->LastFile) {
+    this->LastFile = lfc.FilePath;
+    this->LastFileLocations = &this->LocationIndex[lfc.FilePath];
+  }
+
+  std::string const& name = lff.LowerCaseName();
+  auto const inserted = this->LastFileLocations->emplace(
+    std::make_pair(lfc.Line, name), this->Locations.size());
+  if (inserted.second) {
+    Location location;
+    location.Category = "script";
+    location.File = lfc.FilePath;
+    location.Line = lfc.Line;
+    location.Name = name;
+    this->Locations.push_back(std::move(location));
+  }
+
+  auto const command =
+    this->CommandIndex.emplace(name, this->Commands.size());
+  if (command.second) {
+    this->Commands.emplace_back(name, Times());
+  }
+
+  this->Start(inserted.first->second, command.first->second);
+}
+
+void cmMakefileProfilingSummary::StartEntry(std::string const& category,
+                                            std::string const& name)
+{
+  auto const inserted = this->EntryIndex.emplace(
+    std::make_pair(category, name), this->Locations.size());
+  if (inserted.second) {
+    Location location;
+    location.Category = category;
+    location.Name = name;
+    this->Locations.push_back(std::move(location));
+  }
+
+  this->Start(inserted.first->second, NoCommand);
+}
+
+void cmMakefileProfilingSummary::Start(std::size_t location,
+                                       std::size_t command)
+{
+  ++this->Locations[location].Active;
+  if (command != NoCommand) {
+    ++this->Commands[command].second.Active;
+  }
+  this->Stack.push_back(
+    Frame{ location, command, Clock::now(), Clock::duration::zero() });
+}
+
+void cmMakefileProfilingSummary::StopEntry()
+{
+  if (this->Stack.empty()) {
+    return;
+  }
+
+  Frame const frame = this->Stack.back();
+  this->Stack.pop_back();
+  Clock::duration const total = Clock::now() - frame.Start;
+  Clock::duration const self = total - frame.Children;
+
+  Stop(this->Locations[frame.Location], total, self);
+  if (frame.Command != NoCommand) {
+    Stop(this->Commands[frame.Command].second, total, self);
+  }
+
+  if (this->Stack.empty()) {
+    this->TotalTime += total;
+  } else {
+    this->Stack.back().Children += total;
+  }
+}
+
+void cmMakefileProfilingSummary::Stop(Times& times, Clock::duration total,
+                                      Clock::duration self)
+{
+  ++times.Calls;
+  times.Self += self;
+  if (--times.Active == 0) {
+    times.Total += total;
+  }
+}
+
+void cmMakefileProfilingSummary::AddCounters(std::string const& name,
+                                             Json::Value counters)
+{
+  this->Counters[name] = std::move(counters);
+}
+
+Json::Value cmMakefileProfilingSummary::TimesToJson(Times const& times)
+{
+  Json::Value v(Json::objectValue);
+  v["calls"] = static_cast<Json::Value::UInt64>(times.Calls);
+  v["selfTime"] = Microseconds(times.Self);
+  v["totalTime"] = Microseconds(times.Total);
+  return v;
+}
+
+void cmMakefileProfilingSummary::Write(std::ostream& os) const
+{
+  Json::Value root(Json::objectValue);
+  root["version"] = 1;
+  root["totalTime"] = Microseconds(this->TotalTime);
+
+  Json::Value& commands = root["commands"] = Json::arrayValue;
+  for (std::size_t i : SortBySelfTime(
+         this->Commands,
+         [](std::pair<std::string, Times> const& c) -> Times const& {
+           return c.second;
+         })) {
+    Json::Value v = TimesToJson(this->Commands[i].second);
+    v["name"] = this->Commands[i].first;
+    commands.append(std::move(v));
+  }
+
+  Json::Value& locations = root["locations"] = Json::arrayValue;
+  Json::Value& entries = root["entries"] = Json::arrayValue;
+  for (std::size_t i : SortBySelfTime(
+         this->Locations,
+         [](Location const& l) -> Times const& { return l; })) {
+    Location const& location = this->Locations[i];
+    Json::Value v = TimesToJson(location);
+    if (location.File.empty()) {
+      v["category"] = location.Category;
+      v["name"] = location.Name;
+      entries.append(std::move(v));
+    } else {
+      v["file"] = location.File;
+      v["line"] = static_cast<Json::Value::Int64>(location.Line);
+      v["command"] = location.Name;
+      locations.append(std::move(v));
+    }
+  }
+
+  Json::Value& counters = root["counters"] = Json::objectValue;
+  for (auto const& c : this->Counters) {
+    counters[c.first] = c.second;
+  }
+
+  Json::StreamWriterBuilder wbuilder;
+  wbuilder["indentation"] = "";
+  std::unique_ptr<Json::StreamWriter> jsonWriter(wbuilder.newStreamWriter());
+  jsonWriter->write(root, &os);
+  os << '\n';
+}
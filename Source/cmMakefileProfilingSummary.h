@@ -0,0 +1,87 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cm3p/json/value.h>
+
+class cmListFileContext;
+class cmListFileFunction;
+
+/** \class cmMakefileProfilingSummary
+ * \brief Aggregate the time spent running CMake script.
+ *
+ * Rather than recording an event for every command executed, keep the
+ * number of calls, the time spent including nested calls (total) and the
+ * time spent excluding them (self), per location and per command name.
+ * Time spent in a recursive call is counted once in the total time.
+ */
+class cmMakefileProfilingSummary
+{
+public:
+  void StartEntry(cmListFileFunction const& lff, cmListFileContext const& lfc);
+  void StartEntry(std::string const& category, std::string const& name);
+  void StopEntry();
+  void AddCounters(std::string const& name, Json::Value counters);
+
+  /** Write the summary as JSON.  */
+  void Write(std::ostream& os) const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Times
+  {
+    std::size_t Calls = 0;
+    Clock::duration Self = Clock::duration::zero();
+    Clock::duration Total = Clock::duration::zero();
+    unsigned int Active = 0;
+  };
+
+  struct Location : public Times
+  {
+    std::string Category;
+    std::string File;
+    long Line = 0;
+    std::string Name;
+  };
+
+  struct Frame
+  {
+    std::size_t Location;
+    std::size_t Command;
+    Clock::time_point Start;
+    Clock::duration Children;
+  };
+
+  static std::size_t const NoCommand = static_cast<std::size_t>(-1);
+
+  void Start(std::size_t location, std::size_t command);
+  static void Stop(Times& times, Clock::duration total,
+                   Clock::duration self);
+  static Json::Value TimesToJson(Times const& times);
+
+  std::vector<Location> Locations;
+  std::vector<std::pair<std::string, Times>> Commands;
+  std::vector<Frame> Stack;
+  Clock::duration TotalTime = Clock::duration::zero();
+  std::map<std::string, Json::Value> Counters;
+
+  // Look up locations by file, then by line and command name.
+  using FileLocations = std::map<std::pair<long, std::string>, std::size_t>;
+  std::unordered_map<std::string, FileLocations> LocationIndex;
+  std::string LastFile;
+  FileLocations* LastFileLocations = nullptr;
+  std::map<std::pair<std::string, std::string>, std::size_t> EntryIndex;
+  std::unordered_map<std::string, std::size_t> CommandIndex;
+};
@@ -314,40 +314,6 @@ void cmMakefileTargetGenerator::WriteTargetBuildRules()
     }
   }
 
-  std::map<std::string, std::string> file_set_map;
-
-  auto const* tgt = this->GeneratorTarget->Target;
-  for (auto const& name : tgt->GetAllFileSetNames()) {
-    auto const* file_set = tgt->GetFileSet(name);
-    if (!file_set) {
-      this->Makefile->IssueMessage(
-        MessageType::INTERNAL_ERROR,
-        cmStrCat("Target \"", tgt->GetName(),
-                 "\" is tracked to have file set \"", name,
-                 "\", but it was not found."));
-      continue;
-    }
-
-    auto fileEntries = file_set->CompileFileEntries();
-    auto directoryEntries = file_set->CompileDirectoryEntries();
-    auto directories = file_set->EvaluateDirectoryEntries(
-      directoryEntries, this->LocalGenerator, this->GetConfigName(),
-      this->GeneratorTarget);
-
-    std::map<std::string, std::vector<std::string>> files;
-    for (auto const& entry : fileEntries) {
-      file_set->EvaluateFileEntry(directories, files, entry,
-                                  this->LocalGenerator, this->GetConfigName(),
-                                  this->GeneratorTarget);
-    }
-
-    for (auto const& it : files) {
-      for (auto const& filename : it.second) {
-        file_set_map[filename] = file_set->GetType();
-      }
-    }
-  }
-
   std::vector<cmSourceFile const*> objectSources;
   this->GeneratorTarget->GetObjectSources(objectSources,
                                           this->GetConfigName());
@@ -361,6 +327,8 @@ void cmMakefileTargetGenerator::WriteTargetBuildRules()
     }
   }
 
+  auto const& file_set_map = this->GetFileSetTypes(this->GetConfigName());
+  auto const* tgt = this->GeneratorTarget->Target;
   for (cmSourceFile const* sf : objectSources) {
     auto const& path = sf->GetFullPath();
     auto const it = file_set_map.find(path);
@@ -598,6 +566,54 @@ void cmMakefileTargetGenerator::MacOSXContentGeneratorType::operator()(
   this->Generator->ExtraFiles.insert(output);
 }
 
+cmMakefileTargetGenerator::ObjectRuleTargetPaths const&
+cmMakefileTargetGenerator::GetObjectRuleTargetPaths()
+{
+  if (this->TargetPathsForObjectRules) {
+    return *this->TargetPathsForObjectRules;
+  }
+  auto paths = cm::make_unique<ObjectRuleTargetPaths>();
+
+  std::string targetFullPathReal;
+  std::string targetFullPathPDB;
+  std::string targetFullPathCompilePDB =
+    this->ComputeTargetCompilePDB(this->GetConfigName());
+  if (this->GeneratorTarget->GetType() == cmStateEnums::EXECUTABLE ||
+      this->GeneratorTarget->GetType() == cmStateEnums::STATIC_LIBRARY ||
+      this->GeneratorTarget->GetType() == cmStateEnums::SHARED_LIBRARY ||
+      this->GeneratorTarget->GetType() == cmStateEnums::MODULE_LIBRARY) {
+    targetFullPathReal = this->GeneratorTarget->GetFullPath(
+      this->GetConfigName(), cmStateEnums::RuntimeBinaryArtifact, true);
+    targetFullPathPDB = cmStrCat(
+      this->GeneratorTarget->GetPDBDirectory(this->GetConfigName()), '/',
+      this->GeneratorTarget->GetPDBName(this->GetConfigName()));
+  }
+
+  paths->Real = this->LocalGenerator->ConvertToOutputFormat(
+    this->LocalGenerator->MaybeRelativeToCurBinDir(targetFullPathReal),
+    cmOutputConverter::SHELL);
+  paths->PDB = this->LocalGenerator->ConvertToOutputFormat(
+    targetFullPathPDB, cmOutputConverter::SHELL);
+  paths->CompilePDB = this->LocalGenerator->ConvertToOutputFormat(
+    this->LocalGenerator->MaybeRelativeToCurBinDir(targetFullPathCompilePDB),
+    cmOutputConverter::SHELL);
+
+  if (this->LocalGenerator->IsMinGWMake() &&
+      cmHasLiteralSuffix(paths->CompilePDB, "\\")) {
+    // mingw32-make incorrectly interprets 'a\ b c' as 'a b' and 'c'
+    // (but 'a\ b "c"' as 'a\', 'b', and 'c'!).  Workaround this by
+    // avoiding a trailing backslash in the argument.
+    paths->CompilePDB.back() = '/';
+  }
+
+  std::string compilePdbOutputPath =
+    this->GeneratorTarget->GetCompilePDBDirectory(this->GetConfigName());
+  cmSystemTools::MakeDirectory(compilePdbOutputPath);
+
+  this->TargetPathsForObjectRules = std::move(paths);
+  return *this->TargetPathsForObjectRules;
+}
+
 void cmMakefileTargetGenerator::WriteObjectRuleFiles(
   cmSourceFile const& source)
 {
@@ -669,22 +685,15 @@ void cmMakefileTargetGenerator::WriteObjectRuleFiles(
   std::string configUpper = cmSystemTools::UpperCase(config);
 
   // Add precompile headers dependencies
-  std::vector<std::string> architectures;
-  this->GeneratorTarget->GetAppleArchs(config, architectures);
-  if (architectures.empty()) {
-    architectures.emplace_back();
-  }
-
+  CompileSignature const& signature = this->GetCompileSignature(lang, config);
+  std::vector<std::string> const& architectures = signature.Architectures;
+  std::unordered_map<std::string, std::string> const& pchSources =
+    signature.PchSources;
   std::string filterArch;
-  std::unordered_map<std::string, std::string> pchSources;
-  for (const std::string& arch : architectures) {
-    const std::string pchSource =
-      this->GeneratorTarget->GetPchSource(config, lang, arch);
-    if (pchSource == source.GetFullPath()) {
-      filterArch = arch;
-    }
-    if (!pchSource.empty()) {
-      pchSources.insert(std::make_pair(pchSource, arch));
+  {
+    auto pchIt = pchSources.find(source.GetFullPath());
+    if (pchIt != pchSources.end()) {
+      filterArch = pchIt->second;
     }
   }
 
@@ -857,54 +866,16 @@ void cmMakefileTargetGenerator::WriteObjectRuleFiles(
                                      &progress);
   }
 
-  std::string targetOutPathReal;
-  std::string targetOutPathPDB;
-  std::string targetOutPathCompilePDB;
-  {
-    std::string targetFullPathReal;
-    std::string targetFullPathPDB;
-    std::string targetFullPathCompilePDB =
-      this->ComputeTargetCompilePDB(this->GetConfigName());
-    if (this->GeneratorTarget->GetType() == cmStateEnums::EXECUTABLE ||
-        this->GeneratorTarget->GetType() == cmStateEnums::STATIC_LIBRARY ||
-        this->GeneratorTarget->GetType() == cmStateEnums::SHARED_LIBRARY ||
-        this->GeneratorTarget->GetType() == cmStateEnums::MODULE_LIBRARY) {
-      targetFullPathReal = this->GeneratorTarget->GetFullPath(
-        this->GetConfigName(), cmStateEnums::RuntimeBinaryArtifact, true);
-      targetFullPathPDB = cmStrCat(
-        this->GeneratorTarget->GetPDBDirectory(this->GetConfigName()), '/',
-        this->GeneratorTarget->GetPDBName(this->GetConfigName()));
-    }
-
-    targetOutPathReal = this->LocalGenerator->ConvertToOutputFormat(
-      this->LocalGenerator->MaybeRelativeToCurBinDir(targetFullPathReal),
-      cmOutputConverter::SHELL);
-    targetOutPathPDB = this->LocalGenerator->ConvertToOutputFormat(
-      targetFullPathPDB, cmOutputConverter::SHELL);
-    targetOutPathCompilePDB = this->LocalGenerator->ConvertToOutputFormat(
-      this->LocalGenerator->MaybeRelativeToCurBinDir(targetFullPathCompilePDB),
-      cmOutputConverter::SHELL);
-
-    if (this->LocalGenerator->IsMinGWMake() &&
-        cmHasLiteralSuffix(targetOutPathCompilePDB, "\\")) {
-      // mingw32-make incorrectly interprets 'a\ b c' as 'a b' and 'c'
-      // (but 'a\ b "c"' as 'a\', 'b', and 'c'!).  Workaround this by
-      // avoiding a trailing backslash in the argument.
-      targetOutPathCompilePDB.back() = '/';
-    }
-
-    std::string compilePdbOutputPath =
-      this->GeneratorTarget->GetCompilePDBDirectory(this->GetConfigName());
-    cmSystemTools::MakeDirectory(compilePdbOutputPath);
-  }
+  ObjectRuleTargetPaths const& targetPaths =
+    this->GetObjectRuleTargetPaths();
   cmRulePlaceholderExpander::RuleVariables vars;
   vars.CMTargetName = this->GeneratorTarget->GetName().c_str();
   vars.CMTargetType =
     cmState::GetTargetTypeName(this->GeneratorTarget->GetType()).c_str();
   vars.Language = lang.c_str();
-  vars.Target = targetOutPathReal.c_str();
-  vars.TargetPDB = targetOutPathPDB.c_str();
-  vars.TargetCompilePDB = targetOutPathCompilePDB.c_str();
+  vars.Target = targetPaths.Real.c_str();
+  vars.TargetPDB = targetPaths.PDB.c_str();
+  vars.TargetCompilePDB = targetPaths.CompilePDB.c_str();
   vars.Source = sourceFile.c_str();
   std::string shellObj =
     this->LocalGenerator->ConvertToOutputFormat(obj, cmOutputConverter::SHELL);
@@ -100,6 +100,15 @@ protected:
   // write the rules for an object
   void WriteObjectRuleFiles(cmSourceFile const& source);
 
+  // the target paths referenced by the compile rules of all objects
+  struct ObjectRuleTargetPaths
+  {
+    std::string Real;
+    std::string PDB;
+    std::string CompilePDB;
+  };
+  ObjectRuleTargetPaths const& GetObjectRuleTargetPaths();
+
   // write the depend.make file for an object
   void WriteObjectDependRules(cmSourceFile const& source,
                               std::vector<std::string>& depends);
@@ -265,4 +274,7 @@ protected:
   std::set<std::string> MacContentFolders;
   std::unique_ptr<cmOSXBundleGenerator> OSXBundleGenerator;
   std::unique_ptr<MacOSXContentGeneratorType> MacOSXContentGenerator;
+
+  // Computed once for the compile rules of all objects.
+  std::unique_ptr<ObjectRuleTargetPaths> TargetPathsForObjectRules;
 };
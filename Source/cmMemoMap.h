@@ -0,0 +1,64 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+/** \class cmMemoMap
+ * \brief Map of lazily computed values that may be read concurrently.
+ *
+ * Each value is computed at most once per key and never changes once it
+ * is stored, so references returned by Get stay valid for the lifetime of
+ * the map and may be shared between threads.
+ *
+ * Computing a value usually reads other lazily filled state, so Get takes
+ * a caller-provided recursive mutex around the computation.  All maps
+ * sharing that mutex therefore fill in one thread at a time, while lookups
+ * of values computed earlier only take the short per-map lock.
+ */
+template <typename Key, typename Value>
+class cmMemoMap
+{
+public:
+  cmMemoMap() = default;
+  cmMemoMap(cmMemoMap const&) = delete;
+  cmMemoMap& operator=(cmMemoMap const&) = delete;
+
+  /** Return the value for a key, computing it with the given function
+      while holding computeMutex if it is not yet known.  */
+  template <typename Compute>
+  Value const& Get(Key const& key, std::recursive_mutex& computeMutex,
+                   Compute const& compute) const
+  {
+    if (Value const* value = this->Find(key)) {
+      return *value;
+    }
+    std::lock_guard<std::recursive_mutex> computeLock(computeMutex);
+    // Another thread may have computed the value while we waited.
+    if (Value const* value = this->Find(key)) {
+      return *value;
+    }
+    Value value = compute();
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    return this->Map.emplace(key, std::move(value)).first->second;
+  }
+
+  /** Return the value for a key if it has been computed, or null.  */
+  Value const* Find(Key const& key) const
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    auto i = this->Map.find(key);
+    return i != this->Map.end() ? &i->second : nullptr;
+  }
+
+  /** Forget all values.  Must not race with any other call.  */
+  void Clear() { this->Map.clear(); }
+
+private:
+  mutable std::mutex Mutex;
+  mutable std::map<Key, Value> Map;
+};
@@ -190,6 +190,8 @@ void PrintCallStack(std::ostream& out, cmListFileBacktrace bt,
 void cmMessenger::IssueMessage(MessageType t, const std::string& text,
                                const cmListFileBacktrace& backtrace) const
 {
+  ++this->IssuedMessageCount;
+
   bool force = false;
   // override the message type, if needed, for warnings and errors
   MessageType override = this->ConvertMessageType(t);
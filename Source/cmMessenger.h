@@ -4,6 +4,8 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <atomic>
+#include <cstddef>
 #include <iosfwd>
 #include <string>
 
@@ -56,6 +58,12 @@ public:
   void PrintBacktraceTitle(std::ostream& out,
                            cmListFileBacktrace const& bt) const;
 
+  // The number of messages issued so far, shown or not.
+  std::size_t GetIssuedMessageCount() const
+  {
+    return this->IssuedMessageCount;
+  }
+
 private:
   bool IsMessageTypeVisible(MessageType t) const;
   MessageType ConvertMessageType(MessageType t) const;
@@ -66,4 +74,6 @@ private:
   bool SuppressDeprecatedWarnings = false;
   bool DevWarningsAsErrors = false;
   bool DeprecatedWarningsAsErrors = false;
+
+  mutable std::atomic<std::size_t> IssuedMessageCount{ 0 };
 };
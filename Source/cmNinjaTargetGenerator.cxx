@@ -8,7 +8,6 @@
 #include <map>
 #include <ostream>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 
 #include <cm/memory>
@@ -188,25 +187,52 @@ std::string cmNinjaTargetGenerator::ComputeFlagsForObject(
   cmSourceFile const* source, const std::string& language,
   const std::string& config)
 {
-  std::vector<std::string> architectures;
-  std::unordered_map<std::string, std::string> pchSources;
-  this->GeneratorTarget->GetAppleArchs(config, architectures);
-  if (architectures.empty()) {
-    architectures.emplace_back();
-  }
-
-  std::string filterArch;
-  for (const std::string& arch : architectures) {
-    const std::string pchSource =
-      this->GeneratorTarget->GetPchSource(config, language, arch);
-    if (pchSource == source->GetFullPath()) {
-      filterArch = arch;
+  auto const& path = source->GetFullPath();
+  auto const* tgt = this->GeneratorTarget->Target;
+
+  auto const& fileSetTypes = this->GetFileSetTypes(config);
+  auto const fileSetIt = fileSetTypes.find(path);
+  if (fileSetIt != fileSetTypes.end()) {
+    std::string const& file_set_type = fileSetIt->second;
+    if (file_set_type == "CXX_MODULES"_s ||
+        file_set_type == "CXX_MODULE_HEADER_UNITS"_s) {
+      if (source->GetLanguage() != "CXX"_s) {
+        this->GetMakefile()->IssueMessage(
+          MessageType::FATAL_ERROR,
+          cmStrCat(
+            "Target \"", tgt->GetName(), "\" contains the source\n  ", path,
+            "\nin a file set of type \"", file_set_type,
+            R"(" but the source is not classified as a "CXX" source.)"));
+      }
     }
-    if (!pchSource.empty()) {
-      pchSources.insert(std::make_pair(pchSource, arch));
+  }
+
+  CompileSignature const& signature =
+    this->GetCompileSignature(language, config);
+  auto const pchIt = signature.PchSources.find(path);
+  bool const usePch = !signature.PchSources.empty() &&
+    !source->GetProperty("SKIP_PRECOMPILE_HEADERS");
+
+  const std::string COMPILE_FLAGS("COMPILE_FLAGS");
+  const std::string COMPILE_OPTIONS("COMPILE_OPTIONS");
+  cmValue cflags = source->GetProperty(COMPILE_FLAGS);
+  cmValue coptions = source->GetProperty(COMPILE_OPTIONS);
+
+  // Most sources have no flags of their own and share those of the target.
+  cm::optional<std::string>* sharedFlags = nullptr;
+  if (!cflags && !coptions && pchIt == signature.PchSources.end() &&
+      language != "Fortran" && !source->GetProperty("LANGUAGE")) {
+    SharedCompileVars& shared =
+      this->Configs[config].SharedCompileVarsByLanguage[language];
+    sharedFlags = usePch ? &shared.FlagsWithPch : &shared.Flags;
+    if (*sharedFlags) {
+      return **sharedFlags;
     }
   }
 
+  std::string const filterArch =
+    pchIt != signature.PchSources.end() ? pchIt->second : std::string();
+
   std::string flags;
   // Explicitly add the explicit language flag before any other flag
   // so user flags can override it.
@@ -228,23 +254,20 @@ std::string cmNinjaTargetGenerator::ComputeFlagsForObject(
   cmGeneratorExpressionInterpreter genexInterpreter(
     this->LocalGenerator, config, this->GeneratorTarget, language);
 
-  const std::string COMPILE_FLAGS("COMPILE_FLAGS");
-  if (cmValue cflags = source->GetProperty(COMPILE_FLAGS)) {
+  if (cflags) {
     this->LocalGenerator->AppendFlags(
       flags, genexInterpreter.Evaluate(*cflags, COMPILE_FLAGS));
   }
 
-  const std::string COMPILE_OPTIONS("COMPILE_OPTIONS");
-  if (cmValue coptions = source->GetProperty(COMPILE_OPTIONS)) {
+  if (coptions) {
     this->LocalGenerator->AppendCompileOptions(
       flags, genexInterpreter.Evaluate(*coptions, COMPILE_OPTIONS));
   }
 
   // Add precompile headers compile options.
-  if (!pchSources.empty() && !source->GetProperty("SKIP_PRECOMPILE_HEADERS")) {
+  if (usePch) {
     std::string pchOptions;
-    auto pchIt = pchSources.find(source->GetFullPath());
-    if (pchIt != pchSources.end()) {
+    if (pchIt != signature.PchSources.end()) {
       pchOptions = this->GeneratorTarget->GetPchCreateCompileOptions(
         config, language, pchIt->second);
     } else {
@@ -256,57 +279,9 @@ std::string cmNinjaTargetGenerator::ComputeFlagsForObject(
       flags, genexInterpreter.Evaluate(pchOptions, COMPILE_OPTIONS));
   }
 
-  auto const& path = source->GetFullPath();
-  auto const* tgt = this->GeneratorTarget->Target;
-
-  std::string file_set_type;
-
-  for (auto const& name : tgt->GetAllFileSetNames()) {
-    auto const* file_set = tgt->GetFileSet(name);
-    if (!file_set) {
-      this->GetMakefile()->IssueMessage(
-        MessageType::INTERNAL_ERROR,
-        cmStrCat("Target \"", tgt->GetName(),
-                 "\" is tracked to have file set \"", name,
-                 "\", but it was not found."));
-      continue;
-    }
-
-    auto fileEntries = file_set->CompileFileEntries();
-    auto directoryEntries = file_set->CompileDirectoryEntries();
-    auto directories = file_set->EvaluateDirectoryEntries(
-      directoryEntries, this->LocalGenerator, config, this->GeneratorTarget);
-
-    std::map<std::string, std::vector<std::string>> files;
-    for (auto const& entry : fileEntries) {
-      file_set->EvaluateFileEntry(directories, files, entry,
-                                  this->LocalGenerator, config,
-                                  this->GeneratorTarget);
-    }
-
-    for (auto const& it : files) {
-      for (auto const& filename : it.second) {
-        if (filename == path) {
-          file_set_type = file_set->GetType();
-          break;
-        }
-      }
-    }
-
-    if (file_set_type == "CXX_MODULES"_s ||
-        file_set_type == "CXX_MODULE_HEADER_UNITS"_s) {
-      if (source->GetLanguage() != "CXX"_s) {
-        this->GetMakefile()->IssueMessage(
-          MessageType::FATAL_ERROR,
-          cmStrCat(
-            "Target \"", tgt->GetName(), "\" contains the source\n  ", path,
-            "\nin a file set of type \"", file_set_type,
-            R"(" but the source is not classified as a "CXX" source.)"));
-        continue;
-      }
-    }
+  if (sharedFlags) {
+    *sharedFlags = flags;
   }
-
   return flags;
 }
 
@@ -333,6 +308,22 @@ std::string cmNinjaTargetGenerator::ComputeDefines(cmSourceFile const* source,
                                                    const std::string& language,
                                                    const std::string& config)
 {
+  const std::string COMPILE_DEFINITIONS("COMPILE_DEFINITIONS");
+  std::string defPropName =
+    cmStrCat("COMPILE_DEFINITIONS_", cmSystemTools::UpperCase(config));
+  cmValue compile_defs = source->GetProperty(COMPILE_DEFINITIONS);
+  cmValue config_compile_defs = source->GetProperty(defPropName);
+
+  // Most sources have no definitions of their own.
+  cm::optional<std::string>* sharedDefines = nullptr;
+  if (!compile_defs && !config_compile_defs) {
+    sharedDefines =
+      &this->Configs[config].SharedCompileVarsByLanguage[language].Defines;
+    if (*sharedDefines) {
+      return **sharedDefines;
+    }
+  }
+
   std::set<std::string> defines;
   cmGeneratorExpressionInterpreter genexInterpreter(
     this->LocalGenerator, config, this->GeneratorTarget, language);
@@ -342,15 +333,12 @@ std::string cmNinjaTargetGenerator::ComputeDefines(cmSourceFile const* source,
     defines.insert(cmStrCat("CMAKE_INTDIR=\"", config, '"'));
   }
 
-  const std::string COMPILE_DEFINITIONS("COMPILE_DEFINITIONS");
-  if (cmValue compile_defs = source->GetProperty(COMPILE_DEFINITIONS)) {
+  if (compile_defs) {
     this->LocalGenerator->AppendDefines(
       defines, genexInterpreter.Evaluate(*compile_defs, COMPILE_DEFINITIONS));
   }
 
-  std::string defPropName =
-    cmStrCat("COMPILE_DEFINITIONS_", cmSystemTools::UpperCase(config));
-  if (cmValue config_compile_defs = source->GetProperty(defPropName)) {
+  if (config_compile_defs) {
     this->LocalGenerator->AppendDefines(
       defines,
       genexInterpreter.Evaluate(*config_compile_defs, COMPILE_DEFINITIONS));
@@ -359,6 +347,9 @@ std::string cmNinjaTargetGenerator::ComputeDefines(cmSourceFile const* source,
   std::string definesString = this->GetDefines(language, config);
   this->LocalGenerator->JoinDefines(defines, definesString, language);
 
+  if (sharedDefines) {
+    *sharedDefines = definesString;
+  }
   return definesString;
 }
 
@@ -366,12 +357,23 @@ std::string cmNinjaTargetGenerator::ComputeIncludes(
   cmSourceFile const* source, const std::string& language,
   const std::string& config)
 {
-  std::vector<std::string> includes;
-  cmGeneratorExpressionInterpreter genexInterpreter(
-    this->LocalGenerator, config, this->GeneratorTarget, language);
-
   const std::string INCLUDE_DIRECTORIES("INCLUDE_DIRECTORIES");
-  if (cmValue cincludes = source->GetProperty(INCLUDE_DIRECTORIES)) {
+  cmValue cincludes = source->GetProperty(INCLUDE_DIRECTORIES);
+
+  // Most sources have no include directories of their own.
+  cm::optional<std::string>* sharedIncludes = nullptr;
+  if (!cincludes) {
+    sharedIncludes =
+      &this->Configs[config].SharedCompileVarsByLanguage[language].Includes;
+    if (*sharedIncludes) {
+      return **sharedIncludes;
+    }
+  }
+
+  std::vector<std::string> includes;
+  if (cincludes) {
+    cmGeneratorExpressionInterpreter genexInterpreter(
+      this->LocalGenerator, config, this->GeneratorTarget, language);
     this->LocalGenerator->AppendIncludeDirectories(
       includes, genexInterpreter.Evaluate(*cincludes, INCLUDE_DIRECTORIES),
       *source);
@@ -382,6 +384,9 @@ std::string cmNinjaTargetGenerator::ComputeIncludes(
   this->LocalGenerator->AppendFlags(includesString,
                                     this->GetIncludes(language, config));
 
+  if (sharedIncludes) {
+    *sharedIncludes = includesString;
+  }
   return includesString;
 }
 
@@ -810,6 +815,8 @@ void cmNinjaTargetGenerator::WriteCompileRule(const std::string& lang,
     rule.Comment =
       cmStrCat("Rule to generate ninja dyndep files for ", lang, '.');
     rule.Description = cmStrCat("Generating ", lang, " dyndep file $out");
+    // The collator leaves the dyndep file alone if it did not change.
+    rule.Restat = "1";
     this->GetGlobalGenerator()->AddRule(rule);
   }
 
@@ -1378,21 +1385,11 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatement(
   // Add precompile headers dependencies
   std::vector<std::string> depList;
 
-  std::vector<std::string> architectures;
-  this->GeneratorTarget->GetAppleArchs(config, architectures);
-  if (architectures.empty()) {
-    architectures.emplace_back();
-  }
-
-  std::unordered_set<std::string> pchSources;
-  for (const std::string& arch : architectures) {
-    const std::string pchSource =
-      this->GeneratorTarget->GetPchSource(config, language, arch);
-
-    if (!pchSource.empty()) {
-      pchSources.insert(pchSource);
-    }
-  }
+  CompileSignature const& signature =
+    this->GetCompileSignature(language, config);
+  std::vector<std::string> const& architectures = signature.Architectures;
+  std::unordered_map<std::string, std::string> const& pchSources =
+    signature.PchSources;
 
   if (!pchSources.empty() && !source->GetProperty("SKIP_PRECOMPILE_HEADERS")) {
     for (const std::string& arch : architectures) {
@@ -11,6 +11,8 @@
 #include <utility>
 #include <vector>
 
+#include <cm/optional>
+
 #include <cm3p/json/value.h>
 
 #include "cmCommonTargetGenerator.h"
@@ -212,10 +214,20 @@ protected:
 private:
   cmLocalNinjaGenerator* LocalGenerator;
 
+  /// Compile variables shared by the sources without settings of their own.
+  struct SharedCompileVars
+  {
+    cm::optional<std::string> Flags;
+    cm::optional<std::string> FlagsWithPch;
+    cm::optional<std::string> Defines;
+    cm::optional<std::string> Includes;
+  };
+
   struct ByConfig
   {
     /// List of object files for this target.
     cmNinjaDeps Objects;
+    std::map<std::string, SharedCompileVars> SharedCompileVarsByLanguage;
     // Fortran Support
     std::map<std::string, cmNinjaDeps> DDIFiles;
     // Swift Support
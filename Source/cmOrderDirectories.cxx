@@ -5,7 +5,9 @@
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <mutex>
 #include <sstream>
+#include <unordered_set>
 #include <vector>
 
 #include <cm/memory>
@@ -61,9 +63,15 @@ public:
 
   virtual void Report(std::ostream& e) = 0;
 
+  std::vector<std::string> const& GetConflictNames() const
+  {
+    return this->ConflictNames;
+  }
+
   void FindConflicts(unsigned int index)
   {
-    for (unsigned int i = 0; i < this->OD->OriginalDirectories.size(); ++i) {
+    for (unsigned int i :
+         this->OD->GetDirectoriesWithFiles(this->ConflictNames)) {
       // Check if this directory conflicts with the entry.
       std::string const& dir = this->OD->OriginalDirectories[i];
       if (!this->OD->IsSameDirectory(dir, this->Directory) &&
@@ -80,8 +88,10 @@ public:
   void FindImplicitConflicts(std::ostringstream& w)
   {
     bool first = true;
-    for (std::string const& dir : this->OD->OriginalDirectories) {
+    for (unsigned int i :
+         this->OD->GetDirectoriesWithFiles(this->ConflictNames)) {
       // Check if this directory conflicts with the entry.
+      std::string const& dir = this->OD->OriginalDirectories[i];
       if (dir != this->Directory &&
           cmSystemTools::GetRealPath(dir) !=
             cmSystemTools::GetRealPath(this->Directory) &&
@@ -112,6 +122,11 @@ protected:
   std::string Directory;
   std::string FileName;
 
+  // The names of files that conflict with the item if found in another
+  // directory.  Empty if not known, in which case every directory may
+  // conflict.
+  std::vector<std::string> ConflictNames;
+
   // The index assigned to the directory.
   int DirectoryIndex;
 };
@@ -150,6 +165,9 @@ public:
         this->SOName = soguess;
       }
     }
+    if (!this->SOName.empty()) {
+      this->ConflictNames.push_back(this->SOName);
+    }
   }
 
   void Report(std::ostream& e) override
@@ -205,6 +223,19 @@ public:
                                       std::string const& file)
     : cmOrderDirectoriesConstraint(od, file)
   {
+    // The linker may find the library file itself or a file with the
+    // same name but another extension it considers.
+    this->ConflictNames.push_back(this->FileName);
+    if (!this->OD->LinkExtensions.empty() &&
+        this->OD->RemoveLibraryExtension.find(this->FileName)) {
+      std::string lib = this->OD->RemoveLibraryExtension.match(1);
+      std::string ext = this->OD->RemoveLibraryExtension.match(2);
+      for (std::string const& LinkExtension : this->OD->LinkExtensions) {
+        if (LinkExtension != ext) {
+          this->ConflictNames.push_back(cmStrCat(lib, LinkExtension));
+        }
+      }
+    }
   }
 
   void Report(std::ostream& e) override
@@ -217,27 +248,12 @@ public:
 
 bool cmOrderDirectoriesConstraintLibrary::FindConflict(std::string const& dir)
 {
-  // We have the library file name.  Check if it will be found.
-  if (this->FileMayConflict(dir, this->FileName)) {
-    return true;
-  }
-
-  // Now check if the file exists with other extensions the linker
-  // might consider.
-  if (!this->OD->LinkExtensions.empty() &&
-      this->OD->RemoveLibraryExtension.find(this->FileName)) {
-    std::string lib = this->OD->RemoveLibraryExtension.match(1);
-    std::string ext = this->OD->RemoveLibraryExtension.match(2);
-    for (std::string const& LinkExtension : this->OD->LinkExtensions) {
-      if (LinkExtension != ext) {
-        std::string fname = cmStrCat(lib, LinkExtension);
-        if (this->FileMayConflict(dir, fname)) {
-          return true;
-        }
-      }
-    }
-  }
-  return false;
+  // Check if the library file, or the file with other extensions the
+  // linker might consider, will be found.
+  return std::any_of(this->ConflictNames.begin(), this->ConflictNames.end(),
+                     [this, &dir](std::string const& name) {
+                       return this->FileMayConflict(dir, name);
+                     });
 }
 
 cmOrderDirectories::cmOrderDirectories(cmGlobalGenerator* gg,
@@ -254,11 +270,18 @@ cmOrderDirectories::~cmOrderDirectories() = default;
 
 std::vector<std::string> const& cmOrderDirectories::GetOrderedDirectories()
 {
-  if (!this->Computed) {
-    this->Computed = true;
-    this->CollectOriginalDirectories();
-    this->FindConflicts();
-    this->OrderDirectories();
+  // Link information may be shared by concurrent readers, so order the
+  // directories at most once under the target evaluation mutex.
+  if (!this->Computed.load(std::memory_order_acquire)) {
+    std::lock_guard<std::recursive_mutex> lock(
+      this->GlobalGenerator->GetTargetEvaluationMutex());
+    if (!this->Computed.load(std::memory_order_relaxed)) {
+      this->CollectOriginalDirectories();
+      this->IndexDirectoryContent();
+      this->FindConflicts();
+      this->OrderDirectories();
+      this->Computed.store(true, std::memory_order_release);
+    }
   }
   return this->OrderedDirectories;
 }
@@ -411,6 +434,94 @@ void cmOrderDirectories::AddOriginalDirectories(
   }
 }
 
+namespace {
+// The key under which a file is indexed.  A name with a path, as used
+// for frameworks, is indexed by its first component, which the listing
+// of the directory holds.
+std::string DirectoryIndexKey(std::string const& name)
+{
+  std::string key = name.substr(0, name.find('/'));
+#if defined(_WIN32) || defined(__APPLE__)
+  key = cmSystemTools::LowerCase(key);
+#endif
+  return key;
+}
+}
+
+void cmOrderDirectories::IndexDirectoryContent()
+{
+  // Collect the names of the files the constraints look for.
+  std::unordered_set<std::string> names;
+  for (auto const& entry : this->ConstraintEntries) {
+    for (std::string const& name : entry->GetConflictNames()) {
+      names.insert(DirectoryIndexKey(name));
+    }
+  }
+  for (auto const& entry : this->ImplicitDirEntries) {
+    for (std::string const& name : entry->GetConflictNames()) {
+      names.insert(DirectoryIndexKey(name));
+    }
+  }
+  if (names.empty()) {
+    return;
+  }
+
+  // Look up each directory once instead of once per constraint.  Walk
+  // either the names or the listing, whichever is smaller.
+  for (unsigned int i = 0; i < this->OriginalDirectories.size(); ++i) {
+    std::string const& dir = this->OriginalDirectories[i];
+    if (!cmGlobalGenerator::IsDirectoryContentTracked(dir)) {
+      // The listing may be stale, so the directory may hold any file.
+      this->UnindexedDirectories.push_back(i);
+      continue;
+    }
+    std::set<std::string> const& content =
+      this->GlobalGenerator->GetDirectoryContent(dir);
+#if !defined(_WIN32) && !defined(__APPLE__)
+    if (names.size() < content.size()) {
+      for (std::string const& name : names) {
+        if (content.count(name)) {
+          this->DirectoryContentIndex[name].push_back(i);
+        }
+      }
+      continue;
+    }
+#endif
+    for (std::string const& file : content) {
+      std::string key = DirectoryIndexKey(file);
+      if (names.count(key)) {
+        this->DirectoryContentIndex[key].push_back(i);
+      }
+    }
+  }
+}
+
+std::vector<unsigned int> cmOrderDirectories::GetDirectoriesWithFiles(
+  std::vector<std::string> const& names) const
+{
+  std::vector<unsigned int> dirs;
+  if (names.empty()) {
+    dirs.reserve(this->OriginalDirectories.size());
+    for (unsigned int i = 0; i < this->OriginalDirectories.size(); ++i) {
+      dirs.push_back(i);
+    }
+    return dirs;
+  }
+
+  dirs = this->UnindexedDirectories;
+  for (std::string const& name : names) {
+    auto i = this->DirectoryContentIndex.find(DirectoryIndexKey(name));
+    if (i != this->DirectoryContentIndex.end()) {
+      cm::append(dirs, i->second);
+    }
+  }
+
+  // Check the directories in their original order.
+  std::sort(dirs.begin(), dirs.end());
+  dirs.erase(std::unique(dirs.begin(), dirs.end()), dirs.end());
+  return dirs;
+}
+
 struct cmOrderDirectoriesCompare
 {
   using ConflictPair = std::pair<int, int>;
@@ -4,10 +4,12 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -62,6 +64,9 @@ private:
   void CollectOriginalDirectories();
   int AddOriginalDirectory(std::string const& dir);
   void AddOriginalDirectories(std::vector<std::string> const& dirs);
+  void IndexDirectoryContent();
+  std::vector<unsigned int> GetDirectoriesWithFiles(
+    std::vector<std::string> const& names) const;
   void FindConflicts();
   void FindImplicitConflicts();
   void OrderDirectories();
@@ -69,7 +74,7 @@ private:
   void DiagnoseCycle();
   int WalkId;
   bool CycleDiagnosed;
-  bool Computed;
+  std::atomic<bool> Computed;
 
   // Adjacency-list representation of runtime path ordering graph.
   // This maps from directory to those that must come *before* it.
@@ -83,6 +88,13 @@ private:
   };
   std::vector<ConflictList> ConflictGraph;
 
+  // The original directories containing each file looked for by the
+  // constraints, by file name.  Directories whose listing may be stale
+  // are not indexed and may contain any file.
+  std::unordered_map<std::string, std::vector<unsigned int>>
+    DirectoryContentIndex;
+  std::vector<unsigned int> UnindexedDirectories;
+
   // Compare directories after resolving symlinks.
   bool IsSameDirectory(std::string const& l, std::string const& r);
 
@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <utility>
 
+#include <cm/optional>
+
 void cmPropertyMap::Clear()
 {
   this->Map_.clear();
@@ -13,20 +15,20 @@ void cmPropertyMap::Clear()
 void cmPropertyMap::SetProperty(const std::string& name, const char* value)
 {
   if (!value) {
-    this->Map_.erase(name);
+    this->RemoveProperty(name);
     return;
   }
 
-  this->Map_[name] = value;
+  this->Map_[cmAtom(name)] = value;
 }
 void cmPropertyMap::SetProperty(const std::string& name, cmValue value)
 {
   if (!value) {
-    this->Map_.erase(name);
+    this->RemoveProperty(name);
     return;
   }
 
-  this->Map_[name] = *value;
+  this->Map_[cmAtom(name)] = *value;
 }
 
 void cmPropertyMap::AppendProperty(const std::string& name,
@@ -38,7 +40,7 @@ void cmPropertyMap::AppendProperty(const std::string& name,
   }
 
   {
-    std::string& pVal = this->Map_[name];
+    std::string& pVal = this->Map_[cmAtom(name)];
     if (!pVal.empty() && !asString) {
       pVal += ';';
     }
@@ -48,12 +50,18 @@ void cmPropertyMap::AppendProperty(const std::string& name,
 
 void cmPropertyMap::RemoveProperty(const std::string& name)
 {
-  this->Map_.erase(name);
+  if (cm::optional<cmAtom> key = cmAtom::Find(name)) {
+    this->Map_.erase(*key);
+  }
 }
 
 cmValue cmPropertyMap::GetPropertyValue(const std::string& name) const
 {
-  auto it = this->Map_.find(name);
+  cm::optional<cmAtom> key = cmAtom::Find(name);
+  if (!key) {
+    return nullptr;
+  }
+  auto it = this->Map_.find(*key);
   if (it != this->Map_.end()) {
     return cmValue(it->second);
   }
@@ -65,7 +73,7 @@ std::vector<std::string> cmPropertyMap::GetKeys() const
   std::vector<std::string> keyList;
   keyList.reserve(this->Map_.size());
   for (auto const& item : this->Map_) {
-    keyList.push_back(item.first);
+    keyList.push_back(item.first.GetString());
   }
   std::sort(keyList.begin(), keyList.end());
   return keyList;
@@ -77,7 +85,7 @@ std::vector<std::pair<std::string, std::string>> cmPropertyMap::GetList() const
   std::vector<StringPair> kvList;
   kvList.reserve(this->Map_.size());
   for (auto const& item : this->Map_) {
-    kvList.emplace_back(item.first, item.second);
+    kvList.emplace_back(item.first.GetString(), item.second);
   }
   std::sort(kvList.begin(), kvList.end(),
             [](StringPair const& a, StringPair const& b) {
@@ -9,10 +9,15 @@
 #include <utility>
 #include <vector>
 
+#include "cmAtom.h"
 #include "cmValue.h"
 
 /** \class cmPropertyMap
  * \brief String property map.
+ *
+ * Property names are interned so that the many targets, source files and
+ * directories carrying the same properties share one copy of each name
+ * and compare keys by identity.
  */
 class cmPropertyMap
 {
@@ -51,5 +56,5 @@ public:
   std::vector<std::pair<std::string, std::string>> GetList() const;
 
 private:
-  std::unordered_map<std::string, std::string> Map_;
+  std::unordered_map<cmAtom, std::string, cmAtom::Hash> Map_;
 };
@@ -58,10 +58,19 @@ static Json::Value EncodeFilename(std::string const& path)
   return data;
 }
 
+static void ReportError(std::string* error, std::string message)
+{
+  if (error) {
+    *error = std::move(message);
+  } else {
+    cmSystemTools::Error(message);
+  }
+}
+
 #define PARSE_BLOB(val, res)                                                  \
   do {                                                                        \
     if (!ParseFilename(val, res)) {                                           \
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ", \
+      ReportError(error, cmStrCat("-E cmake_ninja_dyndep failed to parse ",   \
                                     arg_pp, ": invalid blob"));               \
       return false;                                                           \
     }                                                                         \
@@ -70,7 +79,7 @@ static Json::Value EncodeFilename(std::string const& path)
 #define PARSE_FILENAME(val, res)                                              \
   do {                                                                        \
     if (!ParseFilename(val, res)) {                                           \
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ", \
+      ReportError(error, cmStrCat("-E cmake_ninja_dyndep failed to parse ",   \
                                     arg_pp, ": invalid filename"));           \
       return false;                                                           \
     }                                                                         \
@@ -82,7 +91,7 @@ static Json::Value EncodeFilename(std::string const& path)
   } while (0)
 
 bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
-                                 cmScanDepInfo* info)
+                                 cmScanDepInfo* info, std::string* error)
 {
   Json::Value ppio;
   Json::Value const& ppi = ppio;
@@ -90,25 +99,24 @@ bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
   {
     Json::Reader reader;
     if (!reader.parse(ppf, ppio, false)) {
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                    arg_pp,
-                                    reader.getFormattedErrorMessages()));
+      ReportError(error, cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                  arg_pp, reader.getFormattedErrorMessages()));
       return false;
     }
   }
 
   Json::Value const& version = ppi["version"];
   if (version.asUInt() > 1) {
-    cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                  arg_pp, ": version ", version.asString()));
+    ReportError(error, cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                arg_pp, ": version ", version.asString()));
     return false;
   }
 
   Json::Value const& rules = ppi["rules"];
   if (rules.isArray()) {
     if (rules.size() != 1) {
-      cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                    arg_pp, ": expected 1 source entry"));
+      ReportError(error, cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                  arg_pp, ": expected 1 source entry"));
       return false;
     }
 
@@ -120,9 +128,9 @@ bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
         PARSE_BLOB(workdir, wd);
         work_directory = std::move(wd);
       } else if (!workdir.isNull()) {
-        cmSystemTools::Error(cmStrCat("-E cmake_ninja_dyndep failed to parse ",
-                                      arg_pp,
-                                      ": work-directory is not a string"));
+        ReportError(error, cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                    arg_pp,
+                                    ": work-directory is not a string"));
         return false;
       }
 
@@ -146,9 +154,8 @@ bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
       if (rule.isMember("provides")) {
         Json::Value const& provides = rule["provides"];
         if (!provides.isArray()) {
-          cmSystemTools::Error(
-            cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                     ": provides is not an array"));
+          ReportError(error, cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                      arg_pp, ": provides is not an array"));
           return false;
         }
 
@@ -169,7 +176,8 @@ bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
             Json::Value const& unique_on_source_path =
               provide["unique-on-source-path"];
             if (!unique_on_source_path.isBool()) {
-              cmSystemTools::Error(
+              ReportError(
+                error,
                 cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
                          ": unique-on-source-path is not a boolean"));
               return false;
@@ -183,18 +191,18 @@ bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
             Json::Value const& source_path = provide["source-path"];
             PARSE_FILENAME(source_path, provide_info.SourcePath);
           } else if (provide_info.UseSourcePath) {
-            cmSystemTools::Error(
-              cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                       ": source-path is missing"));
+            ReportError(error,
+                        cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                 arg_pp, ": source-path is missing"));
             return false;
           }
 
           if (provide.isMember("is-interface")) {
             Json::Value const& is_interface = provide["is-interface"];
             if (!is_interface.isBool()) {
-              cmSystemTools::Error(
-                cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                         ": is-interface is not a boolean"));
+              ReportError(error,
+                          cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                   arg_pp, ": is-interface is not a boolean"));
               return false;
             }
             provide_info.IsInterface = is_interface.asBool();
@@ -209,9 +217,8 @@ bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
       if (rule.isMember("requires")) {
         Json::Value const& reqs = rule["requires"];
         if (!reqs.isArray()) {
-          cmSystemTools::Error(
-            cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                     ": requires is not an array"));
+          ReportError(error, cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                      arg_pp, ": requires is not an array"));
           return false;
         }
 
@@ -232,7 +239,8 @@ bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
             Json::Value const& unique_on_source_path =
               require["unique-on-source-path"];
             if (!unique_on_source_path.isBool()) {
-              cmSystemTools::Error(
+              ReportError(
+                error,
                 cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
                          ": unique-on-source-path is not a boolean"));
               return false;
@@ -246,18 +254,18 @@ bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
             Json::Value const& source_path = require["source-path"];
             PARSE_FILENAME(source_path, require_info.SourcePath);
           } else if (require_info.UseSourcePath) {
-            cmSystemTools::Error(
-              cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                       ": source-path is missing"));
+            ReportError(error,
+                        cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                 arg_pp, ": source-path is missing"));
             return false;
           }
 
           if (require.isMember("lookup-method")) {
             Json::Value const& lookup_method = require["lookup-method"];
             if (!lookup_method.isString()) {
-              cmSystemTools::Error(
-                cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                         ": lookup-method is not a string"));
+              ReportError(error,
+                          cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                   arg_pp, ": lookup-method is not a string"));
               return false;
             }
 
@@ -269,9 +277,10 @@ bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
             } else if (lookup_method_str == "include-quote"_s) {
               require_info.Method = LookupMethod::IncludeQuote;
             } else {
-              cmSystemTools::Error(cmStrCat(
-                "-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                ": lookup-method is not a valid: ", lookup_method_str));
+              ReportError(error,
+                          cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                   arg_pp, ": lookup-method is not a valid: ",
+                                   lookup_method_str));
               return false;
             }
           } else if (require_info.UseSourcePath) {
@@ -291,9 +300,9 @@ bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
 
         Json::Value const& is_interface_json = rule["is-interface"];
         if (!is_interface_json.isBool()) {
-          cmSystemTools::Error(
-            cmStrCat("-E cmake_ninja_dyndep failed to parse ", arg_pp,
-                     ": is-interface is not a boolean"));
+          ReportError(error, cmStrCat("-E cmake_ninja_dyndep failed to parse ",
+                                      arg_pp,
+                                      ": is-interface is not a boolean"));
           return false;
         }
         bool is_interface = is_interface_json.asBool();
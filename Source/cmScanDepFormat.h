@@ -36,7 +36,9 @@ struct cmScanDepInfo
   std::vector<cmSourceReqInfo> Requires;
 };
 
+// Parse a P1689 file.  Errors are reported, or stored in the given string.
 bool cmScanDepFormat_P1689_Parse(std::string const& arg_pp,
-                                 cmScanDepInfo* info);
+                                 cmScanDepInfo* info,
+                                 std::string* error = nullptr);
 bool cmScanDepFormat_P1689_Write(std::string const& path,
                                  cmScanDepInfo const& info);
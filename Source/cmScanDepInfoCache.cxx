@@ -0,0 +1,190 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmScanDepInfoCache.h"
+
+#include <ios>
+#include <utility>
+#include <vector>
+
+#include <cm/string_view>
+#include <cmext/string_view>
+
+#include "cmBinaryIO.h"
+#include "cmGeneratedFileStream.h"
+#include "cmVersion.h"
+
+namespace {
+// Bump this whenever the layout of the cache changes.
+unsigned long long const FormatVersion = 1;
+cm::string_view const Magic = "CMDDI\n"_s;
+
+void WriteRequests(std::string& out,
+                   std::vector<cmSourceReqInfo> const& requests)
+{
+  cmBinaryIO::WriteNumber(out, requests.size());
+  for (cmSourceReqInfo const& r : requests) {
+    cmBinaryIO::WriteString(out, r.LogicalName);
+    cmBinaryIO::WriteString(out, r.SourcePath);
+    cmBinaryIO::WriteString(out, r.CompiledModulePath);
+    cmBinaryIO::WriteNumber(out, r.UseSourcePath ? 1 : 0);
+    cmBinaryIO::WriteNumber(out, r.IsInterface ? 1 : 0);
+    cmBinaryIO::WriteNumber(out, static_cast<unsigned long long>(r.Method));
+  }
+}
+
+bool ReadRequests(cmBinaryIO::Reader& reader,
+                  std::vector<cmSourceReqInfo>& requests)
+{
+  unsigned long long count;
+  if (!reader.ReadNumber(count)) {
+    return false;
+  }
+  for (unsigned long long i = 0; i < count; ++i) {
+    cmSourceReqInfo r;
+    unsigned long long useSourcePath;
+    unsigned long long isInterface;
+    unsigned long long method;
+    if (!reader.ReadString(r.LogicalName) ||
+        !reader.ReadString(r.SourcePath) ||
+        !reader.ReadString(r.CompiledModulePath) ||
+        !reader.ReadNumber(useSourcePath) || !reader.ReadNumber(isInterface) ||
+        !reader.ReadNumber(method) ||
+        method >
+          static_cast<unsigned long long>(LookupMethod::IncludeQuote)) {
+      return false;
+    }
+    r.UseSourcePath = useSourcePath != 0;
+    r.IsInterface = isInterface != 0;
+    r.Method = static_cast<LookupMethod>(method);
+    requests.push_back(std::move(r));
+  }
+  return true;
+}
+}
+
+cmScanDepInfoCache::cmScanDepInfoCache(std::string cacheFile)
+  : CacheFile(std::move(cacheFile))
+{
+}
+
+void cmScanDepInfoCache::Load()
+{
+  this->Entries.clear();
+  this->Modified = false;
+
+  std::string data;
+  if (!cmBinaryIO::ReadFile(this->CacheFile, data)) {
+    return;
+  }
+  cmBinaryIO::Reader reader(data);
+  if (!reader.ReadMagic(Magic)) {
+    return;
+  }
+
+  // A different CMake may interpret the scan results differently.
+  unsigned long long version;
+  std::string cmakeVersion;
+  unsigned long long numEntries;
+  if (!reader.ReadNumber(version) || version != FormatVersion ||
+      !reader.ReadString(cmakeVersion) ||
+      cmakeVersion != cmVersion::GetCMakeVersion() ||
+      !reader.ReadNumber(numEntries)) {
+    return;
+  }
+  for (unsigned long long e = 0; e < numEntries; ++e) {
+    std::string path;
+    Entry entry;
+    unsigned long long mtime;
+    unsigned long long numExtraOutputs;
+    bool ok = reader.ReadString(path) && reader.ReadNumber(mtime) &&
+      reader.ReadNumber(entry.Size) &&
+      reader.ReadString(entry.Info.PrimaryOutput) &&
+      reader.ReadNumber(numExtraOutputs);
+    for (unsigned long long i = 0; ok && i < numExtraOutputs; ++i) {
+      std::string output;
+      ok = reader.ReadString(output);
+      entry.Info.ExtraOutputs.push_back(std::move(output));
+    }
+    if (!ok || !ReadRequests(reader, entry.Info.Provides) ||
+        !ReadRequests(reader, entry.Info.Requires)) {
+      this->Entries.clear();
+      return;
+    }
+    entry.MTime = static_cast<long long>(mtime);
+    this->Entries.emplace(std::move(path), std::move(entry));
+  }
+  if (!reader.AtEnd()) {
+    this->Entries.clear();
+  }
+}
+
+bool cmScanDepInfoCache::Save()
+{
+  // Forget the files no longer collated.
+  std::vector<std::pair<std::string const*, Entry const*>> entries;
+  for (auto const& e : this->Entries) {
+    if (e.second.Used) {
+      entries.emplace_back(&e.first, &e.second);
+    }
+  }
+  if (!this->Modified && entries.size() == this->Entries.size()) {
+    return true;
+  }
+
+  std::string out(Magic.data(), Magic.size());
+  cmBinaryIO::WriteNumber(out, FormatVersion);
+  cmBinaryIO::WriteString(out, cmVersion::GetCMakeVersion());
+  cmBinaryIO::WriteNumber(out, entries.size());
+  for (auto const& e : entries) {
+    cmScanDepInfo const& info = e.second->Info;
+    cmBinaryIO::WriteString(out, *e.first);
+    cmBinaryIO::WriteNumber(out,
+                            static_cast<unsigned long long>(e.second->MTime));
+    cmBinaryIO::WriteNumber(out, e.second->Size);
+    cmBinaryIO::WriteString(out, info.PrimaryOutput);
+    cmBinaryIO::WriteNumber(out, info.ExtraOutputs.size());
+    for (std::string const& output : info.ExtraOutputs) {
+      cmBinaryIO::WriteString(out, output);
+    }
+    WriteRequests(out, info.Provides);
+    WriteRequests(out, info.Requires);
+  }
+
+  cmGeneratedFileStream fout;
+  fout.Open(this->CacheFile, true, true);
+  fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+  return fout.Close();
+}
+
+bool cmScanDepInfoCache::Lookup(std::string const& path, cmScanDepInfo& info)
+{
+  auto i = this->Entries.find(path);
+  if (i == this->Entries.end()) {
+    return false;
+  }
+  long long mtime;
+  unsigned long long size;
+  if (!cmBinaryIO::StatFile(path, mtime, size) || mtime != i->second.MTime ||
+      size != i->second.Size) {
+    return false;
+  }
+  i->second.Used = true;
+  info = i->second.Info;
+  return true;
+}
+
+void cmScanDepInfoCache::Store(std::string const& path,
+                               cmScanDepInfo const& info)
+{
+  // A file written again within the resolution of its time might look
+  // unchanged later, so wait until its time can be trusted.
+  Entry entry;
+  if (!cmBinaryIO::StatFile(path, entry.MTime, entry.Size) ||
+      cmBinaryIO::IsRacy(entry.MTime)) {
+    return;
+  }
+  entry.Info = info;
+  entry.Used = true;
+  this->Entries[path] = std::move(entry);
+  this->Modified = true;
+}
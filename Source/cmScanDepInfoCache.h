@@ -0,0 +1,64 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <unordered_map>
+
+#include "cmScanDepFormat.h"
+
+/** \class cmScanDepInfoCache
+ * \brief Remember the module dependencies parsed from P1689 files.
+ *
+ * Collating the module dependencies of a target parses the scan results
+ * of all of its sources, even if only one of them was scanned again.
+ * The cache records the parsed information of each file along with its
+ * size and modification time, so that only the files that changed since
+ * the previous collation need to be parsed.
+ */
+class cmScanDepInfoCache
+{
+public:
+  /** Use the cache stored in the given file.  */
+  explicit cmScanDepInfoCache(std::string cacheFile);
+
+  cmScanDepInfoCache(cmScanDepInfoCache const&) = delete;
+  cmScanDepInfoCache& operator=(cmScanDepInfoCache const&) = delete;
+
+  /**
+   * Read the entries saved by the previous collation.  A missing,
+   * truncated or incompatible cache is silently treated as empty.
+   */
+  void Load();
+
+  /**
+   * Write the entries looked up or stored since the cache was loaded,
+   * if any of them changed.
+   */
+  bool Save();
+
+  /**
+   * Get the information parsed from the given file, if it did not change
+   * since it was recorded.
+   */
+  bool Lookup(std::string const& path, cmScanDepInfo& info);
+
+  /** Record the information just parsed from the given file.  */
+  void Store(std::string const& path, cmScanDepInfo const& info);
+
+private:
+  struct Entry
+  {
+    long long MTime = 0;
+    unsigned long long Size = 0;
+    cmScanDepInfo Info;
+    // Whether the entry is still used by the current collation.
+    bool Used = false;
+  };
+
+  std::string CacheFile;
+  std::unordered_map<std::string, Entry> Entries;
+  bool Modified = false;
+};
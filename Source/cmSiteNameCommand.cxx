@@ -30,6 +30,7 @@ bool cmSiteNameCommand(std::vector<std::string> const& args,
   if (cacheValue) {
     return true;
   }
+  status.GetMakefile().MarkConfigureVolatile("site_name()");
 
   cmValue temp = status.GetMakefile().GetDefinition("HOSTNAME");
   std::string hostname_cmd;
@@ -399,8 +399,9 @@ void cmState::AddBuiltinCommand(std::string const& name,
 void cmState::AddBuiltinCommand(std::string const& name, Command command)
 {
   assert(name == cmSystemTools::LowerCase(name));
-  assert(this->BuiltinCommands.find(name) == this->BuiltinCommands.end());
-  this->BuiltinCommands.emplace(name, std::move(command));
+  cmAtom const key(name);
+  assert(this->BuiltinCommands.find(key) == this->BuiltinCommands.end());
+  this->BuiltinCommands.emplace(key, std::move(command));
 }
 
 static bool InvokeBuiltinCommand(cmState::BuiltinCommand command,
@@ -508,11 +509,12 @@ bool cmState::AddScriptedCommand(std::string const& name, BT<Command> command,
   }
 
   // if the command already exists, give a new name to the old command.
-  if (Command oldCmd = this->GetCommandByExactName(sName)) {
-    this->ScriptedCommands["_" + sName] = oldCmd;
+  cmAtom const key(sName);
+  if (Command oldCmd = this->GetCommandByExactName(key)) {
+    this->ScriptedCommands[cmAtom(cmStrCat('_', sName))] = oldCmd;
   }
 
-  this->ScriptedCommands[sName] = std::move(command.Value);
+  this->ScriptedCommands[key] = std::move(command.Value);
   return true;
 }
 
@@ -522,6 +524,15 @@ cmState::Command cmState::GetCommand(std::string const& name) const
 }
 
 cmState::Command cmState::GetCommandByExactName(std::string const& name) const
+{
+  // A name that was never interned cannot name a command.
+  if (cm::optional<cmAtom> key = cmAtom::Find(name)) {
+    return this->GetCommandByExactName(*key);
+  }
+  return nullptr;
+}
+
+cmState::Command cmState::GetCommandByExactName(cmAtom name) const
 {
   auto pos = this->ScriptedCommands.find(name);
   if (pos != this->ScriptedCommands.end()) {
@@ -540,10 +551,10 @@ std::vector<std::string> cmState::GetCommandNames() const
   commandNames.reserve(this->BuiltinCommands.size() +
                        this->ScriptedCommands.size());
   for (auto const& bc : this->BuiltinCommands) {
-    commandNames.push_back(bc.first);
+    commandNames.push_back(bc.first.GetString());
   }
   for (auto const& sc : this->ScriptedCommands) {
-    commandNames.push_back(sc.first);
+    commandNames.push_back(sc.first.GetString());
   }
   std::sort(commandNames.begin(), commandNames.end());
   commandNames.erase(std::unique(commandNames.begin(), commandNames.end()),
@@ -554,7 +565,9 @@ std::vector<std::string> cmState::GetCommandNames() const
 void cmState::RemoveBuiltinCommand(std::string const& name)
 {
   assert(name == cmSystemTools::LowerCase(name));
-  this->BuiltinCommands.erase(name);
+  if (cm::optional<cmAtom> key = cmAtom::Find(name)) {
+    this->BuiltinCommands.erase(*key);
+  }
 }
 
 void cmState::RemoveUserDefinedCommands()
@@ -16,6 +16,7 @@
 
 #include <cm/optional>
 
+#include "cmAtom.h"
 #include "cmDefinitions.h"
 #include "cmDependencyProvider.h"
 #include "cmLinkedTree.h"
@@ -176,6 +177,7 @@ public:
   Command GetCommand(std::string const& name) const;
   // Returns a command from its name, or nullptr
   Command GetCommandByExactName(std::string const& name) const;
+  Command GetCommandByExactName(cmAtom name) const;
 
   void AddBuiltinCommand(std::string const& name,
                          std::unique_ptr<cmCommand> command);
@@ -283,8 +285,8 @@ private:
 
   cmPropertyDefinitionMap PropertyDefinitions;
   std::vector<std::string> EnabledLanguages;
-  std::unordered_map<std::string, Command> BuiltinCommands;
-  std::unordered_map<std::string, Command> ScriptedCommands;
+  std::unordered_map<cmAtom, Command, cmAtom::Hash> BuiltinCommands;
+  std::unordered_map<cmAtom, Command, cmAtom::Hash> ScriptedCommands;
   std::unordered_set<std::string> FlowControlCommands;
   cmPropertyMap GlobalProperties;
   std::unique_ptr<cmCacheManager> CacheManager;
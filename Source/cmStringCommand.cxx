@@ -748,6 +748,7 @@ bool HandleRandomCommand(std::vector<std::string> const& args,
     status.SetError("sub-command RANDOM requires at least one argument.");
     return false;
   }
+  status.GetMakefile().MarkConfigureVolatile("string(RANDOM)");
 
   static bool seeded = false;
   bool force_seed = false;
@@ -820,6 +821,7 @@ bool HandleTimestampCommand(std::vector<std::string> const& args,
     status.SetError("sub-command TIMESTAMP takes at most three arguments.");
     return false;
   }
+  status.GetMakefile().MarkConfigureVolatile("string(TIMESTAMP)");
 
   unsigned int argsIndex = 1;
 
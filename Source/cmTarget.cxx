@@ -609,6 +609,7 @@ cmTarget::cmTarget(std::string const& name, cmStateEnums::TargetType type,
     initProp("DISABLE_PRECOMPILE_HEADERS");
     initProp("UNITY_BUILD");
     initProp("UNITY_BUILD_UNIQUE_ID");
+    initProp("UNITY_BUILD_COST_FILE");
     initProp("OPTIMIZE_DEPENDENCIES");
     initProp("EXPORT_COMPILE_COMMANDS");
     initProp("COMPILE_WARNING_AS_ERROR");
@@ -4,6 +4,7 @@
 
 #include "cmCoreTryCompile.h"
 #include "cmExecutionStatus.h"
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
 #include "cmRange.h"
@@ -24,6 +25,8 @@ bool cmTryCompileCommand(std::vector<std::string> const& args,
       "The try_compile() command requires at least 3 arguments.");
     return false;
   }
+  mf.MarkConfigureVolatile("try_compile()");
+  mf.GetGlobalGenerator()->InvalidateDirectoryContent();
 
   if (mf.GetCMakeInstance()->GetWorkingMode() == cmake::FIND_PACKAGE_MODE) {
     mf.IssueMessage(
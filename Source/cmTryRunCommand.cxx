@@ -12,6 +12,7 @@
 #include "cmCoreTryCompile.h"
 #include "cmDuration.h"
 #include "cmExecutionStatus.h"
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
 #include "cmRange.h"
@@ -482,6 +483,8 @@ bool cmTryRunCommand(std::vector<std::string> const& args,
                     "The try_run() command requires at least 4 arguments.");
     return false;
   }
+  mf.MarkConfigureVolatile("try_run()");
+  mf.GetGlobalGenerator()->InvalidateDirectoryContent();
 
   if (mf.GetCMakeInstance()->GetWorkingMode() == cmake::FIND_PACKAGE_MODE) {
     mf.IssueMessage(
@@ -0,0 +1,164 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmUnityBuildCostFile.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <ios>
+
+#include <cm/string_view>
+#include <cmext/string_view>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+namespace {
+cm::string_view const NinjaLogSignature = "# ninja log v"_s;
+
+bool ParseCost(std::string const& str, double& cost)
+{
+  char const* begin = str.c_str();
+  char* end = nullptr;
+  errno = 0;
+  cost = std::strtod(begin, &end);
+  return end != begin && *end == '\0' && errno == 0 && cost >= 0;
+}
+
+std::string StripExtension(std::string const& path)
+{
+  std::string::size_type const slash = path.rfind('/');
+  std::string::size_type const dot = path.rfind('.');
+  if (dot == std::string::npos ||
+      (slash != std::string::npos && dot < slash)) {
+    return path;
+  }
+  return path.substr(0, dot);
+}
+}
+
+bool cmUnityBuildCostFile::Load(std::string const& path, std::string& error)
+{
+  std::string firstLine;
+  {
+    cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+    if (!fin) {
+      error = cmStrCat("Cannot read unity build cost file\n  ", path);
+      return false;
+    }
+    cmSystemTools::GetLineFromStream(fin, firstLine);
+  }
+  if (cmHasPrefix(firstLine, NinjaLogSignature)) {
+    return this->LoadNinjaLog(path, error);
+  }
+  return this->LoadCSV(path, error);
+}
+
+bool cmUnityBuildCostFile::LoadNinjaLog(std::string const& path,
+                                        std::string& error)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    error = cmStrCat("Cannot read unity build cost file\n  ", path);
+    return false;
+  }
+
+  // Later entries of an output replace the earlier ones.
+  std::unordered_map<std::string, double> outputs;
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    // Each line holds the start time, the end time, the modification time,
+    // the output and the command hash, separated by tabs.
+    std::vector<std::string> fields = cmTokenize(line, "\t");
+    unsigned long long start;
+    unsigned long long end;
+    if (fields.size() < 4 || !cmStrToULongLong(fields[0], &start) ||
+        !cmStrToULongLong(fields[1], &end) || end < start) {
+      continue;
+    }
+    outputs[StripExtension(fields[3])] = static_cast<double>(end - start);
+  }
+
+  for (auto& output : outputs) {
+    std::string name = cmSystemTools::GetFilenameName(output.first);
+    this->ObjectCosts[name].emplace_back(output.first, output.second);
+  }
+  return true;
+}
+
+bool cmUnityBuildCostFile::LoadCSV(std::string const& path, std::string& error)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    error = cmStrCat("Cannot read unity build cost file\n  ", path);
+    return false;
+  }
+
+  // Relative source paths are relative to the directory of the cost file.
+  std::string const dir = cmSystemTools::GetFilenamePath(path);
+  std::string line;
+  for (unsigned long lineNumber = 1;
+       cmSystemTools::GetLineFromStream(fin, line); ++lineNumber) {
+    std::string const content = cmTrimWhitespace(line);
+    if (content.empty() || content[0] == '#') {
+      continue;
+    }
+    // The source path may itself contain commas.
+    auto const comma = content.rfind(',');
+    double cost;
+    if (comma == std::string::npos || comma == 0 ||
+        !ParseCost(cmTrimWhitespace(content.substr(comma + 1)), cost)) {
+      error = cmStrCat("Malformed line ", lineNumber,
+                       " of unity build cost file\n  ", path,
+                       "\nExpected a source path and a non-negative cost "
+                       "separated by a comma.");
+      return false;
+    }
+    std::string const source = cmTrimWhitespace(content.substr(0, comma));
+    this->SourceCosts[cmSystemTools::CollapseFullPath(source, dir)] = cost;
+  }
+  return true;
+}
+
+cm::optional<double> cmUnityBuildCostFile::GetCost(
+  std::string const& sourcePath, std::string const& targetDirName,
+  std::string const& objectName) const
+{
+  auto const source = this->SourceCosts.find(sourcePath);
+  if (source != this->SourceCosts.end()) {
+    return source->second;
+  }
+
+  auto const objects =
+    this->ObjectCosts.find(cmSystemTools::GetFilenameName(objectName));
+  if (objects == this->ObjectCosts.end()) {
+    return cm::nullopt;
+  }
+
+  // The object must be in the object directory of the target, possibly
+  // within a per-config subdirectory.  Keep the longest of several builds.
+  std::string const suffix = cmStrCat('/', objectName);
+  std::string const dirName = cmStrCat(targetDirName, '/');
+  cm::optional<double> cost;
+  for (auto const& object : objects->second) {
+    std::string const& output = object.first;
+    if (!cmHasSuffix(output, suffix)) {
+      continue;
+    }
+    std::string::size_type const objectPos = output.size() - suffix.size();
+    std::string::size_type const dirPos = output.rfind(dirName, objectPos);
+    if (dirPos == std::string::npos ||
+        dirPos + dirName.size() > objectPos + 1 ||
+        (dirPos != 0 && output[dirPos - 1] != '/')) {
+      continue;
+    }
+    if (!cost || object.second > *cost) {
+      cost = object.second;
+    }
+  }
+  return cost;
+}
@@ -0,0 +1,51 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#pragma once
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cm/optional>
+
+/** \class cmUnityBuildCostFile
+ * \brief Measured compile cost of sources used to balance unity batches.
+ *
+ * The costs are read either from a ninja log, in which case the cost of a
+ * source is the time taken to build its object file, or from a CSV file
+ * whose lines hold the path of a source and its cost in arbitrary units.
+ */
+class cmUnityBuildCostFile
+{
+public:
+  /**
+   * Read the given cost file.  Returns false and sets the error if the
+   * file cannot be read or is malformed.
+   */
+  bool Load(std::string const& path, std::string& error);
+
+  /**
+   * Look up the cost of a source.  The source is known by its full path,
+   * as used in CSV files, and by the path of its object file relative to
+   * the object directory of the target, without the object extension,
+   * as used in ninja logs.
+   */
+  cm::optional<double> GetCost(std::string const& sourcePath,
+                               std::string const& targetDirName,
+                               std::string const& objectName) const;
+
+private:
+  // Cost of each source listed in a CSV file, by full path.
+  std::unordered_map<std::string, double> SourceCosts;
+
+  // Object files listed in a ninja log, without their extension, and
+  // their cost, grouped by file name.
+  std::unordered_map<std::string, std::vector<std::pair<std::string, double>>>
+    ObjectCosts;
+
+  bool LoadNinjaLog(std::string const& path, std::string& error);
+  bool LoadCSV(std::string const& path, std::string& error);
+};
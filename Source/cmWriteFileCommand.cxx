@@ -7,6 +7,7 @@
 #include "cm_sys_stat.h"
 
 #include "cmExecutionStatus.h"
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
@@ -42,6 +43,10 @@ bool cmWriteFileCommand(std::vector<std::string> const& args,
     return false;
   }
 
+  // The find commands must list the directories again.
+  status.GetMakefile().GetGlobalGenerator()->InvalidateDirectoryContent(
+    cmSystemTools::CollapseFullPath(fileName));
+
   std::string dir = cmSystemTools::GetFilenamePath(fileName);
   cmSystemTools::MakeDirectory(dir);
 
@@ -71,7 +71,11 @@
 #  include <cm3p/curl/curl.h>
 #  include <cm3p/json/writer.h>
 
+#  include "cmBinaryTrace.h"
+#  include "cmConfigureInputs.h"
+#  include "cmFindPackageSearchCache.h"
 #  include "cmFileAPI.h"
+#  include "cmGeneratedFileHashes.h"
 #  include "cmGraphVizWriter.h"
 #  include "cmVariableWatch.h"
 #endif
@@ -1041,7 +1045,7 @@ void cmake::SetArgs(const std::vector<std::string>& args)
                        if (traceFormat == TraceFormat::TRACE_UNDEFINED) {
                          cmSystemTools::Error(
                            "Invalid format specified for --trace-format. "
-                           "Valid formats are human, json-v1.");
+                           "Valid formats are human, json-v1, binary-v1.");
                          return false;
                        }
                        state->SetTraceFormat(traceFormat);
@@ -1055,6 +1059,19 @@ void cmake::SetArgs(const std::vector<std::string>& args)
                        state->SetTrace(true);
                        return true;
                      } },
+    CommandArgument{ "--trace-sample", CommandArgument::Values::One,
+                     [](std::string const& value, cmake* state) -> bool {
+                       unsigned long n = 0;
+                       if (!cmStrToULong(value, &n) || n == 0) {
+                         cmSystemTools::Error(
+                           "Invalid value specified for --trace-sample. "
+                           "It must be a positive integer.");
+                         return false;
+                       }
+                       state->SetTraceSample(n);
+                       state->SetTrace(true);
+                       return true;
+                     } },
     CommandArgument{ "--trace-redirect", CommandArgument::Values::One,
                      [](std::string const& value, cmake* state) -> bool {
                        std::string file(value);
@@ -1128,6 +1145,26 @@ void cmake::SetArgs(const std::vector<std::string>& args)
       cmSystemTools::ConvertToUnixSlashes(profilingOutput);
       return true;
     });
+  arguments.emplace_back(
+    "--parse-cache", "No mode specified for --parse-cache",
+    CommandArgument::Values::One, CommandArgument::RequiresSeparator::Yes,
+    [](std::string const& value, cmake* state) -> bool {
+      auto mode = cmListFileParseCache::ModeFromString(value);
+      if (!mode) {
+        cmSystemTools::Error(
+          cmStrCat("Invalid mode specified for --parse-cache: ", value,
+                   "\nValid modes are off, read, readwrite."));
+        return false;
+      }
+      state->SetListFileParseCacheMode(*mode);
+      return true;
+    });
+  arguments.emplace_back("--skip-unchanged-reconfigure",
+                         CommandArgument::Values::Zero,
+                         [](std::string const&, cmake* state) -> bool {
+                           state->SkipUnchangedReconfigure = true;
+                           return true;
+                         });
   arguments.emplace_back("--preset", "No preset specified for --preset",
                          CommandArgument::Values::One,
                          [&](std::string const& value, cmake*) -> bool {
@@ -1245,25 +1282,47 @@ void cmake::SetArgs(const std::vector<std::string>& args)
   }
 
 #if !defined(CMAKE_BOOTSTRAP)
+  if (this->TraceFormatVar == TraceFormat::TRACE_BINARY_V1 &&
+      !this->TraceRedirect) {
+    if (this->TraceFileName.empty()) {
+      cmSystemTools::Error(
+        "--trace-format=binary-v1 specified but no --trace-redirect!");
+      return;
+    }
+    // The binary trace replaces the text trace file.
+    this->TraceFile.close();
+    this->BinaryTrace = cm::make_unique<cmBinaryTrace>();
+    if (!this->BinaryTrace->Open(this->TraceFileName)) {
+      cmSystemTools::Error(cmStrCat("Error opening trace file ",
+                                    this->TraceFileName, ": ",
+                                    cmSystemTools::GetLastSystemError()));
+      this->BinaryTrace.reset();
+      return;
+    }
+  }
+
   if (!profilingOutput.empty() || !profilingFormat.empty()) {
     if (profilingOutput.empty()) {
       cmSystemTools::Error(
         "--profiling-format specified but no --profiling-output!");
       return;
     }
+    cmMakefileProfilingData::Format format;
     if (profilingFormat == "google-trace"_s) {
-      try {
-        this->ProfilingOutput =
-          cm::make_unique<cmMakefileProfilingData>(profilingOutput);
-      } catch (std::runtime_error& e) {
-        cmSystemTools::Error(
-          cmStrCat("Could not start profiling: ", e.what()));
-        return;
-      }
+      format = cmMakefileProfilingData::Format::GoogleTrace;
+    } else if (profilingFormat == "summary"_s) {
+      format = cmMakefileProfilingData::Format::Summary;
     } else {
       cmSystemTools::Error("Invalid format specified for --profiling-format");
       return;
     }
+    try {
+      this->ProfilingOutput =
+        cm::make_unique<cmMakefileProfilingData>(profilingOutput, format);
+    } catch (std::runtime_error& e) {
+      cmSystemTools::Error(cmStrCat("Could not start profiling: ", e.what()));
+      return;
+    }
   }
 #endif
 
@@ -1475,6 +1534,7 @@ cmake::TraceFormat cmake::StringToTraceFormat(const std::string& traceStr)
   static const std::vector<TracePair> levels = {
     { "human", TraceFormat::TRACE_HUMAN },
     { "json-v1", TraceFormat::TRACE_JSON_V1 },
+    { "binary-v1", TraceFormat::TRACE_BINARY_V1 },
   };
 
   const auto traceStrLowCase = cmSystemTools::LowerCase(traceStr);
@@ -1488,6 +1548,7 @@ cmake::TraceFormat cmake::StringToTraceFormat(const std::string& traceStr)
 
 void cmake::SetTraceFile(const std::string& file)
 {
+  this->TraceFileName = file;
   this->TraceFile.close();
   this->TraceFile.open(file.c_str());
   if (!this->TraceFile) {
@@ -1523,6 +1584,7 @@ void cmake::PrintTraceFormatVersion()
       break;
     }
     case TraceFormat::TRACE_HUMAN:
+    case TraceFormat::TRACE_BINARY_V1:
       msg = "";
       break;
     case TraceFormat::TRACE_UNDEFINED:
@@ -2314,7 +2376,14 @@ int cmake::ActualConfigure()
 #endif
 
   // actually do the configure
+#if !defined(CMAKE_BOOTSTRAP)
+  this->StartListFileParseCache();
+#endif
   this->GlobalGenerator->Configure();
+#if !defined(CMAKE_BOOTSTRAP)
+  this->FinishListFileParseCache();
+  this->FinishFindPackageSearchCache();
+#endif
   // Before saving the cache
   // if the project did not define one of the entries below, add them now
   // so users can edit the values in the cache:
@@ -2550,6 +2619,26 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
     return 0;
   }
 
+#if !defined(CMAKE_BOOTSTRAP)
+  std::string const inputsRecord =
+    cmConfigureInputs::ComputeRecordFile(this->GetHomeOutputDirectory());
+  if (!this->SkipUnchangedReconfigure) {
+    if (this->RegenerateDuringBuild ||
+        !this->CheckBuildSystemArgument.empty()) {
+      // The build tool regenerates a build system that skips unchanged
+      // reconfigures the same way.
+      this->SkipUnchangedReconfigure = cmSystemTools::FileExists(inputsRecord);
+    } else {
+      // This run does not record its inputs, so the record of an earlier
+      // run must not make the build tool skip the next regeneration.
+      cmSystemTools::RemoveFile(inputsRecord);
+    }
+  }
+  if (this->SkipUnchangedReconfigure && !this->StartConfigureInputs()) {
+    return 0;
+  }
+#endif
+
   int ret = this->Configure();
   if (ret) {
 #if defined(CMAKE_HAVE_VS_GENERATORS)
@@ -2575,6 +2664,9 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
                            "Build files cannot be regenerated correctly.");
     return ret;
   }
+#if !defined(CMAKE_BOOTSTRAP)
+  this->FinishConfigureInputs();
+#endif
   std::string message = cmStrCat("Build files have been written to: ",
                                  this->GetHomeOutputDirectory());
   this->UpdateProgress(message, -1);
@@ -2589,9 +2681,13 @@ int cmake::Generate()
 
 #if !defined(CMAKE_BOOTSTRAP)
   auto profilingRAII = this->CreateProfilingEntry("project", "generate");
+  this->StartGeneratedFileHashes();
 #endif
 
   if (!this->GlobalGenerator->Compute()) {
+#if !defined(CMAKE_BOOTSTRAP)
+    this->FinishGeneratedFileHashes();
+#endif
     return -1;
   }
   this->GlobalGenerator->Generate();
@@ -2603,6 +2699,9 @@ int cmake::Generate()
     this->RunCheckForUnusedVariables();
   }
   if (cmSystemTools::GetErrorOccurredFlag()) {
+#if !defined(CMAKE_BOOTSTRAP)
+    this->FinishGeneratedFileHashes();
+#endif
     return -1;
   }
   // Save the cache again after a successful Generate so that any internal
@@ -2612,6 +2711,7 @@ int cmake::Generate()
 
 #if !defined(CMAKE_BOOTSTRAP)
   this->FileAPI->WriteReplies();
+  this->FinishGeneratedFileHashes();
 #endif
 
   return 0;
@@ -4052,6 +4152,230 @@ bool cmake::GetDebugFindPkgOutput(std::string const& pkg) const
 }
 
 #if !defined(CMAKE_BOOTSTRAP)
+void cmake::StartListFileParseCache()
+{
+  // A try_compile project shares the list files parsed by its parent,
+  // but not its own files.
+  if (this->ListFileParseCache) {
+    this->ListFileParseCache->PushTransientDirectory(
+      this->GetHomeOutputDirectory());
+    return;
+  }
+
+  cmListFileParseCache::Mode mode = cmListFileParseCache::Mode::Off;
+  if (this->ListFileParseCacheMode) {
+    mode = *this->ListFileParseCacheMode;
+  } else {
+    std::string envMode;
+    if (cmSystemTools::GetEnv("CMAKE_PARSE_CACHE", envMode) &&
+        !envMode.empty()) {
+      if (auto m = cmListFileParseCache::ModeFromString(envMode)) {
+        mode = *m;
+      } else {
+        this->IssueMessage(
+          MessageType::WARNING,
+          cmStrCat("Ignoring invalid CMAKE_PARSE_CACHE environment variable "
+                   "value:\n  ",
+                   envMode, "\nValid modes are off, read, readwrite."));
+      }
+    }
+  }
+  // A try_compile project is configured once and then discarded.
+  if (this->GetIsInTryCompile()) {
+    mode = cmListFileParseCache::Mode::Off;
+  }
+
+  this->ListFileParseCache = std::make_shared<cmListFileParseCache>(
+    mode,
+    cmStrCat(this->GetHomeOutputDirectory(),
+             "/CMakeFiles/ListFileParseCache.bin"));
+  this->ListFileParseCache->Load();
+}
+
+void cmake::FinishListFileParseCache()
+{
+  if (this->GetIsInTryCompile()) {
+    this->ListFileParseCache->PopTransientDirectory();
+    this->ListFileParseCache.reset();
+    return;
+  }
+
+  if (!this->ListFileParseCache->Save()) {
+    this->IssueMessage(
+      MessageType::WARNING,
+      cmStrCat("Could not write list file parse cache:\n  ",
+               this->ListFileParseCache->GetCacheFile()));
+  }
+
+  if (this->IsProfilingEnabled()) {
+    cmListFileParseCache::Statistics const& stats =
+      this->ListFileParseCache->GetStatistics();
+    Json::Value counters(Json::objectValue);
+    counters["loaded"] = static_cast<Json::UInt64>(stats.Loaded);
+    counters["hits"] = static_cast<Json::UInt64>(stats.Hits);
+    counters["reused"] = static_cast<Json::UInt64>(stats.Reused);
+    counters["misses"] = static_cast<Json::UInt64>(stats.Misses);
+    counters["stale"] = static_cast<Json::UInt64>(stats.Stale);
+    counters["uncacheable"] = static_cast<Json::UInt64>(stats.Uncacheable);
+    counters["stored"] = static_cast<Json::UInt64>(stats.Stored);
+    this->GetProfilingOutput().AddCounters("parse-cache", counters);
+  }
+  this->ListFileParseCache.reset();
+}
+
+cmFindPackageSearchCache* cmake::GetFindPackageSearchCache()
+{
+  // A try_compile project is configured once and then discarded.
+  if (this->GetIsInTryCompile()) {
+    return nullptr;
+  }
+  if (!this->FindPackageSearchCache) {
+    this->FindPackageSearchCache = cm::make_unique<cmFindPackageSearchCache>(
+      this->GetHomeOutputDirectory());
+    this->FindPackageSearchCache->Load();
+  }
+  return this->FindPackageSearchCache.get();
+}
+
+void cmake::FinishFindPackageSearchCache()
+{
+  if (!this->FindPackageSearchCache) {
+    return;
+  }
+
+  if (!this->FindPackageSearchCache->Save()) {
+    this->IssueMessage(
+      MessageType::WARNING,
+      cmStrCat("Could not write find_package search cache:\n  ",
+               this->FindPackageSearchCache->GetCacheFile()));
+  }
+
+  if (this->IsProfilingEnabled()) {
+    cmFindPackageSearchCache::Statistics const& stats =
+      this->FindPackageSearchCache->GetStatistics();
+    Json::Value counters(Json::objectValue);
+    counters["hits"] = static_cast<Json::UInt64>(stats.Hits);
+    counters["misses"] = static_cast<Json::UInt64>(stats.Misses);
+    counters["stale"] = static_cast<Json::UInt64>(stats.Stale);
+    counters["stored"] = static_cast<Json::UInt64>(stats.Stored);
+    this->GetProfilingOutput().AddCounters("find-package-cache", counters);
+  }
+  this->FindPackageSearchCache.reset();
+}
+
+void cmake::StartGeneratedFileHashes()
+{
+  // A try_compile project is generated once and then discarded.
+  std::string skipUnchanged;
+  if (this->GetIsInTryCompile() ||
+      !cmSystemTools::GetEnv("CMAKE_GENERATE_SKIP_UNCHANGED",
+                             skipUnchanged) ||
+      !cmIsOn(skipUnchanged)) {
+    return;
+  }
+
+  this->GeneratedFileHashes =
+    cm::make_unique<cmGeneratedFileHashes>(this->GetHomeOutputDirectory());
+  this->GeneratedFileHashes->Load();
+  cmGeneratedFileStreamBase::SetContentHashes(this->GeneratedFileHashes.get());
+}
+
+void cmake::FinishGeneratedFileHashes()
+{
+  if (!this->GeneratedFileHashes) {
+    return;
+  }
+  cmGeneratedFileStreamBase::SetContentHashes(nullptr);
+
+  if (!this->GeneratedFileHashes->Save()) {
+    this->IssueMessage(
+      MessageType::WARNING,
+      cmStrCat("Could not write generated file hashes:\n  ",
+               this->GeneratedFileHashes->GetRecordFile()));
+  }
+
+  if (this->IsProfilingEnabled()) {
+    cmGeneratedFileHashes::Statistics const& stats =
+      this->GeneratedFileHashes->GetStatistics();
+    Json::Value counters(Json::objectValue);
+    counters["written"] = static_cast<Json::UInt64>(stats.Written);
+    counters["unchanged"] = static_cast<Json::UInt64>(stats.Unchanged);
+    counters["skipped"] = static_cast<Json::UInt64>(stats.Skipped);
+    this->GetProfilingOutput().AddCounters("generated-files", counters);
+  }
+  this->GeneratedFileHashes.reset();
+}
+
+bool cmake::CanSkipConfigure() const
+{
+  // Options that ask for output from the configure or generate steps need
+  // them to run.
+  return !this->GetIsInTryCompile() && !this->Trace && !this->DebugOutput &&
+    !this->DebugFindOutput && !this->WarnUninitialized &&
+    !this->CheckSystemVars && this->GraphVizFile.empty() &&
+    !this->IsProfilingEnabled();
+}
+
+bool cmake::StartConfigureInputs()
+{
+  this->ConfigureInputs =
+    cm::make_unique<cmConfigureInputs>(this->GetHomeOutputDirectory());
+
+  cmValue cachedGenerator =
+    this->State->GetInitializedCacheValue("CMAKE_GENERATOR");
+  std::vector<std::string> changes;
+  if (!this->CanSkipConfigure()) {
+    changes.emplace_back("a debugging or warning option was given");
+  } else if ((this->GlobalGenerator && cachedGenerator &&
+              cachedGenerator != this->GlobalGenerator->GetName()) ||
+             this->GeneratorInstanceSet || this->GeneratorPlatformSet ||
+             this->GeneratorToolsetSet) {
+    // Let the configure step check the generator settings against the
+    // cache.
+    changes.emplace_back("generator settings were given");
+  } else if (this->ConfigureInputs->IsUpToDate(
+               cmConfigureInputs::ComputeCacheDigest(this->State.get()),
+               changes)) {
+    this->ConfigureInputs->TouchRegenerationOutputs();
+    this->ConfigureInputs.reset();
+    this->UpdateProgress(
+      cmStrCat("Configure inputs are unchanged, build files are up to date "
+               "in: ",
+               this->GetHomeOutputDirectory()),
+      -1);
+    return false;
+  }
+
+  // Report a few of the reasons.  A project with many directories may
+  // have changed in all of them.
+  std::size_t const maxReported = 10;
+  for (std::size_t i = 0; i < changes.size() && i < maxReported; ++i) {
+    this->UpdateProgress(
+      cmStrCat("Configuring again because ", changes[i]), -1);
+  }
+  if (changes.size() > maxReported) {
+    this->UpdateProgress(cmStrCat("Configuring again because of ",
+                                  changes.size() - maxReported,
+                                  " more changes"),
+                         -1);
+  }
+
+  this->ConfigureInputs->StartRecording();
+  return true;
+}
+
+void cmake::FinishConfigureInputs()
+{
+  if (this->ConfigureInputs &&
+      !this->ConfigureInputs->Save(this->GlobalGenerator.get())) {
+    this->IssueMessage(
+      MessageType::WARNING,
+      cmStrCat("Could not write configure inputs record:\n  ",
+               this->ConfigureInputs->GetRecordFile()));
+  }
+  this->ConfigureInputs.reset();
+}
+
 cmMakefileProfilingData& cmake::GetProfilingOutput()
 {
   return *(this->ProfilingOutput);
@@ -18,6 +18,7 @@
 #include <cm/string_view>
 #include <cmext/string_view>
 
+#include "cmAtom.h"
 #include "cmGeneratedFileStream.h"
 #include "cmInstalledFile.h"
 #include "cmListFileCache.h"
@@ -33,10 +34,15 @@
 #  include <cm3p/json/value.h>
 
 #  include "cmCMakePresetsGraph.h"
+#  include "cmListFileParseCache.h"
 #  include "cmMakefileProfilingData.h"
 #endif
 
+class cmBinaryTrace;
+class cmConfigureInputs;
 class cmExternalMakefileProjectGeneratorFactory;
+class cmFindPackageSearchCache;
+class cmGeneratedFileHashes;
 class cmFileAPI;
 class cmFileTimeCache;
 class cmGlobalGenerator;
@@ -124,6 +130,7 @@ public:
     TRACE_UNDEFINED,
     TRACE_HUMAN,
     TRACE_JSON_V1,
+    TRACE_BINARY_V1,
   };
 
   struct GeneratorInfo
@@ -520,6 +527,24 @@ public:
   }
   void SetTraceFile(std::string const& file);
   void PrintTraceFormatVersion();
+#if !defined(CMAKE_BOOTSTRAP)
+  cmBinaryTrace* GetBinaryTrace()
+  {
+    if (this->TraceRedirect) {
+      return this->TraceRedirect->GetBinaryTrace();
+    }
+    return this->BinaryTrace.get();
+  }
+#endif
+  void SetTraceSample(unsigned long n) { this->TraceSample = n; }
+  //! Whether to output the next command traced, one in every TraceSample.
+  bool SampleTrace()
+  {
+    if (this->TraceRedirect) {
+      return this->TraceRedirect->SampleTrace();
+    }
+    return this->TraceCount++ % this->TraceSample == 0;
+  }
 
   //! Use trace from another ::cmake instance.
   void SetTraceRedirect(cmake* other);
@@ -648,12 +673,41 @@ public:
     }
     return cm::nullopt;
   }
+
+  //! Cache of parsed list files, or null if not configuring.
+  cmListFileParseCache* GetListFileParseCache() const
+  {
+    return this->ListFileParseCache.get();
+  }
+  void SetListFileParseCacheMode(cmListFileParseCache::Mode mode)
+  {
+    this->ListFileParseCacheMode = mode;
+  }
+  //! Reuse the parsed list files of a parent instance, e.g. in try_compile.
+  void ShareListFileParseCache(cmake* parent)
+  {
+    this->ListFileParseCache = parent->ListFileParseCache;
+  }
+
+  //! Inputs recorded to skip an unchanged reconfigure, or null if disabled.
+  cmConfigureInputs* GetConfigureInputs() const
+  {
+    return this->ConfigureInputs.get();
+  }
+
+  //! The find_package search results of previous runs, or null in
+  //! try_compile projects.
+  cmFindPackageSearchCache* GetFindPackageSearchCache();
 #endif
 
 protected:
   void RunCheckForUnusedVariables();
   int HandleDeleteCacheVariables(const std::string& var);
 
+  // Keep the names interned by this instance until it is destroyed.
+  // This comes first so that it outlives the other members.
+  cmAtom::Scope AtomScope;
+
   using RegisteredGeneratorsVector =
     std::vector<std::unique_ptr<cmGlobalGeneratorFactory>>;
   RegisteredGeneratorsVector Generators;
@@ -706,6 +760,9 @@ private:
   bool TraceExpand = false;
   TraceFormat TraceFormatVar = TRACE_HUMAN;
   cmGeneratedFileStream TraceFile;
+  std::string TraceFileName;
+  unsigned long TraceSample = 1;
+  unsigned long TraceCount = 0;
   cmake* TraceRedirect = nullptr;
   bool WarnUninitialized = false;
   bool WarnUnusedCli = true;
@@ -785,6 +842,25 @@ private:
 
 #if !defined(CMAKE_BOOTSTRAP)
   std::unique_ptr<cmMakefileProfilingData> ProfilingOutput;
+  std::unique_ptr<cmBinaryTrace> BinaryTrace;
+
+  cm::optional<cmListFileParseCache::Mode> ListFileParseCacheMode;
+  std::shared_ptr<cmListFileParseCache> ListFileParseCache;
+  void StartListFileParseCache();
+  void FinishListFileParseCache();
+
+  bool SkipUnchangedReconfigure = false;
+  std::unique_ptr<cmConfigureInputs> ConfigureInputs;
+  bool CanSkipConfigure() const;
+  bool StartConfigureInputs();
+  void FinishConfigureInputs();
+
+  std::unique_ptr<cmFindPackageSearchCache> FindPackageSearchCache;
+  void FinishFindPackageSearchCache();
+
+  std::unique_ptr<cmGeneratedFileHashes> GeneratedFileHashes;
+  void StartGeneratedFileHashes();
+  void FinishGeneratedFileHashes();
 #endif
 };
 
@@ -101,7 +101,9 @@ const char* cmDocumentationOptions[][2] = {
     "Limit cmake debug-find to the comma-separated list of result variables" },
   { "--trace", "Put cmake in trace mode." },
   { "--trace-expand", "Put cmake in trace mode with variable expansion." },
-  { "--trace-format=<human|json-v1>", "Set the output format of the trace." },
+  { "--trace-format=<human|json-v1|binary-v1>",
+    "Set the output format of the trace." },
+  { "--trace-sample=<n>", "Trace only one in every <n> commands." },
   { "--trace-source=<file>",
     "Trace only this CMake file/module. Multiple options allowed." },
   { "--trace-redirect=<file>",
@@ -116,10 +118,14 @@ const char* cmDocumentationOptions[][2] = {
 #  if !defined(CMAKE_BOOTSTRAP)
   { "--profiling-format=<fmt>",
     "Output data for profiling CMake scripts. Supported formats: "
-    "google-trace" },
+    "google-trace, summary" },
   { "--profiling-output=<file>",
     "Select an output path for the profiling data enabled through "
     "--profiling-format." },
+  { "--parse-cache=<off|read|readwrite>",
+    "Cache parsed list files in the build tree across runs." },
+  { "--skip-unchanged-reconfigure",
+    "Skip configure and generate if no recorded input changed." },
 #  endif
   { nullptr, nullptr }
 };
@@ -7,6 +7,7 @@
 #include <cm3p/uv.h>
 #include <fcntl.h>
 
+#include "cmCompileCommandsDatabase.h"
 #include "cmConsoleBuf.h"
 #include "cmDuration.h"
 #include "cmGlobalGenerator.h"
@@ -28,6 +29,7 @@
 #include "cmake.h"
 
 #if !defined(CMAKE_BOOTSTRAP)
+#  include "cmBinaryTrace.h"
 #  include "cmDependsFortran.h" // For -E cmake_copy_f90_mod callback.
 #  include "cmFileTime.h"
 
@@ -102,12 +104,15 @@ void CMakeCommandUsage(std::string const& program)
     << "  chdir dir cmd [args...]   - run command in a given directory\n"
     << "  compare_files [--ignore-eol] file1 file2\n"
     << "                              - check if file1 is same as file2\n"
+    << "  compile_commands_query database file\n"
+    << "                            - print the compile commands of a file\n"
     << "  copy <file>... destination  - copy files to destination "
        "(either file or directory)\n"
     << "  copy_directory <dir>... destination   - copy content of <dir>... "
        "directories to 'destination' directory\n"
     << "  copy_if_different <file>... destination  - copy files if it has "
        "changed\n"
+    << "  decode_trace file         - print a binary-v1 trace as json-v1\n"
     << "  echo [<string>...]        - displays arguments as text\n"
     << "  echo_append [<string>...] - displays arguments as text but no new "
        "line\n"
@@ -725,7 +730,46 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string> const& args,
       return 0;
     }
 
+    // Print the compile commands of a source from the compact database
+    if (args[1] == "compile_commands_query" && args.size() == 4) {
+      std::string const file = cmSystemTools::CollapseFullPath(args[3]);
+      std::vector<cmCompileCommandsDatabase::Entry> entries;
+      std::string error;
+      if (!cmCompileCommandsDatabase::Query(args[2], file, entries, error)) {
+        std::cerr << "Error reading \"" << args[2] << "\": " << error
+                  << "\n";
+        return 2;
+      }
+      std::cout << "[";
+      const char* sep = "\n";
+      for (cmCompileCommandsDatabase::Entry const& entry : entries) {
+        std::cout << sep << "{\n"
+                  << R"(  "directory": ")"
+                  << cmGlobalGenerator::EscapeJSON(entry.Directory) << "\",\n"
+                  << R"(  "command": ")"
+                  << cmGlobalGenerator::EscapeJSON(entry.Command) << "\",\n"
+                  << R"(  "file": ")"
+                  << cmGlobalGenerator::EscapeJSON(entry.File) << "\",\n"
+                  << R"(  "output": ")"
+                  << cmGlobalGenerator::EscapeJSON(entry.Output) << "\"\n}";
+        sep = ",\n";
+      }
+      std::cout << "\n]\n";
+      return entries.empty() ? 1 : 0;
+    }
+
 #if !defined(CMAKE_BOOTSTRAP)
+    // Convert a binary trace to the json-v1 format
+    if (args[1] == "decode_trace" && args.size() == 3) {
+      std::string error;
+      if (!cmBinaryTrace::Decode(args[2], std::cout, error)) {
+        std::cerr << "Error reading \"" << args[2] << "\": " << error
+                  << "\n";
+        return 1;
+      }
+      return 0;
+    }
+
     if (args[1] == "__create_def") {
       if (args.size() < 4) {
         std::cerr << "__create_def Usage: -E __create_def outfile.def "
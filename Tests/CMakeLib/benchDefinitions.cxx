@@ -0,0 +1,101 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+// Micro-benchmark for cmDefinitions.  It mimics what the CMake language
+// does for nested function() calls: each call pushes a scope, defines the
+// ARGC/ARGV/ARGN/ARGV<n> variables, reads variables defined near the root,
+// sets and unsets locals, and sets a result in the parent scope.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cmDefinitions.h"
+#include "cmLinkedTree.h"
+#include "cmValue.h"
+
+namespace {
+
+using Tree = cmLinkedTree<cmDefinitions>;
+
+struct Benchmark
+{
+  Tree VarTree;
+  Tree::iterator Root;
+  std::vector<std::string> GlobalNames;
+  std::vector<std::string> ArgNames;
+  std::size_t Found = 0;
+
+  Benchmark(int globals, int args)
+  {
+    this->Root = this->VarTree.Push(this->VarTree.Root());
+    for (int i = 0; i < globals; ++i) {
+      this->GlobalNames.push_back("CMAKE_GLOBAL_VARIABLE_" +
+                                  std::to_string(i));
+      this->Root->Set(this->GlobalNames.back(), "global");
+    }
+    for (int i = 0; i < args; ++i) {
+      this->ArgNames.push_back("ARGV" + std::to_string(i));
+    }
+  }
+
+  void Call(Tree::iterator parent, int depth)
+  {
+    Tree::iterator scope = this->VarTree.Push(parent);
+    scope->Set("ARGC", std::to_string(this->ArgNames.size()));
+    scope->Set("ARGV", "a;b;c;d");
+    scope->Set("ARGN", "");
+    for (std::string const& arg : this->ArgNames) {
+      scope->Set(arg, "value");
+    }
+
+    for (std::string const& name : this->GlobalNames) {
+      if (cmDefinitions::Get(name, scope, this->VarTree.Root())) {
+        ++this->Found;
+      }
+    }
+    scope->Set("_local", "x");
+    if (cmDefinitions::Get("_local", scope, this->VarTree.Root())) {
+      ++this->Found;
+    }
+    scope->Unset("_local");
+    if (cmDefinitions::Get("_missing", scope, this->VarTree.Root())) {
+      ++this->Found;
+    }
+
+    if (depth > 1) {
+      this->Call(scope, depth - 1);
+    }
+
+    // set(result ... PARENT_SCOPE)
+    cmDefinitions::Raise("result", parent, this->VarTree.Root());
+    parent->Set("result", "done");
+
+    this->VarTree.Pop(scope);
+  }
+};
+}
+
+int main(int argc, char* argv[])
+{
+  int const iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+  int const depth = argc > 2 ? std::atoi(argv[2]) : 16;
+  int const globals = argc > 3 ? std::atoi(argv[3]) : 64;
+
+  Benchmark bench(globals, 4);
+  auto const start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    bench.Call(bench.Root, depth);
+  }
+  auto const stop = std::chrono::steady_clock::now();
+
+  double const ms =
+    std::chrono::duration<double, std::milli>(stop - start).count();
+  double const calls = static_cast<double>(iterations) * depth;
+  std::cout << iterations << " iterations of " << depth
+            << " nested calls reading " << globals << " globals: " << ms
+            << " ms (" << (ms * 1e6 / calls) << " ns per call)\n";
+  return bench.Found != 0 ? 0 : 1;
+}
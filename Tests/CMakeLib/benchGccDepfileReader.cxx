@@ -0,0 +1,86 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+// Benchmark for reading GCC-style depfiles.  It reports the throughput of
+// the parser that works without the lexer and of the lexer on one depfile,
+// such as testGccDepfileReader_data/large.d.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <ios>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmGccDepfileLexerHelper.h"
+#include "cmGccDepfileReaderTypes.h"
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <depfile> [iterations]\n";
+    return 1;
+  }
+  std::string const depfile = argv[1];
+  int const iterations = argc > 2 ? std::atoi(argv[2]) : 10;
+  if (iterations < 1) {
+    std::cerr << "At least one iteration is required.\n";
+    return 1;
+  }
+
+  std::string content;
+  {
+    cmsys::ifstream is(depfile.c_str(), std::ios::in | std::ios::binary);
+    if (!is) {
+      std::cerr << "Cannot read " << depfile << "\n";
+      return 1;
+    }
+    std::ostringstream ss;
+    ss << is.rdbuf();
+    content = ss.str();
+  }
+
+  std::size_t paths = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    cmGccDepfileLexerHelper parser;
+    if (parser.parseContent(content) !=
+        cmGccDepfileLexerHelper::ParseResult::Success) {
+      std::cerr << "Parsing " << depfile << " without the lexer failed\n";
+      return 1;
+    }
+    paths = 0;
+    for (cmGccStyleDependency const& entry :
+         std::move(parser).extractContent()) {
+      paths += entry.rules.size() + entry.paths.size();
+    }
+  }
+  auto const parserTime = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    cmGccDepfileLexerHelper lexer;
+    if (!lexer.readFile(depfile.c_str())) {
+      std::cerr << "Lexing " << depfile << " failed\n";
+      return 1;
+    }
+  }
+  auto const lexerTime = std::chrono::steady_clock::now() - start;
+
+  auto perSecond = [&](std::chrono::steady_clock::duration d) {
+    double const seconds = std::chrono::duration<double>(d).count();
+    return seconds > 0 ? static_cast<double>(paths) * iterations / seconds
+                       : 0;
+  };
+  std::cout << iterations << " iterations reading " << paths
+            << " paths from " << depfile << ":\n"
+            << "  without lexer: " << perSecond(parserTime)
+            << " paths per second\n"
+            << "  with lexer: " << perSecond(lexerTime)
+            << " paths per second\n";
+  return 0;
+}
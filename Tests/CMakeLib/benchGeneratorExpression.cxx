@@ -0,0 +1,123 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+// Benchmark for evaluating usage requirements through long chains of
+// INTERFACE_* properties.  It generates a project in which every library
+// links to the previous one and publishes include directories and compile
+// definitions with generator expressions, then repeatedly asks for the
+// usage requirements of the executable at the end of the chain.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cmGeneratedFileStream.h"
+#include "cmGeneratorExpression.h"
+#include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
+#include "cmListFileCache.h"
+#include "cmState.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmake.h"
+
+namespace {
+
+std::string const kConfig = "Bench";
+
+void WriteProject(std::string const& sourceDir, int libraries)
+{
+  cmSystemTools::MakeDirectory(sourceDir);
+  {
+    cmGeneratedFileStream fout(cmStrCat(sourceDir, "/empty.c"));
+    fout << "int main(void) { return 0; }\n";
+  }
+
+  cmGeneratedFileStream fout(cmStrCat(sourceDir, "/CMakeLists.txt"));
+  fout << "cmake_minimum_required(VERSION 3.25)\n"
+          "project(BenchGeneratorExpression C)\n";
+  for (int i = 0; i < libraries; ++i) {
+    std::string const lib = cmStrCat("lib", i);
+    fout << "add_library(" << lib << " INTERFACE)\n"
+         << "target_include_directories(" << lib << " INTERFACE\n"
+         << "  \"$<BUILD_INTERFACE:${CMAKE_CURRENT_SOURCE_DIR}/" << lib
+         << ">\"\n"
+         << "  \"$<INSTALL_INTERFACE:include/" << lib << ">\")\n"
+         << "target_compile_definitions(" << lib << " INTERFACE\n"
+         << "  " << lib << "_CONFIG=$<CONFIG>\n"
+         << "  $<$<CONFIG:Bench>:" << lib << "_BENCH>\n"
+         << "  $<$<BOOL:ON>:" << lib << "_ON>)\n";
+    if (i > 0) {
+      fout << "target_link_libraries(" << lib << " INTERFACE lib" << (i - 1)
+           << ")\n";
+    }
+  }
+  fout << "add_executable(exe empty.c)\n"
+       << "target_link_libraries(exe PRIVATE lib" << (libraries - 1)
+       << ")\n";
+}
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <cmake> <work-dir> [libraries] [iterations] [generator]\n";
+    return 1;
+  }
+  std::string const workDir = argv[2];
+  int const libraries = argc > 3 ? std::atoi(argv[3]) : 200;
+  int const iterations = argc > 4 ? std::atoi(argv[4]) : 50;
+  if (libraries < 1) {
+    std::cerr << "At least one library is required.\n";
+    return 1;
+  }
+
+  std::string const sourceDir = cmStrCat(workDir, "/src");
+  std::string const binaryDir = cmStrCat(workDir, "/build");
+  cmSystemTools::FindCMakeResources(argv[1]);
+  cmSystemTools::RemoveADirectory(binaryDir);
+  WriteProject(sourceDir, libraries);
+
+  cmake cm(cmake::RoleProject, cmState::Project);
+  std::vector<std::string> args = { argv[1], "-S", sourceDir, "-B",
+                                    binaryDir };
+  if (argc > 5) {
+    args.emplace_back(cmStrCat("-G", argv[5]));
+  }
+  if (cm.Run(args) != 0) {
+    std::cerr << "Failed to generate " << sourceDir << "\n";
+    return 1;
+  }
+
+  cmGeneratorTarget const* exe =
+    cm.GetGlobalGenerator()->FindGeneratorTarget("exe");
+  if (!exe) {
+    std::cerr << "Target exe was not generated.\n";
+    return 1;
+  }
+  std::string const property = cmStrCat(
+    "$<TARGET_PROPERTY:lib", libraries - 1, ",INTERFACE_COMPILE_DEFINITIONS>");
+
+  std::size_t items = 0;
+  auto const start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    items += exe->GetIncludeDirectories(kConfig, "C").size();
+    items += exe->GetCompileDefinitions(kConfig, "C").size();
+    std::string const definitions = cmGeneratorExpression::Evaluate(
+      property, exe->GetLocalGenerator(), kConfig, exe);
+    items += cmExpandedList(definitions).size();
+  }
+  auto const stop = std::chrono::steady_clock::now();
+
+  double const ms =
+    std::chrono::duration<double, std::milli>(stop - start).count();
+  std::cout << iterations << " iterations over a chain of " << libraries
+            << " libraries: " << ms << " ms (" << (ms / iterations)
+            << " ms per iteration, " << items << " items)\n";
+  std::size_t const expected =
+    static_cast<std::size_t>(iterations) * libraries * 7;
+  return items == expected ? 0 : 1;
+}
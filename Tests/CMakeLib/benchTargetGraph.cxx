@@ -0,0 +1,110 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+// Micro-benchmark for walks over the target dependency graph.  It builds a
+// random acyclic graph shaped like a large project, where each target
+// depends on a few targets defined before it, mostly nearby ones.  It then
+// times the strongly connected component analysis, building the compact
+// graph, and collecting the transitive dependencies of a sample of targets
+// both with a std::set, as generators used to, and with cmCompactGraphWalk.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+
+#include "cmCompactGraph.h"
+#include "cmComputeComponentGraph.h"
+#include "cmGraphAdjacencyList.h"
+#include "cmListFileCache.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double Milliseconds(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+    .count();
+}
+
+cmGraphAdjacencyList MakeGraph(int nodes, int depends)
+{
+  std::mt19937 random(42);
+  cmGraphAdjacencyList graph;
+  graph.resize(static_cast<std::size_t>(nodes));
+  for (int i = 1; i < nodes; ++i) {
+    std::uniform_int_distribution<int> near(i > 100 ? i - 100 : 0, i - 1);
+    std::uniform_int_distribution<int> far(0, i - 1);
+    std::set<int> dests;
+    for (int d = 0; d < depends; ++d) {
+      dests.insert(d % 4 == 3 ? far(random) : near(random));
+    }
+    for (int dest : dests) {
+      graph[i].emplace_back(dest, false, false, cmListFileBacktrace());
+    }
+  }
+  return graph;
+}
+
+void CollectDepends(cmGraphAdjacencyList const& graph, int n,
+                    std::set<int>& emitted)
+{
+  if (emitted.insert(n).second) {
+    for (cmGraphEdge const& edge : graph[n]) {
+      CollectDepends(graph, edge, emitted);
+    }
+  }
+}
+}
+
+int main(int argc, char* argv[])
+{
+  int const nodes = argc > 1 ? std::atoi(argv[1]) : 50000;
+  int const depends = argc > 2 ? std::atoi(argv[2]) : 8;
+  int const roots = argc > 3 ? std::atoi(argv[3]) : 100;
+
+  cmGraphAdjacencyList const graph = MakeGraph(nodes, depends);
+
+  auto start = Clock::now();
+  cmComputeComponentGraph ccg(graph);
+  ccg.Compute();
+  double const componentMs = Milliseconds(start);
+
+  start = Clock::now();
+  cmCompactGraph const compact(graph);
+  double const compactMs = Milliseconds(start);
+
+  int const step = nodes > roots ? nodes / roots : 1;
+
+  start = Clock::now();
+  std::size_t setTotal = 0;
+  for (int root = nodes - 1; root >= 0; root -= step) {
+    std::set<int> emitted;
+    CollectDepends(graph, root, emitted);
+    setTotal += emitted.size();
+  }
+  double const setMs = Milliseconds(start);
+
+  start = Clock::now();
+  std::size_t walkTotal = 0;
+  cmCompactGraphWalk walk(compact);
+  for (int root = nodes - 1; root >= 0; root -= step) {
+    walk.Reset();
+    walk.VisitNodes(root, [&walkTotal](int) { ++walkTotal; });
+  }
+  double const walkMs = Milliseconds(start);
+
+  std::cout << nodes << " targets, " << compact.GetNumberOfEdges()
+            << " dependencies, " << ccg.GetComponents().size()
+            << " components\n"
+            << "  components:   " << componentMs << " ms\n"
+            << "  compact copy: " << compactMs << " ms\n"
+            << "  closures of " << (nodes + step - 1) / step
+            << " targets reaching " << walkTotal << " nodes:\n"
+            << "    std::set:   " << setMs << " ms\n"
+            << "    walk:       " << walkMs << " ms\n";
+  return setTotal == walkTotal ? 0 : 1;
+}
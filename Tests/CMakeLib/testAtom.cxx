@@ -0,0 +1,153 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <cm/optional>
+
+#include "cmAtom.h"
+#include "cmPropertyMap.h"
+#include "cmValue.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+namespace {
+
+bool testScope()
+{
+  std::cout << "testScope()\n";
+  {
+    cmAtom::Scope scope;
+    cmAtom a("testAtom_Scoped");
+    {
+      cmAtom::Scope nested;
+      cm::optional<cmAtom> found = cmAtom::Find("testAtom_Scoped");
+      ASSERT_TRUE(found && *found == a);
+    }
+    cm::optional<cmAtom> found = cmAtom::Find("testAtom_Scoped");
+    ASSERT_TRUE(found && *found == a);
+  }
+
+  // The table was freed with the last scope.
+  cmAtom::Scope scope;
+  ASSERT_TRUE(!cmAtom::Find("testAtom_Scoped"));
+  ASSERT_TRUE(cmAtom().GetString().empty());
+  return true;
+}
+
+bool testIdentity()
+{
+  std::cout << "testIdentity()\n";
+  cmAtom a("testAtom_Identity");
+  cmAtom b(std::string("testAtom_Identity"));
+  cmAtom c("testAtom_Other");
+  ASSERT_TRUE(a == b);
+  ASSERT_TRUE(a != c);
+  ASSERT_TRUE(a.GetHash() == b.GetHash());
+  ASSERT_TRUE(&a.GetString() == &b.GetString());
+  ASSERT_TRUE(a.GetString() == "testAtom_Identity");
+  ASSERT_TRUE(a < c);
+  ASSERT_TRUE(!(a < b));
+
+  ASSERT_TRUE(cmAtom() == cmAtom(""));
+  ASSERT_TRUE(cmAtom().GetString().empty());
+  return true;
+}
+
+bool testFind()
+{
+  std::cout << "testFind()\n";
+  ASSERT_TRUE(!cmAtom::Find("testAtom_NeverInterned"));
+  cmAtom a("testAtom_Find");
+  cm::optional<cmAtom> found = cmAtom::Find("testAtom_Find");
+  ASSERT_TRUE(found);
+  ASSERT_TRUE(*found == a);
+  return true;
+}
+
+bool testLowerCase()
+{
+  std::cout << "testLowerCase()\n";
+  cmAtom mixed("Add_Executable");
+  cmAtom lower = mixed.GetLowerCase();
+  ASSERT_TRUE(lower.GetString() == "add_executable");
+  ASSERT_TRUE(lower == cmAtom("add_executable"));
+  ASSERT_TRUE(lower.GetLowerCase() == lower);
+  ASSERT_TRUE(mixed.GetLowerCase() == lower);
+  return true;
+}
+
+bool testThreads()
+{
+  std::cout << "testThreads()\n";
+  std::vector<std::vector<cmAtom>> results(4);
+  std::vector<std::thread> threads;
+  for (auto& result : results) {
+    threads.emplace_back([&result]() {
+      for (int i = 0; i < 1000; ++i) {
+        result.emplace_back("testAtom_Thread_" + std::to_string(i));
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  for (auto const& result : results) {
+    ASSERT_TRUE(result == results.front());
+  }
+  std::unordered_set<cmAtom, cmAtom::Hash> distinct(results[0].begin(),
+                                                    results[0].end());
+  ASSERT_TRUE(distinct.size() == 1000);
+  return true;
+}
+
+bool testPropertyMap()
+{
+  std::cout << "testPropertyMap()\n";
+  cmPropertyMap map;
+  ASSERT_TRUE(!map.GetPropertyValue("testAtom_Property"));
+  map.SetProperty("testAtom_Property", "a");
+  map.AppendProperty("testAtom_Property", "b");
+  ASSERT_TRUE(map.GetPropertyValue("testAtom_Property") == "a;b");
+  map.SetProperty("testAtom_Property", nullptr);
+  ASSERT_TRUE(!map.GetPropertyValue("testAtom_Property"));
+  map.SetProperty("B", "2");
+  map.SetProperty("A", "1");
+  ASSERT_TRUE((map.GetKeys() == std::vector<std::string>{ "A", "B" }));
+  return true;
+}
+}
+
+int testAtom(int /*unused*/, char* /*unused*/[])
+{
+  // This must run before any atom is created outside of a scope.
+  if (!testScope()) {
+    return 1;
+  }
+  if (!testIdentity()) {
+    return 1;
+  }
+  if (!testFind()) {
+    return 1;
+  }
+  if (!testLowerCase()) {
+    return 1;
+  }
+  if (!testThreads()) {
+    return 1;
+  }
+  if (!testPropertyMap()) {
+    return 1;
+  }
+  return 0;
+}
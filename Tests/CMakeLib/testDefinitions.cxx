@@ -0,0 +1,227 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cmDefinitions.h"
+#include "cmLinkedTree.h"
+#include "cmValue.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+namespace {
+
+using Tree = cmLinkedTree<cmDefinitions>;
+
+bool testSetGetUnset()
+{
+  std::cout << "testSetGetUnset()\n";
+  Tree tree;
+  Tree::iterator root = tree.Push(tree.Root());
+
+  ASSERT_TRUE(!cmDefinitions::Get("A", root, tree.Root()));
+  ASSERT_TRUE(!cmDefinitions::HasKey("A", root, tree.Root()));
+
+  root->Set("A", "a");
+  ASSERT_TRUE(cmDefinitions::Get("A", root, tree.Root()) == "a");
+  root->Set("A", "b");
+  ASSERT_TRUE(cmDefinitions::Get("A", root, tree.Root()) == "b");
+  root->Set("E", "");
+  ASSERT_TRUE(cmDefinitions::Get("E", root, tree.Root()) == "");
+
+  root->Unset("A");
+  ASSERT_TRUE(!cmDefinitions::Get("A", root, tree.Root()));
+  // An unset variable is still a known key in its scope.
+  ASSERT_TRUE(cmDefinitions::HasKey("A", root, tree.Root()));
+  return true;
+}
+
+bool testManyKeys()
+{
+  std::cout << "testManyKeys()\n";
+  Tree tree;
+  Tree::iterator root = tree.Push(tree.Root());
+
+  // Force the table to grow several times.
+  for (int i = 0; i < 1000; ++i) {
+    root->Set("VAR_" + std::to_string(i), std::to_string(i));
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    root->Unset("VAR_" + std::to_string(i));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    cmValue v = cmDefinitions::Get("VAR_" + std::to_string(i), root,
+                                   tree.Root());
+    if (i % 2 == 0) {
+      ASSERT_TRUE(!v);
+    } else {
+      ASSERT_TRUE(v == std::to_string(i));
+    }
+  }
+  ASSERT_TRUE(cmDefinitions::ClosureKeys(root, tree.Root()).size() == 500);
+  return true;
+}
+
+bool testNestedScopes()
+{
+  std::cout << "testNestedScopes()\n";
+  Tree tree;
+  Tree::iterator root = tree.Push(tree.Root());
+  root->Set("A", "root");
+  root->Set("B", "root");
+
+  Tree::iterator child = tree.Push(root);
+  child->Set("B", "child");
+  child->Unset("A");
+  child->Set("C", "child");
+
+  ASSERT_TRUE(!cmDefinitions::Get("A", child, tree.Root()));
+  ASSERT_TRUE(cmDefinitions::Get("B", child, tree.Root()) == "child");
+  ASSERT_TRUE(cmDefinitions::Get("C", child, tree.Root()) == "child");
+  ASSERT_TRUE(cmDefinitions::Get("A", root, tree.Root()) == "root");
+  ASSERT_TRUE(cmDefinitions::Get("B", root, tree.Root()) == "root");
+  ASSERT_TRUE(!cmDefinitions::Get("C", root, tree.Root()));
+
+  Tree::iterator grandchild = tree.Push(child);
+  ASSERT_TRUE(cmDefinitions::Get("B", grandchild, tree.Root()) == "child");
+  ASSERT_TRUE(!cmDefinitions::HasKey("B", grandchild, child));
+
+  // Raising a variable copies the visible definition into the scope, but
+  // not into the scopes between it and the definition.
+  Tree::iterator greatgrandchild = tree.Push(grandchild);
+  cmDefinitions::Raise("A", greatgrandchild, tree.Root());
+  ASSERT_TRUE(cmDefinitions::HasKey("A", greatgrandchild, grandchild));
+  ASSERT_TRUE(!cmDefinitions::HasKey("A", grandchild, child));
+  ASSERT_TRUE(!cmDefinitions::Get("A", greatgrandchild, tree.Root()));
+  tree.Pop(greatgrandchild);
+
+  cmDefinitions::Raise("B", grandchild, tree.Root());
+  ASSERT_TRUE(cmDefinitions::HasKey("B", grandchild, child));
+  grandchild->Set("B", "grandchild");
+  ASSERT_TRUE(cmDefinitions::Get("B", grandchild, tree.Root()) ==
+              "grandchild");
+  ASSERT_TRUE(cmDefinitions::Get("B", child, tree.Root()) == "child");
+
+  std::vector<std::string> keys =
+    cmDefinitions::ClosureKeys(grandchild, tree.Root());
+  std::sort(keys.begin(), keys.end());
+  ASSERT_TRUE((keys == std::vector<std::string>{ "B", "C" }));
+  return true;
+}
+
+bool testMakeClosure()
+{
+  std::cout << "testMakeClosure()\n";
+  Tree tree;
+  Tree::iterator root = tree.Push(tree.Root());
+  root->Set("A", "root");
+  root->Set("B", "root");
+  root->Set("C", "root");
+
+  Tree::iterator child = tree.Push(root);
+  child->Unset("A");
+  child->Set("B", "child");
+
+  Tree::iterator closure =
+    tree.Push(tree.Root(), cmDefinitions::MakeClosure(child, tree.Root()));
+  ASSERT_TRUE(!cmDefinitions::HasKey("A", closure, tree.Root()));
+  ASSERT_TRUE(cmDefinitions::Get("B", closure, tree.Root()) == "child");
+  ASSERT_TRUE(cmDefinitions::Get("C", closure, tree.Root()) == "root");
+
+  // The closure and the scopes it was taken from do not see later changes
+  // of each other.
+  root->Set("C", "root2");
+  root->Set("D", "root2");
+  closure->Set("B", "closure");
+  ASSERT_TRUE(cmDefinitions::Get("C", closure, tree.Root()) == "root");
+  ASSERT_TRUE(!cmDefinitions::Get("D", closure, tree.Root()));
+  ASSERT_TRUE(cmDefinitions::Get("B", closure, tree.Root()) == "closure");
+  ASSERT_TRUE(cmDefinitions::Get("B", child, tree.Root()) == "child");
+  ASSERT_TRUE(cmDefinitions::Get("C", child, tree.Root()) == "root2");
+
+  std::vector<std::string> keys =
+    cmDefinitions::ClosureKeys(closure, tree.Root());
+  std::sort(keys.begin(), keys.end());
+  ASSERT_TRUE((keys == std::vector<std::string>{ "B", "C" }));
+  return true;
+}
+
+bool testNestedClosures()
+{
+  std::cout << "testNestedClosures()\n";
+  Tree tree;
+  Tree::iterator dir = tree.Push(tree.Root());
+  dir->Set("LEVEL", "0");
+  dir->Set("KEEP", "0");
+  dir->Set("DROP", "0");
+
+  // Take closures of closures, deep enough to flatten the shared layers,
+  // changing the parent before and after each one.
+  std::vector<Tree::iterator> dirs{ dir };
+  for (int i = 1; i <= 20; ++i) {
+    Tree::iterator parent = dirs.back();
+    parent->Set("BEFORE_" + std::to_string(i), "x");
+    if (i == 5) {
+      parent->Unset("DROP");
+    }
+    Tree::iterator sub = tree.Push(
+      tree.Root(), cmDefinitions::MakeClosure(parent, tree.Root()));
+    parent->Set("LEVEL", "parent");
+    parent->Set("AFTER_" + std::to_string(i), "x");
+    sub->Set("LEVEL", std::to_string(i));
+    dirs.push_back(sub);
+  }
+
+  for (int i = 0; i <= 20; ++i) {
+    Tree::iterator d = dirs[i];
+    std::string const level = i == 20 ? "20" : "parent";
+    ASSERT_TRUE(cmDefinitions::Get("LEVEL", d, tree.Root()) == level);
+    ASSERT_TRUE(cmDefinitions::Get("KEEP", d, tree.Root()) == "0");
+    ASSERT_TRUE(cmDefinitions::HasKey("KEEP", d, tree.Root()));
+    if (i < 4) {
+      ASSERT_TRUE(cmDefinitions::Get("DROP", d, tree.Root()) == "0");
+    } else {
+      ASSERT_TRUE(!cmDefinitions::Get("DROP", d, tree.Root()));
+      // An unset variable is not carried into a closure.
+      ASSERT_TRUE(cmDefinitions::HasKey("DROP", d, tree.Root()) == (i == 4));
+    }
+    for (int j = 1; j <= 20; ++j) {
+      std::string const n = std::to_string(j);
+      ASSERT_TRUE(!!cmDefinitions::Get("BEFORE_" + n, d, tree.Root()) ==
+                  (j <= i + 1 && j <= 20));
+      ASSERT_TRUE(!!cmDefinitions::Get("AFTER_" + n, d, tree.Root()) ==
+                  (j == i + 1));
+    }
+  }
+  return true;
+}
+}
+
+int testDefinitions(int /*unused*/, char* /*unused*/[])
+{
+  if (!testSetGetUnset()) {
+    return 1;
+  }
+  if (!testManyKeys()) {
+    return 1;
+  }
+  if (!testNestedScopes()) {
+    return 1;
+  }
+  if (!testMakeClosure()) {
+    return 1;
+  }
+  if (!testNestedClosures()) {
+    return 1;
+  }
+  return 0;
+}
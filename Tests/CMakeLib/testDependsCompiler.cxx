@@ -0,0 +1,285 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <ctime>
+#include <ios>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cm3p/uv.h>
+
+#include "cmBinaryIO.h"
+#include "cmDepends.h"
+#include "cmDependsCompiler.h"
+#include "cmGeneratedFileStream.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+namespace {
+
+std::string const Dir = "testDependsCompiler";
+std::string const Log = Dir + "/compiler_depend.internal";
+
+/**
+ * Set the modification time of a file to the given number of seconds in
+ * the past, so that the tests do not depend on the timestamp resolution.
+ */
+bool SetAge(std::string const& path, int seconds)
+{
+  double const t = static_cast<double>(std::time(nullptr) - seconds);
+  uv_fs_t req;
+  int const err =
+    uv_fs_utime(uv_default_loop(), &req, path.c_str(), t, t, nullptr);
+  uv_fs_req_cleanup(&req);
+  return err == 0;
+}
+
+/** Write a dependencies file in the "msvc" format, one path per line.  */
+bool WriteDepFile(std::string const& name,
+                  std::vector<std::string> const& paths)
+{
+  cmGeneratedFileStream fout(Dir + "/" + name + ".d");
+  for (std::string const& path : paths) {
+    fout << path << "\n";
+  }
+  return fout.Close();
+}
+
+std::vector<std::string> DepFiles()
+{
+  return { "a.c", "a.o", "msvc", Dir + "/a.d",
+           "b.c", "b.o", "msvc", Dir + "/b.d" };
+}
+
+/** Check the dependencies with a new scanner, and update the log.  */
+bool Check(cmDepends::DependencyMap& dependencies, bool& upToDate,
+           bool& changed)
+{
+  cmDependsCompiler depends;
+  dependencies.clear();
+  upToDate = depends.CheckDependencies(Log, DepFiles(), dependencies, {});
+  changed = depends.HasChangedDependencies();
+  return upToDate || depends.WriteDependencyLog(Log, dependencies);
+}
+
+/** Make the given dependencies file newer than the log.  */
+bool Outdate(std::string const& name)
+{
+  return SetAge(Log, 20) && SetAge(Dir + "/" + name + ".d", 0);
+}
+
+bool Setup()
+{
+  cmSystemTools::RemoveADirectory(Dir);
+  return cmSystemTools::MakeDirectory(Dir) &&
+    WriteDepFile("a", { "a.h", "common.h" }) &&
+    WriteDepFile("b", { "b00.h", "common.h" }) && SetAge(Dir + "/a.d", 30) &&
+    SetAge(Dir + "/b.d", 30);
+}
+
+bool testFirstWrite()
+{
+  std::cout << "testFirstWrite()" << std::endl;
+  ASSERT_TRUE(Setup());
+
+  cmDepends::DependencyMap dependencies;
+  bool upToDate;
+  bool changed;
+  ASSERT_TRUE(Check(dependencies, upToDate, changed));
+  ASSERT_TRUE(!upToDate);
+  ASSERT_TRUE(changed);
+  ASSERT_TRUE(dependencies.size() == 2);
+  ASSERT_TRUE((dependencies["a.o"] ==
+               std::vector<std::string>{ "a.c", "a.h", "common.h" }));
+  ASSERT_TRUE((dependencies["b.o"] ==
+               std::vector<std::string>{ "b.c", "b00.h", "common.h" }));
+
+  std::string content;
+  ASSERT_TRUE(cmBinaryIO::ReadFile(Log, content));
+  ASSERT_TRUE(cmHasLiteralPrefix(content, "CMDLOG\n"));
+
+  // The log is newer than all dependencies files, so it is not even read.
+  ASSERT_TRUE(Check(dependencies, upToDate, changed));
+  ASSERT_TRUE(upToDate);
+  ASSERT_TRUE(dependencies.empty());
+  return true;
+}
+
+bool testUnchanged()
+{
+  std::cout << "testUnchanged()" << std::endl;
+  ASSERT_TRUE(Setup());
+
+  cmDepends::DependencyMap dependencies;
+  bool upToDate;
+  bool changed;
+  ASSERT_TRUE(Check(dependencies, upToDate, changed));
+  unsigned long const size = cmSystemTools::FileLength(Log);
+
+  // A dependencies file rewritten with the same content is read again,
+  // but leaves the log as it is.
+  ASSERT_TRUE(WriteDepFile("a", { "a.h", "common.h" }));
+  ASSERT_TRUE(Outdate("a"));
+  ASSERT_TRUE(Check(dependencies, upToDate, changed));
+  ASSERT_TRUE(!upToDate);
+  ASSERT_TRUE(!changed);
+  ASSERT_TRUE(dependencies.size() == 2);
+  ASSERT_TRUE(cmSystemTools::FileLength(Log) == size);
+
+  // The log was touched, so the next check takes the fast path.
+  ASSERT_TRUE(Check(dependencies, upToDate, changed));
+  ASSERT_TRUE(upToDate);
+  return true;
+}
+
+bool testAppend()
+{
+  std::cout << "testAppend()" << std::endl;
+  ASSERT_TRUE(Setup());
+
+  cmDepends::DependencyMap dependencies;
+  bool upToDate;
+  bool changed;
+  ASSERT_TRUE(Check(dependencies, upToDate, changed));
+  unsigned long const size = cmSystemTools::FileLength(Log);
+
+  // Only the record of the changed dependencies is appended.
+  ASSERT_TRUE(WriteDepFile("b", { "b01.h", "common.h", "extra.h" }));
+  ASSERT_TRUE(Outdate("b"));
+  ASSERT_TRUE(Check(dependencies, upToDate, changed));
+  ASSERT_TRUE(!upToDate);
+  ASSERT_TRUE(changed);
+  unsigned long const appended = cmSystemTools::FileLength(Log);
+  ASSERT_TRUE(appended > size);
+
+  // The appended record replaces the earlier one when the log is read.
+  ASSERT_TRUE(SetAge(Dir + "/b.d", 30));
+  ASSERT_TRUE(Outdate("a"));
+  ASSERT_TRUE(Check(dependencies, upToDate, changed));
+  ASSERT_TRUE(!changed);
+  ASSERT_TRUE(dependencies.size() == 2);
+  ASSERT_TRUE(
+    (dependencies["b.o"] ==
+     std::vector<std::string>{ "b.c", "b01.h", "common.h", "extra.h" }));
+  ASSERT_TRUE(cmSystemTools::FileLength(Log) == appended);
+  return true;
+}
+
+bool testCompaction()
+{
+  std::cout << "testCompaction()" << std::endl;
+  ASSERT_TRUE(Setup());
+
+  cmDepends::DependencyMap dependencies;
+  bool upToDate;
+  bool changed;
+  ASSERT_TRUE(Check(dependencies, upToDate, changed));
+  unsigned long const size = cmSystemTools::FileLength(Log);
+
+  // Keep changing the dependencies of b.o with paths of the same length,
+  // until the log is rewritten with one record per object again.
+  bool compacted = false;
+  for (int i = 1; i < 20 && !compacted; ++i) {
+    std::string const header =
+      cmStrCat('b', i < 10 ? "0" : "", std::to_string(i), ".h");
+    ASSERT_TRUE(WriteDepFile("b", { header, "common.h" }));
+    ASSERT_TRUE(Outdate("b"));
+    ASSERT_TRUE(Check(dependencies, upToDate, changed));
+    ASSERT_TRUE(changed);
+    unsigned long const current = cmSystemTools::FileLength(Log);
+    ASSERT_TRUE(current >= size);
+    compacted = i > 1 && current == size;
+  }
+  ASSERT_TRUE(compacted);
+
+  // The rewritten log holds the latest dependencies.
+  ASSERT_TRUE(Outdate("a"));
+  ASSERT_TRUE(Check(dependencies, upToDate, changed));
+  ASSERT_TRUE(!changed);
+  ASSERT_TRUE(dependencies.size() == 2);
+  ASSERT_TRUE(dependencies["b.o"].size() == 3);
+  ASSERT_TRUE(dependencies["b.o"][1] != "b00.h");
+  return true;
+}
+
+bool testRecovery()
+{
+  std::cout << "testRecovery()" << std::endl;
+  std::vector<std::string> const broken = {
+    // A truncated record, as left by an interrupted append.
+    "truncated",
+    // Data that is not a dependency log at all.
+    "corrupt",
+    // An empty file.
+    "empty",
+  };
+  for (std::string const& kind : broken) {
+    ASSERT_TRUE(Setup());
+
+    cmDepends::DependencyMap dependencies;
+    bool upToDate;
+    bool changed;
+    ASSERT_TRUE(Check(dependencies, upToDate, changed));
+    unsigned long const size = cmSystemTools::FileLength(Log);
+
+    std::string content;
+    if (kind == "truncated") {
+      ASSERT_TRUE(cmBinaryIO::ReadFile(Log, content));
+      content.resize(size - 3);
+    } else if (kind == "corrupt") {
+      content = "not a dependency log";
+    }
+    {
+      cmGeneratedFileStream fout;
+      fout.Open(Log, false, true);
+      fout.write(content.data(), static_cast<std::streamsize>(content.size()));
+      ASSERT_TRUE(fout.Close());
+    }
+
+    // The broken log is ignored and all dependencies files are read again.
+    ASSERT_TRUE(Outdate("a"));
+    ASSERT_TRUE(Check(dependencies, upToDate, changed));
+    ASSERT_TRUE(!upToDate);
+    ASSERT_TRUE(changed);
+    ASSERT_TRUE(dependencies.size() == 2);
+    ASSERT_TRUE((dependencies["b.o"] ==
+                 std::vector<std::string>{ "b.c", "b00.h", "common.h" }));
+
+    // The log is rewritten whole.
+    ASSERT_TRUE(cmSystemTools::FileLength(Log) == size);
+    ASSERT_TRUE(Outdate("a"));
+    ASSERT_TRUE(Check(dependencies, upToDate, changed));
+    ASSERT_TRUE(!changed);
+  }
+  return true;
+}
+}
+
+int testDependsCompiler(int /*unused*/, char* /*unused*/ [])
+{
+  if (!testFirstWrite()) {
+    return 1;
+  }
+  if (!testUnchanged()) {
+    return 1;
+  }
+  if (!testAppend()) {
+    return 1;
+  }
+  if (!testCompaction()) {
+    return 1;
+  }
+  if (!testRecovery()) {
+    return 1;
+  }
+  return 0;
+}
@@ -1,6 +1,8 @@
 #include <cstddef> // IWYU pragma: keep
+#include <ios>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -9,6 +11,7 @@
 
 #include "cmsys/FStream.hxx"
 
+#include "cmGccDepfileLexerHelper.h"
 #include "cmGccDepfileReader.h"
 #include "cmGccDepfileReaderTypes.h" // for cmGccDepfileContent, cmGccStyle...
 #include "cmSystemTools.h"
@@ -103,6 +106,40 @@ void dump(const char* label, const cmGccDepfileContent& dfc)
   }
 }
 
+std::string readContent(const std::string& filePath)
+{
+  cmsys::ifstream is(filePath.c_str(), std::ios::in | std::ios::binary);
+  std::ostringstream ss;
+  ss << is.rdbuf();
+  return ss.str();
+}
+
+// Check that the parser without lexer agrees with the lexer.
+bool compareWithLexer(const std::string& depfile)
+{
+  cmGccDepfileLexerHelper lexer;
+  bool const lexerOkay = lexer.readFile(depfile.c_str());
+  cmGccDepfileLexerHelper parser;
+  auto const result = parser.parseContent(readContent(depfile));
+  if (result == cmGccDepfileLexerHelper::ParseResult::NeedLexer) {
+    return true;
+  }
+  if (lexerOkay !=
+      (result == cmGccDepfileLexerHelper::ParseResult::Success)) {
+    std::cerr << "Parsing " << depfile << " without the lexer "
+              << (lexerOkay ? "failed" : "succeeded") << std::endl;
+    return false;
+  }
+  auto const expected = std::move(lexer).extractContent();
+  auto const actual = std::move(parser).extractContent();
+  if (!compare(actual, expected)) {
+    dump("parsed without lexer", actual);
+    dump("parsed with lexer", expected);
+    return false;
+  }
+  return true;
+}
+
 } // anonymous namespace
 
 int testGccDepfileReader(int argc, char* argv[])
@@ -136,6 +173,14 @@ int testGccDepfileReader(int argc, char* argv[])
       std::cerr << "Reading " << depfile << " should have failed\n";
       return 1;
     }
+    if (cmSystemTools::FileExists(depfile) && !compareWithLexer(depfile)) {
+      return 1;
+    }
+  }
+
+  // See benchGccDepfileReader for the throughput on this file.
+  if (!compareWithLexer(dataDirPath + "/large.d")) {
+    return 1;
   }
 
   return 0;
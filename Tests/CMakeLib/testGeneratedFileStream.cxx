@@ -3,6 +3,8 @@
 #include <iostream>
 #include <string>
 
+#include "cmBinaryIO.h"
+#include "cmGeneratedFileHashes.h"
 #include "cmGeneratedFileStream.h"
 #include "cmSystemTools.h"
 
@@ -84,5 +86,26 @@ int testGeneratedFileStream(int /*unused*/, char* /*unused*/ [])
   cmSystemTools::RemoveFile(file3tmp);
   cmSystemTools::RemoveFile(file4tmp);
 
+  // While content hashes are recorded, a stream writes to memory first and
+  // keeps data written in another encoding.
+  cmGeneratedFileHashes hashes(".");
+  cmGeneratedFileStreamBase::SetContentHashes(&hashes);
+  std::string const file5 = "generatedFile5";
+  cmGeneratedFileStream gmem(file5);
+  gmem << "msvc_deps_prefix = ";
+  gmem.WriteAltEncoding("Note: including file:",
+                        cmGeneratedFileStream::Encoding::ConsoleOutput);
+  gmem << "\n";
+  bool const memOkay = static_cast<bool>(gmem);
+  gmem.Close();
+  cmGeneratedFileStreamBase::SetContentHashes(nullptr);
+  std::string content;
+  if (!memOkay || !cmBinaryIO::ReadFile(file5, content) ||
+      content != "msvc_deps_prefix = Note: including file:\n") {
+    cmFailed("Something wrong with cmGeneratedFileStream. Memory content: ",
+             content);
+  }
+  cmSystemTools::RemoveFile(file5);
+
   return failed;
 }
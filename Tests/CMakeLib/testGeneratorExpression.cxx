@@ -0,0 +1,195 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cmGeneratorExpression.h"
+#include "cmGeneratorExpressionDAGChecker.h"
+#include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
+#include "cmListFileCache.h"
+#include "cmState.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmake.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+namespace {
+
+struct Case
+{
+  std::string Input;
+  std::string Config;
+  char const* Target;
+  // Evaluate twice under one DAG checker for this property of the target,
+  // and optionally under a child checker for a property of another target.
+  char const* DAGProperty;
+  char const* ChildTarget;
+  char const* ChildProperty;
+};
+
+std::vector<Case> const kCases = {
+  { "plain", "Release", "top", nullptr, nullptr, nullptr },
+  { "$<1:a>$<0:b>c", "Release", "top", nullptr, nullptr, nullptr },
+  { "$<LOWER_CASE:$<UPPER_CASE:x>>;$<JOIN:a;b,->", "Release", "top", nullptr,
+    nullptr, nullptr },
+  { "$<CONFIG>", "Release", "top", nullptr, nullptr, nullptr },
+  { "$<CONFIG>", "Debug", "top", nullptr, nullptr, nullptr },
+  { "$<$<CONFIG:Debug>:dbg>$<$<BOOL:ON>:on>", "Debug", "top", nullptr,
+    nullptr, nullptr },
+  { "$<TARGET_PROPERTY:NAME>", "Release", "mid", nullptr, nullptr, nullptr },
+  { "$<TARGET_GENEX_EVAL:top,$<TARGET_PROPERTY:top,CUSTOM>>", "Release",
+    "top", nullptr, nullptr, nullptr },
+  { "$<TARGET_GENEX_EVAL:top,$<TARGET_PROPERTY:top,CUSTOM>>", "Debug", "top",
+    nullptr, nullptr, nullptr },
+  { "$<TARGET_PROPERTY:mid,INTERFACE_COMPILE_DEFINITIONS>", "Release", "top",
+    nullptr, nullptr, nullptr },
+  { "$<TARGET_PROPERTY:mid,INTERFACE_COMPILE_DEFINITIONS>", "Release", "top",
+    "COMPILE_DEFINITIONS", nullptr, nullptr },
+  { "$<TARGET_PROPERTY:base,INTERFACE_COMPILE_DEFINITIONS>", "Debug", "top",
+    "COMPILE_DEFINITIONS", "mid", "INTERFACE_COMPILE_DEFINITIONS" },
+  { "$<TARGET_PROPERTY:mid,INTERFACE_COMPILE_DEFINITIONS>", "Release", "top",
+    "CUSTOM", nullptr, nullptr },
+};
+
+std::string Describe(cmCompiledGeneratorExpression const& cge,
+                     std::string const& output)
+{
+  return cmStrCat(output, '\n', cge.GetHadContextSensitiveCondition(),
+                  cge.GetHadHeadSensitiveCondition(),
+                  cge.GetHadLinkLanguageSensitiveCondition(), ' ',
+                  cge.GetAllTargetsSeen().size(), '\n');
+}
+
+/** Evaluate every case, each with a fresh compiled expression.  */
+std::vector<std::string> EvaluateCases(cmGlobalGenerator* gg)
+{
+  std::vector<std::string> results;
+  cmGeneratorExpression ge(cmListFileBacktrace{});
+  for (Case const& c : kCases) {
+    cmGeneratorTarget const* target = gg->FindGeneratorTarget(c.Target);
+    if (!target) {
+      results.emplace_back("missing target");
+      continue;
+    }
+    std::unique_ptr<cmCompiledGeneratorExpression> cge = ge.Parse(c.Input);
+    cmLocalGenerator* lg = target->GetLocalGenerator();
+    if (!c.DAGProperty) {
+      results.emplace_back(
+        Describe(*cge, cge->Evaluate(lg, c.Config, target)));
+      continue;
+    }
+
+    // A repeated evaluation under the same checker may see transitive
+    // properties it has seen before.
+    cmGeneratorExpressionDAGChecker dagChecker(target, c.DAGProperty, nullptr,
+                                               nullptr);
+    std::string result;
+    for (int i = 0; i < 2; ++i) {
+      if (c.ChildTarget) {
+        cmGeneratorExpressionDAGChecker child(
+          gg->FindGeneratorTarget(c.ChildTarget), c.ChildProperty, nullptr,
+          &dagChecker);
+        result += Describe(*cge, cge->Evaluate(lg, c.Config, target, &child));
+      } else {
+        result +=
+          Describe(*cge, cge->Evaluate(lg, c.Config, target, &dagChecker));
+      }
+    }
+    results.emplace_back(std::move(result));
+  }
+  return results;
+}
+
+bool testFoldedAndMemoizedResults(cmGlobalGenerator* gg)
+{
+  std::cout << "testFoldedAndMemoizedResults()\n";
+
+  cmGeneratorExpressionCache& cache = gg->GetGeneratorExpressionCache();
+
+  // Evaluate everything as written, without remembering results.
+  cache.Clear();
+  cache.SetFolding(false);
+  std::vector<std::string> const expected = EvaluateCases(gg);
+  ASSERT_TRUE(cache.GetProgramCount() > 0);
+  ASSERT_TRUE(cache.GetResultCount() == 0);
+
+  std::string const& custom = expected[7];
+  ASSERT_TRUE(custom.find("MID_TOP") != std::string::npos);
+  ASSERT_TRUE(custom.find("BASE_Release") != std::string::npos);
+  ASSERT_TRUE(custom.find("BASE_ON") != std::string::npos);
+  ASSERT_TRUE(custom.find("BASE_OFF") == std::string::npos);
+  ASSERT_TRUE(custom.find("BASE_DEBUG") == std::string::npos);
+  ASSERT_TRUE(expected[8].find("BASE_DEBUG") != std::string::npos);
+
+  // Folding context independent parts does not change any result.
+  cache.SetFolding(true);
+  std::vector<std::string> const folded = EvaluateCases(gg);
+  ASSERT_TRUE(cache.GetResultCount() == 0);
+  for (std::size_t i = 0; i < kCases.size(); ++i) {
+    std::cout << "  " << kCases[i].Input << "\n";
+    ASSERT_TRUE(folded[i] == expected[i]);
+  }
+
+  // Neither does remembering results, whether they are computed or reused.
+  cache.EnableResults();
+  std::vector<std::string> const computed = EvaluateCases(gg);
+  std::size_t const results = cache.GetResultCount();
+  ASSERT_TRUE(results > 0);
+  std::vector<std::string> const reused = EvaluateCases(gg);
+  ASSERT_TRUE(cache.GetResultCount() == results);
+  for (std::size_t i = 0; i < kCases.size(); ++i) {
+    std::cout << "  " << kCases[i].Input << "\n";
+    ASSERT_TRUE(computed[i] == expected[i]);
+    ASSERT_TRUE(reused[i] == expected[i]);
+  }
+
+  // Clearing forgets everything and stops remembering results.
+  cache.Clear();
+  ASSERT_TRUE(cache.GetProgramCount() == 0);
+  ASSERT_TRUE(cache.GetResultCount() == 0);
+  ASSERT_TRUE(!cache.GetResultsEnabled());
+  ASSERT_TRUE(EvaluateCases(gg) == expected);
+  ASSERT_TRUE(cache.GetResultCount() == 0);
+  return true;
+}
+}
+
+int testGeneratorExpression(int argc, char* argv[])
+{
+  if (argc < 4) {
+    std::cout << "Invalid arguments.\n";
+    return -1;
+  }
+  std::string const sourceDir = argv[2];
+  std::string const binaryDir = argv[3];
+
+  cmSystemTools::FindCMakeResources(argv[1]);
+  cmSystemTools::RemoveADirectory(binaryDir);
+
+  cmake cm(cmake::RoleProject, cmState::Project);
+  std::vector<std::string> args = { argv[1], "-S", sourceDir, "-B",
+                                    binaryDir };
+  if (argc > 4) {
+    args.emplace_back(cmStrCat("-G", argv[4]));
+  }
+  if (cm.Run(args) != 0) {
+    std::cout << "Failed to generate " << sourceDir << "\n";
+    return 1;
+  }
+
+  if (!testFoldedAndMemoizedResults(cm.GetGlobalGenerator())) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,139 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cmComputeLinkInformation.h"
+#include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
+#include "cmListFileCache.h"
+#include "cmState.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmake.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+namespace {
+
+std::string const kConfig = "Threads";
+
+/** Summarize what a generator would ask of one target's compile and link
+    steps.  */
+std::string Describe(cmGeneratorTarget const* gt, std::string const& sourceDir)
+{
+  bool const system = gt->IsSystemIncludeDirectory(sourceDir, kConfig, "C");
+  std::string result = cmStrCat(gt->GetName(), '\n', system ? "1\n" : "0\n");
+  for (auto const& dir : gt->GetIncludeDirectories(kConfig, "C")) {
+    result += cmStrCat(dir.Value, ';');
+  }
+  result += '\n';
+  for (auto const& def : gt->GetCompileDefinitions(kConfig, "C")) {
+    result += cmStrCat(def.Value, ';');
+  }
+  result += '\n';
+  if (cmComputeLinkInformation* cli = gt->GetLinkInformation(kConfig)) {
+    for (cmComputeLinkInformation::Item const& item : cli->GetItems()) {
+      result += cmStrCat(item.Value.Value, ';');
+    }
+    result += cmStrCat('\n', cmJoin(cli->GetDirectories(), ";"), '\n',
+                       cli->GetRPathString(false), '\n');
+  }
+  return result;
+}
+
+bool testConcurrentQueries(cmGlobalGenerator* gg, std::string const& sourceDir)
+{
+  std::cout << "testConcurrentQueries()\n";
+
+  std::vector<cmGeneratorTarget const*> targets;
+  for (int i = 1; i <= 8; ++i) {
+    for (char const* prefix : { "lib", "exe" }) {
+      cmGeneratorTarget const* gt =
+        gg->FindGeneratorTarget(cmStrCat(prefix, i));
+      ASSERT_TRUE(gt);
+      targets.push_back(gt);
+    }
+  }
+
+  // Every thread walks all targets, starting at a different one, so the
+  // lazily computed state is filled in by whichever thread gets there first.
+  std::vector<std::vector<std::string>> results(4);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < results.size(); ++t) {
+    threads.emplace_back([&targets, &results, &sourceDir, t]() {
+      std::vector<std::string>& result = results[t];
+      result.resize(targets.size());
+      for (std::size_t i = 0; i < targets.size(); ++i) {
+        std::size_t const n = (i + t * 5) % targets.size();
+        result[n] = Describe(targets[n], sourceDir);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (std::vector<std::string> const& result : results) {
+    ASSERT_TRUE(result == results.front());
+  }
+
+  // The answers do not depend on having been computed concurrently.
+  for (std::size_t i = 0; i < targets.size(); ++i) {
+    ASSERT_TRUE(results.front()[i] == Describe(targets[i], sourceDir));
+  }
+
+  std::string const& lib1 = results.front()[0];
+  ASSERT_TRUE(lib1.find("lib1\n1\n") == 0);
+  ASSERT_TRUE(lib1.find("GeneratorTargetThreads/include;") !=
+              std::string::npos);
+  ASSERT_TRUE(lib1.find("BASE_THREADS;BASE_ON;BASE_TARGET=lib1;\n") !=
+              std::string::npos);
+  ASSERT_TRUE(lib1.find("libbase.a;") != std::string::npos);
+  ASSERT_TRUE(lib1.find("-limported;") != std::string::npos);
+  ASSERT_TRUE(lib1.find("GeneratorTargetThreads/lib\n") != std::string::npos);
+  std::string const& exe1 = results.front()[1];
+  ASSERT_TRUE(exe1.find("liblib1.so;") != std::string::npos);
+  ASSERT_TRUE(exe1.find("LIB1;") != std::string::npos);
+  ASSERT_TRUE(exe1.find("BASE_TARGET=exe1;") != std::string::npos);
+  return true;
+}
+}
+
+int testGeneratorTargetThreads(int argc, char* argv[])
+{
+  if (argc < 4) {
+    std::cout << "Invalid arguments.\n";
+    return -1;
+  }
+  std::string const sourceDir = argv[2];
+  std::string const binaryDir = argv[3];
+
+  cmSystemTools::FindCMakeResources(argv[1]);
+  cmSystemTools::RemoveADirectory(binaryDir);
+
+  cmake cm(cmake::RoleProject, cmState::Project);
+  std::vector<std::string> args = { argv[1], "-S", sourceDir, "-B",
+                                    binaryDir };
+  if (argc > 4) {
+    args.emplace_back(cmStrCat("-G", argv[4]));
+  }
+  if (cm.Run(args) != 0) {
+    std::cout << "Failed to generate " << sourceDir << "\n";
+    return 1;
+  }
+
+  if (!testConcurrentQueries(cm.GetGlobalGenerator(), sourceDir)) {
+    return 1;
+  }
+  return 0;
+}
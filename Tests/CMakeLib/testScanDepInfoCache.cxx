@@ -0,0 +1,271 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <cstddef>
+#include <ctime>
+#include <ios>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cm3p/uv.h>
+
+#include "cmBinaryIO.h"
+#include "cmGeneratedFileStream.h"
+#include "cmScanDepFormat.h"
+#include "cmScanDepInfoCache.h"
+#include "cmSystemTools.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+namespace {
+
+std::string const Dir = "testScanDepInfoCache";
+std::string const Cache = Dir + "/ddi.cache";
+std::string const DdiA = Dir + "/a.ddi";
+std::string const DdiB = Dir + "/b.ddi";
+
+/** Set the modification time of a file to some seconds in the past.  */
+bool SetAge(std::string const& path, int seconds)
+{
+  double const t = static_cast<double>(std::time(nullptr) - seconds);
+  uv_fs_t req;
+  int const err =
+    uv_fs_utime(uv_default_loop(), &req, path.c_str(), t, t, nullptr);
+  uv_fs_req_cleanup(&req);
+  return err == 0;
+}
+
+/** The cache does not parse the files, so any content will do.  */
+bool WriteFile(std::string const& path, std::string const& content)
+{
+  cmGeneratedFileStream fout(path);
+  fout << content;
+  return fout.Close() && SetAge(path, 30);
+}
+
+cmScanDepInfo MakeInfo(std::string const& name)
+{
+  cmScanDepInfo info;
+  info.PrimaryOutput = name + ".o";
+  info.ExtraOutputs.push_back(name + ".pcm");
+  cmSourceReqInfo provide;
+  provide.LogicalName = name;
+  provide.CompiledModulePath = name + ".pcm";
+  provide.IsInterface = false;
+  info.Provides.push_back(provide);
+  cmSourceReqInfo require;
+  require.LogicalName = "header.h";
+  require.SourcePath = "/path/to/header.h";
+  require.UseSourcePath = true;
+  require.Method = LookupMethod::IncludeQuote;
+  info.Requires.push_back(require);
+  return info;
+}
+
+bool SameRequests(std::vector<cmSourceReqInfo> const& a,
+                  std::vector<cmSourceReqInfo> const& b)
+{
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (a[i].LogicalName != b[i].LogicalName ||
+        a[i].SourcePath != b[i].SourcePath ||
+        a[i].CompiledModulePath != b[i].CompiledModulePath ||
+        a[i].UseSourcePath != b[i].UseSourcePath ||
+        a[i].IsInterface != b[i].IsInterface || a[i].Method != b[i].Method) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameInfo(cmScanDepInfo const& a, cmScanDepInfo const& b)
+{
+  return a.PrimaryOutput == b.PrimaryOutput &&
+    a.ExtraOutputs == b.ExtraOutputs && SameRequests(a.Provides, b.Provides) &&
+    SameRequests(a.Requires, b.Requires);
+}
+
+/** Start with both scan results recorded in the cache.  */
+bool Setup()
+{
+  cmSystemTools::RemoveADirectory(Dir);
+  if (!cmSystemTools::MakeDirectory(Dir) || !WriteFile(DdiA, "a") ||
+      !WriteFile(DdiB, "b")) {
+    return false;
+  }
+  cmScanDepInfoCache cache(Cache);
+  cache.Load();
+  cache.Store(DdiA, MakeInfo("a"));
+  cache.Store(DdiB, MakeInfo("b"));
+  return cache.Save();
+}
+
+bool testMiss()
+{
+  std::cout << "testMiss()" << std::endl;
+  ASSERT_TRUE(Setup());
+  cmSystemTools::RemoveFile(Cache);
+
+  // Nothing is found without a cache file.
+  cmScanDepInfoCache cache(Cache);
+  cache.Load();
+  cmScanDepInfo info;
+  ASSERT_TRUE(!cache.Lookup(DdiA, info));
+  return true;
+}
+
+bool testHit()
+{
+  std::cout << "testHit()" << std::endl;
+  ASSERT_TRUE(Setup());
+
+  cmScanDepInfoCache cache(Cache);
+  cache.Load();
+  cmScanDepInfo info;
+  ASSERT_TRUE(cache.Lookup(DdiA, info));
+  ASSERT_TRUE(SameInfo(info, MakeInfo("a")));
+  ASSERT_TRUE(cache.Lookup(DdiB, info));
+  ASSERT_TRUE(SameInfo(info, MakeInfo("b")));
+  ASSERT_TRUE(!cache.Lookup(Dir + "/c.ddi", info));
+
+  // Nothing changed, so the cache file is not written again.
+  long long mtime;
+  unsigned long long size;
+  ASSERT_TRUE(SetAge(Cache, 30));
+  ASSERT_TRUE(cmBinaryIO::StatFile(Cache, mtime, size));
+  ASSERT_TRUE(cache.Save());
+  long long savedMTime;
+  ASSERT_TRUE(cmBinaryIO::StatFile(Cache, savedMTime, size));
+  ASSERT_TRUE(savedMTime == mtime);
+  return true;
+}
+
+bool testInvalidation()
+{
+  std::cout << "testInvalidation()" << std::endl;
+  ASSERT_TRUE(Setup());
+
+  // A file with another size, or another modification time, is parsed
+  // again.
+  ASSERT_TRUE(WriteFile(DdiA, "aa"));
+  ASSERT_TRUE(SetAge(DdiB, 10));
+  {
+    cmScanDepInfoCache cache(Cache);
+    cache.Load();
+    cmScanDepInfo info;
+    ASSERT_TRUE(!cache.Lookup(DdiA, info));
+    ASSERT_TRUE(!cache.Lookup(DdiB, info));
+    cache.Store(DdiA, MakeInfo("a2"));
+    ASSERT_TRUE(cache.Save());
+  }
+
+  // The entry stored again replaces the earlier one, and the entry not
+  // used by the last collation is dropped.
+  ASSERT_TRUE(SetAge(DdiB, 30));
+  cmScanDepInfoCache cache(Cache);
+  cache.Load();
+  cmScanDepInfo info;
+  ASSERT_TRUE(cache.Lookup(DdiA, info));
+  ASSERT_TRUE(SameInfo(info, MakeInfo("a2")));
+  ASSERT_TRUE(!cache.Lookup(DdiB, info));
+  return true;
+}
+
+bool testRacy()
+{
+  std::cout << "testRacy()" << std::endl;
+  ASSERT_TRUE(Setup());
+
+  // A file written just now could be written again with the same size
+  // and time, so the information parsed from it is not stored.
+  {
+    cmGeneratedFileStream fout(DdiA);
+    fout << "A";
+    ASSERT_TRUE(fout.Close());
+  }
+  {
+    cmScanDepInfoCache cache(Cache);
+    cache.Load();
+    cmScanDepInfo info;
+    ASSERT_TRUE(!cache.Lookup(DdiA, info));
+    cache.Store(DdiA, MakeInfo("a2"));
+    ASSERT_TRUE(cache.Lookup(DdiB, info));
+    ASSERT_TRUE(cache.Save());
+  }
+  {
+    cmScanDepInfoCache cache(Cache);
+    cache.Load();
+    cmScanDepInfo info;
+    ASSERT_TRUE(!cache.Lookup(DdiA, info));
+    ASSERT_TRUE(cache.Lookup(DdiB, info));
+  }
+
+  // Once the file is old enough, it is.
+  ASSERT_TRUE(SetAge(DdiA, 30));
+  {
+    cmScanDepInfoCache cache(Cache);
+    cache.Load();
+    cmScanDepInfo info;
+    cache.Store(DdiA, MakeInfo("a2"));
+    ASSERT_TRUE(cache.Save());
+  }
+  cmScanDepInfoCache cache(Cache);
+  cache.Load();
+  cmScanDepInfo info;
+  ASSERT_TRUE(cache.Lookup(DdiA, info));
+  ASSERT_TRUE(SameInfo(info, MakeInfo("a2")));
+  return true;
+}
+
+bool testCorrupt()
+{
+  std::cout << "testCorrupt()" << std::endl;
+  ASSERT_TRUE(Setup());
+
+  // A truncated cache is treated as empty.
+  std::string content;
+  ASSERT_TRUE(cmBinaryIO::ReadFile(Cache, content));
+  content.resize(content.size() - 3);
+  {
+    cmGeneratedFileStream fout;
+    fout.Open(Cache, false, true);
+    fout.write(content.data(), static_cast<std::streamsize>(content.size()));
+    ASSERT_TRUE(fout.Close());
+  }
+  cmScanDepInfoCache cache(Cache);
+  cache.Load();
+  cmScanDepInfo info;
+  ASSERT_TRUE(!cache.Lookup(DdiA, info));
+  ASSERT_TRUE(!cache.Lookup(DdiB, info));
+  return true;
+}
+}
+
+int testScanDepInfoCache(int /*unused*/, char* /*unused*/ [])
+{
+  if (!testMiss()) {
+    return 1;
+  }
+  if (!testHit()) {
+    return 1;
+  }
+  if (!testInvalidation()) {
+    return 1;
+  }
+  if (!testRacy()) {
+    return 1;
+  }
+  if (!testCorrupt()) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,29 @@
+set(CMAKE_DEPENDS_USE_COMPILER OFF)
+enable_language(C)
+
+set(CMAKE_DEPENDS_SCAN_DATABASE 1)
+add_executable(main1 ${CMAKE_CURRENT_BINARY_DIR}/main1.c)
+add_executable(main2 ${CMAKE_CURRENT_BINARY_DIR}/main2.c)
+# Scan main2 after main1 so that it reuses the entries main1 saved.
+add_dependencies(main2 main1)
+
+file(GENERATE OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/check-$<LOWER_CASE:$<CONFIG>>.cmake CONTENT "
+set(check_pairs
+  \"$<TARGET_FILE:main1>|${CMAKE_CURRENT_BINARY_DIR}/shared.h\"
+  \"$<TARGET_FILE:main2>|${CMAKE_CURRENT_BINARY_DIR}/shared.h\"
+  )
+if(check_step GREATER 1)
+  list(APPEND check_pairs
+    \"$<TARGET_FILE:main1>|${CMAKE_CURRENT_BINARY_DIR}/extra.h\"
+    \"$<TARGET_FILE:main2>|${CMAKE_CURRENT_BINARY_DIR}/extra.h\"
+    )
+endif()
+set(check_exes
+  \"$<TARGET_FILE:main1>\"
+  \"$<TARGET_FILE:main2>\"
+  )
+file(GLOB scan_db \"${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/CMakeDependsScan/*/*.db\")
+if(NOT scan_db)
+  set(RunCMake_TEST_FAILED \"The scan database was not written.\")
+endif()
+")
@@ -0,0 +1,9 @@
+foreach(main main1 main2)
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/${main}.c" [[
+#include "shared.h"
+int main(void) { return COUNT; }
+]])
+endforeach()
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/shared.h" [[
+#define COUNT 1
+]])
@@ -0,0 +1,6 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/shared.h" [[
+#include "extra.h"
+]])
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/extra.h" [[
+#define COUNT 2
+]])
@@ -0,0 +1,3 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/extra.h" [[
+#define COUNT 3
+]])
@@ -185,6 +185,12 @@ endif()
 
 if(RunCMake_GENERATOR MATCHES "Make")
   run_BuildDepends(MakeDependencies)
+  unset(run_BuildDepends_skip_step_3)
+  # Report the entries main2 reads from the scan database.
+  set(ENV{VERBOSE} 1)
+  run_BuildDepends(MakeScanDatabase)
+  unset(ENV{VERBOSE})
+  set(run_BuildDepends_skip_step_3 1)
 endif()
 
 if(RunCMake_GENERATOR MATCHES "^Visual Studio 9 " OR
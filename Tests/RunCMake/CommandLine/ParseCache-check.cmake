@@ -0,0 +1,11 @@
+if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileParseCache.bin")
+  set(RunCMake_TEST_FAILED "Parse cache was not written.")
+  return()
+endif()
+
+file(READ "${ParseCacheProfile}" profile)
+if(NOT profile MATCHES [=["name" *: *"parse-cache"]=])
+  set(RunCMake_TEST_FAILED "Profile does not contain parse-cache counters.")
+elseif(NOT profile MATCHES [=["stored" *: *[1-9]]=])
+  set(RunCMake_TEST_FAILED "Parse cache did not store any entries.")
+endif()
@@ -0,0 +1,6 @@
+file(READ "${ParseCacheProfile}" profile)
+if(NOT profile MATCHES [=["hits" *: *[1-9]]=])
+  set(RunCMake_TEST_FAILED "Parse cache entries were not reused.")
+elseif(NOT profile MATCHES [=["stale" *: *0]=])
+  set(RunCMake_TEST_FAILED "Parse cache entries were unexpectedly stale.")
+endif()
@@ -0,0 +1,7 @@
+file(READ "${ParseCacheProfile}" profile)
+# Modified.cmake and the second include of Rewritten.cmake.
+if(NOT profile MATCHES [=["stale" *: *2[^0-9]]=])
+  set(RunCMake_TEST_FAILED "Changed files were not found to be stale.")
+elseif(NOT profile MATCHES [=["hits" *: *[1-9]]=])
+  set(RunCMake_TEST_FAILED "Parse cache entries were not reused.")
+endif()
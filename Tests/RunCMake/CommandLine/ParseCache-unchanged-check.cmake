@@ -0,0 +1,13 @@
+file(TIMESTAMP "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileParseCache.bin"
+  stamp "%s")
+if(NOT stamp STREQUAL ParseCacheStamp)
+  set(RunCMake_TEST_FAILED "Parse cache was rewritten without changes.")
+  return()
+endif()
+
+file(READ "${ParseCacheProfile}" profile)
+if(NOT profile MATCHES [=["stored" *: *0[^0-9]]=])
+  set(RunCMake_TEST_FAILED "Parse cache unexpectedly stored entries.")
+elseif(NOT profile MATCHES [=["hits" *: *[1-9]]=])
+  set(RunCMake_TEST_FAILED "Parse cache entries were not reused.")
+endif()
@@ -0,0 +1,20 @@
+function(parse_cache_test_function)
+endfunction()
+parse_cache_test_function()
+
+# A file rewritten during the run with the same size is parsed again.
+if(PARSE_CACHE_REWRITE)
+  file(WRITE "${CMAKE_BINARY_DIR}/Rewritten.cmake" "set(rewritten 1)\n")
+  include("${CMAKE_BINARY_DIR}/Rewritten.cmake")
+  file(WRITE "${CMAKE_BINARY_DIR}/Rewritten.cmake" "set(rewritten 2)\n")
+  include("${CMAKE_BINARY_DIR}/Rewritten.cmake")
+  if(NOT rewritten EQUAL 2)
+    message(FATAL_ERROR "Rewritten.cmake was not parsed again.")
+  endif()
+endif()
+
+# A file modified between runs is parsed again.
+if(NOT EXISTS "${CMAKE_BINARY_DIR}/Modified.cmake")
+  file(WRITE "${CMAKE_BINARY_DIR}/Modified.cmake" "message(STATUS \"Modified 1\")\n")
+endif()
+include("${CMAKE_BINARY_DIR}/Modified.cmake")
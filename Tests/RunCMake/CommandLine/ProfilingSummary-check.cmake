@@ -0,0 +1,75 @@
+if (NOT EXISTS ${ProfilingTestOutput})
+  set(RunCMake_TEST_FAILED "Expected ${ProfilingTestOutput} to exists")
+  return()
+endif()
+
+file(READ "${ProfilingTestOutput}" summary)
+string(JSON version GET "${summary}" version)
+if (NOT version EQUAL 1)
+  set(RunCMake_TEST_FAILED "Unexpected version: ${version}")
+  return()
+endif()
+
+function(find_element member key value out)
+  set(found "")
+  string(JSON n LENGTH "${summary}" ${member})
+  if (n GREATER 0)
+    math(EXPR last "${n} - 1")
+    foreach(i RANGE ${last})
+      string(JSON element GET "${summary}" ${member} ${i})
+      string(JSON v GET "${element}" ${key})
+      if (v STREQUAL value)
+        list(APPEND found "${element}")
+      endif()
+    endforeach()
+  endif()
+  set(${out} "${found}" PARENT_SCOPE)
+endfunction()
+
+# The recursive function is called 7 times, counted once per call.
+find_element(commands name "__testing_recurse" command)
+if (NOT command)
+  set(RunCMake_TEST_FAILED "Command name not stored in lowercase")
+  return()
+endif()
+string(JSON calls GET "${command}" calls)
+string(JSON selfTime GET "${command}" selfTime)
+string(JSON totalTime GET "${command}" totalTime)
+if (NOT calls EQUAL 7)
+  set(RunCMake_TEST_FAILED "Unexpected number of calls: ${calls}")
+  return()
+endif()
+if (selfTime GREATER totalTime)
+  set(RunCMake_TEST_FAILED
+    "Self time ${selfTime} greater than total time ${totalTime}")
+  return()
+endif()
+
+# The function is called from 3 locations, the recursive one 5 times.
+find_element(locations command "__testing_recurse" locations)
+list(LENGTH locations n)
+if (NOT n EQUAL 3)
+  set(RunCMake_TEST_FAILED "Unexpected locations: ${locations}")
+  return()
+endif()
+foreach(location IN LISTS locations)
+  string(JSON file GET "${location}" file)
+  string(JSON line GET "${location}" line)
+  string(JSON calls GET "${location}" calls)
+  if (line EQUAL 4)
+    set(expected 5)
+  else()
+    set(expected 1)
+  endif()
+  if (NOT file MATCHES "/ProfilingSummary.cmake$" OR
+      NOT calls EQUAL expected)
+    set(RunCMake_TEST_FAILED "Unexpected location: ${location}")
+    return()
+  endif()
+endforeach()
+
+find_element(entries name "configure" configure)
+if (NOT configure)
+  set(RunCMake_TEST_FAILED "No configure entry")
+  return()
+endif()
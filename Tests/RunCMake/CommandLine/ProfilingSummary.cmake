@@ -0,0 +1,9 @@
+function(__testing_recurse n)
+  if(n GREATER 0)
+    math(EXPR n "${n} - 1")
+    __TESTING_RECURSE(${n})
+  endif()
+endfunction()
+
+__testing_recurse(3)
+__testing_recurse(2)
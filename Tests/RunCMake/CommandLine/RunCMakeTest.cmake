@@ -975,6 +975,24 @@ set(RunCMake_TEST_OPTIONS --trace-expand --trace-format=json-v1 --trace-redirect
 run_cmake(trace-json-v1-expand)
 unset(RunCMake_TEST_OPTIONS)
 
+set(RunCMake_TEST_OPTIONS --trace-format=binary-v1 --trace-redirect=${RunCMake_BINARY_DIR}/binary-v1.trace)
+run_cmake(trace-binary-v1)
+unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_OPTIONS --trace-format=binary-v1 --trace-sample=3 --trace-redirect=${RunCMake_BINARY_DIR}/binary-v1-sample.trace)
+run_cmake(trace-binary-v1-sample)
+unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_OPTIONS --trace-format=binary-v1)
+run_cmake(trace-binary-v1-no-redirect)
+unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_OPTIONS --trace-sample=0)
+run_cmake(trace-sample-invalid)
+unset(RunCMake_TEST_OPTIONS)
+
+run_cmake_command(decode_trace-invalid ${CMAKE_COMMAND} -E decode_trace ${RunCMake_SOURCE_DIR}/trace.cmake)
+
 set(RunCMake_TEST_OPTIONS -Wno-deprecated --warn-uninitialized)
 run_cmake(warn-uninitialized)
 unset(RunCMake_TEST_OPTIONS)
@@ -1081,6 +1099,105 @@ set(RunCMake_TEST_OPTIONS --profiling-format=google-trace --profiling-output=${P
 run_cmake(ProfilingTest)
 unset(RunCMake_TEST_OPTIONS)
 
+set(RunCMake_TEST_BINARY_DIR "${RunCMake_BINARY_DIR}/profiling-summary")
+set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/output.json)
+set(RunCMake_TEST_OPTIONS --profiling-format=summary --profiling-output=${ProfilingTestOutput})
+run_cmake(ProfilingSummary)
+unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_OPTIONS --parse-cache=invalid)
+run_cmake(parse-cache-invalid)
+unset(RunCMake_TEST_OPTIONS)
+
+function(run_ParseCache)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ParseCache-build)
+  set(ParseCacheProfile ${RunCMake_TEST_BINARY_DIR}/profile.json)
+  set(RunCMake_TEST_OPTIONS --parse-cache=readwrite
+    --profiling-format=google-trace --profiling-output=${ParseCacheProfile})
+  run_cmake(ParseCache)
+  unset(RunCMake_TEST_OPTIONS)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(ParseCache-read ${CMAKE_COMMAND} . --parse-cache=read
+    --profiling-format=google-trace --profiling-output=${ParseCacheProfile})
+  set(ENV{CMAKE_PARSE_CACHE} "read")
+  run_cmake_command(ParseCache-env ${CMAKE_COMMAND} .
+    --profiling-format=google-trace --profiling-output=${ParseCacheProfile})
+  unset(ENV{CMAKE_PARSE_CACHE})
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/Modified.cmake"
+    "message(STATUS \"Modified 2\")\n")
+  run_cmake_command(ParseCache-modified ${CMAKE_COMMAND} . --parse-cache=read
+    -DPARSE_CACHE_REWRITE=1
+    --profiling-format=google-trace --profiling-output=${ParseCacheProfile})
+  # Store Modified.cmake once its time is old enough to be trusted, and
+  # then check that a run reading only stored files does not rewrite them.
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 2)
+  run_cmake_command(ParseCache-update ${CMAKE_COMMAND} . --parse-cache=readwrite
+    -DPARSE_CACHE_REWRITE=0)
+  file(TIMESTAMP "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileParseCache.bin"
+    ParseCacheStamp "%s")
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  run_cmake_command(ParseCache-unchanged ${CMAKE_COMMAND} . --parse-cache=readwrite
+    --profiling-format=google-trace --profiling-output=${ParseCacheProfile})
+endfunction()
+run_ParseCache()
+
+function(run_SkipUnchanged)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/SkipUnchanged-build)
+  set(SkipUnchangedProfile ${RunCMake_TEST_BINARY_DIR}/profile.json)
+  set(ENV{CMAKE_GENERATE_SKIP_UNCHANGED} 1)
+  set(RunCMake_TEST_OPTIONS
+    --profiling-format=google-trace --profiling-output=${SkipUnchangedProfile})
+  run_cmake(SkipUnchanged)
+  unset(RunCMake_TEST_OPTIONS)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(SkipUnchanged-regenerate ${CMAKE_COMMAND} .
+    --profiling-format=google-trace --profiling-output=${SkipUnchangedProfile})
+  unset(ENV{CMAKE_GENERATE_SKIP_UNCHANGED})
+endfunction()
+run_SkipUnchanged()
+
+function(run_SkipUnchangedReconfigure)
+  set(RunCMake_TEST_BINARY_DIR
+    ${RunCMake_BINARY_DIR}/SkipUnchangedReconfigure-build)
+  set(RunCMake_TEST_OPTIONS --skip-unchanged-reconfigure)
+  run_cmake(SkipUnchangedReconfigure)
+  unset(RunCMake_TEST_OPTIONS)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(reconfigure ${CMAKE_COMMAND} . --skip-unchanged-reconfigure)
+  # The first run determines the host system by running processes.
+  run_cmake_command(SkipUnchangedReconfigure-again ${reconfigure})
+  run_cmake_command(SkipUnchangedReconfigure-unchanged ${reconfigure})
+  set(ENV{RunCMake_RECONFIGURE_VALUE} "changed")
+  run_cmake_command(SkipUnchangedReconfigure-env ${reconfigure})
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/flag.txt" "")
+  run_cmake_command(SkipUnchangedReconfigure-exists ${reconfigure})
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/optional.cmake"
+    "message(STATUS \"optional.cmake included\")\n")
+  run_cmake_command(SkipUnchangedReconfigure-optional ${reconfigure})
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/modules/ReconfigureModule.cmake"
+    "message(STATUS \"ReconfigureModule included\")\n")
+  run_cmake_command(SkipUnchangedReconfigure-module ${reconfigure})
+  # A list file saved again with the same content is unchanged.
+  file(TOUCH "${RunCMake_TEST_BINARY_DIR}/optional.cmake")
+  run_cmake_command(SkipUnchangedReconfigure-touched ${reconfigure})
+  if(RunCMake_GENERATOR MATCHES "Make")
+    # The build tool skips unchanged reconfigures, too, and then considers
+    # the build system it kept up to date.
+    execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1) # handle 1s resolution
+    file(TOUCH "${RunCMake_TEST_BINARY_DIR}/optional.cmake")
+    run_cmake_command(SkipUnchangedReconfigure-regenerate
+      ${CMAKE_COMMAND} --build .)
+    run_cmake_command(SkipUnchangedReconfigure-regenerated
+      ${CMAKE_COMMAND} --build .)
+  endif()
+  unset(ENV{RunCMake_RECONFIGURE_VALUE})
+  run_cmake_command(SkipUnchangedReconfigure-cache ${reconfigure}
+    -DRECONFIGURE_VOLATILE=ON)
+  run_cmake_command(SkipUnchangedReconfigure-volatile ${reconfigure})
+endfunction()
+run_SkipUnchangedReconfigure()
+
 if(RunCMake_GENERATOR MATCHES "^Visual Studio 11 2012")
   run_cmake_with_options(DeprecateVS11-WARN-ON -DCMAKE_WARN_VS11=ON)
   unset(ENV{CMAKE_WARN_VS11})
@@ -0,0 +1,11 @@
+if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/GeneratedFileHashes.bin")
+  set(RunCMake_TEST_FAILED "Generated file hashes were not written.")
+  return()
+endif()
+
+file(READ "${SkipUnchangedProfile}" profile)
+if(NOT profile MATCHES [=["name" *: *"generated-files"]=])
+  set(RunCMake_TEST_FAILED "Profile does not contain generated-files counters.")
+elseif(NOT profile MATCHES [=["written" *: *[1-9]]=])
+  set(RunCMake_TEST_FAILED "No generated files were written.")
+endif()
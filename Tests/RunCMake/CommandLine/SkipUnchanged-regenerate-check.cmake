@@ -0,0 +1,10 @@
+file(READ "${SkipUnchangedProfile}" profile)
+if(NOT profile MATCHES [=["skipped" *: *[1-9]]=])
+  set(RunCMake_TEST_FAILED "No unchanged generated files were skipped.")
+endif()
+
+file(GLOB_RECURSE leftovers "${RunCMake_TEST_BINARY_DIR}/*.tmp*")
+if(leftovers)
+  string(REPLACE ";" "\n  " leftovers "${leftovers}")
+  string(APPEND RunCMake_TEST_FAILED "Temporary files left behind:\n  ${leftovers}\n")
+endif()
@@ -0,0 +1 @@
+add_custom_target(SkipUnchanged ALL COMMAND "${CMAKE_COMMAND}" -E echo SkipUnchanged)
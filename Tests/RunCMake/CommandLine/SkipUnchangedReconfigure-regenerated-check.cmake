@@ -0,0 +1,3 @@
+if(actual_stdout MATCHES "Configure inputs|Configuring")
+  set(RunCMake_TEST_FAILED "The build ran CMake again:\n${actual_stdout}")
+endif()
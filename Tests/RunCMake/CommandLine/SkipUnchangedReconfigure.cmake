@@ -0,0 +1,10 @@
+if(EXISTS "${CMAKE_CURRENT_BINARY_DIR}/flag.txt")
+  message(STATUS "flag.txt exists")
+endif()
+message(STATUS "RunCMake_RECONFIGURE_VALUE='$ENV{RunCMake_RECONFIGURE_VALUE}'")
+if(RECONFIGURE_VOLATILE)
+  execute_process(COMMAND ${CMAKE_COMMAND} -E true)
+endif()
+include("${CMAKE_CURRENT_BINARY_DIR}/optional.cmake" OPTIONAL)
+set(CMAKE_MODULE_PATH "${CMAKE_CURRENT_BINARY_DIR}/modules")
+include(ReconfigureModule OPTIONAL)
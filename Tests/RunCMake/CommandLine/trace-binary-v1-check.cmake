@@ -0,0 +1,43 @@
+set(decoded ${RunCMake_BINARY_DIR}/binary-v1-decoded.trace)
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E decode_trace ${RunCMake_BINARY_DIR}/binary-v1.trace
+  OUTPUT_FILE ${decoded}
+  RESULT_VARIABLE result
+  ERROR_VARIABLE output
+  )
+if(NOT result EQUAL 0)
+  set(RunCMake_TEST_FAILED "Decoding the binary trace failed:\n${output}")
+  return()
+endif()
+
+if(Python_EXECUTABLE)
+  execute_process(
+    COMMAND ${Python_EXECUTABLE} "${RunCMake_SOURCE_DIR}/trace-json-v1-check.py" "${decoded}"
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE output
+    )
+  if(NOT result EQUAL 0)
+    set(RunCMake_TEST_FAILED "JSON trace validation failed:\n${output}")
+    return()
+  endif()
+endif()
+
+# The decoded trace matches the json-v1 trace of the same project,
+# except for the times.
+function(read_trace file out)
+  file(READ "${file}" content)
+  string(REGEX REPLACE ",\"time\":[0-9.e+-]+}" "}" content "${content}")
+  string(REPLACE "trace-json-v1" "trace-v1" content "${content}")
+  string(REPLACE "trace-binary-v1" "trace-v1" content "${content}")
+  set(${out} "${content}" PARENT_SCOPE)
+endfunction()
+read_trace(${RunCMake_BINARY_DIR}/json-v1.trace expected)
+read_trace(${decoded} actual)
+if(NOT actual STREQUAL expected)
+  set(RunCMake_TEST_FAILED
+    "Decoded trace does not match the json-v1 trace.\n"
+    "Expected:\n${expected}\n"
+    "Actual:\n${actual}\n"
+    )
+endif()
@@ -0,0 +1,23 @@
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E decode_trace ${RunCMake_BINARY_DIR}/binary-v1-sample.trace
+  OUTPUT_VARIABLE sampled
+  RESULT_VARIABLE result
+  ERROR_VARIABLE output
+  )
+if(NOT result EQUAL 0)
+  set(RunCMake_TEST_FAILED "Decoding the binary trace failed:\n${output}")
+  return()
+endif()
+
+# One in every 3 commands of the full trace is recorded, starting with the
+# first.  Both traces also hold a version line.
+file(READ ${RunCMake_BINARY_DIR}/binary-v1-decoded.trace full)
+string(REGEX MATCHALL "\n" full_lines "${full}")
+string(REGEX MATCHALL "\n" sampled_lines "${sampled}")
+list(LENGTH full_lines full_count)
+list(LENGTH sampled_lines sampled_count)
+math(EXPR expected "(${full_count} - 1 + 2) / 3 + 1")
+if(NOT sampled_count EQUAL expected)
+  set(RunCMake_TEST_FAILED
+    "Expected ${expected} lines in the sampled trace, got ${sampled_count}.")
+endif()
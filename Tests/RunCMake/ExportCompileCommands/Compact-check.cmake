@@ -0,0 +1,40 @@
+set(database "${RunCMake_TEST_BINARY_DIR}/compile_commands.bin")
+if(NOT EXISTS "${database}")
+  set(RunCMake_TEST_FAILED "compile_commands.bin not generated")
+  return()
+endif()
+
+file(READ "${RunCMake_TEST_BINARY_DIR}/compile_commands.json" compile_commands)
+string(JSON num_commands LENGTH "${compile_commands}")
+math(EXPR last "${num_commands} - 1")
+
+# Each command of the JSON database is found in the compact database.
+foreach(i RANGE ${last})
+  string(JSON expected GET "${compile_commands}" ${i})
+  string(JSON file GET "${expected}" file)
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E compile_commands_query "${database}" "${file}"
+    OUTPUT_VARIABLE actual
+    RESULT_VARIABLE result
+    )
+  if(NOT result EQUAL 0)
+    string(APPEND RunCMake_TEST_FAILED "Query of\n  ${file}\nfailed:\n  ${result}\n")
+    continue()
+  endif()
+  string(JSON num_actual LENGTH "${actual}")
+  string(JSON actual GET "${actual}" 0)
+  string(JSON equal EQUAL "${expected}" "${actual}")
+  if(NOT num_actual EQUAL 1 OR NOT equal)
+    string(APPEND RunCMake_TEST_FAILED "Query of\n  ${file}\nreturned\n  ${actual}\n"
+      "instead of\n  ${expected}\n")
+  endif()
+endforeach()
+
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E compile_commands_query "${database}" "${RunCMake_TEST_SOURCE_DIR}/missing.c"
+  OUTPUT_VARIABLE actual
+  RESULT_VARIABLE result
+  )
+if(NOT result EQUAL 1)
+  string(APPEND RunCMake_TEST_FAILED "Query of a missing file returned ${result}:\n  ${actual}\n")
+endif()
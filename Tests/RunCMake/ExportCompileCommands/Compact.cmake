@@ -0,0 +1,5 @@
+enable_language(C)
+
+set(CMAKE_EXPORT_COMPILE_COMMANDS_BINARY ON)
+add_library(Compact STATIC empty.c expected_file.c)
+set_property(TARGET Compact PROPERTY EXPORT_COMPILE_COMMANDS TRUE)
@@ -7,6 +7,7 @@ else()
 endif()
 
 run_cmake_with_options(BeforeProject -DCMAKE_PROJECT_INCLUDE_BEFORE=BeforeProjectBEFORE.cmake)
+run_cmake(Compact)
 run_cmake(CustomCompileRule)
 run_cmake(Properties)
 run_cmake(PropertiesGenerateCommand)
@@ -0,0 +1,11 @@
+set(marker "${RunCMake_TEST_BINARY_DIR}/marker")
+foreach(f IN ITEMS CXX.dd CXXModules.json CXXDdiCache.bin b.o.modmap)
+  if(NOT "${RunCMake_TEST_BINARY_DIR}/${f}" IS_NEWER_THAN "${marker}")
+    string(APPEND RunCMake_TEST_FAILED "Collation did not update ${f}\n")
+  endif()
+endforeach()
+foreach(f IN ITEMS a.o.modmap c01.o.modmap)
+  if("${RunCMake_TEST_BINARY_DIR}/${f}" IS_NEWER_THAN "${marker}")
+    string(APPEND RunCMake_TEST_FAILED "Collation rewrote unchanged ${f}\n")
+  endif()
+endforeach()
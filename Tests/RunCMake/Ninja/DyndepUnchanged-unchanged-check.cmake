@@ -0,0 +1,10 @@
+foreach(f IN ITEMS CXX.dd CXXModules.json CXXDdiCache.bin a.o.modmap b.o.modmap
+                   c01.o.modmap)
+  set(file "${RunCMake_TEST_BINARY_DIR}/${f}")
+  if(NOT EXISTS "${file}")
+    string(APPEND RunCMake_TEST_FAILED "Collation did not write ${f}\n")
+  elseif("${file}" IS_NEWER_THAN "${RunCMake_TEST_BINARY_DIR}/marker")
+    string(APPEND RunCMake_TEST_FAILED
+      "Collation of unchanged scan results rewrote ${f}\n")
+  endif()
+endforeach()
@@ -0,0 +1,8 @@
+set(log "${RunCMake_TEST_BINARY_DIR}/build.ninja")
+file(READ "${log}" build_file)
+set(closure "${CMAKE_NINJA_OUTPUT_PATH_PREFIX}cmake_target_depends_closure")
+if(NOT "${build_file}" MATCHES "build ${closure}/third: phony [^\n]*${closure}/second")
+  set(RunCMake_TEST_FAILED "Log file:\n ${log}\ndoes not have expected closure of target: third")
+elseif(NOT "${build_file}" MATCHES "build ${CMAKE_NINJA_OUTPUT_PATH_PREFIX}third\\.txt [^\n]*\\|\\| ${closure}/third\n")
+  set(RunCMake_TEST_FAILED "Log file:\n ${log}\ndoes not use expected closure for: third.txt")
+endif()
@@ -0,0 +1,21 @@
+set(CMAKE_NINJA_PHONY_DEPENDS_CLOSURES ON)
+
+add_custom_command(
+  OUTPUT first.txt
+  COMMAND "${CMAKE_COMMAND}" -E touch first.txt
+  )
+add_custom_target(first DEPENDS "${CMAKE_CURRENT_BINARY_DIR}/first.txt")
+
+add_custom_command(
+  OUTPUT second.txt
+  COMMAND "${CMAKE_COMMAND}" -E copy first.txt second.txt
+  )
+add_custom_target(second DEPENDS "${CMAKE_CURRENT_BINARY_DIR}/second.txt")
+add_dependencies(second first)
+
+add_custom_command(
+  OUTPUT third.txt
+  COMMAND "${CMAKE_COMMAND}" -E copy first.txt third.txt
+  )
+add_custom_target(third ALL DEPENDS "${CMAKE_CURRENT_BINARY_DIR}/third.txt")
+add_dependencies(third second)
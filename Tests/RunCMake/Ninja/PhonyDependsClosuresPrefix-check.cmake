@@ -0,0 +1,2 @@
+set(CMAKE_NINJA_OUTPUT_PATH_PREFIX "sub/")
+include("${RunCMake_SOURCE_DIR}/PhonyDependsClosures-check.cmake")
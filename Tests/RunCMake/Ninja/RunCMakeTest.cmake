@@ -90,6 +90,42 @@ run_CMP0058(NEW-by)
 
 run_cmake_with_options(CustomCommandDepfile -DCMAKE_BUILD_TYPE=Debug)
 run_cmake(CustomCommandJobPool)
+
+function(run_PhonyDependsClosures)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/PhonyDependsClosures-build)
+  run_cmake(PhonyDependsClosures)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(PhonyDependsClosures-build ${CMAKE_COMMAND} --build .)
+endfunction()
+run_PhonyDependsClosures()
+
+function(run_PhonyDependsClosuresPrefix)
+  # The closure rules are named like outputs under the prefix.
+  set(RunCMake_TEST_OPTIONS "-DCMAKE_NINJA_OUTPUT_PATH_PREFIX=sub/")
+  run_cmake(PhonyDependsClosuresPrefix)
+endfunction()
+run_PhonyDependsClosuresPrefix()
+
+function(run_SubninjaDirectories)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/SubninjaDirectories-build)
+  run_cmake(SubninjaDirectories)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(SubninjaDirectories-build ${CMAKE_COMMAND} --build .)
+
+  # Change one directory and configure again.  Only its file is written.
+  set(shard "${RunCMake_TEST_BINARY_DIR}/SubninjaDirectories")
+  file(TIMESTAMP "${shard}/CMakeFiles/build.ninja" sub_time UTC)
+  file(TIMESTAMP "${shard}/other/CMakeFiles/build.ninja" other_time UTC)
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/shard-times.cmake"
+    "set(sub_time_before \"${sub_time}\")\n"
+    "set(other_time_before \"${other_time}\")\n")
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1.1)
+  set(RunCMake_TEST_OPTIONS -DSUB_OUTPUT=sub2.txt)
+  run_cmake(SubninjaDirectories-regenerate)
+  run_cmake_command(SubninjaDirectories-regenerate-build ${CMAKE_COMMAND} --build .)
+endfunction()
+run_SubninjaDirectories()
+
 run_cmake(JobPoolUsesTerminal)
 
 run_cmake(RspFileC)
@@ -217,6 +253,75 @@ macro(shell_escape string out)
   string(REPLACE "\"" "\\\"" "${out}" "${string}")
 endmacro(shell_escape)
 
+function(write_DyndepUnchanged_ddi name provides requires)
+  set(dir "${RunCMake_BINARY_DIR}/DyndepUnchanged-build")
+  set(rule "\"primary-output\": \"${dir}/${name}.o\"")
+  if(provides)
+    string(APPEND rule ", \"provides\": [{ \"logical-name\": \"${provides}\" }]")
+  endif()
+  set(reqs "")
+  foreach(req IN LISTS requires)
+    if(reqs)
+      string(APPEND reqs ", ")
+    endif()
+    string(APPEND reqs "{ \"logical-name\": \"${req}\" }")
+  endforeach()
+  string(APPEND rule ", \"requires\": [${reqs}]")
+  file(WRITE "${dir}/${name}.ddi"
+    "{ \"version\": 0, \"revision\": 0, \"rules\": [{ ${rule} }] }\n")
+endfunction()
+
+function(run_DyndepUnchanged)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/DyndepUnchanged-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(dir "${RunCMake_TEST_BINARY_DIR}")
+  file(REMOVE_RECURSE "${dir}")
+  file(MAKE_DIRECTORY "${dir}")
+
+  # Collate enough scan results to parse them on worker threads.
+  set(cxx_modules "")
+  set(ddis "")
+  foreach(name IN ITEMS a b c01 c02 c03 c04 c05 c06 c07 c08 c09 c10
+                        c11 c12 c13 c14 c15 c16 c17 c18 c19 c20)
+    list(APPEND ddis "${dir}/${name}.ddi")
+    if(name MATCHES "^c")
+      write_DyndepUnchanged_ddi(${name} "" "a")
+    endif()
+  endforeach()
+  write_DyndepUnchanged_ddi(a a "")
+  write_DyndepUnchanged_ddi(b b "")
+  foreach(name IN ITEMS a b)
+    string(APPEND cxx_modules "\"${dir}/${name}.o\": {
+    \"name\": \"cxx_modules\", \"relative-directory\": \"\",
+    \"source\": \"${dir}/${name}.cxx\", \"type\": \"CXX_MODULES\",
+    \"visibility\": \"PRIVATE\" },\n")
+  endforeach()
+  string(REGEX REPLACE ",\n$" "" cxx_modules "${cxx_modules}")
+  file(WRITE "${dir}/CXXDependInfo.json" "{
+  \"dir-cur-bld\": \"${dir}\", \"dir-cur-src\": \"${RunCMake_SOURCE_DIR}\",
+  \"dir-top-bld\": \"${dir}\", \"dir-top-src\": \"${RunCMake_SOURCE_DIR}\",
+  \"module-dir\": \"${dir}/modules\", \"linked-target-dirs\": [],
+  \"exports\": [], \"cxx-modules\": { ${cxx_modules} }
+}\n")
+  set(collate ${CMAKE_COMMAND} -E cmake_ninja_dyndep
+    --tdi=${dir}/CXXDependInfo.json --lang=CXX --modmapfmt=gcc
+    --dd=${dir}/CXX.dd ${ddis})
+
+  run_cmake_command(DyndepUnchanged-first ${collate})
+
+  # Collating the same scan results again rewrites none of the outputs.
+  sleep(1)
+  file(TOUCH "${dir}/marker")
+  run_cmake_command(DyndepUnchanged-unchanged ${collate})
+
+  # Once b imports a, only the outputs that mention b change.
+  write_DyndepUnchanged_ddi(b b "a")
+  sleep(1)
+  file(TOUCH "${dir}/marker")
+  run_cmake_command(DyndepUnchanged-changed ${collate})
+endfunction()
+run_DyndepUnchanged()
+
 function(run_sub_cmake test ninja_output_path_prefix)
   set(top_build_dir "${RunCMake_BINARY_DIR}/${test}-build/")
   file(REMOVE_RECURSE "${top_build_dir}")
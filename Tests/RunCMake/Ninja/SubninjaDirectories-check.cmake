@@ -0,0 +1,23 @@
+set(log "${RunCMake_TEST_BINARY_DIR}/build.ninja")
+file(READ "${log}" build_file)
+set(sub_file "${RunCMake_TEST_BINARY_DIR}/SubninjaDirectories/CMakeFiles/build.ninja")
+if(NOT "${build_file}" MATCHES "\nsubninja SubninjaDirectories/CMakeFiles/build\\.ninja\n")
+  set(RunCMake_TEST_FAILED "Log file:\n ${log}\ndoes not include the directory file:\n ${sub_file}")
+elseif(NOT EXISTS "${sub_file}")
+  set(RunCMake_TEST_FAILED "Directory file:\n ${sub_file}\ndoes not exist.")
+else()
+  file(READ "${sub_file}" sub_build_file)
+  if(NOT "${sub_build_file}" MATCHES "\nbuild SubninjaDirectories/sub\\.txt ")
+    set(RunCMake_TEST_FAILED "Directory file:\n ${sub_file}\ndoes not have the build statement for: sub.txt")
+  endif()
+endif()
+
+# A nested directory has its own file, also included by the top file.
+set(other_file "${RunCMake_TEST_BINARY_DIR}/SubninjaDirectories/other/CMakeFiles/build.ninja")
+if(NOT RunCMake_TEST_FAILED)
+  if(NOT "${build_file}" MATCHES "\nsubninja SubninjaDirectories/other/CMakeFiles/build\\.ninja\n")
+    set(RunCMake_TEST_FAILED "Log file:\n ${log}\ndoes not include the directory file:\n ${other_file}")
+  elseif(NOT EXISTS "${other_file}")
+    set(RunCMake_TEST_FAILED "Directory file:\n ${other_file}\ndoes not exist.")
+  endif()
+endif()
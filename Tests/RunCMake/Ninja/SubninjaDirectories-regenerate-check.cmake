@@ -0,0 +1,18 @@
+set(sub_file "${RunCMake_TEST_BINARY_DIR}/SubninjaDirectories/CMakeFiles/build.ninja")
+set(other_file "${RunCMake_TEST_BINARY_DIR}/SubninjaDirectories/other/CMakeFiles/build.ninja")
+include("${RunCMake_TEST_BINARY_DIR}/shard-times.cmake")
+
+# The directory that changed is written again.
+file(READ "${sub_file}" sub_build_file)
+file(TIMESTAMP "${sub_file}" sub_time UTC)
+if(NOT "${sub_build_file}" MATCHES "\nbuild SubninjaDirectories/sub2\\.txt ")
+  set(RunCMake_TEST_FAILED "Directory file:\n ${sub_file}\ndoes not have the build statement for: sub2.txt")
+elseif(sub_time STREQUAL sub_time_before)
+  set(RunCMake_TEST_FAILED "Directory file:\n ${sub_file}\nwas not written again.")
+endif()
+
+# The other one is left alone, so ninja does not reload it.
+file(TIMESTAMP "${other_file}" other_time UTC)
+if(NOT other_time STREQUAL other_time_before)
+  string(APPEND RunCMake_TEST_FAILED "Directory file:\n ${other_file}\nwas written again although it did not change:\n  before: ${other_time_before}\n  after:  ${other_time}\n")
+endif()
@@ -0,0 +1,17 @@
+# The statements common to all configurations and those of each
+# configuration are split into one file each, like in the top directory.
+set(sub_dir "${RunCMake_TEST_BINARY_DIR}/SubninjaDirectories/CMakeFiles")
+check_file_contents("${RunCMake_TEST_BINARY_DIR}/CMakeFiles/common.ninja"
+  "\nsubninja SubninjaDirectories/CMakeFiles/common\\.ninja\n")
+check_file_contents("${sub_dir}/common.ninja"
+  "\n# This file contains the build statements of the directory\n")
+foreach(config IN ITEMS Debug Release)
+  check_file_contents("${RunCMake_TEST_BINARY_DIR}/CMakeFiles/impl-${config}.ninja"
+    "\nsubninja SubninjaDirectories/CMakeFiles/impl-${config}\\.ninja\n")
+  check_file_contents("${sub_dir}/impl-${config}.ninja"
+    "\nbuild SubninjaDirectories/sub-${config}\\.txt ")
+endforeach()
+file(READ "${sub_dir}/impl-Debug.ninja" impl_debug)
+if(impl_debug MATCHES "sub-Release")
+  string(APPEND RunCMake_TEST_FAILED "Directory file:\n ${sub_dir}/impl-Debug.ninja\nhas statements of another configuration.\n")
+endif()
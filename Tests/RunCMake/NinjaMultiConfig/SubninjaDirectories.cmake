@@ -0,0 +1,5 @@
+set(CMAKE_NINJA_SUBNINJA_DIRECTORIES ON)
+
+add_subdirectory(SubninjaDirectories)
+add_custom_target(top ALL COMMAND "${CMAKE_COMMAND}" -E touch top.txt)
+add_dependencies(top sub)
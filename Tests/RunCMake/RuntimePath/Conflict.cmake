@@ -0,0 +1,26 @@
+enable_language(C)
+
+# Directory "a" holds libfoo.so on disk and provides the imported libbar.so.
+set(dir_a "${CMAKE_CURRENT_BINARY_DIR}/a")
+file(WRITE "${dir_a}/libfoo.so" "")
+file(WRITE "${dir_a}/libbar.so" "")
+add_library(bar SHARED IMPORTED)
+set_target_properties(bar PROPERTIES
+  IMPORTED_LOCATION "${dir_a}/libbar.so"
+  IMPORTED_SONAME "libbar.so"
+  )
+
+# Directory "b" will hold a libfoo.so and a libbar.so that are built.
+set(dir_b "${CMAKE_CURRENT_BINARY_DIR}/b")
+add_library(foo SHARED A.c)
+add_library(bar2 SHARED A.c)
+set_target_properties(foo bar2 PROPERTIES LIBRARY_OUTPUT_DIRECTORY "${dir_b}")
+set_property(TARGET bar2 PROPERTY OUTPUT_NAME bar)
+
+# Each directory hides the library that must be found in the other.
+add_executable(main main.c)
+target_link_libraries(main PRIVATE foo bar)
+
+# Nothing hides the library found in "a".
+add_executable(main-ok main.c)
+target_link_libraries(main-ok PRIVATE bar)
@@ -27,6 +27,8 @@ run_cmake_command(SymlinkImplicitCheck
 
 run_RuntimePath(Relative)
 
+run_cmake(Conflict)
+
 run_RuntimePath(Genex)
 run_cmake_command(GenexCheck
   ${CMAKE_COMMAND} -Ddir=${RunCMake_BINARY_DIR}/Genex-build -P ${RunCMake_SOURCE_DIR}/GenexCheck.cmake)
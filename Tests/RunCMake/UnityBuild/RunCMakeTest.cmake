@@ -22,6 +22,9 @@ run_cmake(unitybuild_c_no_unity_build)
 run_cmake(unitybuild_c_no_unity_build_group)
 run_cmake(unitybuild_order)
 run_cmake(unitybuild_invalid_mode)
+run_cmake(unitybuild_cost)
+run_cmake(unitybuild_cost_ninja_log)
+run_cmake(unitybuild_cost_no_file)
 run_build(unitybuild_anon_ns)
 run_build(unitybuild_anon_ns_no_unity_build)
 run_build(unitybuild_anon_ns_group_mode)
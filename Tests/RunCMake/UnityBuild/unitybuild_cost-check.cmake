@@ -0,0 +1,22 @@
+set(unitybuild_c0 "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity/unity_0_c.c")
+set(unitybuild_c1 "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/tgt.dir/Unity/unity_1_c.c")
+if(NOT EXISTS "${unitybuild_c0}" OR NOT EXISTS "${unitybuild_c1}")
+  set(RunCMake_TEST_FAILED "Generated unity source files ${unitybuild_c0} and ${unitybuild_c1} do not exist.")
+  return()
+endif()
+
+# The two most expensive sources are split and the cheap ones balance them.
+file(READ "${unitybuild_c0}" unitybuild_c0_strings)
+file(READ "${unitybuild_c1}" unitybuild_c1_strings)
+foreach(s 1 5 6)
+  if(NOT unitybuild_c0_strings MATCHES "/s${s}\\.c\"")
+    set(RunCMake_TEST_FAILED "Generated unity file ${unitybuild_c0} does not include s${s}.c")
+    return()
+  endif()
+endforeach()
+foreach(s 2 3 4)
+  if(NOT unitybuild_c1_strings MATCHES "/s${s}\\.c\"")
+    set(RunCMake_TEST_FAILED "Generated unity file ${unitybuild_c1} does not include s${s}.c")
+    return()
+  endif()
+endforeach()
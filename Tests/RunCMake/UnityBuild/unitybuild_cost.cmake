@@ -0,0 +1,28 @@
+project(unitybuild_cost C)
+
+set(srcs "")
+foreach(s RANGE 1 6)
+  set(src "${CMAKE_CURRENT_BINARY_DIR}/s${s}.c")
+  file(WRITE "${src}" "int s${s}(void) { return 0; }\n")
+  list(APPEND srcs "${src}")
+endforeach()
+
+# s6.c is not listed and is given the median cost.
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/costs.csv" [[
+# source,cost
+s1.c,100
+s2.c,90
+s3.c,10
+s4.c,10
+s5.c,5
+]])
+
+add_library(tgt SHARED ${srcs})
+
+set_target_properties(tgt
+  PROPERTIES
+    UNITY_BUILD ON
+    UNITY_BUILD_MODE COST
+    UNITY_BUILD_BATCH_SIZE 3
+    UNITY_BUILD_COST_FILE "${CMAKE_CURRENT_BINARY_DIR}/costs.csv"
+)
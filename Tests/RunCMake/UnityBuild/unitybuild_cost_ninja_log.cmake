@@ -0,0 +1,33 @@
+project(unitybuild_cost_ninja_log C)
+
+set(srcs "")
+foreach(s RANGE 1 6)
+  set(src "${CMAKE_CURRENT_BINARY_DIR}/s${s}.c")
+  file(WRITE "${src}" "int s${s}(void) { return 0; }\n")
+  list(APPEND srcs "${src}")
+endforeach()
+
+# The first entry of s1.c is replaced by the later one.  Objects of other
+# targets are not used.
+string(JOIN "\n" ninja_log
+  "# ninja log v5"
+  "0\t1\t0\tCMakeFiles/tgt.dir/s1.c.o\t0"
+  "0\t100\t0\tCMakeFiles/tgt.dir/s1.c.o\t0"
+  "0\t90\t0\tCMakeFiles/tgt.dir/s2.c.o\t0"
+  "10\t20\t0\tCMakeFiles/tgt.dir/s3.c.o\t0"
+  "20\t30\t0\tCMakeFiles/tgt.dir/s4.c.o\t0"
+  "30\t35\t0\tCMakeFiles/tgt.dir/s5.c.o\t0"
+  "0\t1000\t0\tCMakeFiles/other.dir/s6.c.o\t0"
+  ""
+  )
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/cost.ninja_log" "${ninja_log}")
+
+add_library(tgt SHARED ${srcs})
+
+set_target_properties(tgt
+  PROPERTIES
+    UNITY_BUILD ON
+    UNITY_BUILD_MODE COST
+    UNITY_BUILD_BATCH_SIZE 3
+    UNITY_BUILD_COST_FILE "${CMAKE_CURRENT_BINARY_DIR}/cost.ninja_log"
+)
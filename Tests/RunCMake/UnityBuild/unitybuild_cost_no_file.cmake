@@ -0,0 +1,5 @@
+project(unitybuild_cost_no_file C)
+
+add_library(tgt SHARED f.c)
+
+set_target_properties(tgt PROPERTIES UNITY_BUILD ON UNITY_BUILD_MODE COST)
@@ -55,6 +55,16 @@ run_cmake(REGISTRY_VIEW-no-view)
 run_cmake(REGISTRY_VIEW-wrong-view)
 run_cmake(REGISTRY_VIEW-propagated)
 
+function(run_SearchCache)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/SearchCache-build)
+  run_cmake(SearchCache)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_with_options(SearchCache-reuse --fresh --debug-find-pkg=Cached)
+  run_cmake_with_options(SearchCache-changed --fresh -DADD_FIRST=ON
+    --debug-find-pkg=Cached)
+endfunction()
+run_SearchCache()
+
 file(
     GLOB SearchPaths_TEST_CASE_LIST
     LIST_DIRECTORIES TRUE
@@ -0,0 +1,12 @@
+set(CMAKE_FIND_PACKAGE_SEARCH_CACHE ON)
+set(prefix "${CMAKE_BINARY_DIR}/prefix")
+file(MAKE_DIRECTORY "${prefix}/first")
+if(NOT EXISTS "${prefix}/second/CachedConfig.cmake")
+  file(WRITE "${prefix}/second/CachedConfig.cmake" "")
+endif()
+if(ADD_FIRST)
+  file(WRITE "${prefix}/first/CachedConfig.cmake" "")
+endif()
+find_package(Cached CONFIG PATHS "${prefix}/first" "${prefix}/second"
+  NO_DEFAULT_PATH)
+message(STATUS "Cached_DIR='${Cached_DIR}'")
@@ -0,0 +1,27 @@
+set(dir "${CMAKE_CURRENT_BINARY_DIR}/include")
+file(MAKE_DIRECTORY "${dir}")
+
+find_path(PATH_before NAMES Written.h PATHS "${dir}" NO_CACHE NO_DEFAULT_PATH)
+message(STATUS "PATH_before='${PATH_before}'")
+
+# Writing a file checks the cached directory listing again.
+file(WRITE "${dir}/Written.h" "")
+find_path(PATH_written NAMES Written.h PATHS "${dir}" NO_CACHE NO_DEFAULT_PATH)
+message(STATUS "PATH_written='${PATH_written}'")
+
+# So does running a process.
+execute_process(COMMAND "${CMAKE_COMMAND}" -E touch "${dir}/Touched.h")
+find_path(PATH_touched NAMES Touched.h PATHS "${dir}" NO_CACHE NO_DEFAULT_PATH)
+message(STATUS "PATH_touched='${PATH_touched}'")
+
+# So do the older write_file() and make_directory() commands.
+write_file("${dir}/Legacy.h" "")
+find_path(PATH_legacy NAMES Legacy.h PATHS "${dir}" NO_CACHE NO_DEFAULT_PATH)
+message(STATUS "PATH_legacy='${PATH_legacy}'")
+make_directory("${dir}/sub")
+find_path(PATH_sub NAMES sub PATHS "${dir}" NO_CACHE NO_DEFAULT_PATH)
+message(STATUS "PATH_sub='${PATH_sub}'")
+
+# Nothing changed since the last lookup.
+find_path(PATH_hit NAMES Missing.h PATHS "${dir}" NO_CACHE NO_DEFAULT_PATH)
+message(STATUS "PATH_hit='${PATH_hit}'")
@@ -0,0 +1,3 @@
+# Trusted listings are still checked again after the writes CMake knows of.
+set(CMAKE_FIND_TRUST_DIRECTORY_LISTINGS TRUE)
+include(${CMAKE_CURRENT_LIST_DIR}/DirectoryListingCache.cmake)
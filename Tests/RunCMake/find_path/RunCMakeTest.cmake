@@ -17,6 +17,8 @@ if(APPLE)
 endif()
 
 run_cmake_with_options(FromPATHEnvDebugVar --debug-find-var=PATH_IN_ENV_PATH)
+run_cmake_with_options(DirectoryListingCache --debug-find-var=PATH_hit)
+run_cmake_with_options(DirectoryListingCacheTrusted --debug-find-var=PATH_hit)
 
 if(CMAKE_HOST_SYSTEM_NAME STREQUAL "Windows")
   # Tests using the Windows registry